@@ -0,0 +1,310 @@
+#ifndef TINYSTL_ADDRESSABLE_HEAP_TEST_H_
+#define TINYSTL_ADDRESSABLE_HEAP_TEST_H_
+
+// addressable heap test : 测试 indexed_heap, pairing_heap 的接口, 随机操作与朴素实现对比结果
+// 并在随机生成的大图上比较三种 Dijkstra 最短路: priority_queue 惰性删除, indexed_heap, pairing_heap
+
+#include <cstdint>
+
+#include "../TinySTL/addressable_heap.h"
+#include "../TinySTL/queue.h"
+#include "../TinySTL/vector.h"
+#include "../TinySTL/algo.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace addressable_heap_test
+{
+
+typedef mystl::pair<long long, int>      dist_node;   // (距离, 顶点)
+typedef mystl::greater<dist_node>        dist_greater;
+
+// 压缩存储的有向图, 顶点 v 的出边为 [start[v], start[v + 1])
+struct heap_test_graph
+{
+  mystl::vector<size_t> start;
+  mystl::vector<int>    to;
+  mystl::vector<int>    weight;
+};
+
+inline uint32_t heap_test_rand32()
+{
+  return (static_cast<uint32_t>(rand()) << 16) ^ static_cast<uint32_t>(rand());
+}
+
+// n 个顶点, 每个顶点有一条到下一个顶点的边和 degree 条随机的边, 权值在 [1, 1000] 中
+inline heap_test_graph heap_test_make_graph(size_t n, size_t degree)
+{
+  heap_test_graph g;
+  g.start = mystl::vector<size_t>(n + 1);
+  g.to = mystl::vector<int>(n * (degree + 1));
+  g.weight = mystl::vector<int>(n * (degree + 1));
+  size_t e = 0;
+  for (size_t v = 0; v < n; ++v)
+  {
+    g.start[v] = e;
+    g.to[e] = (int)((v + 1) % n);
+    g.weight[e++] = 1 + rand() % 1000;
+    for (size_t k = 0; k < degree; ++k)
+    {
+      g.to[e] = (int)(heap_test_rand32() % n);
+      g.weight[e++] = 1 + rand() % 1000;
+    }
+  }
+  g.start[n] = e;
+  return g;
+}
+
+// 惰性删除: 距离变小时压入新的记录, 弹出时跳过已经过时的记录
+inline mystl::vector<long long> dijkstra_lazy(const heap_test_graph& g, int src)
+{
+  const size_t n = g.start.size() - 1;
+  mystl::vector<long long> dist(n, -1);
+  mystl::priority_queue<dist_node, mystl::vector<dist_node>, dist_greater> q;
+  dist[src] = 0;
+  q.push(dist_node(0, src));
+  while (!q.empty())
+  {
+    const dist_node top = q.top();
+    q.pop();
+    if (top.first != dist[top.second])
+      continue;
+    for (size_t e = g.start[top.second]; e < g.start[top.second + 1]; ++e)
+    {
+      const long long d = top.first + g.weight[e];
+      const int u = g.to[e];
+      if (dist[u] < 0 || d < dist[u])
+      {
+        dist[u] = d;
+        q.push(dist_node(d, u));
+      }
+    }
+  }
+  return dist;
+}
+
+// 每个顶点在堆中至多一个元素, 距离变小时通过句柄 update (decrease-key)
+template <class Heap>
+mystl::vector<long long> dijkstra_addressable(const heap_test_graph& g, int src)
+{
+  typedef typename Heap::handle_type handle_type;
+  const size_t n = g.start.size() - 1;
+  mystl::vector<long long> dist(n, -1);
+  mystl::vector<handle_type> handle(n);
+  mystl::vector<char> in_heap(n, 0);
+  Heap q;
+  dist[src] = 0;
+  handle[src] = q.push(dist_node(0, src));
+  in_heap[src] = 1;
+  while (!q.empty())
+  {
+    const dist_node top = q.top();
+    q.pop();
+    in_heap[top.second] = 0;
+    for (size_t e = g.start[top.second]; e < g.start[top.second + 1]; ++e)
+    {
+      const long long d = top.first + g.weight[e];
+      const int u = g.to[e];
+      if (dist[u] < 0)
+      {
+        dist[u] = d;
+        handle[u] = q.push(dist_node(d, u));
+        in_heap[u] = 1;
+      }
+      else if (in_heap[u] && d < dist[u])
+      {
+        dist[u] = d;
+        q.update(handle[u], dist_node(d, u));
+      }
+    }
+  }
+  return dist;
+}
+
+inline bool heap_test_same(const mystl::vector<long long>& a, const mystl::vector<long long>& b)
+{
+  return a.size() == b.size() && mystl::equal(a.begin(), a.end(), b.begin());
+}
+
+// 随机执行 push, pop, update, erase, meld, 每一步与朴素实现 (无序数组中找最大值) 比较堆顶
+template <class Heap, class Meld>
+bool heap_test_random_ops(size_t steps, Meld meld)
+{
+  typedef typename Heap::handle_type handle_type;
+  Heap h;
+  mystl::vector<handle_type> handles;
+  mystl::vector<int> values;
+  for (size_t i = 0; i < steps; ++i)
+  {
+    const int op = values.empty() ? 0 : rand() % 6;
+    if (op <= 1)
+    {
+      const int v = rand() % 1000;
+      handles.push_back(h.push(v));
+      values.push_back(v);
+    }
+    else if (op == 2)
+    { // 找到堆顶句柄对应的元素, 它的值应为最大值
+      const handle_type top = h.top_handle();
+      const size_t k = (size_t)(mystl::find(handles.begin(), handles.end(), top) - handles.begin());
+      if (k == handles.size() || values[k] != *mystl::max_element(values.begin(), values.end()))
+        return false;
+      h.pop();
+      handles[k] = handles.back();
+      values[k] = values.back();
+      handles.pop_back();
+      values.pop_back();
+    }
+    else if (op == 3)
+    {
+      const size_t k = (size_t)rand() % values.size();
+      const int v = rand() % 1000;
+      h.update(handles[k], v);
+      values[k] = v;
+    }
+    else if (op == 4)
+    {
+      const size_t k = (size_t)rand() % values.size();
+      h.erase(handles[k]);
+      handles[k] = handles.back();
+      values[k] = values.back();
+      handles.pop_back();
+      values.pop_back();
+    }
+    else
+    {
+      Heap other;
+      mystl::vector<handle_type> more;
+      const size_t m = (size_t)rand() % 8;
+      for (size_t j = 0; j < m; ++j)
+      {
+        const int v = rand() % 1000;
+        more.push_back(other.push(v));
+        values.push_back(v);
+      }
+      meld(h, other, more);
+      for (auto x : more)
+        handles.push_back(x);
+      if (!other.empty())
+        return false;
+    }
+    if (h.size() != values.size())
+      return false;
+    if (!values.empty() && h.top() != *mystl::max_element(values.begin(), values.end()))
+      return false;
+  }
+  return true;
+}
+
+#define DIJKSTRA_DO_TEST(fun, len) do {                      \
+  heap_test_graph g = heap_test_make_graph(len, 8);          \
+  char buf[10];                                              \
+  clock_t start = clock();                                   \
+  mystl::vector<long long> dist = fun(g, 0);                 \
+  clock_t end = clock();                                     \
+  volatile long long sink = dist.back();                     \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n + (int)(sink & 0)); \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define DIJKSTRA_ROW(name, fun)                              \
+  std::cout << name;                                         \
+  DIJKSTRA_DO_TEST(fun, LEN1 _SS);                           \
+  DIJKSTRA_DO_TEST(fun, LEN2 _SS);                           \
+  DIJKSTRA_DO_TEST(fun, LEN3 _SS);                           \
+  std::cout << std::endl
+
+void addressable_heap_test()
+{
+  typedef mystl::indexed_heap<dist_node, dist_greater> dist_indexed_heap;
+  typedef mystl::pairing_heap<dist_node, dist_greater> dist_pairing_heap;
+
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------------- Run container test : addressable heap -----------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::indexed_heap<int> ih{ 5,1,9,3 };
+  auto h7 = ih.push(7);
+  FUN_VALUE(ih.top());
+  FUN_VALUE(ih.value(h7));
+  ih.update(h7, 10);
+  FUN_VALUE(ih.top());
+  ih.update(h7, 0);
+  FUN_VALUE(ih.top());
+  ih.erase(2);  // 句柄 2 为 9
+  FUN_VALUE(ih.top());
+  FUN_VALUE(ih.size());
+  mystl::indexed_heap<int> ih2{ 8,2 };
+  auto offset = ih.meld(ih2);
+  FUN_VALUE(ih.top());
+  FUN_VALUE(ih.value(0 + offset));
+  std::cout << std::boolalpha;
+  FUN_VALUE(ih2.empty());
+  FUN_VALUE(ih.contains(2));
+  std::cout << std::noboolalpha;
+
+  mystl::pairing_heap<int, mystl::greater<int>> ph{ 5,1,9,3 };
+  auto p7 = ph.push(7);
+  FUN_VALUE(ph.top());
+  ph.update(p7, 0);  // decrease-key
+  FUN_VALUE(ph.top());
+  ph.erase(p7);
+  FUN_VALUE(ph.top());
+  mystl::pairing_heap<int, mystl::greater<int>> ph2{ 4,-2 };
+  auto p4 = ph2.top_handle();
+  ph.meld(ph2);
+  FUN_VALUE(ph.top());
+  ph.update(p4, -5);
+  FUN_VALUE(ph.top());
+  FUN_VALUE(ph.size());
+
+  bool same = true;
+  for (int rep = 0; rep < 20; ++rep)
+  {
+    same = same && heap_test_random_ops<mystl::indexed_heap<int>>(2000,
+      [](mystl::indexed_heap<int>& h, mystl::indexed_heap<int>& o, mystl::vector<size_t>& more)
+      {
+        const size_t offset = h.meld(o);
+        for (auto& x : more)
+          x += offset;
+      });
+    same = same && heap_test_random_ops<mystl::pairing_heap<int>>(2000,
+      [](mystl::pairing_heap<int>& h, mystl::pairing_heap<int>& o, mystl::vector<pairing_heap_node<int>*>&)
+      {
+        h.meld(o);
+      });
+  }
+  {
+    heap_test_graph g = heap_test_make_graph(20000, 8);
+    mystl::vector<long long> d1 = dijkstra_lazy(g, 0);
+    same = same && heap_test_same(d1, dijkstra_addressable<dist_indexed_heap>(g, 0));
+    same = same && heap_test_same(d1, dijkstra_addressable<dist_pairing_heap>(g, 0));
+  }
+  std::cout << std::boolalpha;
+  FUN_VALUE(same);
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|  dijkstra (8 edges) |";
+  TEST_LEN(LEN1 _SS, LEN2 _SS, LEN3 _SS, WIDE);
+  DIJKSTRA_ROW("|  lazy deletion      |", dijkstra_lazy);
+  DIJKSTRA_ROW("|  indexed_heap       |", dijkstra_addressable<dist_indexed_heap>);
+  DIJKSTRA_ROW("|  pairing_heap       |", dijkstra_addressable<dist_pairing_heap>);
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[------------- End container test : addressable heap -----------]" << std::endl;
+}
+
+} // namespace addressable_heap_test
+} // namespace test
+} // namespace mystl
+#endif // !TINYSTL_ADDRESSABLE_HEAP_TEST_H_
@@ -0,0 +1,215 @@
+#ifndef TINYSTL_ART_MAP_TEST_H_
+#define TINYSTL_ART_MAP_TEST_H_
+
+// art map test : 测试 art_map 的接口, 与 std::map 对比随机操作的结果
+// 并在 URL 形式的键值上与 map (rb_tree) 比较查找和前缀范围查询的性能
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../TinySTL/map.h"
+#include "../TinySTL/art_map.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace art_map_test
+{
+
+typedef mystl::map<std::string, int, mystl::less<std::string>> ART_TEST_MAP;
+typedef mystl::art_map<std::string, int>                       ART_TEST_ART;
+
+// 形如 http://host17.example.com/item/123456 的键值, 约 1000 个主机共享长前缀
+inline std::string art_test_key(size_t i)
+{
+  char buf[64];
+  std::snprintf(buf, sizeof(buf), "http://host%d.example.com/item/%d", (int)(i % 1000), (int)i);
+  return buf;
+}
+
+// 插入 count 个键值后逐个查找一遍
+#define ART_FIND_DO_TEST(con, count) do {                    \
+  std::vector<std::string> keys;                             \
+  for (size_t i = 0; i < count; ++i)                         \
+    keys.push_back(art_test_key(i));                         \
+  con c;                                                     \
+  for (size_t i = 0; i < count; ++i)                         \
+    c.insert(mystl::make_pair(keys[i], (int)i));             \
+  srand((int)time(0));                                       \
+  long long sum = 0;                                         \
+  char buf[10];                                              \
+  clock_t start = clock();                                   \
+  for (size_t i = 0; i < count; ++i)                         \
+    sum += c.find(keys[rand() % count])->second;             \
+  clock_t end = clock();                                     \
+  volatile long long sink = sum;                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n + (int)(sink & 0)); \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+// 对 10000 个形如 http://host17. 的前缀统计元素个数, range(c, prefix) 返回对应的区间
+#define ART_PREFIX_DO_TEST(con, count, range) do {           \
+  con c;                                                     \
+  for (size_t i = 0; i < count; ++i)                         \
+    c.insert(mystl::make_pair(art_test_key(i), (int)i));     \
+  srand((int)time(0));                                       \
+  size_t total = 0;                                          \
+  char buf[10];                                              \
+  clock_t start = clock();                                   \
+  for (int q = 0; q < 10000; ++q)                            \
+  {                                                          \
+    std::string prefix = "http://host" + std::to_string(rand() % 1000) + "."; \
+    auto r = range(c, prefix);                               \
+    for (auto it = r.first; it != r.second; ++it)            \
+      ++total;                                               \
+  }                                                          \
+  clock_t end = clock();                                     \
+  volatile size_t sink = total;                              \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n + (int)(sink & 0)); \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+// map 只能用两次 lower_bound 找出区间, 上界为前缀最后一个字节加一
+inline mystl::pair<ART_TEST_MAP::iterator, ART_TEST_MAP::iterator>
+art_test_map_prefix(ART_TEST_MAP& c, const std::string& prefix)
+{
+  std::string end = prefix;
+  ++end.back();
+  return mystl::make_pair(c.lower_bound(prefix), c.lower_bound(end));
+}
+
+inline mystl::pair<ART_TEST_ART::iterator, ART_TEST_ART::iterator>
+art_test_art_prefix(ART_TEST_ART& c, const std::string& prefix)
+{
+  return c.prefix_range(prefix);
+}
+
+#define ART_COUT(m) do {                                     \
+  std::string m_name = #m;                                   \
+  std::cout << " " << m_name << " :";                        \
+  for (auto it = m.begin(); it != m.end(); ++it)             \
+    std::cout << " <" << it->first << "," << it->second << ">"; \
+  std::cout << std::endl;                                    \
+} while(0)
+
+void art_map_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[--------------- Run container test : art_map ------------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::art_map<std::string, int> m1{ {"romane", 1}, {"romanus", 2}, {"romulus", 3} };
+  m1.insert(mystl::make_pair(std::string("rubens"), 4));
+  m1.emplace("ruber", 5);
+  m1["rubicon"] = 6;
+  m1["rom"] = 7;
+  ART_COUT(m1);
+  FUN_VALUE(m1.size());
+  FUN_VALUE(m1.at("romanus"));
+  FUN_VALUE(m1.count("roman"));
+  FUN_VALUE(m1.lower_bound("roman")->first);
+  FUN_VALUE(m1.upper_bound("romulus")->first);
+  auto r = m1.prefix_range("rom");
+  std::cout << " m1.prefix_range(\"rom\") :";
+  for (auto it = r.first; it != r.second; ++it)
+    std::cout << " " << it->first;
+  std::cout << std::endl;
+  FUN_VALUE(m1.erase("rom"));
+  FUN_VALUE(m1.erase("rom"));
+  FUN_VALUE(m1.rbegin()->first);
+  ART_COUT(m1);
+  mystl::art_map<int, int> m2;
+  for (int i = -3; i <= 3; ++i)
+    m2[i * 1000] = i;
+  ART_COUT(m2);
+  FUN_VALUE(m2.lower_bound(-1500)->first);
+
+  // 与 std::map 对比随机插入删除后的顺序、查找和前缀范围
+  mystl::art_map<std::string, int> am;
+  std::map<std::string, int> sm;
+  srand(42);
+  bool same = true;
+  for (int i = 0; i < 20000 && same; ++i)
+  {
+    std::string key = "k";
+    for (int len = rand() % 6; len > 0; --len)
+      key.push_back("ab\xff"[rand() % 3]);
+    if (rand() % 3)
+    {
+      am.insert(mystl::make_pair(key, i));
+      sm.insert(std::make_pair(key, i));
+    }
+    else
+    {
+      same = am.erase(key) == sm.erase(key);
+    }
+    auto lb = am.lower_bound(key);
+    auto slb = sm.lower_bound(key);
+    same = same && (lb == am.end() ? slb == sm.end() : slb != sm.end() && lb->first == slb->first);
+    std::string prefix = key.substr(0, key.size() / 2);
+    auto pr = am.prefix_range(prefix);
+    size_t n = 0, expect = 0;
+    for (auto it = pr.first; it != pr.second; ++it)
+      ++n;
+    for (auto it = sm.lower_bound(prefix); it != sm.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+      ++expect;
+    same = same && n == expect;
+  }
+  auto it = am.begin();
+  for (auto& kv : sm)
+  {
+    same = same && it != am.end() && it->first == kv.first && it->second == kv.second;
+    if (!same)
+      break;
+    ++it;
+  }
+  std::cout << std::boolalpha;
+  FUN_VALUE((same && am.size() == sm.size()));
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|        find         |";
+  TEST_LEN(LEN1 _S, LEN2 _S, LEN3 _S, WIDE);
+  std::cout << "|         map         |";
+  ART_FIND_DO_TEST(ART_TEST_MAP, LEN1 _S);
+  ART_FIND_DO_TEST(ART_TEST_MAP, LEN2 _S);
+  ART_FIND_DO_TEST(ART_TEST_MAP, LEN3 _S);
+  std::cout << "\n|       art_map       |";
+  ART_FIND_DO_TEST(ART_TEST_ART, LEN1 _S);
+  ART_FIND_DO_TEST(ART_TEST_ART, LEN2 _S);
+  ART_FIND_DO_TEST(ART_TEST_ART, LEN3 _S);
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|  prefix x 10000     |";
+  TEST_LEN(LEN1 _S, LEN2 _S, LEN3 _S, WIDE);
+  std::cout << "|         map         |";
+  ART_PREFIX_DO_TEST(ART_TEST_MAP, LEN1 _S, art_test_map_prefix);
+  ART_PREFIX_DO_TEST(ART_TEST_MAP, LEN2 _S, art_test_map_prefix);
+  ART_PREFIX_DO_TEST(ART_TEST_MAP, LEN3 _S, art_test_map_prefix);
+  std::cout << "\n|       art_map       |";
+  ART_PREFIX_DO_TEST(ART_TEST_ART, LEN1 _S, art_test_art_prefix);
+  ART_PREFIX_DO_TEST(ART_TEST_ART, LEN2 _S, art_test_art_prefix);
+  ART_PREFIX_DO_TEST(ART_TEST_ART, LEN3 _S, art_test_art_prefix);
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[--------------- End container test : art_map ------------------]" << std::endl;
+}
+
+} // namespace art_map_test
+} // namespace test
+} // namespace mystl
+#endif // !TINYSTL_ART_MAP_TEST_H_
@@ -0,0 +1,265 @@
+#ifndef TINYSTL_BTREE_TEST_H_
+#define TINYSTL_BTREE_TEST_H_
+
+// btree test : 测试 btree_set, btree_multiset, btree_map, btree_multimap 的接口
+// 并与 set (rb_tree) 比较查找、顺序遍历的性能以及每个元素的内存开销
+
+#include <set>
+#include <algorithm>
+
+#include "../TinySTL/set.h"
+#include "../TinySTL/btree_set.h"
+#include "../TinySTL/btree_map.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace btree_test
+{
+
+// 插入 count 个随机数后, 进行 count 次随机查找
+#define BTREE_FIND_DO_TEST(con, count) do {                  \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  con c;                                                     \
+  char buf[10];                                              \
+  for (size_t i = 0; i < count; ++i)                         \
+    c.insert(rand());                                        \
+  size_t hit = 0;                                            \
+  start = clock();                                           \
+  for (size_t i = 0; i < count; ++i)                         \
+    hit += c.find(rand()) != c.end();                        \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n + (int)(hit & 0)); \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+// 插入 count 个随机数后, 顺序遍历 10 次
+#define BTREE_SCAN_DO_TEST(con, count) do {                  \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  con c;                                                     \
+  char buf[10];                                              \
+  for (size_t i = 0; i < count; ++i)                         \
+    c.insert(rand());                                        \
+  long long sum = 0;                                         \
+  start = clock();                                           \
+  for (int r = 0; r < 10; ++r)                               \
+    for (auto it = c.begin(); it != c.end(); ++it)           \
+      sum += *it;                                            \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n + (int)(sum & 0)); \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+// 每个元素平均占用的字节数, 不计 malloc 自身的开销
+#define BTREE_MEMORY_DO_TEST(con, count, bytes) do {         \
+  srand((int)time(0));                                       \
+  con c;                                                     \
+  char buf[10];                                              \
+  for (size_t i = 0; i < count; ++i)                         \
+    c.insert(static_cast<int>(i * 2654435761u));             \
+  double per = static_cast<double>(bytes) / c.size();        \
+  std::snprintf(buf, sizeof(buf), "%.1f", per);              \
+  std::string t = buf;                                       \
+  t += "B     |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define BTREE_COMPARE_TEST(DO_TEST, len1, len2, len3)        \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|   mystl::set        |";                    \
+  DO_TEST(mystl::set<int>, len1);                            \
+  DO_TEST(mystl::set<int>, len2);                            \
+  DO_TEST(mystl::set<int>, len3);                            \
+  std::cout << "\n|   mystl::btree_set  |";                  \
+  DO_TEST(mystl::btree_set<int>, len1);                      \
+  DO_TEST(mystl::btree_set<int>, len2);                      \
+  DO_TEST(mystl::btree_set<int>, len3);
+
+void btree_set_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[--------------- Run container test : btree_set ----------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int a[] = { 5,4,3,2,1 };
+  mystl::btree_set<int> s1;
+  mystl::btree_set<int, mystl::greater<int>> s2;
+  mystl::btree_set<int> s3(a, a + 5);
+  mystl::btree_set<int> s4(a, a + 5);
+  mystl::btree_set<int> s5(s3);
+  mystl::btree_set<int> s6(std::move(s3));
+  mystl::btree_set<int> s7;
+  s7 = s4;
+  mystl::btree_set<int> s8;
+  s8 = std::move(s4);
+  mystl::btree_set<int> s9{ 1,2,3,4,5 };
+  mystl::btree_set<int> s10;
+  s10 = { 1,2,3,4,5 };
+
+  for (int i = 5; i > 0; --i)
+  {
+    FUN_AFTER(s1, s1.emplace(i));
+  }
+  FUN_AFTER(s1, s1.emplace_hint(s1.begin(), 0));
+  FUN_AFTER(s1, s1.erase(s1.begin()));
+  FUN_AFTER(s1, s1.erase(0));
+  FUN_AFTER(s1, s1.erase(1));
+  FUN_AFTER(s1, s1.erase(s1.begin(), s1.end()));
+  for (int i = 0; i < 5; ++i)
+  {
+    FUN_AFTER(s1, s1.insert(i));
+  }
+  FUN_AFTER(s1, s1.insert(a, a + 5));
+  FUN_AFTER(s1, s1.insert(5));
+  FUN_AFTER(s1, s1.insert(s1.end(), 5));
+  FUN_VALUE(s1.count(5));
+  FUN_VALUE(*s1.find(3));
+  FUN_VALUE(*s1.lower_bound(3));
+  FUN_VALUE(*s1.upper_bound(3));
+  auto first = *s1.equal_range(3).first;
+  auto second = *s1.equal_range(3).second;
+  std::cout << " s1.equal_range(3) : from " << first << " to " << second << std::endl;
+  FUN_AFTER(s1, s1.erase(s1.begin()));
+  FUN_AFTER(s1, s1.erase(1));
+  FUN_AFTER(s1, s1.erase(s1.begin(), s1.find(3)));
+  FUN_AFTER(s1, s1.clear());
+  FUN_AFTER(s1, s1.swap(s5));
+  FUN_VALUE(*s1.begin());
+  FUN_VALUE(*s1.rbegin());
+  std::cout << std::boolalpha;
+  FUN_VALUE(s1.empty());
+  std::cout << std::noboolalpha;
+  FUN_VALUE(s1.size());
+  FUN_VALUE(s1.max_size());
+  // 被移动后的 s3, s4 仍是可用的空树
+  FUN_VALUE(s3.size());
+  FUN_AFTER(s3, s3.insert(7));
+  FUN_AFTER(s4, s4.clear());
+  FUN_AFTER(s4, s4.insert(a, a + 5));
+  FUN_AFTER(s4, s4 = std::move(s3));
+  FUN_AFTER(s3, s3.emplace(8));
+
+  // 与 std::set 对比大量随机插入删除后的结果
+  mystl::btree_set<int, mystl::less<int>, 64> bs;
+  std::set<int> ss;
+  srand(42);
+  for (int i = 0; i < 100000; ++i)
+  {
+    int k = rand() % 10000;
+    if (rand() % 3)
+    {
+      bs.insert(k);
+      ss.insert(k);
+    }
+    else
+    {
+      bs.erase(k);
+      ss.erase(k);
+    }
+  }
+  std::cout << std::boolalpha;
+  FUN_VALUE((bs.size() == ss.size() && std::equal(ss.begin(), ss.end(), bs.begin())));
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|        find         |";
+#if LARGER_TEST_DATA_ON
+  BTREE_COMPARE_TEST(BTREE_FIND_DO_TEST, LEN1 _M, LEN2 _M, LEN3 _M);
+#else
+  BTREE_COMPARE_TEST(BTREE_FIND_DO_TEST, LEN1 _S, LEN2 _S, LEN3 _S);
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|     ordered scan    |";
+#if LARGER_TEST_DATA_ON
+  BTREE_COMPARE_TEST(BTREE_SCAN_DO_TEST, LEN1 _M, LEN2 _M, LEN3 _M);
+#else
+  BTREE_COMPARE_TEST(BTREE_SCAN_DO_TEST, LEN1 _S, LEN2 _S, LEN3 _S);
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|   bytes / element   |";
+  TEST_LEN(LEN1 _S, LEN2 _S, LEN3 _S, WIDE);
+  std::cout << "|   mystl::set        |";
+  BTREE_MEMORY_DO_TEST(mystl::set<int>, LEN1 _S, c.size() * sizeof(mystl::rb_tree_node<int>));
+  BTREE_MEMORY_DO_TEST(mystl::set<int>, LEN2 _S, c.size() * sizeof(mystl::rb_tree_node<int>));
+  BTREE_MEMORY_DO_TEST(mystl::set<int>, LEN3 _S, c.size() * sizeof(mystl::rb_tree_node<int>));
+  std::cout << "\n|   mystl::btree_set  |";
+  BTREE_MEMORY_DO_TEST(mystl::btree_set<int>, LEN1 _S, c.bytes_used());
+  BTREE_MEMORY_DO_TEST(mystl::btree_set<int>, LEN2 _S, c.bytes_used());
+  BTREE_MEMORY_DO_TEST(mystl::btree_set<int>, LEN3 _S, c.bytes_used());
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[--------------- End container test : btree_set ----------------]" << std::endl;
+}
+
+void btree_multiset_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------------ Run container test : btree_multiset --------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int a[] = { 5,4,3,2,1 };
+  mystl::btree_multiset<int> s1;
+  mystl::btree_multiset<int> s5(a, a + 5);
+  for (int i = 5; i > 0; --i)
+  {
+    FUN_AFTER(s1, s1.emplace(i));
+  }
+  FUN_AFTER(s1, s1.insert(a, a + 5));
+  FUN_AFTER(s1, s1.insert(s1.end(), 5));
+  FUN_VALUE(s1.count(5));
+  FUN_VALUE(*s1.lower_bound(3));
+  FUN_VALUE(*s1.upper_bound(3));
+  FUN_AFTER(s1, s1.erase(3));
+  FUN_AFTER(s1, s1.erase(s1.begin(), s1.find(5)));
+  FUN_AFTER(s1, s1.swap(s5));
+  FUN_VALUE(s1.size());
+  PASSED;
+  std::cout << "[------------ End container test : btree_multiset --------------]" << std::endl;
+}
+
+void btree_map_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[--------------- Run container test : btree_map ----------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::btree_map<int, int> m1;
+  for (int i = 5; i > 0; --i)
+    m1.emplace(i, i * 10);
+  m1[7] = 70;
+  FUN_VALUE(m1.size());
+  FUN_VALUE(m1[3]);
+  FUN_VALUE(m1.at(7));
+  FUN_VALUE(m1.lower_bound(6)->first);
+  FUN_VALUE(m1.upper_bound(3)->first);
+  FUN_VALUE(m1.erase(3));
+  FUN_VALUE(m1.count(3));
+  mystl::btree_multimap<int, int> m2;
+  for (int i = 0; i < 10; ++i)
+    m2.insert(mystl::make_pair(i % 3, i));
+  FUN_VALUE(m2.count(1));
+  FUN_VALUE(m2.erase(1));
+  FUN_VALUE(m2.size());
+  PASSED;
+  std::cout << "[--------------- End container test : btree_map ----------------]" << std::endl;
+}
+
+} // namespace btree_test
+} // namespace test
+} // namespace mystl
+#endif // !TINYSTL_BTREE_TEST_H_
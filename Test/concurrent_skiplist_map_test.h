@@ -0,0 +1,199 @@
+#ifndef TINYSTL_CONCURRENT_SKIPLIST_MAP_TEST_H_
+#define TINYSTL_CONCURRENT_SKIPLIST_MAP_TEST_H_
+
+// concurrent skiplist map test : 测试 concurrent_skiplist_map 的接口和并发正确性
+// 并与 std::mutex 保护的 map 比较 1 到 64 个线程下混合操作的吞吐量
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+#include "../TinySTL/map.h"
+#include "../TinySTL/concurrent_skiplist_map.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace concurrent_skiplist_map_test
+{
+
+typedef mystl::map<int, int, mystl::less<int>>        SKIPLIST_TEST_MAP;
+typedef mystl::concurrent_skiplist_map<int, int>      SKIPLIST_TEST_SKIPLIST;
+
+// threads 个线程共执行 total 次操作: 50% 插入, 40% 查找, 10% 从 lower_bound 起扫描 10 个元素
+// lock 为每次操作前的加锁语句, 多线程下用墙上时间计时
+#define SKIPLIST_SCALE_DO_TEST(con, threads, total, lock) do { \
+  con c;                                                     \
+  std::mutex m;                                              \
+  char buf[10];                                              \
+  std::atomic<long> found(0);                                \
+  std::vector<std::thread> workers;                          \
+  auto start = std::chrono::steady_clock::now();             \
+  for (int t = 0; t < threads; ++t)                          \
+  {                                                          \
+    workers.push_back(std::thread([&, t] {                   \
+      unsigned r = 2654435761u * (t + 1);                    \
+      long hit = 0;                                          \
+      for (size_t i = 0; i < (size_t)(total) / (size_t)(threads); ++i) \
+      {                                                      \
+        r = r * 1103515245u + 12345u;                        \
+        int key = (int)(r >> 8) % (int)(total);              \
+        unsigned op = (r >> 4) % 10;                         \
+        lock;                                                \
+        if (op < 5)                                          \
+          c.insert(mystl::make_pair(key, key));              \
+        else if (op < 9)                                     \
+          hit += c.find(key) != c.end();                     \
+        else                                                 \
+        {                                                    \
+          auto it = c.lower_bound(key);                      \
+          for (int k = 0; k < 10 && it != c.end(); ++k, ++it) \
+            hit += it->second & 1;                           \
+        }                                                    \
+      }                                                      \
+      found += hit;                                          \
+    }));                                                     \
+  }                                                          \
+  for (auto& w : workers)                                    \
+    w.join();                                                \
+  auto end = std::chrono::steady_clock::now();               \
+  int n = (int)std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count(); \
+  std::snprintf(buf, sizeof(buf), "%d", n + (int)(found & 0)); \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define SKIPLIST_SCALE_ROW(con, total, lock) do {            \
+  for (int threads = 1; threads <= 64; threads *= 2)         \
+    SKIPLIST_SCALE_DO_TEST(con, threads, total, lock);       \
+} while(0)
+
+#define SKIPLIST_COUT(m) do {                                \
+  std::string m_name = #m;                                   \
+  std::cout << " " << m_name << " :";                        \
+  for (auto it = m.begin(); it != m.end(); ++it)             \
+    std::cout << " <" << it->first << "," << it->second << ">"; \
+  std::cout << std::endl;                                    \
+} while(0)
+
+void concurrent_skiplist_map_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[-------- Run container test : concurrent_skiplist_map ---------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::concurrent_skiplist_map<int, int> m1{ {3, 3}, {1, 1}, {2, 2} };
+  m1.emplace(5, 5);
+  m1.insert(mystl::make_pair(4, 4));
+  m1[6] = 6;
+  SKIPLIST_COUT(m1);
+  FUN_VALUE(m1.size());
+  FUN_VALUE(m1.insert(mystl::make_pair(3, 30)).second);
+  FUN_VALUE(m1.find(3)->second);
+  FUN_VALUE(m1.count(7));
+  FUN_VALUE(m1.lower_bound(4)->first);
+  FUN_VALUE(m1.upper_bound(4)->first);
+  FUN_VALUE(m1.erase(2));
+  FUN_VALUE(m1.erase(2));
+  SKIPLIST_COUT(m1);
+  m1.clear();
+  FUN_VALUE(m1.empty());
+
+  // 每个线程插入自己的一组键值再删掉其中一半, 同时有线程不停地遍历
+  const int kThreads = 8, kPerThread = 10000;
+  mystl::concurrent_skiplist_map<int, int> m2;
+  std::atomic<bool> stop(false);
+  std::atomic<int> errors(0);
+  std::vector<std::thread> writers;
+  for (int t = 0; t < kThreads; ++t)
+  {
+    writers.push_back(std::thread([&, t] {
+      for (int i = 0; i < kPerThread; ++i)
+        m2.insert(mystl::make_pair(i * kThreads + t, t));
+      for (int i = 1; i < kPerThread; i += 2)
+      {
+        if (m2.erase(i * kThreads + t) != 1)
+          ++errors;
+      }
+    }));
+  }
+  std::thread reader([&] {
+    while (!stop.load())
+    {
+      int prev = -1;
+      for (auto it = m2.begin(); it != m2.end(); ++it)
+      {
+        if (it->first <= prev)
+          ++errors;
+        prev = it->first;
+      }
+    }
+  });
+  for (auto& w : writers)
+    w.join();
+  stop = true;
+  reader.join();
+  for (int k = 0; k < kThreads * kPerThread; ++k)
+  {
+    if (m2.contains(k) != (k / kThreads % 2 == 0))
+      ++errors;
+  }
+
+  // 所有线程在少量键值上反复插入删除, 同键值的节点会被频繁删除后重新插入
+  mystl::concurrent_skiplist_map<int, int> m3;
+  std::vector<std::thread> churners;
+  for (int t = 0; t < kThreads; ++t)
+  {
+    churners.push_back(std::thread([&, t] {
+      for (int i = 0; i < kPerThread * 4; ++i)
+      {
+        int k = (i * 7 + t) % 16;
+        if (i % 2 == 0)
+          m3.insert(mystl::make_pair(k, t));
+        else
+          m3.erase(k);
+        int prev = -1;
+        for (auto it = m3.lower_bound(k); it != m3.end(); ++it)
+        {
+          if (it->first <= prev)
+            ++errors;
+          prev = it->first;
+        }
+      }
+    }));
+  }
+  for (auto& c : churners)
+    c.join();
+  int live = 0;
+  for (auto it = m3.begin(); it != m3.end(); ++it)
+    ++live;
+  std::cout << std::boolalpha;
+  FUN_VALUE((errors == 0 && m2.size() == kThreads * kPerThread / 2 && m3.size() == (size_t)live));
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|"
+            << "-------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|       threads       |      1      |      2      |      4      |"
+            << "      8      |     16      |     32      |     64      |" << std::endl;
+  std::cout << "|   map + mutex       |";
+  SKIPLIST_SCALE_ROW(SKIPLIST_TEST_MAP, LEN2, std::lock_guard<std::mutex> guard(m));
+  std::cout << "\n| skiplist (lockfree) |";
+  SKIPLIST_SCALE_ROW(SKIPLIST_TEST_SKIPLIST, LEN2, (void)m);
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|"
+            << "-------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[-------- End container test : concurrent_skiplist_map ---------]" << std::endl;
+}
+
+} // namespace concurrent_skiplist_map_test
+} // namespace test
+} // namespace mystl
+#endif // !TINYSTL_CONCURRENT_SKIPLIST_MAP_TEST_H_
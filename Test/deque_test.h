@@ -4,8 +4,12 @@
 // deque test : 测试 deque 的接口和 push_front/push_back 的性能
 
 #include <deque>
+#include <vector>
+#include <algorithm>
+#include <numeric>
 
 #include "../TinySTL/deque.h"
+#include "../TinySTL/algo.h"
 #include "test.h"
 
 namespace mystl
@@ -15,6 +19,77 @@ namespace test
 namespace deque_test
 {
 
+// 在分区边界上交替 push_back 和 pop_back 共 total 次, 没有分区缓存时每次都要分配或释放一个分区
+#define DEQUE_BOUNDARY_DO_TEST(con, total) do {              \
+  con d;                                                     \
+  while (d.size() < 4096)                                    \
+    d.push_back(1);                                          \
+  d.pop_back();                                              \
+  long long sum = 0;                                         \
+  char buf[10];                                              \
+  clock_t start = clock();                                   \
+  for (size_t i = 0; i < total; ++i)                         \
+  {                                                          \
+    d.push_back((int)i);                                     \
+    d.push_back((int)i);                                     \
+    sum += d.back();                                         \
+    d.pop_back();                                            \
+    d.pop_back();                                            \
+  }                                                          \
+  clock_t end = clock();                                     \
+  volatile long long sink = sum;                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n + (int)(sink & 0)); \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+// 把 total 个元素的 deque 拷贝到 vector 中, 重复 10 次
+#define DEQUE_COPY_DO_TEST(mode, con, total) do {            \
+  mode::con d;                                               \
+  for (size_t i = 0; i < total; ++i)                         \
+    d.push_back((int)i);                                     \
+  std::vector<int> v(total);                                 \
+  long long sum = 0;                                         \
+  char buf[10];                                              \
+  clock_t start = clock();                                   \
+  for (int r = 0; r < 10; ++r)                               \
+  {                                                          \
+    mode::copy(d.begin(), d.end(), v.data());                \
+    sum += v[r];                                             \
+  }                                                          \
+  clock_t end = clock();                                     \
+  volatile long long sink = sum;                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n + (int)(sink & 0)); \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+// 在 total 个元素的 deque 中查找不存在的值, 重复 10 次
+#define DEQUE_FIND_DO_TEST(mode, con, total) do {            \
+  mode::con d;                                               \
+  for (size_t i = 0; i < total; ++i)                         \
+    d.push_back((int)i);                                     \
+  long long sum = 0;                                         \
+  char buf[10];                                              \
+  clock_t start = clock();                                   \
+  for (int r = 0; r < 10; ++r)                               \
+    sum += mode::find(d.begin(), d.end(), -r) - d.begin();   \
+  clock_t end = clock();                                     \
+  volatile long long sink = sum;                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n + (int)(sink & 0)); \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
 void deque_test()
 {
 #define debug(x) std::cout << (x) << std::endl;
@@ -55,6 +130,7 @@ void deque_test()
   FUN_AFTER(d1, d1.resize(5));
   FUN_AFTER(d1, d1.resize(8, 8));
   FUN_AFTER(d1, d1.clear());
+  FUN_AFTER(d1, d1.shrink_to_fit());
   FUN_AFTER(d1, d1.swap(d4));
   FUN_VALUE(*(d1.begin()));
   FUN_VALUE(*(d1.end() - 1));
@@ -69,6 +145,56 @@ void deque_test()
   std::cout << std::noboolalpha;
   FUN_VALUE(d1.size());
   FUN_VALUE(d1.max_size());
+  mystl::deque<int, 4> d11{ 1,2,3,4,5,6,7,8,9 };
+  FUN_AFTER(d11, d11.pop_front());
+  FUN_AFTER(d11, d11.push_back(10));
+  FUN_VALUE(d11.buffer_size);
+
+  // 逐分区处理的算法: 跨越多个分区的区间与 std::deque 对比
+  mystl::deque<int, 4> d12;
+  std::deque<int> sd;
+  for (int i = 0; i < 37; ++i)
+  {
+    d12.push_front(i);
+    sd.push_front(i);
+  }
+  std::vector<int> v1(30);
+  mystl::copy(d12.begin() + 3, d12.begin() + 33, v1.data());
+  mystl::fill(d12.begin() + 5, d12.begin() + 9, 0);
+  std::fill(sd.begin() + 5, sd.begin() + 9, 0);
+  mystl::fill_n(v1.data(), 2, -1);
+  mystl::copy(v1.data(), v1.data() + 10, d12.begin() + 20);
+  std::copy(v1.begin(), v1.begin() + 10, sd.begin() + 20);
+  int sum = 0;
+  mystl::for_each(d12.begin() + 1, d12.end() - 1, [&](int x) { sum += x; });
+  std::cout << std::boolalpha;
+  FUN_VALUE((mystl::equal(d12.begin(), d12.end(), sd.begin())));
+  FUN_VALUE((mystl::find(d12.begin(), d12.end(), 7) - d12.begin()));
+  FUN_VALUE((sum == std::accumulate(sd.begin() + 1, sd.end() - 1, 0)));
+
+  // 在前半部分插入多个元素: 插入点之前的元素个数分别不少于和少于插入个数, 与 std::deque 对比
+  bool same = true;
+  for (int before = 0; before < 20; ++before)
+  {
+    for (int n = 1; n < 12; ++n)
+    {
+      mystl::deque<int, 4> d13;
+      std::deque<int> sd13;
+      for (int i = 0; i < 45; ++i)
+      {
+        d13.push_back(i);
+        sd13.push_back(i);
+      }
+      d13.insert(d13.begin() + before, n, -1);
+      sd13.insert(sd13.begin() + before, n, -1);
+      d13.insert(d13.begin() + before / 2, v1.data(), v1.data() + n);
+      sd13.insert(sd13.begin() + before / 2, v1.begin(), v1.begin() + n);
+      same = same && d13.size() == sd13.size() &&
+             mystl::equal(d13.begin(), d13.end(), sd13.begin());
+    }
+  }
+  FUN_VALUE(same);
+  std::cout << std::noboolalpha;
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
@@ -87,6 +213,42 @@ void deque_test()
 #else
   CON_TEST_P1(deque<int>, push_back, rand(), LEN1 _L, LEN2 _L, LEN3 _L);
 #endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "| boundary push + pop |";
+  TEST_LEN(LEN1 _L, LEN2 _L, LEN3 _L, WIDE);
+  std::cout << "|         std         |";
+  DEQUE_BOUNDARY_DO_TEST(std::deque<int>, LEN1 _L);
+  DEQUE_BOUNDARY_DO_TEST(std::deque<int>, LEN2 _L);
+  DEQUE_BOUNDARY_DO_TEST(std::deque<int>, LEN3 _L);
+  std::cout << "\n|        mystl        |";
+  DEQUE_BOUNDARY_DO_TEST(mystl::deque<int>, LEN1 _L);
+  DEQUE_BOUNDARY_DO_TEST(mystl::deque<int>, LEN2 _L);
+  DEQUE_BOUNDARY_DO_TEST(mystl::deque<int>, LEN3 _L);
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "| copy to vector x 10 |";
+  TEST_LEN(LEN1 _L, LEN2 _L, LEN3 _L, WIDE);
+  std::cout << "|         std         |";
+  DEQUE_COPY_DO_TEST(std, deque<int>, LEN1 _L);
+  DEQUE_COPY_DO_TEST(std, deque<int>, LEN2 _L);
+  DEQUE_COPY_DO_TEST(std, deque<int>, LEN3 _L);
+  std::cout << "\n|        mystl        |";
+  DEQUE_COPY_DO_TEST(mystl, deque<int>, LEN1 _L);
+  DEQUE_COPY_DO_TEST(mystl, deque<int>, LEN2 _L);
+  DEQUE_COPY_DO_TEST(mystl, deque<int>, LEN3 _L);
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|      find x 10      |";
+  TEST_LEN(LEN1 _L, LEN2 _L, LEN3 _L, WIDE);
+  std::cout << "|         std         |";
+  DEQUE_FIND_DO_TEST(std, deque<int>, LEN1 _L);
+  DEQUE_FIND_DO_TEST(std, deque<int>, LEN2 _L);
+  DEQUE_FIND_DO_TEST(std, deque<int>, LEN3 _L);
+  std::cout << "\n|        mystl        |";
+  DEQUE_FIND_DO_TEST(mystl, deque<int>, LEN1 _L);
+  DEQUE_FIND_DO_TEST(mystl, deque<int>, LEN2 _L);
+  DEQUE_FIND_DO_TEST(mystl, deque<int>, LEN3 _L);
   std::cout << std::endl;
   std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
   PASSED;
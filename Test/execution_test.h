@@ -0,0 +1,215 @@
+#ifndef TINYSTL_EXECUTION_TEST_H_
+#define TINYSTL_EXECUTION_TEST_H_
+
+// execution test : 测试带执行策略的算法与顺序版本结果一致, 以及 seq 与 par 的耗时对比
+// 并在均匀分布、已排序、逆序、少量不同值四种输入上比较 mystl::sort 与并行样本排序
+
+#include <chrono>
+
+#include "../TinySTL/execution.h"
+#include "../TinySTL/algo.h"
+#include "../TinySTL/list.h"
+#include "../TinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace execution_test
+{
+
+inline int execution_test_square(int x)
+{
+  return (int)((long long)x * x % 1000003);
+}
+
+inline bool execution_test_same(const mystl::vector<int>& a, const mystl::vector<int>& b)
+{
+  return a.size() == b.size() && mystl::equal(a.begin(), a.end(), b.begin());
+}
+
+// 生成排序测试的输入: 0 均匀分布, 1 已排序, 2 逆序, 3 只有 16 种不同的值
+inline void execution_test_fill(mystl::vector<int>& v, int dist)
+{
+  const size_t len = v.size();
+  for (size_t i = 0; i < len; ++i)
+  {
+    switch (dist)
+    {
+    case 0:  v[i] = rand(); break;
+    case 1:  v[i] = (int)i; break;
+    case 2:  v[i] = (int)(len - i); break;
+    default: v[i] = rand() % 16; break;
+    }
+  }
+}
+
+#define EXECUTION_SORT_DO_TEST(policy, dist, len) do {       \
+  mystl::vector<int> v(len);                                 \
+  execution_test_fill(v, dist);                              \
+  char buf[10];                                              \
+  auto t0 = std::chrono::steady_clock::now();                \
+  mystl::sort(policy, v.begin(), v.end());                   \
+  auto t1 = std::chrono::steady_clock::now();                \
+  volatile bool sink = mystl::is_sorted(v.begin(), v.end()); \
+  int n = static_cast<int>(std::chrono::duration<double, std::milli>(t1 - t0).count()); \
+  std::snprintf(buf, sizeof(buf), "%d", n + (int)(sink & 0)); \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define EXECUTION_SORT_ROW(name, policy, dist)               \
+  std::cout << name;                                         \
+  EXECUTION_SORT_DO_TEST(policy, dist, LEN1);                \
+  EXECUTION_SORT_DO_TEST(policy, dist, LEN2);                \
+  EXECUTION_SORT_DO_TEST(policy, dist, LEN3);                \
+  std::cout << std::endl
+
+// 与 executor 的测试一样用 steady_clock 计时
+#define EXECUTION_DO_TEST(policy, len, stmt) do {            \
+  mystl::vector<int> v(len), out(len);                       \
+  for (size_t i = 0; i < len; ++i)                           \
+    v[i] = rand();                                           \
+  auto&& pol = policy;                                       \
+  (void)pol;                                                 \
+  char buf[10];                                              \
+  auto t0 = std::chrono::steady_clock::now();                \
+  stmt;                                                      \
+  auto t1 = std::chrono::steady_clock::now();                \
+  volatile int sink = out[0];                                \
+  int n = static_cast<int>(std::chrono::duration<double, std::milli>(t1 - t0).count()); \
+  std::snprintf(buf, sizeof(buf), "%d", n + (sink & 0));     \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define EXECUTION_TEST_ROW(name, policy, stmt)               \
+  std::cout << name;                                         \
+  EXECUTION_DO_TEST(policy, LEN1 _L, stmt);                  \
+  EXECUTION_DO_TEST(policy, LEN2 _L, stmt);                  \
+  EXECUTION_DO_TEST(policy, LEN3 _L, stmt);                  \
+  std::cout << std::endl
+
+void execution_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------------ Run algorithm test : execution policy ------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  // 单核机器上缺省 executor 只有一个线程, 这里固定用 4 个线程, 保证走到并行分支
+  mystl::work_stealing_executor ex(4);
+  auto par = mystl::execution::par.on(ex);
+  auto par_unseq = mystl::execution::par_unseq.on(ex);
+  const size_t n = 1 << 20;
+  mystl::vector<int> v(n), a(n), b(n);
+  srand(7);
+  for (auto& x : v)
+    x = rand() % 100000;
+  auto odd = [](int x) { return x % 2 == 1; };
+  bool same = true;
+
+  mystl::transform(v.begin(), v.end(), a.begin(), execution_test_square);
+  mystl::transform(par, v.begin(), v.end(), b.begin(), execution_test_square);
+  same = same && execution_test_same(a, b);
+  mystl::transform(v.begin(), v.end(), a.begin(), a.begin(), mystl::plus<int>());
+  mystl::transform(par_unseq, v.begin(), v.end(), b.begin(), b.begin(), mystl::plus<int>());
+  same = same && execution_test_same(a, b);
+  same = same && mystl::count_if(par, v.begin(), v.end(), odd) == mystl::count_if(v.begin(), v.end(), odd);
+  same = same && mystl::find_if(par, v.begin(), v.end(), [](int x) { return x > 99990; })
+    == mystl::find_if(v.begin(), v.end(), [](int x) { return x > 99990; });
+  same = same && mystl::find_if(par, v.begin(), v.end(), [](int x) { return x < 0; }) == v.end();
+  same = same && mystl::max_element(par, v.begin(), v.end()) == mystl::max_element(v.begin(), v.end());
+  same = same && mystl::min_element(par, v.begin(), v.end()) == mystl::min_element(v.begin(), v.end());
+  auto ea = mystl::remove_copy_if(v.begin(), v.end(), a.begin(), odd);
+  auto eb = mystl::remove_copy_if(par, v.begin(), v.end(), b.begin(), odd);
+  same = same && ea - a.begin() == eb - b.begin() && mystl::equal(a.begin(), ea, b.begin());
+  a = v;
+  b = v;
+  mystl::replace_if(a.begin(), a.end(), odd, -1);
+  mystl::replace_if(par, b.begin(), b.end(), odd, -1);
+  same = same && execution_test_same(a, b);
+  mystl::for_each(par, b.begin(), b.end(), [](int& x) { x += 1; });
+  mystl::for_each(a.begin(), a.end(), [](int& x) { x += 1; });
+  same = same && execution_test_same(a, b);
+  std::atomic<int> counter(0);
+  mystl::generate(par, b.begin(), b.end(), [&] { return counter++; });
+  mystl::sort(b.begin(), b.end());
+  same = same && b.front() == 0 && b.back() == (int)n - 1;
+
+  a = v;
+  b = v;
+  mystl::sort(a.begin(), a.begin() + n / 2);
+  mystl::sort(a.begin() + n / 2, a.end());
+  mystl::merge(a.begin(), a.begin() + n / 2, a.begin() + n / 2, a.end(), b.begin());
+  mystl::vector<int> c(n);
+  mystl::merge(par, a.begin(), a.begin() + n / 2, a.begin() + n / 2, a.end(), c.begin());
+  same = same && execution_test_same(b, c);
+  mystl::sort(par, v.begin(), v.end(), mystl::greater<int>());
+  same = same && mystl::is_sorted(v.begin(), v.end(), mystl::greater<int>());
+
+  // 样本排序: 各种分布以及需要多于一轮分桶的长度, 与 mystl::sort 的结果比较
+  for (int dist = 0; dist < 4; ++dist)
+  {
+    for (size_t len : { (size_t)40000, (size_t)300000, (size_t)2000000 })
+    {
+      mystl::vector<int> x(len);
+      execution_test_fill(x, dist);
+      mystl::vector<int> y(x);
+      mystl::sort(x.begin(), x.end());
+      mystl::sort(par, y.begin(), y.end());
+      same = same && execution_test_same(x, y);
+    }
+  }
+
+  // 非随机访问迭代器与短区间走顺序版本
+  mystl::list<int> l{ 5,3,8,1 };
+  same = same && mystl::count_if(par, l.begin(), l.end(), odd) == 3;
+  same = same && *mystl::max_element(par, l.begin(), l.end()) == 8;
+  int small[] = { 4,2,9,1 };
+  mystl::sort(mystl::execution::seq, small, small + 4);
+  same = same && small[0] == 1 && small[3] == 9;
+  std::cout << std::boolalpha;
+  FUN_VALUE(same);
+  FUN_VALUE(mystl::is_execution_policy<decltype(par)>::value);
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|      algorithm      |";
+  TEST_LEN(LEN1 _L, LEN2 _L, LEN3 _L, WIDE);
+  EXECUTION_TEST_ROW("|  transform (seq)    |", mystl::execution::seq,
+    mystl::transform(pol, v.begin(), v.end(), out.begin(), execution_test_square));
+  EXECUTION_TEST_ROW("|  transform (par)    |", mystl::execution::par,
+    mystl::transform(pol, v.begin(), v.end(), out.begin(), execution_test_square));
+  EXECUTION_TEST_ROW("|  count_if (seq)     |", mystl::execution::seq,
+    out[0] = (int)mystl::count_if(pol, v.begin(), v.end(), odd));
+  EXECUTION_TEST_ROW("|  count_if (par)     |", mystl::execution::par,
+    out[0] = (int)mystl::count_if(pol, v.begin(), v.end(), odd));
+  EXECUTION_TEST_ROW("|  sort (seq)         |", mystl::execution::seq,
+    mystl::sort(pol, v.begin(), v.end()));
+  EXECUTION_TEST_ROW("|  sort (par)         |", mystl::execution::par,
+    mystl::sort(pol, v.begin(), v.end()));
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|        sort         |";
+  TEST_LEN(LEN1, LEN2, LEN3, WIDE);
+  EXECUTION_SORT_ROW("| uniform    (seq)    |", mystl::execution::seq, 0);
+  EXECUTION_SORT_ROW("| uniform    (par)    |", mystl::execution::par, 0);
+  EXECUTION_SORT_ROW("| sorted     (seq)    |", mystl::execution::seq, 1);
+  EXECUTION_SORT_ROW("| sorted     (par)    |", mystl::execution::par, 1);
+  EXECUTION_SORT_ROW("| reverse    (seq)    |", mystl::execution::seq, 2);
+  EXECUTION_SORT_ROW("| reverse    (par)    |", mystl::execution::par, 2);
+  EXECUTION_SORT_ROW("| few unique (seq)    |", mystl::execution::seq, 3);
+  EXECUTION_SORT_ROW("| few unique (par)    |", mystl::execution::par, 3);
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[------------ End algorithm test : execution policy ------------]" << std::endl;
+}
+
+} // namespace execution_test
+} // namespace test
+} // namespace mystl
+#endif // !TINYSTL_EXECUTION_TEST_H_
@@ -0,0 +1,215 @@
+#ifndef TINYSTL_EXECUTOR_TEST_H_
+#define TINYSTL_EXECUTOR_TEST_H_
+
+// executor test : 测试 work_stealing_executor, task_group, parallel_invoke 的接口
+// 并测试递归 fork-join 的并行求和与并行快速排序在 1 到 64 个工作线程下的耗时
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include "../TinySTL/executor.h"
+#include "../TinySTL/algo.h"
+#include "../TinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace executor_test
+{
+
+// 小于这个长度的区间不再拆分
+const size_t kExecutorGrain = 4096;
+
+inline long long executor_test_sum(mystl::work_stealing_executor& ex, const int* first, const int* last)
+{
+  if ((size_t)(last - first) <= kExecutorGrain)
+  {
+    long long s = 0;
+    for (; first != last; ++first)
+      s += *first;
+    return s;
+  }
+  const int* mid = first + (last - first) / 2;
+  long long left = 0, right = 0;
+  mystl::parallel_invoke(ex,
+                         [&] { left = executor_test_sum(ex, first, mid); },
+                         [&] { right = executor_test_sum(ex, mid, last); });
+  return left + right;
+}
+
+inline void executor_test_quick_sort(mystl::work_stealing_executor& ex, int* first, int* last)
+{
+  if ((size_t)(last - first) <= kExecutorGrain)
+  {
+    mystl::sort(first, last);
+    return;
+  }
+  const int pivot = mystl::median(*first, *(first + (last - first) / 2), *(last - 1));
+  int* cut = mystl::unchecked_partition(first, last, pivot);
+  mystl::parallel_invoke(ex,
+                         [&] { executor_test_quick_sort(ex, first, cut); },
+                         [&] { executor_test_quick_sort(ex, cut, last); });
+}
+
+// threads 为 0 时表示不使用 executor 的顺序版本
+// clock() 统计的是所有线程的 CPU 时间, 这里改用 steady_clock 计时
+#define EXECUTOR_SUM_DO_TEST(threads, len) do {              \
+  mystl::vector<int> v(len);                                 \
+  for (size_t i = 0; i < len; ++i)                           \
+    v[i] = rand();                                           \
+  mystl::work_stealing_executor ex(threads == 0 ? 1 : threads); \
+  long long sum = 0;                                         \
+  char buf[10];                                              \
+  auto t0 = std::chrono::steady_clock::now();                \
+  for (int rep = 0; rep < 10; ++rep)                         \
+  {                                                          \
+    if (threads == 0)                                        \
+    {                                                        \
+      for (size_t i = 0; i < len; ++i)                       \
+        sum += v[i];                                         \
+    }                                                        \
+    else                                                     \
+    {                                                        \
+      sum += executor_test_sum(ex, v.begin(), v.begin() + len); \
+    }                                                        \
+  }                                                          \
+  auto t1 = std::chrono::steady_clock::now();                \
+  volatile long long sink = sum;                             \
+  int n = static_cast<int>(std::chrono::duration<double, std::milli>(t1 - t0).count()); \
+  std::snprintf(buf, sizeof(buf), "%d", n + (int)(sink & 0)); \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define EXECUTOR_SORT_DO_TEST(threads, len) do {             \
+  mystl::vector<int> v(len);                                 \
+  for (size_t i = 0; i < len; ++i)                           \
+    v[i] = rand();                                           \
+  mystl::work_stealing_executor ex(threads == 0 ? 1 : threads); \
+  char buf[10];                                              \
+  auto t0 = std::chrono::steady_clock::now();                \
+  if (threads == 0)                                          \
+    mystl::sort(v.begin(), v.end());                         \
+  else                                                       \
+    executor_test_quick_sort(ex, v.begin(), v.begin() + len); \
+  auto t1 = std::chrono::steady_clock::now();                \
+  volatile bool sink = mystl::is_sorted(v.begin(), v.end()); \
+  int n = static_cast<int>(std::chrono::duration<double, std::milli>(t1 - t0).count()); \
+  std::snprintf(buf, sizeof(buf), "%d", n + (int)(sink & 0)); \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define EXECUTOR_SCALING_TEST(DO_TEST, len1, len2, len3) do { \
+  const size_t threads[] = { 1,2,4,8,16,32,64 };             \
+  std::cout << "|     sequential      |";                    \
+  DO_TEST(0, len1);                                          \
+  DO_TEST(0, len2);                                          \
+  DO_TEST(0, len3);                                          \
+  for (auto th : threads)                                    \
+  {                                                          \
+    char name[24];                                           \
+    std::snprintf(name, sizeof(name), "| %3d threads         |", (int)th); \
+    std::cout << "\n" << name;                               \
+    DO_TEST(th, len1);                                       \
+    DO_TEST(th, len2);                                       \
+    DO_TEST(th, len3);                                       \
+  }                                                          \
+  std::cout << std::endl;                                    \
+} while(0)
+
+void executor_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[---------------- Run container test : executor ----------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::work_stealing_executor ex(4);
+  FUN_VALUE(ex.concurrency());
+  FUN_VALUE(ex.in_worker());
+
+  int a = 0, b = 0, c = 0;
+  mystl::parallel_invoke(ex, [&] { a = 1; }, [&] { b = 2; }, [&] { c = 3; });
+  FUN_VALUE(a + b + c);
+
+  std::atomic<int> hits(0);
+  {
+    mystl::task_group g(ex);
+    for (int i = 0; i < 100; ++i)
+    {
+      g.run([&] {
+        // 任务中再嵌套一个 task_group
+        mystl::task_group inner(ex);
+        for (int k = 0; k < 10; ++k)
+          inner.run([&] { ++hits; });
+        inner.wait();
+      });
+    }
+    g.wait();
+  }
+  FUN_VALUE(hits.load());
+
+  std::string what;
+  mystl::task_group g2(ex);
+  g2.run([] { throw std::runtime_error("task failed"); });
+  g2.run([&] { ++hits; });
+  try
+  {
+    g2.wait();
+  }
+  catch (const std::runtime_error& e)
+  {
+    what = e.what();
+  }
+  FUN_VALUE(what);
+  try
+  {
+    mystl::parallel_invoke(ex, [] {}, [] { throw std::logic_error("invoke failed"); });
+  }
+  catch (const std::logic_error& e)
+  {
+    what = e.what();
+  }
+  FUN_VALUE(what);
+
+  // 与顺序版本对比结果
+  mystl::vector<int> v(1 << 20);
+  long long expect = 0;
+  for (auto& x : v)
+  {
+    x = rand();
+    expect += x;
+  }
+  std::cout << std::boolalpha;
+  FUN_VALUE((executor_test_sum(ex, v.begin(), v.end()) == expect));
+  FUN_VALUE((executor_test_sum(mystl::work_stealing_executor::default_executor(),
+                               v.begin(), v.end()) == expect));
+  executor_test_quick_sort(ex, v.begin(), v.end());
+  FUN_VALUE(mystl::is_sorted(v.begin(), v.end()));
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|  parallel sum x10   |";
+  TEST_LEN(LEN1, LEN2, LEN3, WIDE);
+  EXECUTOR_SCALING_TEST(EXECUTOR_SUM_DO_TEST, LEN1, LEN2, LEN3);
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "| parallel quicksort  |";
+  TEST_LEN(LEN1, LEN2, LEN3, WIDE);
+  EXECUTOR_SCALING_TEST(EXECUTOR_SORT_DO_TEST, LEN1, LEN2, LEN3);
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[---------------- End container test : executor ----------------]" << std::endl;
+}
+
+} // namespace executor_test
+} // namespace test
+} // namespace mystl
+#endif // !TINYSTL_EXECUTOR_TEST_H_
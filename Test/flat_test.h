@@ -0,0 +1,306 @@
+#ifndef TINYSTL_FLAT_TEST_H_
+#define TINYSTL_FLAT_TEST_H_
+
+// flat test : 测试 flat_set, flat_map, flat_multimap 的接口
+// 并与 map (rb_tree) 比较批量构建、查找、顺序遍历的性能
+
+#include <map>
+#include <set>
+#include <algorithm>
+
+#include "../TinySTL/map.h"
+#include "../TinySTL/vector.h"
+#include "../TinySTL/flat_set.h"
+#include "../TinySTL/flat_map.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace flat_test
+{
+
+// 用 count 个随机键值对批量构建容器
+#define FLAT_BUILD_DO_TEST(con, count) do {                  \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  mystl::vector<mystl::pair<int, int>> v;                    \
+  v.reserve(count);                                          \
+  for (size_t i = 0; i < count; ++i)                         \
+    v.push_back(mystl::make_pair(rand(), (int)i));           \
+  start = clock();                                           \
+  con c(v.begin(), v.end());                                 \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+// 构建后进行 count 次随机查找
+#define FLAT_FIND_DO_TEST(con, count) do {                   \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  mystl::vector<mystl::pair<int, int>> v;                    \
+  v.reserve(count);                                          \
+  for (size_t i = 0; i < count; ++i)                         \
+    v.push_back(mystl::make_pair(rand(), (int)i));           \
+  con c(v.begin(), v.end());                                 \
+  size_t hit = 0;                                            \
+  start = clock();                                           \
+  for (size_t i = 0; i < count; ++i)                         \
+    hit += c.find(rand()) != c.end();                        \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n + (int)(hit & 0)); \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+// 构建后顺序遍历 10 次
+#define FLAT_SCAN_DO_TEST(con, count) do {                   \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  mystl::vector<mystl::pair<int, int>> v;                    \
+  v.reserve(count);                                          \
+  for (size_t i = 0; i < count; ++i)                         \
+    v.push_back(mystl::make_pair(rand(), (int)i));           \
+  con c(v.begin(), v.end());                                 \
+  long long sum = 0;                                         \
+  start = clock();                                           \
+  for (int r = 0; r < 10; ++r)                               \
+    for (auto it = c.begin(); it != c.end(); ++it)           \
+      sum += it->second;                                     \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n + (int)(sum & 0)); \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define FLAT_COMPARE_TEST(DO_TEST, len1, len2, len3)         \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|   mystl::map        |";                    \
+  DO_TEST(FLAT_TEST_MAP, len1);                              \
+  DO_TEST(FLAT_TEST_MAP, len2);                              \
+  DO_TEST(FLAT_TEST_MAP, len3);                              \
+  std::cout << "\n|   mystl::flat_map   |";                  \
+  DO_TEST(FLAT_TEST_FLAT_MAP, len1);                         \
+  DO_TEST(FLAT_TEST_FLAT_MAP, len2);                         \
+  DO_TEST(FLAT_TEST_FLAT_MAP, len3);
+
+// 宏参数中不能直接出现逗号
+typedef mystl::map<int, int, mystl::less<int>>      FLAT_TEST_MAP;
+typedef mystl::flat_map<int, int>                   FLAT_TEST_FLAT_MAP;
+
+void flat_set_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[--------------- Run container test : flat_set -----------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int a[] = { 5,4,3,2,1 };
+  int b[] = { 1,2,3,4,5 };
+  mystl::flat_set<int> s1;
+  mystl::flat_set<int, mystl::greater<int>> s2;
+  mystl::flat_set<int> s3(a, a + 5);
+  mystl::flat_set<int> s4(a, a + 5);
+  mystl::flat_set<int> s5(s3);
+  mystl::flat_set<int> s6(std::move(s3));
+  mystl::flat_set<int> s7;
+  s7 = s4;
+  mystl::flat_set<int> s8;
+  s8 = std::move(s4);
+  mystl::flat_set<int> s9{ 1,2,3,4,5 };
+  mystl::flat_set<int> s10;
+  s10 = { 1,2,3,4,5 };
+  mystl::flat_set<int> s11(mystl::sorted_unique, b, b + 5);
+
+  for (int i = 5; i > 0; --i)
+  {
+    FUN_AFTER(s1, s1.emplace(i));
+  }
+  FUN_AFTER(s1, s1.emplace_hint(s1.begin(), 0));
+  FUN_AFTER(s1, s1.erase(s1.begin()));
+  FUN_AFTER(s1, s1.erase(0));
+  FUN_AFTER(s1, s1.erase(1));
+  FUN_AFTER(s1, s1.erase(s1.begin(), s1.end()));
+  for (int i = 0; i < 5; ++i)
+  {
+    FUN_AFTER(s1, s1.insert(i));
+  }
+  FUN_AFTER(s1, s1.insert(a, a + 5));
+  FUN_AFTER(s1, s1.insert(5));
+  FUN_AFTER(s1, s1.insert(s1.end(), 5));
+  FUN_VALUE(s1.count(5));
+  FUN_VALUE(*s1.find(3));
+  FUN_VALUE(*s1.lower_bound(3));
+  FUN_VALUE(*s1.upper_bound(3));
+  auto first = *s1.equal_range(3).first;
+  auto second = *s1.equal_range(3).second;
+  std::cout << " s1.equal_range(3) : from " << first << " to " << second << std::endl;
+  FUN_AFTER(s1, s1.erase(s1.begin()));
+  FUN_AFTER(s1, s1.erase(1));
+  FUN_AFTER(s1, s1.erase(s1.begin(), s1.find(3)));
+  FUN_AFTER(s1, s1.clear());
+  FUN_AFTER(s1, s1.swap(s5));
+  FUN_AFTER(s1, s1.reserve(100));
+  FUN_VALUE(s1.capacity());
+  FUN_VALUE(*s1.begin());
+  FUN_VALUE(*s1.rbegin());
+  std::cout << std::boolalpha;
+  FUN_VALUE(s1.empty());
+  FUN_VALUE((s9 == s11));
+  std::cout << std::noboolalpha;
+  FUN_VALUE(s1.size());
+  FUN_VALUE(s1.max_size());
+
+  // 与 std::set 对比大量随机批量插入和删除后的结果
+  mystl::flat_set<int> fs;
+  std::set<int> ss;
+  srand(42);
+  for (int i = 0; i < 1000; ++i)
+  {
+    // 批量的大小超过插入排序的阈值, 覆盖对新加入部分排序的路径
+    int buf[512];
+    int n = rand() % 512;
+    for (int j = 0; j < n; ++j)
+      buf[j] = rand() % 10000;
+    fs.insert(buf, buf + n);
+    ss.insert(buf, buf + n);
+    for (int j = 0; j < 128; ++j)
+    {
+      int k = rand() % 10000;
+      fs.erase(k);
+      ss.erase(k);
+    }
+  }
+  std::cout << std::boolalpha;
+  FUN_VALUE((fs.size() == ss.size() && std::equal(ss.begin(), ss.end(), fs.begin())));
+  std::cout << std::noboolalpha;
+  PASSED;
+  std::cout << "[--------------- End container test : flat_set -----------------]" << std::endl;
+}
+
+void flat_map_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[--------------- Run container test : flat_map -----------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::flat_map<int, int> m1;
+  for (int i = 5; i > 0; --i)
+    m1.emplace(i, i * 10);
+  m1[7] = 70;
+  FUN_VALUE(m1.size());
+  FUN_VALUE(m1[3]);
+  FUN_VALUE(m1.at(7));
+  FUN_VALUE(m1.lower_bound(6)->first);
+  FUN_VALUE(m1.upper_bound(3)->first);
+  FUN_VALUE(m1.erase(3));
+  FUN_VALUE(m1.count(3));
+  FUN_VALUE(m1.begin()->second);
+  mystl::flat_multimap<int, int> m2;
+  for (int i = 0; i < 10; ++i)
+    m2.insert(mystl::make_pair(i % 3, i));
+  FUN_VALUE(m2.count(1));
+  FUN_VALUE(m2.equal_range(1).first->second);
+  FUN_VALUE(m2.erase(1));
+  FUN_VALUE(m2.size());
+
+  // 批量插入时与已有元素或同一批中靠前的元素键重复则保留先出现的, 与 std::map::insert 一致
+  // flat_multimap 中键相同的元素保持插入顺序, 与 std::multimap 一致
+  mystl::flat_map<int, int> fm;
+  mystl::flat_multimap<int, int> fmm;
+  std::map<int, int> sm;
+  std::multimap<int, int> smm;
+  srand(42);
+  for (int i = 0; i < 300; ++i)
+  {
+    mystl::pair<int, int> buf[512];
+    int n = rand() % 512;
+    for (int j = 0; j < n; ++j)
+      buf[j] = mystl::make_pair(rand() % 1000, i * 512 + j);
+    fm.insert(buf, buf + n);
+    fmm.insert(buf, buf + n);
+    for (int j = 0; j < n; ++j)
+    {
+      sm.insert(std::make_pair(buf[j].first, buf[j].second));
+      smm.insert(std::make_pair(buf[j].first, buf[j].second));
+    }
+    for (int j = 0; j < 64; ++j)
+    {
+      int k = rand() % 1000;
+      fm.erase(k);
+      sm.erase(k);
+      fmm.erase(k);
+      smm.erase(k);
+    }
+  }
+  bool same = fm.size() == sm.size();
+  auto it = fm.begin();
+  for (auto& kv : sm)
+  {
+    if (!same)
+      break;
+    same = it->first == kv.first && it->second == kv.second;
+    ++it;
+  }
+  bool multi_same = fmm.size() == smm.size();
+  auto mit = fmm.begin();
+  for (auto& kv : smm)
+  {
+    if (!multi_same)
+      break;
+    multi_same = mit->first == kv.first && mit->second == kv.second;
+    ++mit;
+  }
+  std::cout << std::boolalpha;
+  FUN_VALUE(same);
+  FUN_VALUE(multi_same);
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|   build (range)     |";
+#if LARGER_TEST_DATA_ON
+  FLAT_COMPARE_TEST(FLAT_BUILD_DO_TEST, LEN1 _M, LEN2 _M, LEN3 _M);
+#else
+  FLAT_COMPARE_TEST(FLAT_BUILD_DO_TEST, LEN1 _S, LEN2 _S, LEN3 _S);
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|        find         |";
+#if LARGER_TEST_DATA_ON
+  FLAT_COMPARE_TEST(FLAT_FIND_DO_TEST, LEN1 _M, LEN2 _M, LEN3 _M);
+#else
+  FLAT_COMPARE_TEST(FLAT_FIND_DO_TEST, LEN1 _S, LEN2 _S, LEN3 _S);
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|     ordered scan    |";
+#if LARGER_TEST_DATA_ON
+  FLAT_COMPARE_TEST(FLAT_SCAN_DO_TEST, LEN1 _M, LEN2 _M, LEN3 _M);
+#else
+  FLAT_COMPARE_TEST(FLAT_SCAN_DO_TEST, LEN1 _S, LEN2 _S, LEN3 _S);
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[--------------- End container test : flat_map -----------------]" << std::endl;
+}
+
+} // namespace flat_test
+} // namespace test
+} // namespace mystl
+#endif // !TINYSTL_FLAT_TEST_H_
@@ -0,0 +1,175 @@
+#ifndef TINYSTL_INTERVAL_MAP_TEST_H_
+#define TINYSTL_INTERVAL_MAP_TEST_H_
+
+// interval map test : 测试 interval_map 的接口
+// 并与按起点存入 multimap 后顺序扫描的做法比较点查询 (stabbing) 的性能
+
+#include <vector>
+#include <algorithm>
+
+#include "../TinySTL/map.h"
+#include "../TinySTL/interval_map.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace interval_map_test
+{
+
+// 在 count 个长度不超过 1000 的随机区间上进行 100 次点查询
+// multimap 以起点为键, 只能扫描所有起点不大于查询点的元素
+#define INTERVAL_STAB_MULTIMAP_TEST(count) do {              \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  mystl::multimap<int, int, mystl::less<int>> c;             \
+  char buf[10];                                              \
+  for (size_t i = 0; i < count; ++i)                         \
+  {                                                          \
+    int low = rand() % (int)count;                           \
+    c.insert(mystl::make_pair(low, low + rand() % 1000));    \
+  }                                                          \
+  size_t hit = 0;                                            \
+  start = clock();                                           \
+  for (int q = 0; q < 100; ++q)                             \
+  {                                                          \
+    int p = rand() % (int)count;                             \
+    for (auto it = c.begin(); it != c.end() && it->first <= p; ++it) \
+      hit += p < it->second;                                 \
+  }                                                          \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n + (int)(hit & 0)); \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define INTERVAL_STAB_TREE_TEST(count) do {                  \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  mystl::interval_map<int, int> c;                           \
+  char buf[10];                                              \
+  for (size_t i = 0; i < count; ++i)                         \
+  {                                                          \
+    int low = rand() % (int)count;                           \
+    c.insert(low, low + rand() % 1000, (int)i);              \
+  }                                                          \
+  size_t hit = 0;                                            \
+  start = clock();                                           \
+  for (int q = 0; q < 100; ++q)                             \
+  {                                                          \
+    int p = rand() % (int)count;                             \
+    c.for_each_stab(p, [&hit](mystl::interval_map<int, int>::iterator) { ++hit; }); \
+  }                                                          \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n + (int)(hit & 0)); \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define INTERVAL_COUT(m) do {                                \
+  std::string m_name = #m;                                   \
+  std::cout << " " << m_name << " :";                        \
+  for (auto it = m.begin(); it != m.end(); ++it)             \
+    std::cout << " [" << it->first.first << "," << it->first.second << "):" << it->second; \
+  std::cout << std::endl;                                    \
+} while(0)
+
+void interval_map_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------------- Run container test : interval_map ---------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::interval_map<int, int> m1;
+  m1.insert(15, 20, 1);
+  m1.insert(10, 30, 2);
+  m1.insert(17, 19, 3);
+  m1.insert(5, 20, 4);
+  m1.insert(12, 15, 5);
+  m1.insert(30, 40, 6);
+  m1.insert(30, 40, 7);
+  INTERVAL_COUT(m1);
+  FUN_VALUE(m1.size());
+  FUN_VALUE(m1.count(30, 40));
+  FUN_VALUE(m1.find(17, 19)->second);
+  FUN_VALUE(m1.any_overlap(20, 25)->second);
+  FUN_VALUE(m1.stab(15).size());
+  FUN_VALUE(m1.stab(30).size());
+  FUN_VALUE(m1.overlap(19, 31).size());
+  FUN_VALUE(m1.overlap(40, 50).size());
+  std::cout << " m1.stab(18) :";
+  m1.for_each_stab(18, [](mystl::interval_map<int, int>::iterator it) { std::cout << " " << it->second; });
+  std::cout << std::endl;
+  FUN_VALUE(m1.erase(30, 40));
+  FUN_VALUE(m1.erase(m1.begin())->second);
+  INTERVAL_COUT(m1);
+  mystl::interval_map<int, int> m2(m1);
+  mystl::interval_map<int, int> m3{ { {1, 2}, 1 }, { {2, 3}, 2 } };
+  std::cout << std::boolalpha;
+  FUN_VALUE((m2 == m1));
+  m2.swap(m3);
+  INTERVAL_COUT(m2);
+  FUN_VALUE((m2 == m1));
+
+  // 与暴力扫描对比大量随机插入删除后的查询结果
+  mystl::interval_map<int, int> im;
+  std::vector<mystl::pair<int, int>> ref;
+  srand(42);
+  bool same = true;
+  for (int i = 0; i < 20000 && same; ++i)
+  {
+    int low = rand() % 5000;
+    int high = low + rand() % 100;
+    if (rand() % 3)
+    {
+      im.insert(low, high, i);
+      ref.push_back(mystl::pair<int, int>(low, high));
+    }
+    else
+    {
+      size_t n = im.erase(low, high);
+      size_t before = ref.size();
+      ref.erase(std::remove(ref.begin(), ref.end(), mystl::pair<int, int>(low, high)), ref.end());
+      same = n == before - ref.size();
+    }
+    if (i % 100 == 0)
+    {
+      size_t expect = 0;
+      for (auto& r : ref)
+        expect += r.first < high && low < r.second;
+      same = same && im.overlap(low, high).size() == expect;
+    }
+  }
+  FUN_VALUE(same);
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|     stab x 100      |";
+  TEST_LEN(LEN1 _SS, LEN2 _SS, LEN3 _SS, WIDE);
+  std::cout << "|   multimap scan     |";
+  INTERVAL_STAB_MULTIMAP_TEST(LEN1 _SS);
+  INTERVAL_STAB_MULTIMAP_TEST(LEN2 _SS);
+  INTERVAL_STAB_MULTIMAP_TEST(LEN3 _SS);
+  std::cout << "\n|   interval_map      |";
+  INTERVAL_STAB_TREE_TEST(LEN1 _SS);
+  INTERVAL_STAB_TREE_TEST(LEN2 _SS);
+  INTERVAL_STAB_TREE_TEST(LEN3 _SS);
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[------------- End container test : interval_map ---------------]" << std::endl;
+}
+
+} // namespace interval_map_test
+} // namespace test
+} // namespace mystl
+#endif // !TINYSTL_INTERVAL_MAP_TEST_H_
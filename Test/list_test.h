@@ -104,6 +104,10 @@ void list_test()
 #else
   LIST_SORT_TEST(LEN1 _S, LEN2 _S, LEN3 _S);
 #endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|    sort (resort)    |";
+  LIST_RESORT_TEST(std::list<int>, mystl::list<int>, LEN1 _M, LEN2 _M, LEN3 _M);
   std::cout << std::endl;
   std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
   PASSED;
@@ -87,6 +87,9 @@ void map_test()
   auto second = *m1.equal_range(2).second;
   std::cout << " m1.equal_range(2) : from <" << first.first << ", " << first.second
     << "> to <" << second.first << ", " << second.second << ">" << std::endl;
+  mystl::map<int, int, mystl::less<int>, mystl::rb_tree_size_augment> m11(m1.begin(), m1.end());
+  MAP_VALUE(*m11.find_by_order(2));
+  FUN_VALUE(m11.order_of_key(3));
   MAP_FUN_AFTER(m1, m1.erase(m1.begin()));
   MAP_FUN_AFTER(m1, m1.erase(1));
   MAP_FUN_AFTER(m1, m1.erase(m1.begin(), m1.find(3)));
@@ -113,6 +116,9 @@ void map_test()
   MAP_EMPLACE_TEST(map, LEN1 _M, LEN2 _M, LEN3 _M);
 #endif
   std::cout << std::endl;
+  typedef mystl::map<int, int>                             map_type;
+  typedef mystl::rb_tree_node<mystl::pair<const int, int>> map_node_type;
+  RB_TREE_MEMORY_TEST(map_type, map_node_type, mystl::make_pair(static_cast<int>(i), static_cast<int>(i)), 10000000);
   std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
   PASSED;
 #endif
@@ -165,6 +171,9 @@ void multimap_test()
   auto second = *m1.equal_range(2).second;
   std::cout << " m1.equal_range(2) : from <" << first.first << ", " << first.second
     << "> to <" << second.first << ", " << second.second << ">" << std::endl;
+  mystl::multimap<int, int, mystl::less<int>, mystl::rb_tree_size_augment> m11(m1.begin(), m1.end());
+  MAP_VALUE(*m11.find_by_order(2));
+  FUN_VALUE(m11.order_of_key(3));
   MAP_FUN_AFTER(m1, m1.erase(m1.begin()));
   MAP_FUN_AFTER(m1, m1.erase(1));
   MAP_FUN_AFTER(m1, m1.erase(m1.begin(), m1.find(3)));
@@ -0,0 +1,202 @@
+#ifndef TINYSTL_PERSISTENT_MAP_TEST_H_
+#define TINYSTL_PERSISTENT_MAP_TEST_H_
+
+// persistent map test : 测试 persistent_map 的接口和快照语义
+// 并与复制整个 map 的做法比较取快照及更新的性能
+
+#include <map>
+#include <vector>
+#include <thread>
+#include <mutex>
+
+#include "../TinySTL/map.h"
+#include "../TinySTL/vector.h"
+#include "../TinySTL/persistent_map.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace persistent_map_test
+{
+
+// 在 count 个元素的映射上, 每次删除一个元素前取一次快照, 共 20 次
+#define PERSISTENT_SNAPSHOT_DO_TEST(con, count, take) do {   \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  con c;                                                     \
+  char buf[10];                                              \
+  for (size_t i = 0; i < count; ++i)                         \
+    c.insert(mystl::make_pair((int)i, (int)i));              \
+  size_t total = 0;                                          \
+  start = clock();                                           \
+  for (size_t i = 0; i < 20; ++i)                            \
+  {                                                          \
+    con snap(take);                                          \
+    total += snap.size();                                    \
+    c.erase(rand() % (int)count);                            \
+  }                                                          \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n + (int)(total & 0)); \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+typedef mystl::map<int, int, mystl::less<int>> PERSISTENT_TEST_MAP;
+typedef mystl::persistent_map<int, int>        PERSISTENT_TEST_PMAP;
+
+#define PMAP_COUT(m) do {                                    \
+  std::string m_name = #m;                                   \
+  std::cout << " " << m_name << " :";                        \
+  for (auto it = m.begin(); it != m.end(); ++it)             \
+    std::cout << " <" << it->first << "," << it->second << ">"; \
+  std::cout << std::endl;                                    \
+} while(0)
+
+void persistent_map_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------------ Run container test : persistent_map --------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::persistent_map<int, int> m1;
+  for (int i = 5; i > 0; --i)
+    m1.emplace(i, i);
+  mystl::persistent_map<int, int> v1 = m1.snapshot();
+  m1.insert_or_assign(3, 30);
+  m1.insert(mystl::make_pair(6, 6));
+  m1.erase(1);
+  mystl::persistent_map<int, int> v2 = m1.snapshot();
+  m1.clear();
+  PMAP_COUT(v1);
+  PMAP_COUT(v2);
+  PMAP_COUT(m1);
+  FUN_VALUE(v1.size());
+  FUN_VALUE(v2.size());
+  FUN_VALUE(v1.at(3));
+  FUN_VALUE(v2.at(3));
+  FUN_VALUE(v2.count(1));
+  FUN_VALUE(v2.lower_bound(4)->first);
+  FUN_VALUE(v2.upper_bound(4)->first);
+  FUN_VALUE(v2.rbegin()->first);
+  mystl::persistent_map<int, int> m2{ {1, 1}, {2, 2} };
+  FUN_VALUE(m2.size());
+
+  // 随机修改并保留大量快照, 每个快照都应与当时的 std::map 一致
+  mystl::persistent_map<int, int> pm;
+  std::map<int, int> sm;
+  mystl::vector<mystl::persistent_map<int, int>> snaps;
+  std::vector<std::map<int, int>> expect;
+  srand(42);
+  for (int i = 0; i < 20000; ++i)
+  {
+    int k = rand() % 2000;
+    if (rand() % 3)
+    {
+      pm.insert_or_assign(k, i);
+      sm[k] = i;
+    }
+    else
+    {
+      pm.erase(k);
+      sm.erase(k);
+    }
+    if (i % 1000 == 0)
+    {
+      snaps.push_back(pm.snapshot());
+      expect.push_back(sm);
+    }
+  }
+  bool same = true;
+  for (size_t i = 0; i < snaps.size() && same; ++i)
+  {
+    same = snaps[i].size() == expect[i].size();
+    auto it = snaps[i].begin();
+    for (auto& kv : expect[i])
+    {
+      if (!same)
+        break;
+      same = it->first == kv.first && it->second == kv.second;
+      ++it;
+    }
+  }
+  std::cout << std::boolalpha;
+  FUN_VALUE(same);
+
+  // 写线程持续更新并发布快照, 读线程只在取快照时加锁, 遍历快照时不加锁
+  // 每次发布时所有值之和为 0, 读到的任何快照都应保持这一点
+  mystl::persistent_map<int, int> shared;
+  for (int i = 0; i < 1000; ++i)
+    shared.insert(mystl::make_pair(i, 0));
+  mystl::persistent_map<int, int> published = shared.snapshot();
+  std::mutex publish_mutex;
+  bool consistent = true;
+  std::thread writer([&] {
+    for (int i = 0; i < 20000; ++i)
+    {
+      int a = i % 1000, b = (i * 7 + 1) % 1000;
+      if (a == b)
+        continue;
+      int va = shared.at(a), vb = shared.at(b);
+      shared.insert_or_assign(a, va + 1);
+      shared.insert_or_assign(b, vb - 1);
+      auto snap = shared.snapshot();
+      std::lock_guard<std::mutex> lock(publish_mutex);
+      published.swap(snap);
+    }
+  });
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 4; ++r)
+  {
+    readers.push_back(std::thread([&] {
+      for (int round = 0; round < 200; ++round)
+      {
+        mystl::persistent_map<int, int> snap;
+        {
+          std::lock_guard<std::mutex> lock(publish_mutex);
+          snap = published;
+        }
+        long long sum = 0;
+        for (auto it = snap.begin(); it != snap.end(); ++it)
+          sum += it->second;
+        if (sum != 0 || snap.size() != 1000)
+          consistent = false;
+      }
+    }));
+  }
+  writer.join();
+  for (auto& t : readers)
+    t.join();
+  long long sum = 0;
+  for (auto it = shared.begin(); it != shared.end(); ++it)
+    sum += it->second;
+  FUN_VALUE((consistent && sum == 0));
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "| snapshot + update   |";
+  TEST_LEN(LEN1 _S, LEN2 _S, LEN3 _S, WIDE);
+  std::cout << "| map (deep copy)     |";
+  PERSISTENT_SNAPSHOT_DO_TEST(PERSISTENT_TEST_MAP, LEN1 _S, c);
+  PERSISTENT_SNAPSHOT_DO_TEST(PERSISTENT_TEST_MAP, LEN2 _S, c);
+  PERSISTENT_SNAPSHOT_DO_TEST(PERSISTENT_TEST_MAP, LEN3 _S, c);
+  std::cout << "\n| persistent_map      |";
+  PERSISTENT_SNAPSHOT_DO_TEST(PERSISTENT_TEST_PMAP, LEN1 _S, c.snapshot());
+  PERSISTENT_SNAPSHOT_DO_TEST(PERSISTENT_TEST_PMAP, LEN2 _S, c.snapshot());
+  PERSISTENT_SNAPSHOT_DO_TEST(PERSISTENT_TEST_PMAP, LEN3 _S, c.snapshot());
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[------------ End container test : persistent_map --------------]" << std::endl;
+}
+
+} // namespace persistent_map_test
+} // namespace test
+} // namespace mystl
+#endif // !TINYSTL_PERSISTENT_MAP_TEST_H_
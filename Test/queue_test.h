@@ -1,11 +1,20 @@
 ﻿#ifndef TINYSTL_QUEUE_TEST_H_
 #define TINYSTL_QUEUE_TEST_H_
 
-// queue test : 测试 queue, priority_queue 的接口和它们 push 的性能
+// queue test : 测试 queue, mpmc_queue, priority_queue 的接口和它们 push 的性能
+// mpmc_queue 另外与加锁的 queue 比较 N 个生产者、M 个消费者时的吞吐量
+// priority_queue 另外比较二叉堆与 d 叉堆在大量元素时 push + pop 的耗时
 
 #include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <string>
+#include <stdexcept>
 
 #include "../TinySTL/queue.h"
+#include "../TinySTL/deque.h"
 #include "test.h"
 
 namespace mystl
@@ -35,6 +44,123 @@ void p_queue_print(mystl::priority_queue<int> p)
   std::cout << std::endl;
 }
 
+// 稳定状态下的 FIFO: 先放入 size 个元素, 再交替 push 和 pop 共 total 次, 队列长度保持不变
+// 队头每用空一个分区, 队尾就需要一个新分区, 以 deque 为底层容器时分区可以从缓存中复用
+#define QUEUE_STEADY_DO_TEST(con, size, total) do {          \
+  con q;                                                     \
+  for (size_t i = 0; i < size; ++i)                          \
+    q.push((int)i);                                          \
+  long long sum = 0;                                         \
+  char buf[10];                                              \
+  clock_t start = clock();                                   \
+  for (size_t i = 0; i < total; ++i)                         \
+  {                                                          \
+    q.push((int)i);                                          \
+    sum += q.front();                                        \
+    q.pop();                                                 \
+  }                                                          \
+  clock_t end = clock();                                     \
+  volatile long long sink = sum;                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n + (int)(sink & 0)); \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+typedef mystl::queue<int, mystl::deque<int>>      QUEUE_TEST_DEQUE;
+typedef mystl::queue<int, mystl::deque<int, 16>>  QUEUE_TEST_DEQUE16;
+
+// 用一把锁和两个条件变量保护的有界 queue, 作为 mpmc_queue 的对照
+class queue_test_locked_queue
+{
+  std::mutex                m_;
+  std::condition_variable   not_full_, not_empty_;
+  mystl::queue<int>         q_;
+  size_t                    cap_;
+public:
+  explicit queue_test_locked_queue(size_t cap) : cap_(cap) {}
+  void push(int v)
+  {
+    std::unique_lock<std::mutex> lock(m_);
+    not_full_.wait(lock, [this] { return q_.size() < cap_; });
+    q_.push(v);
+    lock.unlock();
+    not_empty_.notify_one();
+  }
+  void pop(int& v)
+  {
+    std::unique_lock<std::mutex> lock(m_);
+    not_empty_.wait(lock, [this] { return !q_.empty(); });
+    v = q_.front();
+    q_.pop();
+    lock.unlock();
+    not_full_.notify_one();
+  }
+};
+
+// producers 个线程共写入 total 个非负整数, consumers 个线程读到 -1 时结束
+// 每个消费者检查来自同一生产者的元素是否按写入顺序到达, 返回每秒传递的元素个数 (百万), 出错时返回负数
+template <class Queue>
+double queue_test_contention(int producers, int consumers, size_t total)
+{
+  Queue q(1024);
+  const size_t per = total / producers;
+  std::atomic<long long> sum(0);
+  std::atomic<int> errors(0);
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int c = 0; c < consumers; ++c)
+  {
+    threads.emplace_back([&] {
+      std::vector<long long> last(producers, -1);
+      long long local = 0;
+      for (;;)
+      {
+        int v;
+        q.pop(v);
+        if (v < 0)
+          break;
+        const int p = (int)(v / per);
+        if (v <= last[p])
+          ++errors;
+        last[p] = v;
+        local += v;
+      }
+      sum += local;
+    });
+  }
+  for (int p = 0; p < producers; ++p)
+  {
+    threads.emplace_back([&, p] {
+      for (size_t i = 0; i < per; ++i)
+        q.push((int)(p * per + i));
+    });
+  }
+  for (int p = 0; p < producers; ++p)
+    threads[consumers + p].join();
+  for (int c = 0; c < consumers; ++c)
+    q.push(-1);
+  for (int c = 0; c < consumers; ++c)
+    threads[c].join();
+  auto end = std::chrono::steady_clock::now();
+  const long long n = (long long)per * producers;
+  if (errors != 0 || sum != n * (n - 1) / 2)
+    return -1.0;
+  double sec = std::chrono::duration<double>(end - start).count();
+  return n / sec / 1e6;
+}
+
+#define QUEUE_CONTENTION_DO_TEST(con, producers, consumers, total) do { \
+  char buf[20];                                              \
+  std::snprintf(buf, sizeof(buf), "%.1f",                    \
+      queue_test_contention<con>(producers, consumers, total)); \
+  std::string t = buf;                                       \
+  t += "M/s  |";                                             \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
 //  queue 的遍历输出
 #define QUEUE_COUT(q) do {                       \
     std::string q_name = #q;                     \
@@ -63,6 +189,60 @@ void p_queue_print(mystl::priority_queue<int> p)
   P_QUEUE_COUT(con);                             \
 } while(0)
 
+// 依次 push len 个元素再全部 pop, 记录总耗时
+#define P_QUEUE_HEAP_DO_TEST(con, gen, len) do {             \
+  mystl::vector<typename con::value_type> v(len);            \
+  for (size_t i = 0; i < len; ++i)                           \
+    v[i] = gen;                                              \
+  con p;                                                     \
+  size_t popped = 0;                                         \
+  char buf[10];                                              \
+  clock_t start = clock();                                   \
+  for (size_t i = 0; i < len; ++i)                           \
+    p.push(mystl::move(v[i]));                               \
+  while (!p.empty())                                         \
+  {                                                          \
+    p.pop();                                                 \
+    ++popped;                                                \
+  }                                                          \
+  clock_t end = clock();                                     \
+  volatile size_t sink = popped;                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n + (int)(sink & 0)); \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define P_QUEUE_HEAP_ROW(name, con, gen, len1, len2, len3)   \
+  std::cout << name;                                         \
+  P_QUEUE_HEAP_DO_TEST(con, gen, len1);                      \
+  P_QUEUE_HEAP_DO_TEST(con, gen, len2);                      \
+  P_QUEUE_HEAP_DO_TEST(con, gen, len3);                      \
+  std::cout << std::endl
+
+// 检查 priority_queue 依次弹出的元素是否有序, 并与 std::priority_queue 的结果一致
+template <class PQueue, class Compare>
+bool p_queue_check(const mystl::vector<int>& v)
+{
+  PQueue p(v.begin(), v.end());
+  std::priority_queue<int, std::vector<int>, Compare> q(v.begin(), v.end());
+  for (size_t i = 0; i < v.size(); ++i)
+  {
+    p.push(v[i] / 2);
+    q.push(v[i] / 2);
+  }
+  while (!p.empty() && !q.empty())
+  {
+    if (p.top() != q.top())
+      return false;
+    p.pop();
+    q.pop();
+  }
+  return p.empty() && q.empty();
+}
+
 void queue_test()
 {
   std::cout << "[===============================================================]" << std::endl;
@@ -114,6 +294,26 @@ void queue_test()
 #else
   CON_TEST_P1(queue<int>, push, rand(), LEN1 _L, LEN2 _L, LEN3 _L);
 #endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "| steady push + pop   |";
+  TEST_LEN(LEN1 _L, LEN2 _L, LEN3 _L, WIDE);
+  std::cout << "|   std (deque)       |";
+  QUEUE_STEADY_DO_TEST(std::queue<int>, 1000, LEN1 _L);
+  QUEUE_STEADY_DO_TEST(std::queue<int>, 1000, LEN2 _L);
+  QUEUE_STEADY_DO_TEST(std::queue<int>, 1000, LEN3 _L);
+  std::cout << "\n|   mystl (list)      |";
+  QUEUE_STEADY_DO_TEST(mystl::queue<int>, 1000, LEN1 _L);
+  QUEUE_STEADY_DO_TEST(mystl::queue<int>, 1000, LEN2 _L);
+  QUEUE_STEADY_DO_TEST(mystl::queue<int>, 1000, LEN3 _L);
+  std::cout << "\n|   mystl (deque)     |";
+  QUEUE_STEADY_DO_TEST(QUEUE_TEST_DEQUE, 1000, LEN1 _L);
+  QUEUE_STEADY_DO_TEST(QUEUE_TEST_DEQUE, 1000, LEN2 _L);
+  QUEUE_STEADY_DO_TEST(QUEUE_TEST_DEQUE, 1000, LEN3 _L);
+  std::cout << "\n| mystl (deque, 16)   |";
+  QUEUE_STEADY_DO_TEST(QUEUE_TEST_DEQUE16, 1000, LEN1 _L);
+  QUEUE_STEADY_DO_TEST(QUEUE_TEST_DEQUE16, 1000, LEN2 _L);
+  QUEUE_STEADY_DO_TEST(QUEUE_TEST_DEQUE16, 1000, LEN3 _L);
   std::cout << std::endl;
   std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
   PASSED;
@@ -121,6 +321,106 @@ void queue_test()
   std::cout << "[----------------- End container test : queue ------------------]" << std::endl;
 }
 
+// 用负数构造时抛出异常, 用来产生 mpmc_queue 中的无效槽位
+struct queue_test_throwing
+{
+  int v;
+  queue_test_throwing() : v(0) {}
+  queue_test_throwing(int x) : v(x)
+  {
+    if (x < 0)
+      throw std::invalid_argument("negative");
+  }
+};
+
+void mpmc_queue_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[--------------- Run container test : mpmc_queue ---------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::mpmc_queue<int> q1(3);
+  int v = 0;
+  FUN_VALUE(q1.capacity());
+  FUN_VALUE(q1.try_push(1));
+  FUN_VALUE(q1.try_emplace(2));
+  q1.push(3);
+  q1.emplace(4);
+  FUN_VALUE(q1.try_push(5));
+  FUN_VALUE(q1.size());
+  FUN_VALUE(q1.try_pop(v));
+  FUN_VALUE(v);
+  q1.pop(v);
+  FUN_VALUE(v);
+  FUN_VALUE(q1.pop());
+  FUN_VALUE(q1.pop());
+  std::cout << std::boolalpha;
+  FUN_VALUE(q1.empty());
+  FUN_VALUE(q1.try_pop(v));
+  // 容量很小时让生产者和消费者频繁阻塞
+  mystl::mpmc_queue<int> q2(4);
+  std::thread t1([&] { for (int i = 1; i <= 100000; ++i) q2.push(i); });
+  long long s2 = 0;
+  for (int i = 0; i < 100000; ++i)
+    s2 += q2.pop();
+  t1.join();
+  FUN_VALUE((s2 == 5000050000LL));
+  FUN_VALUE((queue_test_contention<mystl::mpmc_queue<int>>(3, 2, 300000) > 0));
+  // 队列被两个无效槽位占满, 消费者跳过它们时要唤醒阻塞的生产者
+  mystl::mpmc_queue<queue_test_throwing> q3(2);
+  for (int i = 0; i < 2; ++i)
+  {
+    try
+    {
+      q3.emplace(-1);
+    }
+    catch (const std::invalid_argument&)
+    {
+    }
+  }
+  std::thread t3([&] { q3.push(queue_test_throwing(7)); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  queue_test_throwing w;
+  FUN_VALUE(q3.try_pop(w));
+  FUN_VALUE(q3.pop().v);
+  t3.join();
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|  throughput (M/s)   |";
+  TEST_LEN(LEN1 _S, LEN2 _S, LEN3 _S, WIDE);
+  std::cout << "| locked (1P / 1C)    |";
+  QUEUE_CONTENTION_DO_TEST(queue_test_locked_queue, 1, 1, LEN1 _S);
+  QUEUE_CONTENTION_DO_TEST(queue_test_locked_queue, 1, 1, LEN2 _S);
+  QUEUE_CONTENTION_DO_TEST(queue_test_locked_queue, 1, 1, LEN3 _S);
+  std::cout << "\n| mpmc   (1P / 1C)    |";
+  QUEUE_CONTENTION_DO_TEST(mystl::mpmc_queue<int>, 1, 1, LEN1 _S);
+  QUEUE_CONTENTION_DO_TEST(mystl::mpmc_queue<int>, 1, 1, LEN2 _S);
+  QUEUE_CONTENTION_DO_TEST(mystl::mpmc_queue<int>, 1, 1, LEN3 _S);
+  std::cout << "\n| locked (4P / 4C)    |";
+  QUEUE_CONTENTION_DO_TEST(queue_test_locked_queue, 4, 4, LEN1 _S);
+  QUEUE_CONTENTION_DO_TEST(queue_test_locked_queue, 4, 4, LEN2 _S);
+  QUEUE_CONTENTION_DO_TEST(queue_test_locked_queue, 4, 4, LEN3 _S);
+  std::cout << "\n| mpmc   (4P / 4C)    |";
+  QUEUE_CONTENTION_DO_TEST(mystl::mpmc_queue<int>, 4, 4, LEN1 _S);
+  QUEUE_CONTENTION_DO_TEST(mystl::mpmc_queue<int>, 4, 4, LEN2 _S);
+  QUEUE_CONTENTION_DO_TEST(mystl::mpmc_queue<int>, 4, 4, LEN3 _S);
+  std::cout << "\n| locked (8P / 2C)    |";
+  QUEUE_CONTENTION_DO_TEST(queue_test_locked_queue, 8, 2, LEN1 _S);
+  QUEUE_CONTENTION_DO_TEST(queue_test_locked_queue, 8, 2, LEN2 _S);
+  QUEUE_CONTENTION_DO_TEST(queue_test_locked_queue, 8, 2, LEN3 _S);
+  std::cout << "\n| mpmc   (8P / 2C)    |";
+  QUEUE_CONTENTION_DO_TEST(mystl::mpmc_queue<int>, 8, 2, LEN1 _S);
+  QUEUE_CONTENTION_DO_TEST(mystl::mpmc_queue<int>, 8, 2, LEN2 _S);
+  QUEUE_CONTENTION_DO_TEST(mystl::mpmc_queue<int>, 8, 2, LEN3 _S);
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[--------------- End container test : mpmc_queue ---------------]" << std::endl;
+}
+
 void priority_test()
 {
   std::cout << "[===============================================================]" << std::endl;
@@ -153,6 +453,9 @@ void priority_test()
   P_QUEUE_FUN_AFTER(p1, p1.emplace(8));
   std::cout << std::boolalpha;
   FUN_VALUE(p1.empty());
+  FUN_VALUE((p11 == p12));
+  FUN_VALUE((p11 != p12));
+  FUN_VALUE((p1 != p11));
   std::cout << std::noboolalpha;
   FUN_VALUE(p1.size());
   FUN_VALUE(p1.top());
@@ -162,6 +465,34 @@ void priority_test()
   }
   P_QUEUE_FUN_AFTER(p1, p1.swap(p4));
   P_QUEUE_FUN_AFTER(p1, p1.clear());
+
+  // d 叉堆的算法与使用 d 叉堆的 priority_queue
+  int h[] = { 5,7,1,9,3,3,8,0,2,6,4 };
+  FUN_AFTER(h, mystl::make_dary_heap<4>(h, h + 11));
+  FUN_AFTER(h, mystl::pop_dary_heap<4>(h, h + 11));
+  FUN_AFTER(h, mystl::push_dary_heap<4>(h, h + 11));
+  FUN_AFTER(h, mystl::sort_dary_heap<4>(h, h + 11));
+  FUN_AFTER(h, mystl::make_dary_heap<8>(h, h + 11, mystl::greater<int>()));
+  FUN_AFTER(h, mystl::sort_dary_heap<8>(h, h + 11, mystl::greater<int>()));
+  bool same = true;
+  for (size_t len : { (size_t)0, (size_t)1, (size_t)7, (size_t)100, (size_t)10000 })
+  {
+    mystl::vector<int> v(len);
+    for (auto& x : v)
+      x = rand() % 1000;
+    same = same && p_queue_check<mystl::priority_queue<int>, std::less<int>>(v);
+    same = same && p_queue_check<mystl::priority_queue<int, mystl::vector<int>, mystl::greater<int>>,
+                                 std::greater<int>>(v);
+    same = same && p_queue_check<mystl::priority_queue<int, mystl::vector<int>, mystl::less<int>,
+                                 mystl::dary_heap_policy<3>>, std::less<int>>(v);
+    same = same && p_queue_check<mystl::priority_queue<int, mystl::vector<int>, mystl::less<int>,
+                                 mystl::dary_heap_policy<4>>, std::less<int>>(v);
+    same = same && p_queue_check<mystl::priority_queue<int, mystl::vector<int>, mystl::greater<int>,
+                                 mystl::dary_heap_policy<8>>, std::greater<int>>(v);
+  }
+  std::cout << std::boolalpha;
+  FUN_VALUE(same);
+  std::cout << std::noboolalpha;
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
@@ -174,6 +505,32 @@ void priority_test()
 #endif
   std::cout << std::endl;
   std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  typedef mystl::priority_queue<int, mystl::vector<int>, mystl::less<int>,
+                                mystl::dary_heap_policy<4>> pq_4ary_int;
+  typedef mystl::priority_queue<int, mystl::vector<int>, mystl::less<int>,
+                                mystl::dary_heap_policy<8>> pq_8ary_int;
+  typedef mystl::priority_queue<std::string, mystl::vector<std::string>, mystl::less<std::string>,
+                                mystl::dary_heap_policy<4>> pq_4ary_str;
+  std::cout << "|  push + pop (int)   |";
+  TEST_LEN(LEN1 _M, LEN2 _M, LEN3 _M, WIDE);
+  P_QUEUE_HEAP_ROW("|  std                |", std::priority_queue<int>, rand(),
+                   LEN1 _M, LEN2 _M, LEN3 _M);
+  P_QUEUE_HEAP_ROW("|  mystl  (binary)    |", mystl::priority_queue<int>, rand(),
+                   LEN1 _M, LEN2 _M, LEN3 _M);
+  P_QUEUE_HEAP_ROW("|  mystl  (4-ary)     |", pq_4ary_int, rand(),
+                   LEN1 _M, LEN2 _M, LEN3 _M);
+  P_QUEUE_HEAP_ROW("|  mystl  (8-ary)     |", pq_8ary_int, rand(),
+                   LEN1 _M, LEN2 _M, LEN3 _M);
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "| push + pop (string) |";
+  TEST_LEN(LEN1 _S, LEN2 _S, LEN3 _S, WIDE);
+  P_QUEUE_HEAP_ROW("|  std                |", std::priority_queue<std::string>,
+                   std::string(24, 'a') + std::to_string(rand()), LEN1 _S, LEN2 _S, LEN3 _S);
+  P_QUEUE_HEAP_ROW("|  mystl  (binary)    |", mystl::priority_queue<std::string>,
+                   std::string(24, 'a') + std::to_string(rand()), LEN1 _S, LEN2 _S, LEN3 _S);
+  P_QUEUE_HEAP_ROW("|  mystl  (4-ary)     |", pq_4ary_str,
+                   std::string(24, 'a') + std::to_string(rand()), LEN1 _S, LEN2 _S, LEN3 _S);
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
   PASSED;
 #endif
   std::cout << "[------------- End container test : priority_queue -------------]" << std::endl;
@@ -0,0 +1,228 @@
+#ifndef TINYSTL_RADIX_SORT_TEST_H_
+#define TINYSTL_RADIX_SORT_TEST_H_
+
+// radix sort test : 测试 radix_sort, radix_sort_by_key 对整数、浮点数、字符串的排序结果以及稳定性
+// 并与 mystl::sort 比较耗时
+
+#include <string>
+#include <cstdint>
+
+#include "../TinySTL/radix_sort.h"
+#include "../TinySTL/algo.h"
+#include "../TinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace radix_sort_test
+{
+
+struct radix_test_record
+{
+  int      key;
+  unsigned seq;
+};
+
+inline uint32_t radix_test_rand32()
+{
+  return (static_cast<uint32_t>(rand()) << 16) ^ static_cast<uint32_t>(rand());
+}
+
+inline std::string radix_test_word()
+{
+  // 公共前缀较长的字符串, 让 MSD 排序跳过相同的字符
+  std::string s = "key_";
+  const int len = rand() % 12;
+  for (int i = 0; i < len; ++i)
+    s += static_cast<char>('a' + rand() % 26);
+  return s;
+}
+
+template <class T>
+bool radix_test_same(const mystl::vector<T>& a, const mystl::vector<T>& b)
+{
+  return a.size() == b.size() && mystl::equal(a.begin(), a.end(), b.begin());
+}
+
+// mode 为 sort 或 radix_sort
+#define RADIX_SORT_DO_TEST(mode, T, gen, len) do {           \
+  mystl::vector<T> v(len);                                   \
+  for (size_t i = 0; i < len; ++i)                           \
+    v[i] = gen;                                              \
+  char buf[10];                                              \
+  clock_t start = clock();                                   \
+  mystl::mode(v.begin(), v.end());                           \
+  clock_t end = clock();                                     \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define RADIX_SORT_ROW(name, mode, T, gen, len1, len2, len3) \
+  std::cout << name;                                         \
+  RADIX_SORT_DO_TEST(mode, T, gen, len1);                    \
+  RADIX_SORT_DO_TEST(mode, T, gen, len2);                    \
+  RADIX_SORT_DO_TEST(mode, T, gen, len3);                    \
+  std::cout << std::endl
+
+#define RADIX_BY_KEY_DO_TEST(radix, len) do {                \
+  mystl::vector<radix_test_record> v(len);                   \
+  for (size_t i = 0; i < len; ++i)                           \
+    v[i] = radix_test_record{ rand(), (unsigned)i };         \
+  char buf[10];                                              \
+  clock_t start = clock();                                   \
+  if (radix)                                                 \
+    mystl::radix_sort_by_key(v.begin(), v.end(),             \
+      [](const radix_test_record& r) { return r.key; });     \
+  else                                                       \
+    mystl::sort(v.begin(), v.end(),                          \
+      [](const radix_test_record& a, const radix_test_record& b) { return a.key < b.key; }); \
+  clock_t end = clock();                                     \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+void radix_sort_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[---------------- Run algorithm test : radix_sort --------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int a[] = { 5,-3,0,2147483647,-2147483647 - 1,7,-3,1 };
+  FUN_AFTER(a, mystl::radix_sort(a, a + 8));
+  double d[] = { 2.5,-0.5,1e300,-1e300,0.0,-7.25,3.0 };
+  FUN_AFTER(d, mystl::radix_sort(d, d + 7));
+  const char* w[] = { "pear","apple","app","banana","apple","b" };
+  FUN_AFTER(w, mystl::radix_sort(w, w + 6));
+
+  // 与 mystl::sort 比较较长的输入
+  const size_t n = 200000;
+  bool same = true;
+  {
+    mystl::vector<int> x(n), y;
+    for (auto& e : x)
+      e = static_cast<int>(radix_test_rand32());
+    y = x;
+    mystl::radix_sort(x.begin(), x.end());
+    mystl::sort(y.begin(), y.end());
+    same = same && radix_test_same(x, y);
+    // 高位全部相同, 只需要一趟
+    for (auto& e : x)
+      e = rand() % 200;
+    y = x;
+    mystl::radix_sort(x.begin(), x.end());
+    mystl::sort(y.begin(), y.end());
+    same = same && radix_test_same(x, y);
+  }
+  {
+    mystl::vector<unsigned char> x(n), y;
+    for (auto& e : x)
+      e = static_cast<unsigned char>(rand());
+    y = x;
+    mystl::radix_sort(x.begin(), x.end());
+    mystl::sort(y.begin(), y.end());
+    same = same && radix_test_same(x, y);
+  }
+  {
+    mystl::vector<long long> x(n), y;
+    for (auto& e : x)
+      e = static_cast<long long>(static_cast<uint64_t>(radix_test_rand32()) << 32 | radix_test_rand32());
+    y = x;
+    mystl::radix_sort(x.begin(), x.end());
+    mystl::sort(y.begin(), y.end());
+    same = same && radix_test_same(x, y);
+  }
+  {
+    mystl::vector<float> x(n), y;
+    for (auto& e : x)
+      e = (static_cast<float>(rand()) - RAND_MAX / 2) / 1024.0f;
+    y = x;
+    mystl::radix_sort(x.begin(), x.end());
+    mystl::sort(y.begin(), y.end());
+    same = same && radix_test_same(x, y);
+  }
+  {
+    mystl::vector<std::string> x(n), y;
+    for (auto& e : x)
+      e = radix_test_word();
+    y = x;
+    mystl::radix_sort(x.begin(), x.end());
+    mystl::sort(y.begin(), y.end());
+    same = same && radix_test_same(x, y);
+  }
+  {
+    // "a", "aa", ... 打乱后排序, 每层只有一个字符串结束, 桶的划分极不均匀
+    mystl::vector<std::string> x(3000), y;
+    for (size_t i = 0; i < x.size(); ++i)
+      x[i].assign(i + 1, 'a');
+    for (size_t i = x.size() - 1; i > 0; --i)
+      mystl::swap(x[i], x[radix_test_rand32() % (i + 1)]);
+    y = x;
+    mystl::radix_sort(x.begin(), x.end());
+    mystl::sort(y.begin(), y.end());
+    same = same && radix_test_same(x, y);
+  }
+
+  // radix_sort_by_key 是稳定的
+  mystl::vector<radix_test_record> r(n);
+  for (size_t i = 0; i < n; ++i)
+    r[i] = radix_test_record{ rand() % 1000 - 500, (unsigned)i };
+  mystl::radix_sort_by_key(r.begin(), r.end(), [](const radix_test_record& x) { return x.key; });
+  bool stable = true;
+  for (size_t i = 1; i < n; ++i)
+  {
+    if (r[i - 1].key > r[i].key || (r[i - 1].key == r[i].key && r[i - 1].seq > r[i].seq))
+      stable = false;
+  }
+  std::cout << std::boolalpha;
+  FUN_VALUE(same);
+  FUN_VALUE(stable);
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|     algorithm       |";
+  TEST_LEN(LEN1 _L, LEN2 _L, LEN3 _L, WIDE);
+  RADIX_SORT_ROW("|  sort (uint32)      |", sort, uint32_t, radix_test_rand32(),
+                 LEN1 _L, LEN2 _L, LEN3 _L);
+  RADIX_SORT_ROW("|  radix (uint32)     |", radix_sort, uint32_t, radix_test_rand32(),
+                 LEN1 _L, LEN2 _L, LEN3 _L);
+  RADIX_SORT_ROW("|  sort (double)      |", sort, double, (double)rand() - RAND_MAX / 2,
+                 LEN1 _L, LEN2 _L, LEN3 _L);
+  RADIX_SORT_ROW("|  radix (double)     |", radix_sort, double, (double)rand() - RAND_MAX / 2,
+                 LEN1 _L, LEN2 _L, LEN3 _L);
+  std::cout << "|  sort (by key)      |";
+  RADIX_BY_KEY_DO_TEST(false, LEN1 _L);
+  RADIX_BY_KEY_DO_TEST(false, LEN2 _L);
+  RADIX_BY_KEY_DO_TEST(false, LEN3 _L);
+  std::cout << std::endl << "|  radix (by key)     |";
+  RADIX_BY_KEY_DO_TEST(true, LEN1 _L);
+  RADIX_BY_KEY_DO_TEST(true, LEN2 _L);
+  RADIX_BY_KEY_DO_TEST(true, LEN3 _L);
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|     algorithm       |";
+  TEST_LEN(LEN1 _S, LEN2 _S, LEN3 _S, WIDE);
+  RADIX_SORT_ROW("|  sort (string)      |", sort, std::string, radix_test_word(),
+                 LEN1 _S, LEN2 _S, LEN3 _S);
+  RADIX_SORT_ROW("|  radix (string)     |", radix_sort, std::string, radix_test_word(),
+                 LEN1 _S, LEN2 _S, LEN3 _S);
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[---------------- End algorithm test : radix_sort --------------]" << std::endl;
+}
+
+} // namespace radix_sort_test
+} // namespace test
+} // namespace mystl
+#endif // !TINYSTL_RADIX_SORT_TEST_H_
@@ -0,0 +1,180 @@
+#ifndef TINYSTL_RING_BUFFER_TEST_H_
+#define TINYSTL_RING_BUFFER_TEST_H_
+
+// ring buffer test : 测试 ring_buffer 的接口, 以及作为 queue 底层容器时与 list, deque 的性能对比
+
+#include <queue>
+
+#include "../TinySTL/ring_buffer.h"
+#include "../TinySTL/deque.h"
+#include "../TinySTL/queue.h"
+#include "../TinySTL/algo.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace ring_buffer_test
+{
+
+typedef mystl::queue<int>                               RING_TEST_LIST_QUEUE;
+typedef mystl::queue<int, mystl::deque<int>>            RING_TEST_DEQUE_QUEUE;
+typedef mystl::queue<int, mystl::ring_buffer<int>>      RING_TEST_RING_QUEUE;
+
+// ring_buffer 需要指定足够的容量, 其余底层容器缺省构造
+template <class Queue>
+inline Queue ring_test_queue()
+{
+  return Queue();
+}
+
+template <>
+inline RING_TEST_RING_QUEUE ring_test_queue<RING_TEST_RING_QUEUE>()
+{
+  return RING_TEST_RING_QUEUE(mystl::ring_buffer<int>(mystl::ring_buffer_capacity, 1024));
+}
+
+// 有界队列: 队列长度在 0 到 1000 之间往复, 共 push 和 pop 各 total 次
+#define RING_QUEUE_DO_TEST(con, total) do {                  \
+  con q = ring_test_queue<con>();                            \
+  long long sum = 0;                                         \
+  char buf[10];                                              \
+  clock_t start = clock();                                   \
+  for (size_t i = 0; i < total; i += 1000)                   \
+  {                                                          \
+    for (int k = 0; k < 1000; ++k)                           \
+      q.push(k);                                             \
+    for (int k = 0; k < 1000; ++k)                           \
+    {                                                        \
+      sum += q.front();                                      \
+      q.pop();                                               \
+    }                                                        \
+  }                                                          \
+  clock_t end = clock();                                     \
+  volatile long long sink = sum;                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n + (int)(sink & 0)); \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+// 同样的访问模式, 每次批量写入和取出 1000 个元素
+#define RING_BULK_DO_TEST(total) do {                        \
+  mystl::ring_buffer<int> rb(mystl::ring_buffer_capacity, 1024); \
+  int in[1000], out[1000];                                   \
+  for (int k = 0; k < 1000; ++k)                             \
+    in[k] = k;                                               \
+  long long sum = 0;                                         \
+  char buf[10];                                              \
+  clock_t start = clock();                                   \
+  for (size_t i = 0; i < total; i += 1000)                   \
+  {                                                          \
+    rb.push_n(in, 1000);                                     \
+    rb.pop_n(out, 1000);                                     \
+    sum += out[i % 1000];                                    \
+  }                                                          \
+  clock_t end = clock();                                     \
+  volatile long long sink = sum;                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n + (int)(sink & 0)); \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+void ring_buffer_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[--------------- Run container test : ring_buffer --------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int a[] = { 1,2,3,4,5,6 };
+  mystl::ring_buffer<int> r1(mystl::ring_buffer_capacity, 6);
+  mystl::ring_buffer<int> r2(3, 7);
+  mystl::ring_buffer<int> r3(a, a + 6);
+  mystl::ring_buffer<int> r4{ 1,2,3 };
+  mystl::ring_buffer<int> r5(r3);
+  mystl::ring_buffer<int> r6(std::move(r5));
+  mystl::circular_buffer<int> r7;
+  r7 = r4;
+
+  FUN_VALUE(r1.capacity());
+  FUN_AFTER(r1, r1.push_back(3));
+  FUN_AFTER(r1, r1.push_front(2));
+  FUN_AFTER(r1, r1.emplace_back(4));
+  FUN_AFTER(r1, r1.push_n(a, 6));
+  FUN_VALUE(r1.size());
+  FUN_VALUE(r1.full());
+  FUN_AFTER(r1, r1.pop_front());
+  FUN_AFTER(r1, r1.pop_back());
+  FUN_AFTER(r1, r1.set_overwrite(true));
+  FUN_AFTER(r1, r1.push_n(a, 4));
+  FUN_AFTER(r1, r1.push_back(9));
+  int out[8];
+  FUN_VALUE(r1.pop_n(out, 3));
+  FUN_VALUE(out[0] + out[1] + out[2]);
+  FUN_VALUE(r1.front());
+  FUN_VALUE(r1.back());
+  FUN_VALUE(r1[2]);
+  FUN_VALUE(*(r1.end() - 1));
+  FUN_VALUE(*r1.rbegin());
+  FUN_AFTER(r1, mystl::sort(r1.begin(), r1.end()));
+  FUN_AFTER(r1, r1.clear());
+  std::cout << std::boolalpha;
+  FUN_VALUE(r1.empty());
+  FUN_VALUE((r3 == r6));
+  std::cout << std::noboolalpha;
+  mystl::queue<int, mystl::ring_buffer<int>> q1(mystl::ring_buffer<int>(mystl::ring_buffer_capacity, 4));
+  q1.push(1);
+  q1.push(2);
+  q1.push(3);
+  q1.pop();
+  FUN_VALUE(q1.front());
+  FUN_VALUE(q1.size());
+  // 与其他底层容器一样, queue(n) 含有 n 个值初始化的元素
+  mystl::queue<int, mystl::ring_buffer<int>> q2(3);
+  FUN_VALUE(q2.size());
+  FUN_VALUE(q2.back());
+  // 覆盖模式下插入将被覆盖的元素自身
+  mystl::ring_buffer<std::string> r8(mystl::ring_buffer_capacity, 2);
+  r8.set_overwrite(true);
+  while (!r8.full())
+    r8.push_back(std::string(20, static_cast<char>('a' + r8.size())));
+  FUN_AFTER(r8, r8.push_back(r8.front()));
+  FUN_AFTER(r8, r8.push_front(r8.back()));
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "| bounded push + pop  |";
+  TEST_LEN(LEN1 _L, LEN2 _L, LEN3 _L, WIDE);
+  std::cout << "| queue (list)        |";
+  RING_QUEUE_DO_TEST(RING_TEST_LIST_QUEUE, LEN1 _L);
+  RING_QUEUE_DO_TEST(RING_TEST_LIST_QUEUE, LEN2 _L);
+  RING_QUEUE_DO_TEST(RING_TEST_LIST_QUEUE, LEN3 _L);
+  std::cout << "\n| queue (deque)       |";
+  RING_QUEUE_DO_TEST(RING_TEST_DEQUE_QUEUE, LEN1 _L);
+  RING_QUEUE_DO_TEST(RING_TEST_DEQUE_QUEUE, LEN2 _L);
+  RING_QUEUE_DO_TEST(RING_TEST_DEQUE_QUEUE, LEN3 _L);
+  std::cout << "\n| queue (ring_buffer) |";
+  RING_QUEUE_DO_TEST(RING_TEST_RING_QUEUE, LEN1 _L);
+  RING_QUEUE_DO_TEST(RING_TEST_RING_QUEUE, LEN2 _L);
+  RING_QUEUE_DO_TEST(RING_TEST_RING_QUEUE, LEN3 _L);
+  std::cout << "\n| push_n + pop_n      |";
+  RING_BULK_DO_TEST(LEN1 _L);
+  RING_BULK_DO_TEST(LEN2 _L);
+  RING_BULK_DO_TEST(LEN3 _L);
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[--------------- End container test : ring_buffer --------------]" << std::endl;
+}
+
+} // namespace ring_buffer_test
+} // namespace test
+} // namespace mystl
+#endif // !TINYSTL_RING_BUFFER_TEST_H_
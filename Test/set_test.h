@@ -36,6 +36,9 @@ void set_test()
   mystl::set<int> s9{ 1,2,3,4,5 };
   mystl::set<int> s10;
   s10 = { 1,2,3,4,5 };
+  int b[] = { 1,2,3,4,5 };
+  mystl::set<int> s11(mystl::sorted_unique, b, b + 5);
+  COUT(s11);
 
   for (int i = 5; i > 0; --i)
   {
@@ -75,6 +78,27 @@ void set_test()
   std::cout << std::noboolalpha;
   FUN_VALUE(s1.size());
   FUN_VALUE(s1.max_size());
+  mystl::set<int> s12{ 1,3,5,7,9 };
+  mystl::set<int> s13{ 3,4,5,6 };
+  mystl::set<int> s14{ 2,4,6,8 };
+  mystl::set<int> s15{ 4 };
+  mystl::set<int> s16;
+  FUN_AFTER(s12, s12.union_with(s13));
+  FUN_AFTER(s12, s12.intersect_with(s14));
+  FUN_AFTER(s12, s12.difference_with(s15));
+  FUN_AFTER(s9, s9.split(3, s16));
+  COUT(s16);
+  FUN_AFTER(s9, s9.join(s16));
+  // 顺序统计需要维护子树大小的节点
+  typedef mystl::set<int, mystl::less<int>, mystl::rb_tree_size_augment> rank_set;
+  rank_set s17{ 1,3,5,7,9 };
+  rank_set s18{ 2,3,4 };
+  FUN_AFTER(s17, s17.union_with(s18));
+  FUN_VALUE(*s17.find_by_order(2));
+  FUN_VALUE(s17.order_of_key(5));
+  FUN_AFTER(s17, s17.split(4, s18));
+  FUN_VALUE(*s18.find_by_order(1));
+  FUN_VALUE(s18.order_of_key(9));
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
@@ -86,6 +110,7 @@ void set_test()
   CON_TEST_P1(set<int>, emplace, rand(), LEN1 _M, LEN2 _M, LEN3 _M);
 #endif
   std::cout << std::endl;
+  RB_TREE_MEMORY_TEST(mystl::set<int>, mystl::rb_tree_node<int>, static_cast<int>(i), 10000000);
   std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
   PASSED;
 #endif
@@ -135,6 +160,9 @@ void multiset_test()
   auto first = *s1.equal_range(3).first;
   auto second = *s1.equal_range(3).second;
   std::cout << " s1.equal_range(3) : from " << first << " to " << second << std::endl;
+  mystl::multiset<int, mystl::less<int>, mystl::rb_tree_size_augment> s11(s1.begin(), s1.end());
+  FUN_VALUE(*s11.find_by_order(3));
+  FUN_VALUE(s11.order_of_key(3));
   FUN_AFTER(s1, s1.erase(s1.begin()));
   FUN_AFTER(s1, s1.erase(1));
   FUN_AFTER(s1, s1.erase(s1.begin(), s1.find(3)));
@@ -5,6 +5,7 @@
 #ifndef TINYSTL_SLIST_TEST_H
 #define TINYSTL_SLIST_TEST_H
 
+#include <forward_list>
 #include <list>
 
 #include "test.h"
@@ -98,6 +99,10 @@ namespace mystl
 #else
                 LIST_SORT_TEST(LEN1 _S, LEN2 _S, LEN3 _S);
 #endif
+                std::cout << std::endl;
+                std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+                std::cout << "|    sort (resort)    |";
+                LIST_RESORT_TEST(std::forward_list<int>, mystl::slist<int>, LEN1 _M, LEN2 _M, LEN3 _M);
                 std::cout << std::endl;
                 std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
                 PASSED;
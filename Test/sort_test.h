@@ -0,0 +1,211 @@
+#ifndef TINYSTL_SORT_TEST_H_
+#define TINYSTL_SORT_TEST_H_
+
+// sort test : 测试 pdq_sort, stable_sort, tim_sort 在各种输入模式下与 sort 的结果一致,
+// 检查 stable_sort 与 tim_sort 的稳定性, 并比较各排序的耗时
+
+#include <string>
+
+#include "../TinySTL/algo.h"
+#include "../TinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace sort_test
+{
+
+// 输入模式
+enum sort_test_pattern
+{
+  kSortRandom,       // 随机
+  kSortSorted,       // 已排序
+  kSortReverse,      // 逆序
+  kSortOrganPipe,    // 先升后降
+  kSortSawtooth,     // 多段升序
+  kSortFewUnique,    // 只有 16 种不同的值
+  kSortNearlySorted, // 已排序后随机交换少量元素
+  kSortAppend        // 已排序的数据后追加 1% 的随机数据
+};
+
+inline void sort_test_fill(mystl::vector<int>& v, int pattern)
+{
+  const size_t len = v.size();
+  for (size_t i = 0; i < len; ++i)
+  {
+    switch (pattern)
+    {
+    case kSortRandom:    v[i] = rand(); break;
+    case kSortSorted:    v[i] = (int)i; break;
+    case kSortReverse:   v[i] = (int)(len - i); break;
+    case kSortOrganPipe: v[i] = (int)(i < len / 2 ? i : len - i); break;
+    case kSortSawtooth:  v[i] = (int)(i % 1000); break;
+    case kSortFewUnique: v[i] = rand() % 16; break;
+    default:             v[i] = (int)i; break;
+    }
+  }
+  if (pattern == kSortAppend)
+  {
+    for (size_t i = len - len / 100; i < len; ++i)
+      v[i] = rand() % (int)(len + 1);
+  }
+  if (pattern == kSortNearlySorted && len > 1)
+  {
+    for (size_t k = 0; k < len / 100 + 1; ++k)
+      mystl::swap(v[rand() % len], v[rand() % len]);
+  }
+}
+
+// 检查稳定性时使用: 只按 key 比较, seq 记录原来的位置
+struct sort_test_record
+{
+  int    key;
+  size_t seq;
+};
+
+inline bool sort_test_key_less(const sort_test_record& a, const sort_test_record& b)
+{
+  return a.key < b.key;
+}
+
+inline bool sort_test_stable(const mystl::vector<sort_test_record>& v)
+{
+  for (size_t i = 1; i < v.size(); ++i)
+  {
+    if (v[i - 1].key > v[i].key || (v[i - 1].key == v[i].key && v[i - 1].seq > v[i].seq))
+      return false;
+  }
+  return true;
+}
+
+template <class T>
+bool sort_test_same(const mystl::vector<T>& a, const mystl::vector<T>& b)
+{
+  return a.size() == b.size() && mystl::equal(a.begin(), a.end(), b.begin());
+}
+
+// mode 为 sort, pdq_sort, stable_sort 或 tim_sort
+#define SORT_DO_TEST(mode, pattern, len) do {                \
+  mystl::vector<int> v(len);                                 \
+  sort_test_fill(v, pattern);                                \
+  char buf[10];                                              \
+  clock_t start = clock();                                   \
+  mystl::mode(v.begin(), v.end());                           \
+  clock_t end = clock();                                     \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define SORT_ROW(name, mode, pattern)                        \
+  std::cout << name;                                         \
+  SORT_DO_TEST(mode, pattern, LEN1 _L);                      \
+  SORT_DO_TEST(mode, pattern, LEN2 _L);                      \
+  SORT_DO_TEST(mode, pattern, LEN3 _L);                      \
+  std::cout << std::endl
+
+void sort_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------------------ Run algorithm test : sort ------------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int a[] = { 5,7,1,9,3,3,8,0,2,6 };
+  FUN_AFTER(a, mystl::pdq_sort(a, a + 10));
+  FUN_AFTER(a, mystl::pdq_sort(a, a + 10, mystl::greater<int>()));
+  std::string s[] = { "pear","apple","fig","banana","kiwi" };
+  FUN_AFTER(s, mystl::pdq_sort(s, s + 5));
+
+  // 各种模式与长度下与 sort 比较, 包括块分割 (int, less/greater) 与普通分割 (自定义比较函数)
+  bool same = true;
+  for (int pattern = kSortRandom; pattern <= kSortAppend; ++pattern)
+  {
+    for (size_t len : { (size_t)0, (size_t)1, (size_t)23, (size_t)100, (size_t)1000, (size_t)200000 })
+    {
+      mystl::vector<int> x(len);
+      sort_test_fill(x, pattern);
+      mystl::vector<int> y(x), z(x), w(x);
+      mystl::sort(x.begin(), x.end());
+      mystl::pdq_sort(y.begin(), y.end());
+      mystl::pdq_sort(z.begin(), z.end(), [](int l, int r) { return l < r; });
+      mystl::pdq_sort(w.begin(), w.end(), mystl::greater<int>());
+      mystl::reverse(w.begin(), w.end());
+      same = same && sort_test_same(x, y) && sort_test_same(x, z) && sort_test_same(x, w);
+      y = z = w = mystl::vector<int>(x.rbegin(), x.rend());
+      mystl::stable_sort(y.begin(), y.end());
+      mystl::tim_sort(z.begin(), z.end());
+      mystl::inplace_stable_sort(w.begin(), w.end(), mystl::less<int>());
+      same = same && sort_test_same(x, y) && sort_test_same(x, z) && sort_test_same(x, w);
+    }
+  }
+
+  // 稳定性: key 只有 100 种, 输入为各种模式
+  bool stable = true;
+  for (int pattern = kSortRandom; pattern <= kSortAppend; ++pattern)
+  {
+    for (size_t len : { (size_t)50, (size_t)1000, (size_t)100000 })
+    {
+      mystl::vector<int> keys(len);
+      sort_test_fill(keys, pattern);
+      mystl::vector<sort_test_record> x(len);
+      for (size_t i = 0; i < len; ++i)
+        x[i] = sort_test_record{ keys[i] % 100, i };
+      mystl::vector<sort_test_record> y(x), z(x);
+      mystl::stable_sort(x.begin(), x.end(), sort_test_key_less);
+      mystl::tim_sort(y.begin(), y.end(), sort_test_key_less);
+      mystl::inplace_stable_sort(z.begin(), z.end(), sort_test_key_less);
+      stable = stable && sort_test_stable(x) && sort_test_stable(y) && sort_test_stable(z);
+    }
+  }
+  std::cout << std::boolalpha;
+  FUN_VALUE(same);
+  FUN_VALUE(stable);
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|        sort         |";
+  TEST_LEN(LEN1 _L, LEN2 _L, LEN3 _L, WIDE);
+  SORT_ROW("|  random      (sort) |", sort, kSortRandom);
+  SORT_ROW("|  random       (pdq) |", pdq_sort, kSortRandom);
+  SORT_ROW("|  sorted      (sort) |", sort, kSortSorted);
+  SORT_ROW("|  sorted       (pdq) |", pdq_sort, kSortSorted);
+  SORT_ROW("|  reverse     (sort) |", sort, kSortReverse);
+  SORT_ROW("|  reverse      (pdq) |", pdq_sort, kSortReverse);
+  SORT_ROW("|  organ pipe  (sort) |", sort, kSortOrganPipe);
+  SORT_ROW("|  organ pipe   (pdq) |", pdq_sort, kSortOrganPipe);
+  SORT_ROW("|  sawtooth    (sort) |", sort, kSortSawtooth);
+  SORT_ROW("|  sawtooth     (pdq) |", pdq_sort, kSortSawtooth);
+  SORT_ROW("|  few unique  (sort) |", sort, kSortFewUnique);
+  SORT_ROW("|  few unique   (pdq) |", pdq_sort, kSortFewUnique);
+  SORT_ROW("|  nearly sort (sort) |", sort, kSortNearlySorted);
+  SORT_ROW("|  nearly sort  (pdq) |", pdq_sort, kSortNearlySorted);
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|     stable sort     |";
+  TEST_LEN(LEN1 _L, LEN2 _L, LEN3 _L, WIDE);
+  SORT_ROW("|  random    (stable) |", stable_sort, kSortRandom);
+  SORT_ROW("|  random       (tim) |", tim_sort, kSortRandom);
+  SORT_ROW("|  sorted    (stable) |", stable_sort, kSortSorted);
+  SORT_ROW("|  sorted       (tim) |", tim_sort, kSortSorted);
+  SORT_ROW("|  reverse   (stable) |", stable_sort, kSortReverse);
+  SORT_ROW("|  reverse      (tim) |", tim_sort, kSortReverse);
+  SORT_ROW("|  sawtooth  (stable) |", stable_sort, kSortSawtooth);
+  SORT_ROW("|  sawtooth     (tim) |", tim_sort, kSortSawtooth);
+  SORT_ROW("|  append 1%   (sort) |", sort, kSortAppend);
+  SORT_ROW("|  append 1% (stable) |", stable_sort, kSortAppend);
+  SORT_ROW("|  append 1%    (tim) |", tim_sort, kSortAppend);
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[------------------ End algorithm test : sort ------------------]" << std::endl;
+}
+
+} // namespace sort_test
+} // namespace test
+} // namespace mystl
+#endif // !TINYSTL_SORT_TEST_H_
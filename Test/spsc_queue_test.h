@@ -0,0 +1,309 @@
+#ifndef TINYSTL_SPSC_QUEUE_TEST_H_
+#define TINYSTL_SPSC_QUEUE_TEST_H_
+
+// spsc queue test : 测试 spsc_queue 的接口和生产者消费者之间的顺序
+// 并与 std::mutex 保护的 queue 比较两个绑定到不同核心的线程间的吞吐量 (每秒操作数) 和往返延迟
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "../TinySTL/queue.h"
+#include "../TinySTL/spsc_queue.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace spsc_queue_test
+{
+
+// 把当前线程绑定到第 cpu 个核心上 (对核心数取模), 不支持时什么也不做
+// 只在测试新建的线程中调用, 主线程的绑定保持不变
+inline void spsc_test_pin(unsigned cpu)
+{
+  const unsigned n = std::thread::hardware_concurrency();
+  if (n != 0)
+    cpu %= n;
+#if defined(_WIN32)
+  SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu);
+#elif defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+  (void)cpu;
+#endif
+}
+
+// 加锁的有界队列, 作为对照
+class spsc_test_locked_queue
+{
+  std::mutex          m_;
+  mystl::queue<int>   q_;
+  size_t              cap_;
+public:
+  explicit spsc_test_locked_queue(size_t cap) : cap_(cap) {}
+  bool try_push(int v)
+  {
+    std::lock_guard<std::mutex> guard(m_);
+    if (q_.size() == cap_)
+      return false;
+    q_.push(v);
+    return true;
+  }
+  bool try_pop(int& v)
+  {
+    std::lock_guard<std::mutex> guard(m_);
+    if (q_.empty())
+      return false;
+    v = q_.front();
+    q_.pop();
+    return true;
+  }
+};
+
+// 批量接口每次处理的元素个数
+const size_t kSpscBatch = 32;
+
+template <class Queue>
+inline void spsc_test_push(Queue& q, int v)
+{
+  while (!q.try_push(v))
+    std::this_thread::yield();
+}
+
+template <class Queue>
+inline int spsc_test_pop(Queue& q)
+{
+  int v;
+  while (!q.try_pop(v))
+    std::this_thread::yield();
+  return v;
+}
+
+// 生产者向消费者传递 total 个整数, 返回每秒操作数 (百万)
+template <class Queue>
+inline double spsc_test_throughput(size_t total)
+{
+  Queue q(1024);
+  long long sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  std::thread consumer([&] {
+    spsc_test_pin(1);
+    for (size_t i = 0; i < total; ++i)
+      sum += spsc_test_pop(q);
+  });
+  std::thread producer([&] {
+    spsc_test_pin(0);
+    for (size_t i = 0; i < total; ++i)
+      spsc_test_push(q, (int)i);
+  });
+  producer.join();
+  consumer.join();
+  auto end = std::chrono::steady_clock::now();
+  volatile long long sink = sum;
+  (void)sink;
+  double sec = std::chrono::duration<double>(end - start).count();
+  return total / sec / 1e6;
+}
+
+// 同上, 使用 push_n / pop_n 每批传递 kSpscBatch 个
+inline double spsc_test_batch_throughput(size_t total)
+{
+  mystl::spsc_queue<int> q(1024);
+  long long sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  std::thread consumer([&] {
+    spsc_test_pin(1);
+    int buf[kSpscBatch];
+    for (size_t got = 0; got < total; )
+    {
+      size_t n = q.pop_n(buf, kSpscBatch);
+      if (n == 0)
+        std::this_thread::yield();
+      for (size_t k = 0; k < n; ++k)
+        sum += buf[k];
+      got += n;
+    }
+  });
+  std::thread producer([&] {
+    spsc_test_pin(0);
+    int buf[kSpscBatch];
+    for (size_t sent = 0; sent < total; )
+    {
+      size_t n = mystl::min(kSpscBatch, total - sent);
+      for (size_t k = 0; k < n; ++k)
+        buf[k] = (int)(sent + k);
+      size_t done = 0;
+      while (done < n)
+      {
+        size_t w = q.push_n(buf + done, n - done);
+        if (w == 0)
+          std::this_thread::yield();
+        done += w;
+      }
+      sent += n;
+    }
+  });
+  producer.join();
+  consumer.join();
+  auto end = std::chrono::steady_clock::now();
+  volatile long long sink = sum;
+  (void)sink;
+  double sec = std::chrono::duration<double>(end - start).count();
+  return total / sec / 1e6;
+}
+
+// 两个队列来回传递一个整数 rounds 次, 返回平均往返时间 (纳秒)
+template <class Queue>
+inline double spsc_test_round_trip(size_t rounds)
+{
+  Queue ping(64), pong(64);
+  auto start = std::chrono::steady_clock::now();
+  std::thread echo([&] {
+    spsc_test_pin(1);
+    for (size_t i = 0; i < rounds; ++i)
+      spsc_test_push(pong, spsc_test_pop(ping) + 1);
+  });
+  std::thread driver([&] {
+    spsc_test_pin(0);
+    int v = 0;
+    for (size_t i = 0; i < rounds; ++i)
+    {
+      spsc_test_push(ping, v);
+      v = spsc_test_pop(pong);
+    }
+  });
+  driver.join();
+  echo.join();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / rounds;
+}
+
+#define SPSC_RATE_OUT(expr, unit) do {                       \
+  char buf[20];                                              \
+  std::snprintf(buf, sizeof(buf), "%.1f", (double)(expr));   \
+  std::string t = buf;                                       \
+  t += unit;                                                 \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+void spsc_queue_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[--------------- Run container test : spsc_queue ---------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::spsc_queue<int> q1(3);
+  int a[] = { 1,2,3,4,5 };
+  int out[5] = { 0 };
+  int v = 0;
+  FUN_VALUE(q1.capacity());
+  FUN_VALUE(q1.try_push(1));
+  FUN_VALUE(q1.push_n(a + 1, 4));
+  FUN_VALUE(q1.try_push(6));
+  FUN_VALUE(q1.size());
+  FUN_VALUE(*q1.front());
+  q1.pop();
+  FUN_VALUE(q1.try_pop(v));
+  FUN_VALUE(v);
+  FUN_VALUE(q1.pop_n(out, 5));
+  FUN_VALUE(out[0] * 10 + out[1]);
+  std::cout << std::boolalpha;
+  FUN_VALUE(q1.empty());
+  FUN_VALUE(q1.try_pop(v));
+
+  // 生产者交替使用单个和批量写入, 消费者交替使用单个和批量读出, 检查顺序
+  const int kTotal = 1000000;
+  mystl::spsc_queue<int> q2(256);
+  std::atomic<int> errors(0);
+  std::thread producer([&] {
+    int buf[kSpscBatch];
+    for (int i = 0; i < kTotal; )
+    {
+      if (i % 3 == 0)
+      {
+        spsc_test_push(q2, i++);
+        continue;
+      }
+      int n = mystl::min((int)kSpscBatch, kTotal - i);
+      for (int k = 0; k < n; ++k)
+        buf[k] = i + k;
+      size_t w = q2.push_n(buf, n);
+      if (w == 0)
+        std::this_thread::yield();
+      i += (int)w;
+    }
+  });
+  int buf[kSpscBatch];
+  for (int i = 0; i < kTotal; )
+  {
+    if (i % 2 == 0)
+    {
+      if (spsc_test_pop(q2) != i++)
+        ++errors;
+      continue;
+    }
+    size_t n = q2.pop_n(buf, kSpscBatch);
+    if (n == 0)
+      std::this_thread::yield();
+    for (size_t k = 0; k < n; ++k)
+    {
+      if (buf[k] != i++)
+        ++errors;
+    }
+  }
+  producer.join();
+  FUN_VALUE((errors == 0 && q2.empty()));
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|  throughput (M/s)   |";
+  TEST_LEN(LEN1, LEN2, LEN3, WIDE);
+  std::cout << "|   queue + mutex     |";
+  SPSC_RATE_OUT(spsc_test_throughput<spsc_test_locked_queue>(LEN1), "M/s  |");
+  SPSC_RATE_OUT(spsc_test_throughput<spsc_test_locked_queue>(LEN2), "M/s  |");
+  SPSC_RATE_OUT(spsc_test_throughput<spsc_test_locked_queue>(LEN3), "M/s  |");
+  std::cout << "\n|     spsc_queue      |";
+  SPSC_RATE_OUT(spsc_test_throughput<mystl::spsc_queue<int>>(LEN1), "M/s  |");
+  SPSC_RATE_OUT(spsc_test_throughput<mystl::spsc_queue<int>>(LEN2), "M/s  |");
+  SPSC_RATE_OUT(spsc_test_throughput<mystl::spsc_queue<int>>(LEN3), "M/s  |");
+  std::cout << "\n|  spsc_queue (x32)   |";
+  SPSC_RATE_OUT(spsc_test_batch_throughput(LEN1), "M/s  |");
+  SPSC_RATE_OUT(spsc_test_batch_throughput(LEN2), "M/s  |");
+  SPSC_RATE_OUT(spsc_test_batch_throughput(LEN3), "M/s  |");
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "| round trip (ns)     |";
+  TEST_LEN(LEN1 _SS, LEN2 _SS, LEN3 _SS, WIDE);
+  std::cout << "|   queue + mutex     |";
+  SPSC_RATE_OUT(spsc_test_round_trip<spsc_test_locked_queue>(LEN1 _SS), "ns   |");
+  SPSC_RATE_OUT(spsc_test_round_trip<spsc_test_locked_queue>(LEN2 _SS), "ns   |");
+  SPSC_RATE_OUT(spsc_test_round_trip<spsc_test_locked_queue>(LEN3 _SS), "ns   |");
+  std::cout << "\n|     spsc_queue      |";
+  SPSC_RATE_OUT(spsc_test_round_trip<mystl::spsc_queue<int>>(LEN1 _SS), "ns   |");
+  SPSC_RATE_OUT(spsc_test_round_trip<mystl::spsc_queue<int>>(LEN2 _SS), "ns   |");
+  SPSC_RATE_OUT(spsc_test_round_trip<mystl::spsc_queue<int>>(LEN3 _SS), "ns   |");
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[--------------- End container test : spsc_queue ---------------]" << std::endl;
+}
+
+} // namespace spsc_queue_test
+} // namespace test
+} // namespace mystl
+#endif // !TINYSTL_SPSC_QUEUE_TEST_H_
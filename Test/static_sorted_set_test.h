@@ -0,0 +1,216 @@
+#ifndef TINYSTL_STATIC_SORTED_SET_TEST_H_
+#define TINYSTL_STATIC_SORTED_SET_TEST_H_
+
+// static sorted set test : 测试 static_sorted_set 的接口, 与 std::set 对比随机查找的结果
+// 并与有序 vector 上的 lower_bound 以及 set::find 比较随机查找的性能
+
+#include <set>
+#include <vector>
+
+#include "../TinySTL/algo.h"
+#include "../TinySTL/set.h"
+#include "../TinySTL/vector.h"
+#include "../TinySTL/static_sorted_set.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace static_sorted_set_test
+{
+
+typedef mystl::set<int, mystl::less<int>>     SORTED_TEST_SET;
+typedef mystl::static_sorted_set<int>         SORTED_TEST_STATIC;
+
+// 偶数 0, 2, ..., 2 * (count - 1) 作为元素, 查找 count 个随机数, 约一半命中
+#define SORTED_SEARCH_DO_TEST(con, count, build, query) do { \
+  std::vector<int> keys(count), qs(count);                   \
+  for (size_t i = 0; i < count; ++i)                         \
+    keys[i] = (int)(2 * i);                                  \
+  con c = build(keys);                                       \
+  srand((int)time(0));                                       \
+  for (size_t i = 0; i < count; ++i)                         \
+    qs[i] = (int)(((size_t)rand() * RAND_MAX + rand()) % (2 * count)); \
+  char buf[10];                                              \
+  clock_t start = clock();                                   \
+  size_t hit = query(c, qs);                                 \
+  clock_t end = clock();                                     \
+  volatile size_t sink = hit;                                \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n + (int)(sink & 0)); \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+inline mystl::vector<int> sorted_test_build_vector(const std::vector<int>& keys)
+{
+  mystl::vector<int> v;
+  for (auto k : keys)
+    v.push_back(k);
+  return v;
+}
+
+inline SORTED_TEST_SET sorted_test_build_set(const std::vector<int>& keys)
+{
+  SORTED_TEST_SET s;
+  for (auto k : keys)
+    s.insert(k);
+  return s;
+}
+
+inline SORTED_TEST_STATIC sorted_test_build_static(const std::vector<int>& keys)
+{
+  return SORTED_TEST_STATIC(keys.begin(), keys.end());
+}
+
+inline size_t sorted_test_lower_bound(const mystl::vector<int>& v, const std::vector<int>& qs)
+{
+  size_t hit = 0;
+  for (auto q : qs)
+  {
+    auto it = mystl::lower_bound(v.begin(), v.end(), q);
+    hit += it != v.end() && *it == q;
+  }
+  return hit;
+}
+
+inline size_t sorted_test_set_find(const SORTED_TEST_SET& s, const std::vector<int>& qs)
+{
+  size_t hit = 0;
+  for (auto q : qs)
+    hit += s.find(q) != s.end();
+  return hit;
+}
+
+inline size_t sorted_test_contains(const SORTED_TEST_STATIC& s, const std::vector<int>& qs)
+{
+  size_t hit = 0;
+  for (auto q : qs)
+    hit += s.contains(q);
+  return hit;
+}
+
+inline size_t sorted_test_contains_batch(const SORTED_TEST_STATIC& s, const std::vector<int>& qs)
+{
+  std::vector<char> res(qs.size());
+  s.contains_batch(qs.begin(), qs.end(), res.begin());
+  size_t hit = 0;
+  for (auto r : res)
+    hit += r;
+  return hit;
+}
+
+#define SORTED_COUT(s) do {                                  \
+  std::string s_name = #s;                                   \
+  std::cout << " " << s_name << " :";                        \
+  for (auto it = s.begin(); it != s.end(); ++it)             \
+    std::cout << " " << *it;                                 \
+  std::cout << std::endl;                                    \
+} while(0)
+
+void static_sorted_set_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------------ Run container test : static_sorted_set -----------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int a[] = { 1,3,3,5,7,9,11,13,15,17 };
+  mystl::static_sorted_set<int> s1(a, a + 10);
+  mystl::set<int> st{ 4,8,2,6 };
+  mystl::static_sorted_set<int> s2(st);
+  mystl::static_sorted_set<int> s3{ 2,4,6,8 };
+  SORTED_COUT(s1);
+  SORTED_COUT(s2);
+  FUN_VALUE(s1.size());
+  FUN_VALUE(s1.contains(7));
+  FUN_VALUE(s1.contains(8));
+  FUN_VALUE(s1.count(3));
+  FUN_VALUE(*s1.lower_bound(8));
+  FUN_VALUE(*s1.upper_bound(9));
+  FUN_VALUE(*s1.rbegin());
+  FUN_VALUE(*--s1.find(11));
+  FUN_VALUE((s1.lower_bound(18) == s1.end()));
+  FUN_VALUE((s2 == s3));
+  int qs[] = { 0,1,2,16,17,18 };
+  bool found[6];
+  s1.contains_batch(qs, qs + 6, found);
+  std::cout << " s1.contains_batch({ 0,1,2,16,17,18 }) :";
+  for (auto f : found)
+    std::cout << " " << f;
+  std::cout << std::endl;
+
+  // 与 std::set 对比不同大小下的 lower_bound、upper_bound、批量查询与正反向遍历
+  bool same = true;
+  srand(42);
+  for (int n = 0; n < 300 && same; ++n)
+  {
+    std::set<int> ref;
+    while ((int)ref.size() < n)
+      ref.insert(rand() % (4 * n));
+    mystl::static_sorted_set<int> s(ref.begin(), ref.end());
+    std::vector<int> q;
+    for (int x = -1; x <= 4 * n; ++x)
+      q.push_back(x);
+    std::vector<mystl::static_sorted_set<int>::iterator> lbs(q.size());
+    s.lower_bound_batch(q.begin(), q.end(), lbs.begin());
+    for (size_t i = 0; i < q.size(); ++i)
+    {
+      auto lb = s.lower_bound(q[i]);
+      auto ub = s.upper_bound(q[i]);
+      auto rlb = ref.lower_bound(q[i]);
+      auto rub = ref.upper_bound(q[i]);
+      same = same && lb == lbs[i] && s.contains(q[i]) == (ref.count(q[i]) == 1)
+        && (lb == s.end() ? rlb == ref.end() : rlb != ref.end() && *lb == *rlb)
+        && (ub == s.end() ? rub == ref.end() : rub != ref.end() && *ub == *rub);
+    }
+    auto it = s.begin();
+    for (auto x : ref)
+    {
+      same = same && it != s.end() && *it == x;
+      if (!same)
+        break;
+      ++it;
+    }
+    same = same && it == s.end() && s.size() == ref.size();
+    auto rit = s.rbegin();
+    for (auto x = ref.rbegin(); x != ref.rend() && same; ++x, ++rit)
+      same = *rit == *x;
+  }
+  std::cout << std::boolalpha;
+  FUN_VALUE(same);
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|       search        |";
+  TEST_LEN(LEN1 _S, LEN2 _S, LEN3 _S, WIDE);
+  std::cout << "|    lower_bound      |";
+  SORTED_SEARCH_DO_TEST(mystl::vector<int>, LEN1 _S, sorted_test_build_vector, sorted_test_lower_bound);
+  SORTED_SEARCH_DO_TEST(mystl::vector<int>, LEN2 _S, sorted_test_build_vector, sorted_test_lower_bound);
+  SORTED_SEARCH_DO_TEST(mystl::vector<int>, LEN3 _S, sorted_test_build_vector, sorted_test_lower_bound);
+  std::cout << "\n|      set::find      |";
+  SORTED_SEARCH_DO_TEST(SORTED_TEST_SET, LEN1 _S, sorted_test_build_set, sorted_test_set_find);
+  SORTED_SEARCH_DO_TEST(SORTED_TEST_SET, LEN2 _S, sorted_test_build_set, sorted_test_set_find);
+  SORTED_SEARCH_DO_TEST(SORTED_TEST_SET, LEN3 _S, sorted_test_build_set, sorted_test_set_find);
+  std::cout << "\n| static_sorted_set   |";
+  SORTED_SEARCH_DO_TEST(SORTED_TEST_STATIC, LEN1 _S, sorted_test_build_static, sorted_test_contains);
+  SORTED_SEARCH_DO_TEST(SORTED_TEST_STATIC, LEN2 _S, sorted_test_build_static, sorted_test_contains);
+  SORTED_SEARCH_DO_TEST(SORTED_TEST_STATIC, LEN3 _S, sorted_test_build_static, sorted_test_contains);
+  std::cout << "\n| static (batched)    |";
+  SORTED_SEARCH_DO_TEST(SORTED_TEST_STATIC, LEN1 _S, sorted_test_build_static, sorted_test_contains_batch);
+  SORTED_SEARCH_DO_TEST(SORTED_TEST_STATIC, LEN2 _S, sorted_test_build_static, sorted_test_contains_batch);
+  SORTED_SEARCH_DO_TEST(SORTED_TEST_STATIC, LEN3 _S, sorted_test_build_static, sorted_test_contains_batch);
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[------------ End container test : static_sorted_set -----------]" << std::endl;
+}
+
+} // namespace static_sorted_set_test
+} // namespace test
+} // namespace mystl
+#endif // !TINYSTL_STATIC_SORTED_SET_TEST_H_
@@ -631,6 +631,28 @@ void test_len(size_t len1, size_t len2, size_t len3, size_t wide)
   std::cout << std::setw(WIDE) << t;                         \
 } while(0)
 
+// 先排序一次打乱节点在内存中的顺序, 重新赋值后再计时, 模拟长期使用后的链表
+#define LIST_RESORT_DO_TEST(con, len) do {                   \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  con l;                                                     \
+  char buf[10];                                              \
+  for (size_t i = 0; i < len; ++i)                           \
+    l.push_front(rand());                                    \
+  l.sort();                                                  \
+  for (auto& x : l)                                          \
+    x = rand();                                              \
+  start = clock();                                           \
+  l.sort();                                                  \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
 #define MAP_EMPLACE_DO_TEST(mode, con, count) do {           \
   srand((int)time(0));                                       \
   clock_t start, end;                                        \
@@ -693,6 +715,53 @@ void test_len(size_t len1, size_t len2, size_t len3, size_t wide)
   LIST_SORT_DO_TEST(mystl, len2);                            \
   LIST_SORT_DO_TEST(mystl, len3);
 
+#define LIST_RESORT_TEST(std_con, my_con, len1, len2, len3) \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|         std         |";                    \
+  LIST_RESORT_DO_TEST(std_con, len1);                        \
+  LIST_RESORT_DO_TEST(std_con, len2);                        \
+  LIST_RESORT_DO_TEST(std_con, len3);                        \
+  std::cout << "\n|        mystl        |";                  \
+  LIST_RESORT_DO_TEST(my_con, len1);                         \
+  LIST_RESORT_DO_TEST(my_con, len2);                         \
+  LIST_RESORT_DO_TEST(my_con, len3);
+
+// 红黑树容器插入 count 个元素后的内存占用: 单个节点大小和全部节点的总量
+// 总量按 sizeof(节点) 乘以节点个数 (含头节点) 估算, 即向分配器申请的字节数, 不计 malloc 自身的开销
+// baseline 一行为改动前的节点布局 (单独的颜色字段加三个指针) 在相同元素个数下的占用, 用于对比
+#define RB_TREE_MEMORY_TEST(con, node, value, count) do {   \
+  struct baseline_node                                       \
+  {                                                          \
+    bool  color;                                             \
+    void* parent;                                            \
+    void* left;                                              \
+    void* right;                                             \
+    con::value_type value_field;                             \
+  };                                                         \
+  con c;                                                     \
+  char buf[20];                                              \
+  for (size_t i = 0; i < count; ++i)                         \
+    c.insert(c.end(), value);                                \
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl; \
+  std::cout << "|       memory        |   elements  |  node size  |    total    |" << std::endl; \
+  std::cout << "|       baseline      |";                    \
+  std::snprintf(buf, sizeof(buf), "%d   |", (int)c.size());  \
+  std::cout << std::setw(WIDE) << buf;                       \
+  std::snprintf(buf, sizeof(buf), "%dB    |", (int)sizeof(baseline_node)); \
+  std::cout << std::setw(WIDE) << buf;                       \
+  std::snprintf(buf, sizeof(buf), "%dMB    |",               \
+      (int)((c.size() + 1) * sizeof(baseline_node) >> 20));  \
+  std::cout << std::setw(WIDE) << buf << std::endl;          \
+  std::cout << "|        mystl        |";                    \
+  std::snprintf(buf, sizeof(buf), "%d   |", (int)c.size());  \
+  std::cout << std::setw(WIDE) << buf;                       \
+  std::snprintf(buf, sizeof(buf), "%dB    |", (int)sizeof(node)); \
+  std::cout << std::setw(WIDE) << buf;                       \
+  std::snprintf(buf, sizeof(buf), "%dMB    |",               \
+      (int)((c.size() + 1) * sizeof(node) >> 20));           \
+  std::cout << std::setw(WIDE) << buf << std::endl;          \
+} while(0)
+
 // 简单测试的宏定义
 #define TEST(testcase_name) \
   MYTINYSTL_TEST_(testcase_name)
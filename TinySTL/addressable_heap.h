@@ -0,0 +1,607 @@
+#ifndef TINYSTL_ADDRESSABLE_HEAP_H
+#define TINYSTL_ADDRESSABLE_HEAP_H
+
+// 这个头文件包含两个可寻址的优先队列 indexed_heap 与 pairing_heap
+// push 返回一个句柄 (handle), 元素留在队列中时句柄一直有效, 可以通过句柄读取、修改 (update)、删除 (erase) 元素
+// 与 priority_queue 一样, Compare 缺省为 mystl::less, top 为最大的元素; 使用 mystl::greater 时为小顶堆,
+// 此时用较小的值 update 即为 decrease-key
+//
+// indexed_heap: 二叉堆, 堆数组中存放元素与槽位编号, 每个槽位记录元素在堆数组中的位置, 句柄即槽位编号
+//   push / pop / update / erase 为 O(log n), 删除后的槽位会被之后的 push 复用
+//   meld 把另一个堆的元素移入, 对方的句柄加上返回的偏移量后在本堆中继续有效
+// pairing_heap: 配对堆, 每个元素是一个单独分配的结点, 句柄即结点指针
+//   push / meld 为 O(1), 向堆顶方向的 update 均摊 O(log log n) 以下, pop / erase 均摊 O(log n)
+//   meld 之后对方的句柄在本堆中仍然有效
+//
+// notes:
+// 比较函数不应抛出异常, 否则 pairing_heap 的结构可能不完整
+
+#include <initializer_list>
+
+#include "vector.h"
+#include "memory.h"
+#include "functional.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+    /*****************************************************************************************/
+    // 模板类 indexed_heap
+    // 第一个模板参数表示数据类型, 第二个模板参数表示元素优先级的判定方式
+    // 元素与槽位编号一起存放在堆数组中, 调整时比较的都是连续存放的元素; pos_ 记录每个槽位在堆数组中的下标
+    /*****************************************************************************************/
+    template <class T, class Compare = mystl::less<T>>
+    class indexed_heap
+    {
+    public:
+        typedef T                   value_type;
+        typedef Compare             value_compare;
+        typedef size_t              size_type;
+        typedef size_t              handle_type;
+        typedef T&                  reference;
+        typedef const T&            const_reference;
+
+        static constexpr size_type npos = static_cast<size_type>(-1);
+
+    private:
+        struct entry
+        {
+            T           value;
+            handle_type slot;
+        };
+
+        mystl::vector<entry>      heap_;    // 按堆序存放的元素
+        mystl::vector<size_type>  pos_;     // 槽位在 heap_ 中的下标, 槽位空闲时为 npos
+        mystl::vector<size_type>  free_;    // 空闲的槽位
+        value_compare             comp_;
+
+    public:
+        indexed_heap() = default;
+
+        explicit indexed_heap(const Compare& comp)
+            : comp_(comp)
+        {
+        }
+
+        // 句柄依次为 0, 1, 2, ...
+        template <class Iter>
+        indexed_heap(Iter first, Iter last, const Compare& comp = Compare())
+            : comp_(comp)
+        {
+            for (; first != last; ++first)
+            {
+                pos_.push_back(heap_.size());
+                heap_.push_back(entry{ *first, heap_.size() });
+            }
+            rebuild();
+        }
+
+        indexed_heap(std::initializer_list<T> ilist, const Compare& comp = Compare())
+            : indexed_heap(ilist.begin(), ilist.end(), comp)
+        {
+        }
+
+    public:
+        // 容量相关操作
+        bool      empty() const noexcept { return heap_.empty(); }
+        size_type size()  const noexcept { return heap_.size(); }
+
+        void reserve(size_type n)
+        {
+            heap_.reserve(n);
+            pos_.reserve(n);
+        }
+
+        // 访问元素相关操作
+        const_reference top()        const { return heap_.front().value; }
+        handle_type     top_handle() const { return heap_.front().slot; }
+
+        const_reference value(handle_type h) const { return heap_[pos_[h]].value; }
+
+        // 句柄对应的元素是否还在堆中
+        bool contains(handle_type h) const noexcept
+        { return h < pos_.size() && pos_[h] != npos; }
+
+    public:
+        handle_type push(const value_type& value)
+        {
+            return insert_entry(value);
+        }
+
+        handle_type push(value_type&& value)
+        {
+            return insert_entry(mystl::move(value));
+        }
+
+        template <class ...Args>
+        handle_type emplace(Args&& ...args)
+        {
+            return insert_entry(value_type(mystl::forward<Args>(args)...));
+        }
+
+        void pop()
+        {
+            erase(heap_.front().slot);
+        }
+
+        // 修改元素的值, 然后向上或向下调整它的位置
+        void update(handle_type h, const value_type& value)
+        {
+            heap_[pos_[h]].value = value;
+            fix(pos_[h]);
+        }
+
+        void update(handle_type h, value_type&& value)
+        {
+            heap_[pos_[h]].value = mystl::move(value);
+            fix(pos_[h]);
+        }
+
+        // 删除句柄对应的元素, 用堆数组的最后一个元素填补它的位置
+        void erase(handle_type h)
+        {
+            free_.push_back(h);
+            const size_type i = pos_[h];
+            pos_[h] = npos;
+            if (i + 1 != heap_.size())
+            {
+                heap_[i] = mystl::move(heap_.back());
+                pos_[heap_[i].slot] = i;
+                heap_.pop_back();
+                fix(i);
+            }
+            else
+            {
+                heap_.pop_back();
+            }
+        }
+
+        // 把 other 的元素全部移入本堆, other 变为空
+        // 返回偏移量: other 中的句柄 h 在本堆中为 h + 偏移量
+        size_type meld(indexed_heap& other)
+        {
+            if (this == &other)
+                return 0;
+            const size_type offset = pos_.size();
+            const size_type old_size = heap_.size();
+            heap_.reserve(old_size + other.heap_.size());
+            pos_.reserve(offset + other.pos_.size());
+            for (size_type h = 0; h < other.pos_.size(); ++h)
+                pos_.push_back(npos);
+            for (auto& e : other.heap_)
+            {
+                pos_[offset + e.slot] = heap_.size();
+                heap_.push_back(entry{ mystl::move(e.value), offset + e.slot });
+            }
+            for (auto h : other.free_)
+                free_.push_back(offset + h);
+            other.clear();
+            // 移入的元素较多时整体重建, 否则逐个上溯
+            if ((heap_.size() - old_size) * 4 > old_size)
+            {
+                rebuild();
+            }
+            else
+            {
+                for (size_type i = old_size; i < heap_.size(); ++i)
+                    sift_up(i);
+            }
+            return offset;
+        }
+
+        void clear()
+        {
+            heap_.clear();
+            pos_.clear();
+            free_.clear();
+        }
+
+        void swap(indexed_heap& rhs) noexcept
+        {
+            heap_.swap(rhs.heap_);
+            pos_.swap(rhs.pos_);
+            free_.swap(rhs.free_);
+            mystl::swap(comp_, rhs.comp_);
+        }
+
+    private:
+        template <class V>
+        handle_type insert_entry(V&& value)
+        {
+            handle_type h;
+            if (free_.empty())
+            {
+                h = pos_.size();
+                pos_.push_back(npos);
+            }
+            else
+            {
+                h = free_.back();
+                free_.pop_back();
+            }
+            pos_[h] = heap_.size();
+            heap_.push_back(entry{ mystl::forward<V>(value), h });
+            sift_up(heap_.size() - 1);
+            return h;
+        }
+
+        // 位置 i 的元素比父结点优先时上溯, 否则下溯
+        void fix(size_type i)
+        {
+            if (i > 0 && comp_(heap_[(i - 1) / 2].value, heap_[i].value))
+                sift_up(i);
+            else
+                sift_down(i);
+        }
+
+        void sift_up(size_type i)
+        {
+            entry e = mystl::move(heap_[i]);
+            while (i > 0)
+            {
+                const size_type parent = (i - 1) / 2;
+                if (!comp_(heap_[parent].value, e.value))
+                    break;
+                heap_[i] = mystl::move(heap_[parent]);
+                pos_[heap_[i].slot] = i;
+                i = parent;
+            }
+            pos_[e.slot] = i;
+            heap_[i] = mystl::move(e);
+        }
+
+        void sift_down(size_type i)
+        {
+            const size_type n = heap_.size();
+            entry e = mystl::move(heap_[i]);
+            while (true)
+            {
+                size_type child = 2 * i + 1;
+                if (child >= n)
+                    break;
+                if (child + 1 < n && comp_(heap_[child].value, heap_[child + 1].value))
+                    ++child;
+                if (!comp_(e.value, heap_[child].value))
+                    break;
+                heap_[i] = mystl::move(heap_[child]);
+                pos_[heap_[i].slot] = i;
+                i = child;
+            }
+            pos_[e.slot] = i;
+            heap_[i] = mystl::move(e);
+        }
+
+        void rebuild()
+        {
+            for (size_type i = heap_.size() / 2; i > 0; --i)
+                sift_down(i - 1);
+        }
+    };
+
+    template <class T, class Compare>
+    constexpr typename indexed_heap<T, Compare>::size_type indexed_heap<T, Compare>::npos;
+
+    template <class T, class Compare>
+    void swap(indexed_heap<T, Compare>& lhs, indexed_heap<T, Compare>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    /*****************************************************************************************/
+    // 模板类 pairing_heap
+    // 第一个模板参数表示数据类型, 第二个模板参数表示元素优先级的判定方式
+    // 结点的 child 指向第一个子结点, next 指向右边的兄弟, prev 指向左边的兄弟 (第一个子结点指向父结点)
+    /*****************************************************************************************/
+    template <class T>
+    struct pairing_heap_node
+    {
+        T                     value;
+        pairing_heap_node*    child;
+        pairing_heap_node*    next;
+        pairing_heap_node*    prev;
+    };
+
+    template <class T, class Compare = mystl::less<T>>
+    class pairing_heap
+    {
+    public:
+        typedef T                           value_type;
+        typedef Compare                     value_compare;
+        typedef size_t                      size_type;
+        typedef pairing_heap_node<T>*       handle_type;
+        typedef T&                          reference;
+        typedef const T&                    const_reference;
+
+    private:
+        typedef pairing_heap_node<T>                node_type;
+        typedef node_type*                          node_ptr;
+        typedef mystl::allocator<node_type>         node_allocator;
+        typedef mystl::allocator<T>                 data_allocator;
+
+        node_ptr      root_;
+        size_type     size_;
+        value_compare comp_;
+
+    public:
+        pairing_heap() : root_(nullptr), size_(0) {}
+
+        explicit pairing_heap(const Compare& comp)
+            : root_(nullptr), size_(0), comp_(comp)
+        {
+        }
+
+        template <class Iter>
+        pairing_heap(Iter first, Iter last, const Compare& comp = Compare())
+            : root_(nullptr), size_(0), comp_(comp)
+        {
+            try
+            {
+                for (; first != last; ++first)
+                    push(*first);
+            }
+            catch (...)
+            {
+                clear();
+                throw;
+            }
+        }
+
+        pairing_heap(std::initializer_list<T> ilist, const Compare& comp = Compare())
+            : pairing_heap(ilist.begin(), ilist.end(), comp)
+        {
+        }
+
+        // 句柄指向结点, 复制出来的堆无法沿用原来的句柄, 所以只支持移动
+        pairing_heap(const pairing_heap&) = delete;
+        pairing_heap& operator=(const pairing_heap&) = delete;
+
+        pairing_heap(pairing_heap&& rhs) noexcept
+            : root_(rhs.root_), size_(rhs.size_), comp_(rhs.comp_)
+        {
+            rhs.root_ = nullptr;
+            rhs.size_ = 0;
+        }
+
+        pairing_heap& operator=(pairing_heap&& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                clear();
+                swap(rhs);
+            }
+            return *this;
+        }
+
+        ~pairing_heap() { clear(); }
+
+    public:
+        // 容量相关操作
+        bool      empty() const noexcept { return root_ == nullptr; }
+        size_type size()  const noexcept { return size_; }
+
+        // 访问元素相关操作
+        const_reference top()        const { return root_->value; }
+        handle_type     top_handle() const { return root_; }
+
+        static const_reference value(handle_type h) { return h->value; }
+
+    public:
+        handle_type push(const value_type& value)
+        {
+            return insert_node(create_node(value));
+        }
+
+        handle_type push(value_type&& value)
+        {
+            return insert_node(create_node(mystl::move(value)));
+        }
+
+        template <class ...Args>
+        handle_type emplace(Args&& ...args)
+        {
+            return insert_node(create_node(mystl::forward<Args>(args)...));
+        }
+
+        void pop()
+        {
+            node_ptr old = root_;
+            root_ = merge_pairs(old->child);
+            --size_;
+            destroy_node(old);
+        }
+
+        // 修改元素的值:
+        // 新值不比原值落后时把以它为根的子树剪下再与根合并, 否则把它的子结点合并后重新插入
+        void update(handle_type h, const value_type& value)
+        {
+            const bool raise = !comp_(value, h->value);
+            h->value = value;
+            reposition(h, raise);
+        }
+
+        void update(handle_type h, value_type&& value)
+        {
+            const bool raise = !comp_(value, h->value);
+            h->value = mystl::move(value);
+            reposition(h, raise);
+        }
+
+        void erase(handle_type h)
+        {
+            if (h == root_)
+            {
+                pop();
+                return;
+            }
+            cut(h);
+            root_ = link(root_, merge_pairs(h->child));
+            --size_;
+            destroy_node(h);
+        }
+
+        // 把 other 的元素全部移入本堆, other 变为空, other 的句柄在本堆中仍然有效
+        void meld(pairing_heap& other)
+        {
+            if (this == &other)
+                return;
+            root_ = link(root_, other.root_);
+            size_ += other.size_;
+            other.root_ = nullptr;
+            other.size_ = 0;
+        }
+
+        // 逐个释放结点, 把子结点链拼接到待释放的链上, 不使用递归
+        void clear()
+        {
+            node_ptr p = root_;
+            while (p != nullptr)
+            {
+                if (p->child != nullptr)
+                {
+                    node_ptr last = p->child;
+                    while (last->next != nullptr)
+                        last = last->next;
+                    last->next = p->next;
+                    p->next = p->child;
+                }
+                node_ptr next = p->next;
+                destroy_node(p);
+                p = next;
+            }
+            root_ = nullptr;
+            size_ = 0;
+        }
+
+        void swap(pairing_heap& rhs) noexcept
+        {
+            mystl::swap(root_, rhs.root_);
+            mystl::swap(size_, rhs.size_);
+            mystl::swap(comp_, rhs.comp_);
+        }
+
+    private:
+        template <class ...Args>
+        node_ptr create_node(Args&& ...args)
+        {
+            node_ptr p = node_allocator::allocate(1);
+            try
+            {
+                data_allocator::construct(&p->value, mystl::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                node_allocator::deallocate(p);
+                throw;
+            }
+            p->child = p->next = p->prev = nullptr;
+            return p;
+        }
+
+        static void destroy_node(node_ptr p)
+        {
+            data_allocator::destroy(&p->value);
+            node_allocator::deallocate(p);
+        }
+
+        handle_type insert_node(node_ptr p)
+        {
+            root_ = link(root_, p);
+            ++size_;
+            return p;
+        }
+
+        // 合并两棵树, 落后的根成为优先的根的第一个子结点, 返回新的根
+        node_ptr link(node_ptr a, node_ptr b)
+        {
+            if (a == nullptr)
+                return b;
+            if (b == nullptr)
+                return a;
+            if (comp_(a->value, b->value))
+                mystl::swap(a, b);
+            b->prev = a;
+            b->next = a->child;
+            if (a->child != nullptr)
+                a->child->prev = b;
+            a->child = b;
+            a->next = a->prev = nullptr;
+            return a;
+        }
+
+        // 把以 h 为根的子树从兄弟链上摘下, h 不是根
+        void cut(node_ptr h)
+        {
+            if (h->prev->child == h)
+                h->prev->child = h->next;
+            else
+                h->prev->next = h->next;
+            if (h->next != nullptr)
+                h->next->prev = h->prev;
+            h->next = h->prev = nullptr;
+        }
+
+        // 两趟合并一条兄弟链: 从左到右两两合并, 再从右到左依次合并, 不使用递归
+        node_ptr merge_pairs(node_ptr first)
+        {
+            node_ptr pairs = nullptr;  // 第一趟的结果, 用 next 逆序相连
+            while (first != nullptr)
+            {
+                node_ptr a = first;
+                node_ptr b = a->next;
+                if (b == nullptr)
+                {
+                    a->next = pairs;
+                    pairs = a;
+                    break;
+                }
+                first = b->next;
+                node_ptr w = link(a, b);
+                w->next = pairs;
+                pairs = w;
+            }
+            node_ptr result = nullptr;
+            while (pairs != nullptr)
+            {
+                node_ptr next = pairs->next;
+                result = link(pairs, result);
+                pairs = next;
+            }
+            if (result != nullptr)
+                result->next = result->prev = nullptr;
+            return result;
+        }
+
+        void reposition(node_ptr h, bool raise)
+        {
+            if (raise)
+            {
+                if (h != root_)
+                {
+                    cut(h);
+                    root_ = link(root_, h);
+                }
+                return;
+            }
+            node_ptr children = merge_pairs(h->child);
+            h->child = nullptr;
+            if (h == root_)
+            {
+                root_ = link(children, h);
+            }
+            else
+            {
+                cut(h);
+                root_ = link(link(root_, h), children);
+            }
+        }
+    };
+
+    template <class T, class Compare>
+    void swap(pairing_heap<T, Compare>& lhs, pairing_heap<T, Compare>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+}
+
+#endif //TINYSTL_ADDRESSABLE_HEAP_H
@@ -102,13 +102,52 @@ size_t count_if(InputIter first, InputIter last, UnaryPredicate unary_pred)
 /*****************************************************************************************/
 template <class InputIter, class T>
 InputIter
-find(InputIter first, InputIter last, const T& value)
+unchecked_find(InputIter first, InputIter last, const T& value)
 {
   while (first != last && *first != value)
     ++first;
   return first;
 }
 
+template <class InputIter, class T>
+InputIter
+segmented_find(InputIter first, InputIter last, const T& value, m_false_type)
+{
+  return unchecked_find(first, last, value);
+}
+
+// 逐段查找, 每段内为指针区间
+template <class SegmentedIter, class T>
+SegmentedIter
+segmented_find(SegmentedIter first, SegmentedIter last, const T& value, m_true_type)
+{
+  typedef segmented_iterator_traits<SegmentedIter> traits;
+  auto sfirst = traits::segment(first);
+  auto slast = traits::segment(last);
+  if (sfirst == slast)
+    return traits::compose(sfirst, unchecked_find(traits::local(first), traits::local(last), value));
+  auto lend = traits::end(sfirst);
+  auto it = unchecked_find(traits::local(first), lend, value);
+  if (it != lend)
+    return traits::compose(sfirst, it);
+  for (++sfirst; sfirst != slast; ++sfirst)
+  {
+    lend = traits::end(sfirst);
+    it = unchecked_find(traits::begin(sfirst), lend, value);
+    if (it != lend)
+      return traits::compose(sfirst, it);
+  }
+  it = unchecked_find(traits::begin(slast), traits::local(last), value);
+  return it == traits::local(last) ? last : traits::compose(slast, it);
+}
+
+template <class InputIter, class T>
+InputIter
+find(InputIter first, InputIter last, const T& value)
+{
+  return segmented_find(first, last, value, is_segmented_iterator<InputIter>());
+}
+
 /*****************************************************************************************/
 // find_if
 // 在[first, last)区间内找到第一个令一元操作 unary_pred 为 true 的元素并返回指向该元素的迭代器
@@ -475,15 +514,46 @@ find_first_of(InputIter first1, InputIter last1,
 // f() 可返回一个值，但该值会被忽略
 /*****************************************************************************************/
 template <class InputIter, class Function>
-Function for_each(InputIter first, InputIter last, Function f)
+void unchecked_for_each(InputIter first, InputIter last, Function& f)
 {
   for (; first != last; ++first)
   {
     f(*first);
   }
+}
+
+template <class InputIter, class Function>
+Function segmented_for_each(InputIter first, InputIter last, Function f, m_false_type)
+{
+  unchecked_for_each(first, last, f);
   return f;
 }
 
+// 逐段处理, 每段内为指针区间上的简单循环
+template <class SegmentedIter, class Function>
+Function segmented_for_each(SegmentedIter first, SegmentedIter last, Function f, m_true_type)
+{
+  typedef segmented_iterator_traits<SegmentedIter> traits;
+  auto sfirst = traits::segment(first);
+  auto slast = traits::segment(last);
+  if (sfirst == slast)
+  {
+    unchecked_for_each(traits::local(first), traits::local(last), f);
+    return f;
+  }
+  unchecked_for_each(traits::local(first), traits::end(sfirst), f);
+  for (++sfirst; sfirst != slast; ++sfirst)
+    unchecked_for_each(traits::begin(sfirst), traits::end(sfirst), f);
+  unchecked_for_each(traits::begin(slast), traits::local(last), f);
+  return f;
+}
+
+template <class InputIter, class Function>
+Function for_each(InputIter first, InputIter last, Function f)
+{
+  return segmented_for_each(first, last, f, is_segmented_iterator<InputIter>());
+}
+
 /*****************************************************************************************/
 // adjacent_find
 // 找出第一对匹配的相邻元素，缺省使用 operator== 比较，如果找到返回一个迭代器，指向这对元素的第一个元素
@@ -1166,7 +1236,7 @@ ForwardIter max_element(ForwardIter first, ForwardIter last, Compared comp)
 // 返回一个迭代器，指向序列中最小的元素
 /*****************************************************************************************/
 template <class ForwardIter>
-ForwardIter min_elememt(ForwardIter first, ForwardIter last)
+ForwardIter min_element(ForwardIter first, ForwardIter last)
 {
   if (first == last)
     return first;
@@ -1181,7 +1251,7 @@ ForwardIter min_elememt(ForwardIter first, ForwardIter last)
 
 // 重载版本使用函数对象 comp 代替比较操作
 template <class ForwardIter, class Compared>
-ForwardIter min_elememt(ForwardIter first, ForwardIter last, Compared comp)
+ForwardIter min_element(ForwardIter first, ForwardIter last, Compared comp)
 {
   if (first == last)
     return first;
@@ -2180,7 +2250,7 @@ void partial_sort(RandomIter first, RandomIter middle,
   {
     if (*i < *first)
     {
-      mystl::pop_heap_aux(first, middle, i, *i, distance_type(first));
+      mystl::pop_heap_aux(first, middle, i, mystl::move(*i), distance_type(first));
     }
   }
   mystl::sort_heap(first, middle);
@@ -2196,7 +2266,7 @@ void partial_sort(RandomIter first, RandomIter middle,
   {
     if (comp(*i, *first))
     {
-      mystl::pop_heap_aux(first, middle, i, *i, distance_type(first), comp);
+      mystl::pop_heap_aux(first, middle, i, mystl::move(*i), distance_type(first), comp);
     }
   }
   mystl::sort_heap(first, middle, comp);
@@ -2413,8 +2483,9 @@ template <class RandomIter>
 void unchecked_insertion_sort(RandomIter first, RandomIter last)
 {
   for (auto i = first; i != last; ++i)
-  {
-    mystl::unchecked_linear_insert(i, *i);
+  { // 先取出 *i, 否则后移元素时会覆盖要插入的值
+    auto value = *i;
+    mystl::unchecked_linear_insert(i, value);
   }
 }
 
@@ -2499,7 +2570,7 @@ void intro_sort(RandomIter first, RandomIter last,
       return;
     }
     --depth_limit;
-    auto mid = mystl::median(*(first), *(first + (last - first) / 2), *(last - 1));
+    auto mid = mystl::median(*(first), *(first + (last - first) / 2), *(last - 1), comp);
     auto cut = mystl::unchecked_partition(first, last, mid, comp);
     mystl::intro_sort(cut, last, depth_limit, comp);
     last = cut;
@@ -2528,7 +2599,8 @@ void unchecked_insertion_sort(RandomIter first, RandomIter last,
 {
   for (auto i = first; i != last; ++i)
   {
-    mystl::unchecked_linear_insert(i, *i, comp);
+    auto value = *i;
+    mystl::unchecked_linear_insert(i, value, comp);
   }
 }
 
@@ -2579,6 +2651,925 @@ void sort(RandomIter first, RandomIter last, Compared comp)
   }
 }
 
+/*****************************************************************************************/
+// pdq_sort
+// pattern-defeating quicksort, 与 sort 的结果相同但不稳定, 在有序、逆序以及重复元素多的输入上更快:
+//   1. 长区间用 ninther (三组三点中值的中值) 选枢轴, 短区间用三点中值
+//   2. 枢轴与左侧相邻元素相等时, 把等于枢轴的元素全部分到左边, 重复元素多时退化为线性
+//   3. 分割极不平衡时交换几个固定位置的元素打乱模式, 多次不平衡后改用 heap sort
+//   4. 分割时没有交换任何元素则尝试有限次数的插入排序, 基本有序的区间可以提前结束
+//   5. 算术类型使用 mystl::less / mystl::greater 时, 用块分割 (BlockQuicksort):
+//      先在一块内无分支地记录需要交换的元素偏移, 再成批交换, 避免难以预测的分支
+/*****************************************************************************************/
+constexpr size_t kPdqInsertionSortThreshold = 24;   // 小于这个长度时使用插入排序
+constexpr size_t kPdqNintherThreshold       = 128;  // 超过这个长度时使用 ninther
+constexpr size_t kPdqPartialInsertionLimit  = 8;    // 部分插入排序允许移动的元素个数
+constexpr size_t kPdqBlockSize              = 64;   // 块分割每块的元素个数
+
+// 是否使用块分割
+template <class T, class Compared>
+struct pdq_use_block_partition : public m_bool_constant<std::is_arithmetic<T>::value &&
+  (std::is_same<Compared, mystl::less<T>>::value || std::is_same<Compared, mystl::greater<T>>::value)> {};
+
+template <class RandomIter, class Compared>
+void pdq_insertion_sort(RandomIter first, RandomIter last, Compared& comp)
+{
+  if (first == last)
+    return;
+  for (auto cur = first + 1; cur != last; ++cur)
+  {
+    auto sift = cur;
+    auto sift_1 = cur - 1;
+    if (comp(*sift, *sift_1))
+    {
+      auto tmp = mystl::move(*sift);
+      do
+      {
+        *sift-- = mystl::move(*sift_1);
+      } while (sift != first && comp(tmp, *--sift_1));
+      *sift = mystl::move(tmp);
+    }
+  }
+}
+
+// first 左侧的元素不大于区间内的任何元素, 可以省去边界检查
+template <class RandomIter, class Compared>
+void pdq_unguarded_insertion_sort(RandomIter first, RandomIter last, Compared& comp)
+{
+  if (first == last)
+    return;
+  for (auto cur = first + 1; cur != last; ++cur)
+  {
+    auto sift = cur;
+    auto sift_1 = cur - 1;
+    if (comp(*sift, *sift_1))
+    {
+      auto tmp = mystl::move(*sift);
+      do
+      {
+        *sift-- = mystl::move(*sift_1);
+      } while (comp(tmp, *--sift_1));
+      *sift = mystl::move(tmp);
+    }
+  }
+}
+
+// 移动的元素超过 kPdqPartialInsertionLimit 个时放弃并返回 false
+template <class RandomIter, class Compared>
+bool pdq_partial_insertion_sort(RandomIter first, RandomIter last, Compared& comp)
+{
+  if (first == last)
+    return true;
+  size_t limit = 0;
+  for (auto cur = first + 1; cur != last; ++cur)
+  {
+    auto sift = cur;
+    auto sift_1 = cur - 1;
+    if (comp(*sift, *sift_1))
+    {
+      auto tmp = mystl::move(*sift);
+      do
+      {
+        *sift-- = mystl::move(*sift_1);
+      } while (sift != first && comp(tmp, *--sift_1));
+      *sift = mystl::move(tmp);
+      limit += static_cast<size_t>(cur - sift);
+    }
+    if (limit > kPdqPartialInsertionLimit)
+      return false;
+  }
+  return true;
+}
+
+template <class RandomIter, class Compared>
+void pdq_sort2(RandomIter a, RandomIter b, Compared& comp)
+{
+  if (comp(*b, *a))
+    mystl::iter_swap(a, b);
+}
+
+template <class RandomIter, class Compared>
+void pdq_sort3(RandomIter a, RandomIter b, RandomIter c, Compared& comp)
+{
+  mystl::pdq_sort2(a, b, comp);
+  mystl::pdq_sort2(b, c, comp);
+  mystl::pdq_sort2(a, b, comp);
+}
+
+// 交换左右两块中记录的 num 对元素, 两侧个数相同时逐对交换, 否则轮换以减少移动次数
+template <class RandomIter>
+void pdq_swap_offsets(RandomIter first, RandomIter last,
+                      const unsigned char* offsets_l, const unsigned char* offsets_r,
+                      size_t num, bool use_swaps)
+{
+  if (use_swaps)
+  {
+    for (size_t i = 0; i < num; ++i)
+      mystl::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+  }
+  else if (num > 0)
+  {
+    auto l = first + offsets_l[0];
+    auto r = last - offsets_r[0];
+    auto tmp = mystl::move(*l);
+    *l = mystl::move(*r);
+    for (size_t i = 1; i < num; ++i)
+    {
+      l = first + offsets_l[i];
+      *r = mystl::move(*l);
+      r = last - offsets_r[i];
+      *l = mystl::move(*r);
+    }
+    *r = mystl::move(tmp);
+  }
+}
+
+// 以 *first 为枢轴分割, 等于枢轴的元素放在右边
+// 返回枢轴的最终位置, 以及分割前区间是否已经分好 (没有发生交换)
+template <class RandomIter, class Compared>
+mystl::pair<RandomIter, bool>
+pdq_partition_right(RandomIter first, RandomIter last, Compared& comp, m_false_type)
+{
+  auto pivot = mystl::move(*first);
+  auto begin = first;
+  while (comp(*++first, pivot));
+  if (first - 1 == begin)
+    while (first < last && !comp(*--last, pivot));
+  else
+    while (!comp(*--last, pivot));
+  const bool already_partitioned = first >= last;
+  while (first < last)
+  {
+    mystl::iter_swap(first, last);
+    while (comp(*++first, pivot));
+    while (!comp(*--last, pivot));
+  }
+  auto pivot_pos = first - 1;
+  *begin = mystl::move(*pivot_pos);
+  *pivot_pos = mystl::move(pivot);
+  return mystl::pair<RandomIter, bool>(pivot_pos, already_partitioned);
+}
+
+// 块分割版本: 每次从左右各取一块, 无分支地记录两侧放错位置的元素偏移, 再成批交换
+template <class RandomIter, class Compared>
+mystl::pair<RandomIter, bool>
+pdq_partition_right(RandomIter first, RandomIter last, Compared& comp, m_true_type)
+{
+  auto pivot = mystl::move(*first);
+  auto begin = first;
+  while (comp(*++first, pivot));
+  if (first - 1 == begin)
+    while (first < last && !comp(*--last, pivot));
+  else
+    while (!comp(*--last, pivot));
+  const bool already_partitioned = first >= last;
+  if (!already_partitioned)
+  {
+    mystl::iter_swap(first, last);
+    ++first;
+
+    alignas(64) unsigned char offsets_l[kPdqBlockSize];
+    alignas(64) unsigned char offsets_r[kPdqBlockSize];
+    auto offsets_l_base = first;
+    auto offsets_r_base = last;
+    size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+    while (first < last)
+    {
+      // 剩余元素不足两块时, 按两侧缓冲区的情况分配
+      const size_t num_unknown = static_cast<size_t>(last - first);
+      const size_t left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+      const size_t right_split = num_r == 0 ? (num_unknown - left_split) : 0;
+
+      if (left_split >= kPdqBlockSize)
+      {
+        for (size_t i = 0; i < kPdqBlockSize; ++i, ++first)
+        {
+          offsets_l[num_l] = static_cast<unsigned char>(i);
+          num_l += !comp(*first, pivot);
+        }
+      }
+      else
+      {
+        for (size_t i = 0; i < left_split; ++i, ++first)
+        {
+          offsets_l[num_l] = static_cast<unsigned char>(i);
+          num_l += !comp(*first, pivot);
+        }
+      }
+
+      if (right_split >= kPdqBlockSize)
+      {
+        for (size_t i = 0; i < kPdqBlockSize; )
+        {
+          offsets_r[num_r] = static_cast<unsigned char>(++i);
+          num_r += comp(*--last, pivot);
+        }
+      }
+      else
+      {
+        for (size_t i = 0; i < right_split; )
+        {
+          offsets_r[num_r] = static_cast<unsigned char>(++i);
+          num_r += comp(*--last, pivot);
+        }
+      }
+
+      const size_t num = mystl::min(num_l, num_r);
+      mystl::pdq_swap_offsets(offsets_l_base, offsets_r_base,
+                              offsets_l + start_l, offsets_r + start_r, num, num_l == num_r);
+      num_l -= num;
+      num_r -= num;
+      start_l += num;
+      start_r += num;
+      if (num_l == 0)
+      {
+        start_l = 0;
+        offsets_l_base = first;
+      }
+      if (num_r == 0)
+      {
+        start_r = 0;
+        offsets_r_base = last;
+      }
+    }
+
+    // 处理某一侧剩下的元素
+    if (num_l)
+    {
+      while (num_l--)
+        mystl::iter_swap(offsets_l_base + offsets_l[start_l + num_l], --last);
+      first = last;
+    }
+    if (num_r)
+    {
+      while (num_r--)
+      {
+        mystl::iter_swap(offsets_r_base - offsets_r[start_r + num_r], first);
+        ++first;
+      }
+      last = first;
+    }
+  }
+  auto pivot_pos = first - 1;
+  *begin = mystl::move(*pivot_pos);
+  *pivot_pos = mystl::move(pivot);
+  return mystl::pair<RandomIter, bool>(pivot_pos, already_partitioned);
+}
+
+// 以 *first 为枢轴分割, 等于枢轴的元素放在左边, 返回枢轴的最终位置
+template <class RandomIter, class Compared>
+RandomIter pdq_partition_left(RandomIter first, RandomIter last, Compared& comp)
+{
+  auto pivot = mystl::move(*first);
+  auto begin = first;
+  auto end = last;
+  while (comp(pivot, *--last));
+  if (last + 1 == end)
+    while (first < last && !comp(pivot, *++first));
+  else
+    while (!comp(pivot, *++first));
+  while (first < last)
+  {
+    mystl::iter_swap(first, last);
+    while (comp(pivot, *--last));
+    while (!comp(pivot, *++first));
+  }
+  *begin = mystl::move(*last);
+  *last = mystl::move(pivot);
+  return last;
+}
+
+// bad_allowed 为还允许出现的不平衡分割次数, leftmost 表示区间左侧没有元素
+template <class RandomIter, class Compared, class Block>
+void pdq_sort_loop(RandomIter first, RandomIter last, Compared& comp,
+                   size_t bad_allowed, bool leftmost, Block block)
+{
+  while (true)
+  {
+    const size_t size = static_cast<size_t>(last - first);
+    if (size < kPdqInsertionSortThreshold)
+    {
+      if (leftmost)
+        mystl::pdq_insertion_sort(first, last, comp);
+      else
+        mystl::pdq_unguarded_insertion_sort(first, last, comp);
+      return;
+    }
+
+    // 枢轴放在 *first
+    const size_t s2 = size / 2;
+    if (size > kPdqNintherThreshold)
+    {
+      mystl::pdq_sort3(first, first + s2, last - 1, comp);
+      mystl::pdq_sort3(first + 1, first + (s2 - 1), last - 2, comp);
+      mystl::pdq_sort3(first + 2, first + (s2 + 1), last - 3, comp);
+      mystl::pdq_sort3(first + (s2 - 1), first + s2, first + (s2 + 1), comp);
+      mystl::iter_swap(first, first + s2);
+    }
+    else
+    {
+      mystl::pdq_sort3(first + s2, first, last - 1, comp);
+    }
+
+    // 左侧相邻元素 (上一次的枢轴) 不小于当前枢轴, 说明枢轴与它相等, 把等于枢轴的元素分到左边后跳过
+    if (!leftmost && !comp(*(first - 1), *first))
+    {
+      first = mystl::pdq_partition_left(first, last, comp) + 1;
+      continue;
+    }
+
+    auto part = mystl::pdq_partition_right(first, last, comp, block);
+    auto pivot_pos = part.first;
+    const bool already_partitioned = part.second;
+
+    const size_t l_size = static_cast<size_t>(pivot_pos - first);
+    const size_t r_size = static_cast<size_t>(last - (pivot_pos + 1));
+    if (l_size < size / 8 || r_size < size / 8)
+    {
+      if (--bad_allowed == 0)
+      { // 不平衡的分割太多, 改用 heap sort
+        mystl::partial_sort(first, last, last, comp);
+        return;
+      }
+      // 交换几个固定位置的元素, 打破可能导致不平衡的模式
+      if (l_size >= kPdqInsertionSortThreshold)
+      {
+        mystl::iter_swap(first, first + l_size / 4);
+        mystl::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+        if (l_size > kPdqNintherThreshold)
+        {
+          mystl::iter_swap(first + 1, first + (l_size / 4 + 1));
+          mystl::iter_swap(first + 2, first + (l_size / 4 + 2));
+          mystl::iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+          mystl::iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+        }
+      }
+      if (r_size >= kPdqInsertionSortThreshold)
+      {
+        mystl::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+        mystl::iter_swap(last - 1, last - r_size / 4);
+        if (r_size > kPdqNintherThreshold)
+        {
+          mystl::iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+          mystl::iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+          mystl::iter_swap(last - 2, last - (1 + r_size / 4));
+          mystl::iter_swap(last - 3, last - (2 + r_size / 4));
+        }
+      }
+    }
+    else if (already_partitioned &&
+             mystl::pdq_partial_insertion_sort(first, pivot_pos, comp) &&
+             mystl::pdq_partial_insertion_sort(pivot_pos + 1, last, comp))
+    { // 分割时没有交换, 且两侧都只需少量移动就已有序
+      return;
+    }
+
+    // 递归处理左侧, 循环处理右侧
+    mystl::pdq_sort_loop(first, pivot_pos, comp, bad_allowed, leftmost, block);
+    first = pivot_pos + 1;
+    leftmost = false;
+  }
+}
+
+template <class RandomIter, class Compared>
+void pdq_sort(RandomIter first, RandomIter last, Compared comp)
+{
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  if (first == last)
+    return;
+  mystl::pdq_sort_loop(first, last, comp, slg2(static_cast<size_t>(last - first)), true,
+                       pdq_use_block_partition<value_type, Compared>());
+}
+
+template <class RandomIter>
+void pdq_sort(RandomIter first, RandomIter last)
+{
+  mystl::pdq_sort(first, last, mystl::less<typename iterator_traits<RandomIter>::value_type>());
+}
+
+/*****************************************************************************************/
+// stable_sort
+// 稳定排序: 先对每 kStableSortChunkSize 个元素做插入排序, 再借助缓冲区自底向上逐层归并,
+// 缓冲区来自 temporary_buffer, 不够容纳一半元素时先分段排序再用 merge_adaptive 合并,
+// 申请不到缓冲区时使用不需要额外空间的 inplace_stable_sort (O(N * logN * logN))
+/*****************************************************************************************/
+constexpr static size_t kStableSortChunkSize = 7;
+
+template <class RandomIter, class Distance, class Compared>
+void chunk_insertion_sort(RandomIter first, RandomIter last,
+                          Distance chunk_size, Compared comp)
+{
+  while (last - first >= chunk_size)
+  {
+    mystl::insertion_sort(first, first + chunk_size, comp);
+    first += chunk_size;
+  }
+  mystl::insertion_sort(first, last, comp);
+}
+
+// 把长度为 step 的相邻两段合并到 result
+template <class RandomIter1, class RandomIter2, class Distance, class Compared>
+void merge_sort_loop(RandomIter1 first, RandomIter1 last,
+                     RandomIter2 result, Distance step, Compared comp)
+{
+  const Distance two_step = step * 2;
+  while (last - first >= two_step)
+  {
+    result = mystl::merge(first, first + step, first + step, first + two_step, result, comp);
+    first += two_step;
+  }
+  step = mystl::min(static_cast<Distance>(last - first), step);
+  mystl::merge(first, first + step, first + step, last, result, comp);
+}
+
+// 缓冲区至少能容纳 [first, last) 的全部元素
+template <class RandomIter, class Pointer, class Compared>
+void merge_sort_with_buffer(RandomIter first, RandomIter last,
+                            Pointer buffer, Compared comp)
+{
+  const ptrdiff_t len = last - first;
+  const Pointer buffer_last = buffer + len;
+  ptrdiff_t step = kStableSortChunkSize;
+  mystl::chunk_insertion_sort(first, last, step, comp);
+  while (step < len)
+  {
+    mystl::merge_sort_loop(first, last, buffer, step, comp);
+    step *= 2;
+    mystl::merge_sort_loop(buffer, buffer_last, first, step, comp);
+    step *= 2;
+  }
+}
+
+template <class RandomIter, class Pointer, class Distance, class Compared>
+void stable_sort_adaptive(RandomIter first, RandomIter last,
+                          Pointer buffer, Distance buffer_size, Compared comp)
+{
+  const Distance len = (last - first + 1) / 2;
+  const RandomIter middle = first + len;
+  if (len > buffer_size)
+  {
+    mystl::stable_sort_adaptive(first, middle, buffer, buffer_size, comp);
+    mystl::stable_sort_adaptive(middle, last, buffer, buffer_size, comp);
+  }
+  else
+  {
+    mystl::merge_sort_with_buffer(first, middle, buffer, comp);
+    mystl::merge_sort_with_buffer(middle, last, buffer, comp);
+  }
+  mystl::merge_adaptive(first, middle, last, static_cast<Distance>(middle - first),
+                        static_cast<Distance>(last - middle), buffer, buffer_size, comp);
+}
+
+template <class RandomIter, class Compared>
+void inplace_stable_sort(RandomIter first, RandomIter last, Compared comp)
+{
+  if (last - first < 15)
+  {
+    mystl::insertion_sort(first, last, comp);
+    return;
+  }
+  const RandomIter middle = first + (last - first) / 2;
+  mystl::inplace_stable_sort(first, middle, comp);
+  mystl::inplace_stable_sort(middle, last, comp);
+  mystl::merge_without_buffer(first, middle, last, middle - first, last - middle, comp);
+}
+
+template <class RandomIter, class T, class Compared>
+void stable_sort_aux(RandomIter first, RandomIter last, T*, Compared comp)
+{
+  temporary_buffer<RandomIter, T> buf(first, last);
+  if (!buf.begin())
+    mystl::inplace_stable_sort(first, last, comp);
+  else
+    mystl::stable_sort_adaptive(first, last, buf.begin(), buf.size(), comp);
+}
+
+template <class RandomIter, class Compared>
+void stable_sort(RandomIter first, RandomIter last, Compared comp)
+{
+  if (last - first < 2)
+    return;
+  mystl::stable_sort_aux(first, last, value_type(first), comp);
+}
+
+template <class RandomIter>
+void stable_sort(RandomIter first, RandomIter last)
+{
+  mystl::stable_sort(first, last, mystl::less<typename iterator_traits<RandomIter>::value_type>());
+}
+
+/*****************************************************************************************/
+// tim_sort
+// 稳定的自适应归并排序, 对已经部分有序的输入接近线性:
+//   1. 从左到右找出单调的 run (严格递减的 run 原地翻转), 短于 minrun 的用二分插入排序补足到 minrun
+//   2. run 压入栈中, 保持栈中长度满足 len[i-2] > len[i-1] + len[i] 且 len[i-1] > len[i], 否则合并相邻的 run
+//   3. 合并前先用 gallop 跳过两侧已经就位的前缀与后缀, 只把较短的一侧移入缓冲区,
+//      某一侧连续胜出 min_gallop 次后改用指数搜索成段移动 (galloping)
+// 缓冲区一次申请 N / 2 个元素, 申请不到或不够时对这次合并使用 merge_without_buffer
+/*****************************************************************************************/
+constexpr static size_t kTimSortMinMerge   = 64;  // 短于这个长度时只做一次二分插入排序
+constexpr static size_t kTimSortMinGallop  = 7;   // 进入 galloping 模式的初始阈值
+constexpr static size_t kTimSortStackSize  = 85;  // 满足栈的约束时, 64 位长度最多需要的 run 个数
+
+// 计算 minrun: 取 n 的最高 6 位, 低位中有 1 时加一, 使 n / minrun 接近且不超过 2 的幂
+inline size_t tim_sort_minrun(size_t n)
+{
+  size_t r = 0;
+  while (n >= kTimSortMinMerge)
+  {
+    r |= n & 1;
+    n >>= 1;
+  }
+  return n + r;
+}
+
+// [first, start) 已经有序, 把 [start, last) 的元素逐个二分插入
+template <class RandomIter, class Compared>
+void tim_binary_insertion_sort(RandomIter first, RandomIter last, RandomIter start, Compared& comp)
+{
+  if (start == first)
+    ++start;
+  for (; start < last; ++start)
+  {
+    auto pivot = mystl::move(*start);
+    auto pos = mystl::upper_bound(first, start, pivot, comp);
+    mystl::move_backward(pos, start, start + 1);
+    *pos = mystl::move(pivot);
+  }
+}
+
+// 返回从 first 开始的 run 的长度, 严格递减的 run 翻转为递增
+template <class RandomIter, class Compared>
+size_t tim_count_run(RandomIter first, RandomIter last, Compared& comp)
+{
+  auto run_last = first + 1;
+  if (run_last == last)
+    return 1;
+  if (comp(*run_last++, *first))
+  {
+    while (run_last < last && comp(*run_last, *(run_last - 1)))
+      ++run_last;
+    mystl::reverse(first, run_last);
+  }
+  else
+  {
+    while (run_last < last && !comp(*run_last, *(run_last - 1)))
+      ++run_last;
+  }
+  return static_cast<size_t>(run_last - first);
+}
+
+// 在有序的 [first, first + len) 中从 hint 开始指数搜索, 返回第一个不小于 key 的位置 (相对 first)
+template <class Iter, class T, class Compared>
+ptrdiff_t tim_gallop_left(const T& key, Iter first, ptrdiff_t len, ptrdiff_t hint, Compared& comp)
+{
+  ptrdiff_t last_ofs = 0, ofs = 1;
+  if (comp(*(first + hint), key))
+  { // key 在 hint 右侧
+    const ptrdiff_t max_ofs = len - hint;
+    while (ofs < max_ofs && comp(*(first + (hint + ofs)), key))
+    {
+      last_ofs = ofs;
+      ofs = (ofs << 1) + 1;
+    }
+    if (ofs > max_ofs)
+      ofs = max_ofs;
+    last_ofs += hint;
+    ofs += hint;
+  }
+  else
+  { // key 在 hint 左侧
+    const ptrdiff_t max_ofs = hint + 1;
+    while (ofs < max_ofs && !comp(*(first + (hint - ofs)), key))
+    {
+      last_ofs = ofs;
+      ofs = (ofs << 1) + 1;
+    }
+    if (ofs > max_ofs)
+      ofs = max_ofs;
+    const ptrdiff_t tmp = last_ofs;
+    last_ofs = hint - ofs;
+    ofs = hint - tmp;
+  }
+  // 此时 first[last_ofs] < key <= first[ofs], 在 (last_ofs, ofs] 中二分
+  ++last_ofs;
+  while (last_ofs < ofs)
+  {
+    const ptrdiff_t m = last_ofs + (ofs - last_ofs) / 2;
+    if (comp(*(first + m), key))
+      last_ofs = m + 1;
+    else
+      ofs = m;
+  }
+  return ofs;
+}
+
+// 同上, 返回第一个大于 key 的位置
+template <class Iter, class T, class Compared>
+ptrdiff_t tim_gallop_right(const T& key, Iter first, ptrdiff_t len, ptrdiff_t hint, Compared& comp)
+{
+  ptrdiff_t last_ofs = 0, ofs = 1;
+  if (comp(key, *(first + hint)))
+  {
+    const ptrdiff_t max_ofs = hint + 1;
+    while (ofs < max_ofs && comp(key, *(first + (hint - ofs))))
+    {
+      last_ofs = ofs;
+      ofs = (ofs << 1) + 1;
+    }
+    if (ofs > max_ofs)
+      ofs = max_ofs;
+    const ptrdiff_t tmp = last_ofs;
+    last_ofs = hint - ofs;
+    ofs = hint - tmp;
+  }
+  else
+  {
+    const ptrdiff_t max_ofs = len - hint;
+    while (ofs < max_ofs && !comp(key, *(first + (hint + ofs))))
+    {
+      last_ofs = ofs;
+      ofs = (ofs << 1) + 1;
+    }
+    if (ofs > max_ofs)
+      ofs = max_ofs;
+    last_ofs += hint;
+    ofs += hint;
+  }
+  ++last_ofs;
+  while (last_ofs < ofs)
+  {
+    const ptrdiff_t m = last_ofs + (ofs - last_ofs) / 2;
+    if (comp(key, *(first + m)))
+      ofs = m;
+    else
+      last_ofs = m + 1;
+  }
+  return ofs;
+}
+
+// tim_sort 的状态: 比较函数, 缓冲区与 run 栈
+template <class RandomIter, class Compared>
+class tim_sorter
+{
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+
+  Compared&   comp_;
+  value_type* buf_;
+  ptrdiff_t   buf_size_;
+  ptrdiff_t   min_gallop_;
+  RandomIter  run_base_[kTimSortStackSize];
+  ptrdiff_t   run_len_[kTimSortStackSize];
+  size_t      runs_;
+
+public:
+  tim_sorter(Compared& comp, ptrdiff_t n)
+    : comp_(comp), buf_(nullptr), buf_size_(0),
+      min_gallop_(static_cast<ptrdiff_t>(kTimSortMinGallop)), runs_(0)
+  {
+    auto p = mystl::get_temporary_buffer<value_type>(n / 2 + 1);
+    buf_ = p.first;
+    buf_size_ = p.second;
+  }
+
+  ~tim_sorter()
+  {
+    mystl::release_temporary_buffer(buf_);
+  }
+
+  void push_run(RandomIter base, ptrdiff_t len)
+  {
+    run_base_[runs_] = base;
+    run_len_[runs_] = len;
+    ++runs_;
+  }
+
+  // 合并栈顶的 run, 直到满足栈的约束
+  void merge_collapse()
+  {
+    while (runs_ > 1)
+    {
+      size_t n = runs_ - 2;
+      if ((n > 0 && run_len_[n - 1] <= run_len_[n] + run_len_[n + 1]) ||
+          (n > 1 && run_len_[n - 2] <= run_len_[n - 1] + run_len_[n]))
+      {
+        if (run_len_[n - 1] < run_len_[n + 1])
+          --n;
+      }
+      else if (run_len_[n] > run_len_[n + 1])
+      {
+        break;
+      }
+      merge_at(n);
+    }
+  }
+
+  // 合并剩下的所有 run
+  void merge_force_collapse()
+  {
+    while (runs_ > 1)
+    {
+      size_t n = runs_ - 2;
+      if (n > 0 && run_len_[n - 1] < run_len_[n + 1])
+        --n;
+      merge_at(n);
+    }
+  }
+
+private:
+  // 合并栈中第 i 与 i + 1 个 run
+  void merge_at(size_t i)
+  {
+    RandomIter base1 = run_base_[i];
+    ptrdiff_t len1 = run_len_[i];
+    RandomIter base2 = run_base_[i + 1];
+    ptrdiff_t len2 = run_len_[i + 1];
+    run_len_[i] = len1 + len2;
+    if (i == runs_ - 3)
+    {
+      run_base_[i + 1] = run_base_[i + 2];
+      run_len_[i + 1] = run_len_[i + 2];
+    }
+    --runs_;
+
+    // run1 中不大于 run2 首元素的前缀与 run2 中不小于 run1 末元素的后缀已经就位
+    const ptrdiff_t k = mystl::tim_gallop_right(*base2, base1, len1, 0, comp_);
+    base1 += k;
+    len1 -= k;
+    if (len1 == 0)
+      return;
+    len2 = mystl::tim_gallop_left(*(base1 + (len1 - 1)), base2, len2, len2 - 1, comp_);
+    if (len2 == 0)
+      return;
+
+    if (mystl::min(len1, len2) > buf_size_)
+      mystl::merge_without_buffer(base1, base2, base2 + len2, len1, len2, comp_);
+    else if (len1 <= len2)
+      merge_lo(base1, len1, base2, len2);
+    else
+      merge_hi(base1, len1, base2, len2);
+  }
+
+  // run1 较短: 移入缓冲区后从前往后合并
+  void merge_lo(RandomIter base1, ptrdiff_t len1, RandomIter base2, ptrdiff_t len2)
+  {
+    value_type* cursor1 = buf_;
+    value_type* end1 = mystl::uninitialized_move(base1, base1 + len1, buf_);
+    RandomIter cursor2 = base2;
+    RandomIter end2 = base2 + len2;
+    RandomIter dest = base1;
+    ptrdiff_t min_gallop = min_gallop_;
+    const ptrdiff_t gallop = static_cast<ptrdiff_t>(kTimSortMinGallop);
+    while (cursor1 != end1 && cursor2 != end2)
+    {
+      // 逐个比较, 某一侧连续胜出 min_gallop 次后进入 galloping 模式
+      ptrdiff_t count1 = 0, count2 = 0;
+      while (cursor1 != end1 && cursor2 != end2 && (count1 | count2) < min_gallop)
+      {
+        if (comp_(*cursor2, *cursor1))
+        {
+          *dest++ = mystl::move(*cursor2++);
+          ++count2;
+          count1 = 0;
+        }
+        else
+        {
+          *dest++ = mystl::move(*cursor1++);
+          ++count1;
+          count2 = 0;
+        }
+      }
+      if (cursor1 == end1 || cursor2 == end2)
+        break;
+      do
+      {
+        count1 = mystl::tim_gallop_right(*cursor2, cursor1, end1 - cursor1, 0, comp_);
+        dest = mystl::move(cursor1, cursor1 + count1, dest);
+        cursor1 += count1;
+        if (cursor1 == end1)
+          break;
+        *dest++ = mystl::move(*cursor2++);
+        if (cursor2 == end2)
+          break;
+        count2 = mystl::tim_gallop_left(*cursor1, cursor2, end2 - cursor2, 0, comp_);
+        dest = mystl::move(cursor2, cursor2 + count2, dest);
+        cursor2 += count2;
+        if (cursor2 == end2)
+          break;
+        *dest++ = mystl::move(*cursor1++);
+        if (cursor1 == end1)
+          break;
+        --min_gallop;
+      } while (count1 >= gallop || count2 >= gallop);
+      if (min_gallop < 0)
+        min_gallop = 0;
+      min_gallop += 2;  // 离开 galloping 模式时提高阈值
+    }
+    // run2 剩下的元素已经在原位
+    mystl::move(cursor1, end1, dest);
+    mystl::destroy(buf_, end1);
+    min_gallop_ = min_gallop < 1 ? 1 : min_gallop;
+  }
+
+  // run2 较短: 移入缓冲区后从后往前合并
+  void merge_hi(RandomIter base1, ptrdiff_t len1, RandomIter base2, ptrdiff_t len2)
+  {
+    value_type* end2 = mystl::uninitialized_move(base2, base2 + len2, buf_);
+    value_type* cursor2 = end2;
+    RandomIter cursor1 = base1 + len1;
+    RandomIter dest = base2 + len2;
+    ptrdiff_t min_gallop = min_gallop_;
+    const ptrdiff_t gallop = static_cast<ptrdiff_t>(kTimSortMinGallop);
+    while (cursor1 != base1 && cursor2 != buf_)
+    {
+      ptrdiff_t count1 = 0, count2 = 0;
+      while (cursor1 != base1 && cursor2 != buf_ && (count1 | count2) < min_gallop)
+      {
+        if (comp_(*(cursor2 - 1), *(cursor1 - 1)))
+        {
+          *--dest = mystl::move(*--cursor1);
+          ++count1;
+          count2 = 0;
+        }
+        else
+        {
+          *--dest = mystl::move(*--cursor2);
+          ++count2;
+          count1 = 0;
+        }
+      }
+      if (cursor1 == base1 || cursor2 == buf_)
+        break;
+      do
+      {
+        const ptrdiff_t n1 = cursor1 - base1;
+        count1 = n1 - mystl::tim_gallop_right(*(cursor2 - 1), base1, n1, n1 - 1, comp_);
+        dest = mystl::move_backward(cursor1 - count1, cursor1, dest);
+        cursor1 -= count1;
+        if (cursor1 == base1)
+          break;
+        *--dest = mystl::move(*--cursor2);
+        if (cursor2 == buf_)
+          break;
+        const ptrdiff_t n2 = cursor2 - buf_;
+        count2 = n2 - mystl::tim_gallop_left(*(cursor1 - 1), buf_, n2, n2 - 1, comp_);
+        dest = mystl::move_backward(cursor2 - count2, cursor2, dest);
+        cursor2 -= count2;
+        if (cursor2 == buf_)
+          break;
+        *--dest = mystl::move(*--cursor1);
+        if (cursor1 == base1)
+          break;
+        --min_gallop;
+      } while (count1 >= gallop || count2 >= gallop);
+      if (min_gallop < 0)
+        min_gallop = 0;
+      min_gallop += 2;
+    }
+    // run1 剩下的元素已经在原位
+    mystl::move_backward(buf_, cursor2, dest);
+    mystl::destroy(buf_, end2);
+    min_gallop_ = min_gallop < 1 ? 1 : min_gallop;
+  }
+};
+
+template <class RandomIter, class Compared>
+void tim_sort(RandomIter first, RandomIter last, Compared comp)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  if (n < 2)
+    return;
+  if (n < kTimSortMinMerge)
+  {
+    const size_t run = mystl::tim_count_run(first, last, comp);
+    mystl::tim_binary_insertion_sort(first, last, first + run, comp);
+    return;
+  }
+  tim_sorter<RandomIter, Compared> sorter(comp, static_cast<ptrdiff_t>(n));
+  const size_t minrun = mystl::tim_sort_minrun(n);
+  for (size_t remain = n; remain != 0; )
+  {
+    size_t run = mystl::tim_count_run(first, last, comp);
+    if (run < minrun)
+    { // 用二分插入排序把短 run 补足到 minrun
+      const size_t force = mystl::min(remain, minrun);
+      mystl::tim_binary_insertion_sort(first, first + force, first + run, comp);
+      run = force;
+    }
+    sorter.push_run(first, static_cast<ptrdiff_t>(run));
+    sorter.merge_collapse();
+    first += run;
+    remain -= run;
+  }
+  sorter.merge_force_collapse();
+}
+
+template <class RandomIter>
+void tim_sort(RandomIter first, RandomIter last)
+{
+  mystl::tim_sort(first, last, mystl::less<typename iterator_traits<RandomIter>::value_type>());
+}
+
 /*****************************************************************************************/
 // nth_element
 // 对序列重排，使得所有小于第 n 个元素的元素出现在它的前面，大于它的出现在它的后面
@@ -2591,9 +3582,9 @@ void nth_element(RandomIter first, RandomIter nth,
     return;
   while (last - first > 3)
   {
-    auto cut = mystl::unchecked_partition(first, last, mystl::median(*first,
-										  *(first + (last - first) / 2),
-										  *(last - 1)));
+    // 先复制枢轴, 分割时交换元素会改变引用所指的值
+    auto pivot = mystl::median(*first, *(first + (last - first) / 2), *(last - 1));
+    auto cut = mystl::unchecked_partition(first, last, pivot);
     if (cut <= nth)  // 如果 nth 位于右段
       first = cut;   // 对右段进行分割
     else
@@ -2611,9 +3602,8 @@ void nth_element(RandomIter first, RandomIter nth,
     return;
   while (last - first > 3)
   {
-    auto cut = mystl::unchecked_partition(first, last, mystl::median(*first, 
-										  *(first + (last - first) / 2),
-										  *(last - 1)), comp);
+    auto pivot = mystl::median(*first, *(first + (last - first) / 2), *(last - 1), comp);
+    auto cut = mystl::unchecked_partition(first, last, pivot, comp);
     if (cut <= nth)  // 如果 nth 位于右段
       first = cut;   // 对右段进行分割
     else
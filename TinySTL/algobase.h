@@ -116,12 +116,74 @@ unchecked_copy(Tp* first, Tp* last, Up* result)
   return result + n;
 }
 
+// 目标为分段迭代器时, 按目标的段切分, 每段调用一次 unchecked_copy
 template <class InputIter, class OutputIter>
-OutputIter copy(InputIter first, InputIter last, OutputIter result)
+OutputIter
+copy_to_segments(InputIter first, InputIter last, OutputIter result, m_false_type)
 {
   return unchecked_copy(first, last, result);
 }
 
+template <class RandomIter, class SegmentedIter>
+SegmentedIter
+copy_to_segments(RandomIter first, RandomIter last, SegmentedIter result, m_true_type)
+{
+  typedef segmented_iterator_traits<SegmentedIter> traits;
+  auto seg = traits::segment(result);
+  auto lresult = traits::local(result);
+  while (true)
+  {
+    const auto room = traits::end(seg) - lresult;
+    const auto n = last - first;
+    if (n < room)
+      return traits::compose(seg, unchecked_copy(first, last, lresult));
+    unchecked_copy(first, first + room, lresult);
+    first += room;
+    ++seg;
+    lresult = traits::begin(seg);
+    if (n == room)
+      return traits::compose(seg, lresult);
+  }
+}
+
+template <class InputIter, class OutputIter>
+OutputIter
+copy_segment(InputIter first, InputIter last, OutputIter result)
+{
+  return copy_to_segments(first, last, result, m_bool_constant<
+    is_segmented_iterator<OutputIter>::value && is_random_access_iterator<InputIter>::value>());
+}
+
+// 源为分段迭代器时, 逐段拷贝
+template <class InputIter, class OutputIter>
+OutputIter
+segmented_copy(InputIter first, InputIter last, OutputIter result, m_false_type)
+{
+  return copy_segment(first, last, result);
+}
+
+template <class SegmentedIter, class OutputIter>
+OutputIter
+segmented_copy(SegmentedIter first, SegmentedIter last, OutputIter result, m_true_type)
+{
+  typedef segmented_iterator_traits<SegmentedIter> traits;
+  auto sfirst = traits::segment(first);
+  auto slast = traits::segment(last);
+  if (sfirst == slast)
+    return copy_segment(traits::local(first), traits::local(last), result);
+  result = copy_segment(traits::local(first), traits::end(sfirst), result);
+  for (++sfirst; sfirst != slast; ++sfirst)
+    result = copy_segment(traits::begin(sfirst), traits::end(sfirst), result);
+  return copy_segment(traits::begin(slast), traits::local(last), result);
+}
+
+// 分段迭代器 (如 deque 的迭代器) 逐段处理, 可平凡复制的类型在每段内使用 memmove
+template <class InputIter, class OutputIter>
+OutputIter copy(InputIter first, InputIter last, OutputIter result)
+{
+  return segmented_copy(first, last, result, is_segmented_iterator<InputIter>());
+}
+
 /*****************************************************************************************/
 // copy_backward
 // 将 [first, last)区间内的元素拷贝到 [result - (last - first), result)内
@@ -349,17 +411,104 @@ move_backward(BidirectionalIter1 first, BidirectionalIter1 last, BidirectionalIt
 // equal
 // 比较第一序列在 [first, last)区间上的元素值是否和第二序列相等
 /*****************************************************************************************/
+// 相等时 first2 前进到第二序列比较过的部分之后
 template <class InputIter1, class InputIter2>
-bool equal(InputIter1 first1, InputIter1 last1, InputIter2 first2)
+bool unchecked_equal(InputIter1 first1, InputIter1 last1, InputIter2& first2)
 {
   for (; first1 != last1; ++first1, ++first2)
   {
-    if (*first1 != *first2)  
+    if (*first1 != *first2)
       return false;
   }
   return true;
 }
 
+// 为整数和指针类型提供特化版本, 逐字节比较
+template <class Tp, class Up>
+typename std::enable_if<
+  std::is_same<typename std::remove_const<Tp>::type, typename std::remove_const<Up>::type>::value &&
+  (std::is_integral<Tp>::value || std::is_pointer<Tp>::value),
+  bool>::type
+unchecked_equal(Tp* first1, Tp* last1, Up*& first2)
+{
+  const auto n = static_cast<size_t>(last1 - first1);
+  if (n != 0 && std::memcmp(first1, first2, n * sizeof(Tp)) != 0)
+    return false;
+  first2 += n;
+  return true;
+}
+
+// 第二序列为分段迭代器时, 按其段切分第一序列
+// 内部使用, first2 可能停在某段的尾后位置
+template <class InputIter1, class InputIter2>
+bool equal_to_segments(InputIter1 first1, InputIter1 last1, InputIter2& first2, m_false_type)
+{
+  return unchecked_equal(first1, last1, first2);
+}
+
+template <class RandomIter, class SegmentedIter>
+bool equal_to_segments(RandomIter first1, RandomIter last1, SegmentedIter& first2, m_true_type)
+{
+  typedef segmented_iterator_traits<SegmentedIter> traits;
+  auto seg = traits::segment(first2);
+  auto lfirst2 = traits::local(first2);
+  while (true)
+  {
+    const auto room = traits::end(seg) - lfirst2;
+    const auto n = last1 - first1;
+    if (n <= room)
+    {
+      const bool result = unchecked_equal(first1, last1, lfirst2);
+      first2 = traits::compose(seg, lfirst2);
+      return result;
+    }
+    if (!unchecked_equal(first1, first1 + room, lfirst2))
+      return false;
+    first1 += room;
+    ++seg;
+    lfirst2 = traits::begin(seg);
+  }
+}
+
+template <class InputIter1, class InputIter2>
+bool equal_segment(InputIter1 first1, InputIter1 last1, InputIter2& first2)
+{
+  return equal_to_segments(first1, last1, first2, m_bool_constant<
+    is_segmented_iterator<InputIter2>::value && is_random_access_iterator<InputIter1>::value>());
+}
+
+// 第一序列为分段迭代器时, 逐段比较
+template <class InputIter1, class InputIter2>
+bool segmented_equal(InputIter1 first1, InputIter1 last1, InputIter2 first2, m_false_type)
+{
+  return equal_segment(first1, last1, first2);
+}
+
+template <class SegmentedIter, class InputIter2>
+bool segmented_equal(SegmentedIter first1, SegmentedIter last1, InputIter2 first2, m_true_type)
+{
+  typedef segmented_iterator_traits<SegmentedIter> traits;
+  auto sfirst = traits::segment(first1);
+  auto slast = traits::segment(last1);
+  if (sfirst == slast)
+    return equal_segment(traits::local(first1), traits::local(last1), first2);
+  if (!equal_segment(traits::local(first1), traits::end(sfirst), first2))
+    return false;
+  for (++sfirst; sfirst != slast; ++sfirst)
+  {
+    if (!equal_segment(traits::begin(sfirst), traits::end(sfirst), first2))
+      return false;
+  }
+  return equal_segment(traits::begin(slast), traits::local(last1), first2);
+}
+
+// 分段迭代器 (如 deque 的迭代器) 逐段比较, 整数和指针类型在每段内使用 memcmp
+template <class InputIter1, class InputIter2>
+bool equal(InputIter1 first1, InputIter1 last1, InputIter2 first2)
+{
+  return segmented_equal(first1, last1, first2, is_segmented_iterator<InputIter1>());
+}
+
 // 重载版本使用函数对象 comp 代替比较操作
 template <class InputIter1, class InputIter2, class Compared>
 bool equal(InputIter1 first1, InputIter1 last1, InputIter2 first2, Compared comp)
@@ -403,11 +552,31 @@ unchecked_fill_n(Tp* first, Size n, Up value)
 }
 
 template <class OutputIter, class Size, class T>
-OutputIter fill_n(OutputIter first, Size n, const T& value)
+OutputIter fill_n_dispatch(OutputIter first, Size n, const T& value, m_false_type)
 {
   return unchecked_fill_n(first, n, value);
 }
 
+template <class SegmentedIter, class T>
+void fill(SegmentedIter first, SegmentedIter last, const T& value);
+
+// 分段迭代器交给 fill 逐段填充
+template <class SegmentedIter, class Size, class T>
+SegmentedIter fill_n_dispatch(SegmentedIter first, Size n, const T& value, m_true_type)
+{
+  if (n <= 0)
+    return first;
+  auto last = first + n;
+  mystl::fill(first, last, value);
+  return last;
+}
+
+template <class OutputIter, class Size, class T>
+OutputIter fill_n(OutputIter first, Size n, const T& value)
+{
+  return fill_n_dispatch(first, n, value, is_segmented_iterator<OutputIter>());
+}
+
 /*****************************************************************************************/
 // fill
 // 为 [first, last)区间内的所有元素填充新值
@@ -430,11 +599,35 @@ void fill_cat(RandomIter first, RandomIter last, const T& value,
 }
 
 template <class ForwardIter, class T>
-void fill(ForwardIter first, ForwardIter last, const T& value)
+void segmented_fill(ForwardIter first, ForwardIter last, const T& value, m_false_type)
 {
   fill_cat(first, last, value, iterator_category(first));
 }
 
+// 逐段填充, 每段内为指针区间, 单字节类型使用 memset, 其余为编译器可以向量化的简单循环
+template <class SegmentedIter, class T>
+void segmented_fill(SegmentedIter first, SegmentedIter last, const T& value, m_true_type)
+{
+  typedef segmented_iterator_traits<SegmentedIter> traits;
+  auto sfirst = traits::segment(first);
+  auto slast = traits::segment(last);
+  if (sfirst == slast)
+  {
+    fill_cat(traits::local(first), traits::local(last), value, random_access_iterator_tag());
+    return;
+  }
+  fill_cat(traits::local(first), traits::end(sfirst), value, random_access_iterator_tag());
+  for (++sfirst; sfirst != slast; ++sfirst)
+    fill_cat(traits::begin(sfirst), traits::end(sfirst), value, random_access_iterator_tag());
+  fill_cat(traits::begin(slast), traits::local(last), value, random_access_iterator_tag());
+}
+
+template <class ForwardIter, class T>
+void fill(ForwardIter first, ForwardIter last, const T& value)
+{
+  segmented_fill(first, last, value, is_segmented_iterator<ForwardIter>());
+}
+
 /*****************************************************************************************/
 //    
 // 以字典序排列对两个序列进行比较，当在某个位置发现第一组不相等元素时，有下列几种情况：
@@ -0,0 +1,1316 @@
+#ifndef TINYSTL_ART_MAP_H
+#define TINYSTL_ART_MAP_H
+
+// 这个头文件包含模板类 art_map (自适应基数树, Adaptive Radix Tree)
+// 键值被看作字节串, 每个内部节点按一个字节分支, 查找只需逐字节前进, 不做整键比较, 代价为 O(键长)
+// 内部节点按子节点个数在 Node4 / Node16 / Node48 / Node256 四种布局之间自动伸缩, Node16 的查找使用 SSE2
+// 只有一个子节点的路径被压缩到节点的前缀中, 前缀最多存 kArtMaxPrefix 个字节, 更长的部分用子树中任一叶子的键值补全
+// 某个键值恰好是其他键值的前缀时, 它的叶子挂在对应内部节点的 end_leaf 上
+// 所有叶子按键值升序串成双向循环链表, 迭代器沿链表移动, 因此遍历、lower_bound 之后的范围扫描以及前缀扫描都是顺序访问
+// 元素按键值的字节序 (无符号) 排列; 支持 std::string 和整数键值, 其他类型可以提供自己的 KeyTraits
+
+#include <initializer_list>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MYSTL_ART_SSE2 1
+#include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "iterator.h"
+#include "memory.h"
+#include "functional.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+    // 键值的字节视图: size 为字节数, at 为第 i 个字节, 字节的字典序即为元素顺序
+    template <class Key, class = void>
+    struct art_key_traits;
+
+    template <>
+    struct art_key_traits<std::string>
+    {
+        static size_t        size(const std::string& key)           { return key.size(); }
+        static unsigned char at(const std::string& key, size_t i)   { return static_cast<unsigned char>(key[i]); }
+        static bool          equal(const std::string& lhs, const std::string& rhs) { return lhs == rhs; }
+    };
+
+    // 整数按大端序展开, 有符号数把符号位取反, 使字节序与数值大小一致
+    template <class Key>
+    struct art_key_traits<Key, typename std::enable_if<std::is_integral<Key>::value &&
+                                                       !std::is_same<Key, bool>::value>::type>
+    {
+        typedef typename std::make_unsigned<Key>::type unsigned_type;
+
+        static size_t size(const Key&) { return sizeof(Key); }
+
+        static unsigned char at(const Key& key, size_t i)
+        {
+            unsigned_type u = static_cast<unsigned_type>(key);
+            if (std::is_signed<Key>::value)
+                u ^= unsigned_type(1) << (sizeof(Key) * 8 - 1);
+            return static_cast<unsigned char>(u >> (8 * (sizeof(Key) - 1 - i)));
+        }
+
+        static bool equal(const Key& lhs, const Key& rhs) { return lhs == rhs; }
+    };
+
+    constexpr size_t kArtMaxPrefix = 8;
+
+    enum art_node_kind : unsigned char
+    {
+        art_kind4, art_kind16, art_kind48, art_kind256
+    };
+
+    // 叶子链表的节点, 链表头也是这个类型
+    struct art_leaf_base
+    {
+        art_leaf_base* prev;
+        art_leaf_base* next;
+    };
+
+    template <class Value>
+    struct art_leaf : public art_leaf_base
+    {
+        Value value_field;
+    };
+
+    // 内部节点的公共部分; 子节点指针最低位为 1 时指向叶子
+    struct art_node
+    {
+        unsigned char   kind;
+        unsigned short  count;                      // 子节点个数, 不含 end_leaf
+        uint32_t        prefix_len;                 // 压缩路径的完整长度
+        unsigned char   prefix[kArtMaxPrefix];      // 压缩路径的前 kArtMaxPrefix 个字节
+        art_leaf_base*  end_leaf;                   // 键值恰好在本节点 (前缀之后) 结束的叶子
+    };
+
+    // Node4 / Node16: 有序的键和子节点数组
+    struct art_node4 : public art_node
+    {
+        static constexpr unsigned char node_kind = art_kind4;
+        unsigned char keys[4];
+        art_node*     children[4];
+    };
+
+    struct art_node16 : public art_node
+    {
+        static constexpr unsigned char node_kind = art_kind16;
+        unsigned char keys[16];
+        art_node*     children[16];
+    };
+
+    // Node48: 按字节索引的 256 项下标表, 0 表示没有子节点, 否则为 children 中的位置加一
+    struct art_node48 : public art_node
+    {
+        static constexpr unsigned char node_kind = art_kind48;
+        unsigned char index[256];
+        art_node*     children[48];
+    };
+
+    struct art_node256 : public art_node
+    {
+        static constexpr unsigned char node_kind = art_kind256;
+        art_node*     children[256];
+    };
+
+    inline unsigned art_ctz(unsigned x)
+    {
+#ifdef _MSC_VER
+        unsigned long i;
+        _BitScanForward(&i, x);
+        return static_cast<unsigned>(i);
+#else
+        return static_cast<unsigned>(__builtin_ctz(x));
+#endif
+    }
+
+    // 双向迭代器, 沿叶子链表移动
+    template <class T, class Ref, class Ptr>
+    struct art_iterator : public mystl::iterator<mystl::bidirectional_iterator_tag, T>
+    {
+        typedef art_iterator<T, T&, T*>             iterator;
+        typedef art_iterator<T, const T&, const T*> const_iterator;
+        typedef art_iterator                        self;
+
+        typedef T           value_type;
+        typedef Ptr         pointer;
+        typedef Ref         reference;
+        typedef ptrdiff_t   difference_type;
+
+        art_leaf_base* node;
+
+        art_iterator() noexcept : node(nullptr) {}
+        explicit art_iterator(art_leaf_base* x) noexcept : node(x) {}
+        art_iterator(const iterator& rhs) noexcept : node(rhs.node) {}
+
+        reference operator*()  const { return static_cast<art_leaf<T>*>(node)->value_field; }
+        pointer   operator->() const { return &(operator*()); }
+
+        self& operator++()
+        {
+            node = node->next;
+            return *this;
+        }
+        self operator++(int)
+        {
+            self tmp = *this;
+            node = node->next;
+            return tmp;
+        }
+        self& operator--()
+        {
+            node = node->prev;
+            return *this;
+        }
+        self operator--(int)
+        {
+            self tmp = *this;
+            node = node->prev;
+            return tmp;
+        }
+
+        bool operator==(const self& rhs) const { return node == rhs.node; }
+        bool operator!=(const self& rhs) const { return node != rhs.node; }
+    };
+
+    // 模板类 art_map
+    // 参数一表示键值类型, 参数二表示实值类型, 参数三提供键值的字节视图
+    template <class Key, class T, class KeyTraits = art_key_traits<Key>>
+    class art_map
+    {
+    public:
+        typedef Key                             key_type;
+        typedef T                               mapped_type;
+        typedef mystl::pair<const Key, T>       value_type;
+        typedef KeyTraits                       key_traits;
+
+        typedef mystl::allocator<value_type>    allocator_type;
+        typedef mystl::allocator<value_type>    data_allocator;
+
+        typedef value_type*                     pointer;
+        typedef const value_type*               const_pointer;
+        typedef value_type&                     reference;
+        typedef const value_type&               const_reference;
+        typedef size_t                          size_type;
+        typedef ptrdiff_t                       difference_type;
+
+        typedef art_iterator<value_type, value_type&, value_type*>             iterator;
+        typedef art_iterator<value_type, const value_type&, const value_type*> const_iterator;
+        typedef mystl::reverse_iterator<iterator>                              reverse_iterator;
+        typedef mystl::reverse_iterator<const_iterator>                        const_reverse_iterator;
+
+    private:
+        typedef art_leaf<value_type>                leaf_type;
+        typedef mystl::allocator<leaf_type>         leaf_allocator;
+        typedef mystl::allocator<art_leaf_base>     header_allocator;
+
+        art_node*       root_;
+        art_leaf_base*  header_;    // 叶子链表的头, 作为 end()
+        size_type       size_;
+
+    public:
+        // 构造、复制、移动、析构函数
+        art_map()
+            : root_(nullptr), header_(create_header()), size_(0)
+        {
+        }
+
+        template <class InputIterator>
+        art_map(InputIterator first, InputIterator last)
+            : art_map()
+        {
+            for (; first != last; ++first)
+                insert(*first);
+        }
+
+        art_map(std::initializer_list<value_type> ilist)
+            : art_map(ilist.begin(), ilist.end())
+        {
+        }
+
+        art_map(const art_map& rhs)
+            : art_map()
+        {
+            for (auto it = rhs.begin(); it != rhs.end(); ++it)
+                insert(*it);
+        }
+
+        art_map(art_map&& rhs)
+            : art_map()
+        {
+            swap(rhs);
+        }
+
+        art_map& operator=(const art_map& rhs)
+        {
+            if (this != &rhs)
+            {
+                art_map tmp(rhs);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        art_map& operator=(art_map&& rhs) noexcept
+        {
+            swap(rhs);
+            return *this;
+        }
+
+        ~art_map()
+        {
+            clear();
+            header_allocator::deallocate(header_);
+        }
+
+    public:
+        // 迭代器
+        iterator               begin()         noexcept { return iterator(header_->next); }
+        const_iterator         begin()   const noexcept { return const_iterator(header_->next); }
+        iterator               end()           noexcept { return iterator(header_); }
+        const_iterator         end()     const noexcept { return const_iterator(header_); }
+        reverse_iterator       rbegin()        noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+        reverse_iterator       rend()          noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+        const_iterator         cbegin()  const noexcept { return begin(); }
+        const_iterator         cend()    const noexcept { return end(); }
+
+        // 容量
+        bool      empty()    const noexcept { return size_ == 0; }
+        size_type size()     const noexcept { return size_; }
+        size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+
+    public:
+        // 访问元素
+        mapped_type& at(const key_type& key)
+        {
+            leaf_type* l = find_leaf(key);
+            THROW_OUT_OF_RANGE_IF(l == nullptr, "art_map<Key, T> no such element exists");
+            return l->value_field.second;
+        }
+
+        const mapped_type& at(const key_type& key) const
+        {
+            leaf_type* l = find_leaf(key);
+            THROW_OUT_OF_RANGE_IF(l == nullptr, "art_map<Key, T> no such element exists");
+            return l->value_field.second;
+        }
+
+        mapped_type& operator[](const key_type& key)
+        {
+            bool exact;
+            art_leaf_base* pos = floor_leaf(key, exact);
+            if (exact)
+                return static_cast<leaf_type*>(pos)->value_field.second;
+            return insert_leaf_after(pos, create_leaf(key, mapped_type()))->value_field.second;
+        }
+
+        // 插入删除
+
+        mystl::pair<iterator, bool> insert(const value_type& value)
+        {
+            bool exact;
+            art_leaf_base* pos = floor_leaf(value.first, exact);
+            if (exact)
+                return mystl::make_pair(iterator(pos), false);
+            return mystl::make_pair(iterator(insert_leaf_after(pos, create_leaf(value))), true);
+        }
+
+        template <class ...Args>
+        mystl::pair<iterator, bool> emplace(Args&& ...args)
+        {
+            leaf_type* l = create_leaf(mystl::forward<Args>(args)...);
+            bool exact;
+            art_leaf_base* pos = floor_leaf(l->value_field.first, exact);
+            if (exact)
+            {
+                destroy_leaf(l);
+                return mystl::make_pair(iterator(pos), false);
+            }
+            return mystl::make_pair(iterator(insert_leaf_after(pos, l)), true);
+        }
+
+        size_type erase(const key_type& key)
+        {
+            leaf_type* l = erase_leaf(key);
+            if (l == nullptr)
+                return 0;
+            unlink_leaf(l);
+            destroy_leaf(l);
+            --size_;
+            return 1;
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            MYSTL_DEBUG(pos != end());
+            iterator next(pos.node->next);
+            erase(pos->first);
+            return next;
+        }
+
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            while (first != last)
+                first = erase(first);
+            return iterator(last.node);
+        }
+
+        void clear()
+        {
+            destroy_nodes(root_);
+            root_ = nullptr;
+            art_leaf_base* x = header_->next;
+            while (x != header_)
+            {
+                art_leaf_base* next = x->next;
+                destroy_leaf(static_cast<leaf_type*>(x));
+                x = next;
+            }
+            header_->prev = header_->next = header_;
+            size_ = 0;
+        }
+
+        void swap(art_map& rhs) noexcept
+        {
+            mystl::swap(root_, rhs.root_);
+            mystl::swap(header_, rhs.header_);
+            mystl::swap(size_, rhs.size_);
+        }
+
+    public:
+        // 查找
+
+        iterator find(const key_type& key)
+        {
+            leaf_type* l = find_leaf(key);
+            return l ? iterator(l) : end();
+        }
+
+        const_iterator find(const key_type& key) const
+        {
+            leaf_type* l = find_leaf(key);
+            return l ? const_iterator(l) : end();
+        }
+
+        bool      contains(const key_type& key) const { return find_leaf(key) != nullptr; }
+        size_type count(const key_type& key)    const { return contains(key) ? 1 : 0; }
+
+        iterator lower_bound(const key_type& key)
+        {
+            bool exact;
+            art_leaf_base* pos = floor_leaf(key, exact);
+            return iterator(exact ? pos : pos->next);
+        }
+
+        const_iterator lower_bound(const key_type& key) const
+        {
+            bool exact;
+            art_leaf_base* pos = floor_leaf(key, exact);
+            return const_iterator(exact ? pos : pos->next);
+        }
+
+        iterator upper_bound(const key_type& key)
+        {
+            bool exact;
+            return iterator(floor_leaf(key, exact)->next);
+        }
+
+        const_iterator upper_bound(const key_type& key) const
+        {
+            bool exact;
+            return const_iterator(floor_leaf(key, exact)->next);
+        }
+
+        mystl::pair<iterator, iterator> equal_range(const key_type& key)
+        {
+            bool exact;
+            art_leaf_base* pos = floor_leaf(key, exact);
+            return mystl::pair<iterator, iterator>(iterator(exact ? pos : pos->next), iterator(pos->next));
+        }
+
+        mystl::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+        {
+            bool exact;
+            art_leaf_base* pos = floor_leaf(key, exact);
+            return mystl::pair<const_iterator, const_iterator>(const_iterator(exact ? pos : pos->next),
+                                                               const_iterator(pos->next));
+        }
+
+        // 所有以 prefix 的字节为前缀的元素构成的区间, 只需走到覆盖该前缀的子树, 不必逐个比较
+        mystl::pair<iterator, iterator> prefix_range(const key_type& prefix)
+        {
+            art_node* sub = prefix_subtree(prefix);
+            if (sub == nullptr)
+            {
+                iterator it = lower_bound(prefix);
+                return mystl::pair<iterator, iterator>(it, it);
+            }
+            return mystl::pair<iterator, iterator>(iterator(min_leaf(sub)), iterator(max_leaf(sub)->next));
+        }
+
+        mystl::pair<const_iterator, const_iterator> prefix_range(const key_type& prefix) const
+        {
+            auto r = const_cast<art_map*>(this)->prefix_range(prefix);
+            return mystl::pair<const_iterator, const_iterator>(r.first, r.second);
+        }
+
+    private:
+        // 键值的字节视图
+
+        static const key_type& leaf_key(const art_leaf_base* l)
+        { return static_cast<const leaf_type*>(l)->value_field.first; }
+
+        static size_t        key_size(const key_type& key)           { return key_traits::size(key); }
+        static unsigned char key_at(const key_type& key, size_t i)   { return key_traits::at(key, i); }
+
+        // 从第 from 个字节开始比较两个键值的字节序
+        static int key_compare(const key_type& lhs, const key_type& rhs, size_t from)
+        {
+            const size_t ln = key_size(lhs), rn = key_size(rhs);
+            for (size_t i = from; i < ln && i < rn; ++i)
+            {
+                unsigned char a = key_at(lhs, i), b = key_at(rhs, i);
+                if (a != b)
+                    return a < b ? -1 : 1;
+            }
+            return ln < rn ? -1 : (rn < ln ? 1 : 0);
+        }
+
+        // 带标记的子节点指针
+
+        static bool is_leaf(const art_node* p)
+        { return (reinterpret_cast<uintptr_t>(p) & 1) != 0; }
+
+        static leaf_type* as_leaf(const art_node* p)
+        { return reinterpret_cast<leaf_type*>(reinterpret_cast<uintptr_t>(p) & ~uintptr_t(1)); }
+
+        static art_node* leaf_ref(art_leaf_base* l)
+        { return reinterpret_cast<art_node*>(reinterpret_cast<uintptr_t>(l) | 1); }
+
+        // 节点与叶子的分配
+
+        static art_leaf_base* create_header()
+        {
+            art_leaf_base* h = header_allocator::allocate(1);
+            h->prev = h->next = h;
+            return h;
+        }
+
+        template <class ...Args>
+        static leaf_type* create_leaf(Args&& ...args)
+        {
+            leaf_type* l = leaf_allocator::allocate(1);
+            try
+            {
+                data_allocator::construct(&l->value_field, mystl::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                leaf_allocator::deallocate(l);
+                throw;
+            }
+            return l;
+        }
+
+        static void destroy_leaf(leaf_type* l)
+        {
+            data_allocator::destroy(&l->value_field);
+            leaf_allocator::deallocate(l);
+        }
+
+        template <class Node>
+        static Node* create_node()
+        {
+            Node* n = mystl::allocator<Node>::allocate(1);
+            ::new (n) Node();
+            n->kind = Node::node_kind;
+            return n;
+        }
+
+        static void free_node(art_node* n)
+        {
+            switch (n->kind)
+            {
+            case art_kind4:   mystl::allocator<art_node4>::deallocate(static_cast<art_node4*>(n));     break;
+            case art_kind16:  mystl::allocator<art_node16>::deallocate(static_cast<art_node16*>(n));   break;
+            case art_kind48:  mystl::allocator<art_node48>::deallocate(static_cast<art_node48*>(n));   break;
+            default:          mystl::allocator<art_node256>::deallocate(static_cast<art_node256*>(n)); break;
+            }
+        }
+
+        // 节点长大或缩小时复制公共部分
+        static void copy_header(art_node* dst, const art_node* src)
+        {
+            dst->count = src->count;
+            dst->prefix_len = src->prefix_len;
+            std::memcpy(dst->prefix, src->prefix, kArtMaxPrefix);
+            dst->end_leaf = src->end_leaf;
+        }
+
+        static void destroy_nodes(art_node* p)
+        {
+            if (p == nullptr || is_leaf(p))
+                return;
+            for (int c = next_child_byte(p, -1); c >= 0; c = next_child_byte(p, c))
+                destroy_nodes(*find_child(p, static_cast<unsigned char>(c)));
+            free_node(p);
+        }
+
+        // 叶子链表
+
+        leaf_type* insert_leaf_after(art_leaf_base* pos, leaf_type* l)
+        {
+            l->prev = pos;
+            l->next = pos->next;
+            pos->next->prev = l;
+            pos->next = l;
+            try
+            {
+                insert_aux(l);
+            }
+            catch (...)
+            {
+                unlink_leaf(l);
+                destroy_leaf(l);
+                throw;
+            }
+            ++size_;
+            return l;
+        }
+
+        static void unlink_leaf(art_leaf_base* l)
+        {
+            l->prev->next = l->next;
+            l->next->prev = l->prev;
+        }
+
+    private:
+        // 单个节点上的操作
+
+        // 找到字节 b 对应的子节点槽位, 不存在时返回 nullptr
+        static art_node** find_child(art_node* n, unsigned char b)
+        {
+            switch (n->kind)
+            {
+            case art_kind4:
+            {
+                art_node4* p = static_cast<art_node4*>(n);
+                for (unsigned i = 0; i < p->count; ++i)
+                {
+                    if (p->keys[i] == b)
+                        return &p->children[i];
+                }
+                return nullptr;
+            }
+            case art_kind16:
+            {
+                art_node16* p = static_cast<art_node16*>(n);
+#ifdef MYSTL_ART_SSE2
+                // 16 个键一次比较, 得到相等位置的位掩码
+                __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(b)),
+                                             _mm_loadu_si128(reinterpret_cast<const __m128i*>(p->keys)));
+                unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(cmp)) & ((1u << p->count) - 1);
+                return mask ? &p->children[art_ctz(mask)] : nullptr;
+#else
+                unsigned lo = 0, hi = p->count;
+                while (lo < hi)
+                {
+                    unsigned mid = (lo + hi) / 2;
+                    if (p->keys[mid] < b)
+                        lo = mid + 1;
+                    else
+                        hi = mid;
+                }
+                return lo < p->count && p->keys[lo] == b ? &p->children[lo] : nullptr;
+#endif
+            }
+            case art_kind48:
+            {
+                art_node48* p = static_cast<art_node48*>(n);
+                return p->index[b] ? &p->children[p->index[b] - 1] : nullptr;
+            }
+            default:
+            {
+                art_node256* p = static_cast<art_node256*>(n);
+                return p->children[b] ? &p->children[b] : nullptr;
+            }
+            }
+        }
+
+        // 大于 c 的第一个有子节点的字节, 没有则返回 -1; c 为 -1 时返回最小的字节
+        static int next_child_byte(const art_node* n, int c)
+        {
+            switch (n->kind)
+            {
+            case art_kind4:
+            case art_kind16:
+            {
+                const unsigned char* keys = n->kind == art_kind4
+                    ? static_cast<const art_node4*>(n)->keys : static_cast<const art_node16*>(n)->keys;
+                for (unsigned i = 0; i < n->count; ++i)
+                {
+                    if (keys[i] > c)
+                        return keys[i];
+                }
+                return -1;
+            }
+            case art_kind48:
+            {
+                const art_node48* p = static_cast<const art_node48*>(n);
+                for (int b = c + 1; b < 256; ++b)
+                {
+                    if (p->index[b])
+                        return b;
+                }
+                return -1;
+            }
+            default:
+            {
+                const art_node256* p = static_cast<const art_node256*>(n);
+                for (int b = c + 1; b < 256; ++b)
+                {
+                    if (p->children[b])
+                        return b;
+                }
+                return -1;
+            }
+            }
+        }
+
+        // 小于 c 的最后一个有子节点的字节, 没有则返回 -1; c 为 256 时返回最大的字节
+        static int prev_child_byte(const art_node* n, int c)
+        {
+            switch (n->kind)
+            {
+            case art_kind4:
+            case art_kind16:
+            {
+                const unsigned char* keys = n->kind == art_kind4
+                    ? static_cast<const art_node4*>(n)->keys : static_cast<const art_node16*>(n)->keys;
+                for (unsigned i = n->count; i > 0; --i)
+                {
+                    if (keys[i - 1] < c)
+                        return keys[i - 1];
+                }
+                return -1;
+            }
+            case art_kind48:
+            {
+                const art_node48* p = static_cast<const art_node48*>(n);
+                for (int b = c - 1; b >= 0; --b)
+                {
+                    if (p->index[b])
+                        return b;
+                }
+                return -1;
+            }
+            default:
+            {
+                const art_node256* p = static_cast<const art_node256*>(n);
+                for (int b = c - 1; b >= 0; --b)
+                {
+                    if (p->children[b])
+                        return b;
+                }
+                return -1;
+            }
+            }
+        }
+
+        // 在 ref 指向的节点上增加字节 b 对应的子节点, 节点已满时换成更大的布局
+        static void add_child(art_node*& ref, unsigned char b, art_node* child)
+        {
+            art_node* n = ref;
+            switch (n->kind)
+            {
+            case art_kind4:
+            {
+                art_node4* p = static_cast<art_node4*>(n);
+                if (p->count < 4)
+                {
+                    unsigned pos = 0;
+                    while (pos < p->count && p->keys[pos] < b)
+                        ++pos;
+                    std::memmove(p->keys + pos + 1, p->keys + pos, p->count - pos);
+                    std::memmove(p->children + pos + 1, p->children + pos, (p->count - pos) * sizeof(art_node*));
+                    p->keys[pos] = b;
+                    p->children[pos] = child;
+                    ++p->count;
+                    return;
+                }
+                art_node16* m = create_node<art_node16>();
+                copy_header(m, p);
+                std::memcpy(m->keys, p->keys, 4);
+                std::memcpy(m->children, p->children, 4 * sizeof(art_node*));
+                free_node(p);
+                ref = m;
+                add_child(ref, b, child);
+                return;
+            }
+            case art_kind16:
+            {
+                art_node16* p = static_cast<art_node16*>(n);
+                if (p->count < 16)
+                {
+                    unsigned pos = 0;
+                    while (pos < p->count && p->keys[pos] < b)
+                        ++pos;
+                    std::memmove(p->keys + pos + 1, p->keys + pos, p->count - pos);
+                    std::memmove(p->children + pos + 1, p->children + pos, (p->count - pos) * sizeof(art_node*));
+                    p->keys[pos] = b;
+                    p->children[pos] = child;
+                    ++p->count;
+                    return;
+                }
+                art_node48* m = create_node<art_node48>();
+                copy_header(m, p);
+                for (unsigned i = 0; i < 16; ++i)
+                {
+                    m->index[p->keys[i]] = static_cast<unsigned char>(i + 1);
+                    m->children[i] = p->children[i];
+                }
+                free_node(p);
+                ref = m;
+                add_child(ref, b, child);
+                return;
+            }
+            case art_kind48:
+            {
+                art_node48* p = static_cast<art_node48*>(n);
+                if (p->count < 48)
+                {
+                    unsigned slot = 0;
+                    while (p->children[slot])
+                        ++slot;
+                    p->children[slot] = child;
+                    p->index[b] = static_cast<unsigned char>(slot + 1);
+                    ++p->count;
+                    return;
+                }
+                art_node256* m = create_node<art_node256>();
+                copy_header(m, p);
+                for (unsigned c = 0; c < 256; ++c)
+                {
+                    if (p->index[c])
+                        m->children[c] = p->children[p->index[c] - 1];
+                }
+                free_node(p);
+                ref = m;
+                add_child(ref, b, child);
+                return;
+            }
+            default:
+            {
+                art_node256* p = static_cast<art_node256*>(n);
+                p->children[b] = child;
+                ++p->count;
+                return;
+            }
+            }
+        }
+
+        // 删除 ref 指向的节点中字节 b 对应的子节点, slot 为其槽位
+        static void remove_child(art_node*& ref, unsigned char b, art_node** slot)
+        {
+            art_node* n = ref;
+            switch (n->kind)
+            {
+            case art_kind4:
+            case art_kind16:
+            {
+                unsigned char* keys = n->kind == art_kind4
+                    ? static_cast<art_node4*>(n)->keys : static_cast<art_node16*>(n)->keys;
+                art_node** children = n->kind == art_kind4
+                    ? static_cast<art_node4*>(n)->children : static_cast<art_node16*>(n)->children;
+                size_t pos = static_cast<size_t>(slot - children);
+                std::memmove(keys + pos, keys + pos + 1, n->count - pos - 1);
+                std::memmove(children + pos, children + pos + 1, (n->count - pos - 1) * sizeof(art_node*));
+                break;
+            }
+            case art_kind48:
+            {
+                art_node48* p = static_cast<art_node48*>(n);
+                p->children[p->index[b] - 1] = nullptr;
+                p->index[b] = 0;
+                break;
+            }
+            default:
+                static_cast<art_node256*>(n)->children[b] = nullptr;
+                break;
+            }
+            --n->count;
+            shrink(ref);
+        }
+
+        // 子节点减少后换成更小的布局; 只剩一个分支的 Node4 与唯一的子节点合并
+        static void shrink(art_node*& ref)
+        {
+            art_node* n = ref;
+            switch (n->kind)
+            {
+            case art_kind4:
+            {
+                art_node4* p = static_cast<art_node4*>(n);
+                if (p->count == 0)
+                {
+                    ref = p->end_leaf ? leaf_ref(p->end_leaf) : nullptr;
+                    free_node(p);
+                }
+                else if (p->count == 1 && p->end_leaf == nullptr)
+                {
+                    art_node* child = p->children[0];
+                    if (!is_leaf(child))
+                    {
+                        // 新的前缀为 本节点前缀 + 分支字节 + 子节点前缀, 只保留前 kArtMaxPrefix 个字节
+                        unsigned char buf[kArtMaxPrefix];
+                        size_t len = p->prefix_len < kArtMaxPrefix ? p->prefix_len : kArtMaxPrefix;
+                        std::memcpy(buf, p->prefix, len);
+                        if (len < kArtMaxPrefix)
+                        {
+                            buf[len++] = p->keys[0];
+                            size_t take = child->prefix_len < kArtMaxPrefix - len
+                                ? child->prefix_len : kArtMaxPrefix - len;
+                            std::memcpy(buf + len, child->prefix, take);
+                            len += take;
+                        }
+                        std::memcpy(child->prefix, buf, len);
+                        child->prefix_len += p->prefix_len + 1;
+                    }
+                    ref = child;
+                    free_node(p);
+                }
+                return;
+            }
+            case art_kind16:
+            {
+                art_node16* p = static_cast<art_node16*>(n);
+                if (p->count > 3)
+                    return;
+                art_node4* m = create_node<art_node4>();
+                copy_header(m, p);
+                std::memcpy(m->keys, p->keys, p->count);
+                std::memcpy(m->children, p->children, p->count * sizeof(art_node*));
+                free_node(p);
+                ref = m;
+                shrink(ref);
+                return;
+            }
+            case art_kind48:
+            {
+                art_node48* p = static_cast<art_node48*>(n);
+                if (p->count > 12)
+                    return;
+                art_node16* m = create_node<art_node16>();
+                copy_header(m, p);
+                unsigned pos = 0;
+                for (unsigned c = 0; c < 256; ++c)
+                {
+                    if (p->index[c])
+                    {
+                        m->keys[pos] = static_cast<unsigned char>(c);
+                        m->children[pos++] = p->children[p->index[c] - 1];
+                    }
+                }
+                free_node(p);
+                ref = m;
+                return;
+            }
+            default:
+            {
+                art_node256* p = static_cast<art_node256*>(n);
+                if (p->count > 37)
+                    return;
+                art_node48* m = create_node<art_node48>();
+                copy_header(m, p);
+                unsigned pos = 0;
+                for (unsigned c = 0; c < 256; ++c)
+                {
+                    if (p->children[c])
+                    {
+                        m->index[c] = static_cast<unsigned char>(pos + 1);
+                        m->children[pos++] = p->children[c];
+                    }
+                }
+                free_node(p);
+                ref = m;
+                return;
+            }
+            }
+        }
+
+        // 子树中最小 / 最大的叶子; end_leaf 是它所在子树中最小的键值
+        static leaf_type* min_leaf(const art_node* p)
+        {
+            while (!is_leaf(p))
+            {
+                if (p->end_leaf)
+                    return static_cast<leaf_type*>(p->end_leaf);
+                art_node* n = const_cast<art_node*>(p);
+                p = *find_child(n, static_cast<unsigned char>(next_child_byte(n, -1)));
+            }
+            return as_leaf(p);
+        }
+
+        static leaf_type* max_leaf(const art_node* p)
+        {
+            while (!is_leaf(p))
+            {
+                art_node* n = const_cast<art_node*>(p);
+                int c = prev_child_byte(n, 256);
+                if (c < 0)
+                    return static_cast<leaf_type*>(n->end_leaf);
+                p = *find_child(n, static_cast<unsigned char>(c));
+            }
+            return as_leaf(p);
+        }
+
+        // 完整前缀 (从键值的第 depth 个字节开始) 的第 i 个字节
+        static unsigned char prefix_byte(const art_node* n, size_t depth, size_t i)
+        {
+            return i < kArtMaxPrefix ? n->prefix[i] : key_at(leaf_key(min_leaf(n)), depth + i);
+        }
+
+        // 节点完整前缀与 key 从 depth 起公共部分的长度, key 先结束时不超过剩余长度
+        static size_t prefix_mismatch(const art_node* n, const key_type& key, size_t keylen, size_t depth)
+        {
+            size_t limit = keylen - depth < n->prefix_len ? keylen - depth : n->prefix_len;
+            size_t stored = limit < kArtMaxPrefix ? limit : kArtMaxPrefix;
+            size_t i = 0;
+            for (; i < stored; ++i)
+            {
+                if (n->prefix[i] != key_at(key, depth + i))
+                    return i;
+            }
+            if (i < limit)
+            {
+                const key_type& full = leaf_key(min_leaf(n));
+                for (; i < limit; ++i)
+                {
+                    if (key_at(full, depth + i) != key_at(key, depth + i))
+                        return i;
+                }
+            }
+            return i;
+        }
+
+    private:
+        // 树上的操作
+
+        // 精确查找: 只比较节点中存下来的前缀, 跳过的部分在叶子处用整键比较确认
+        leaf_type* find_leaf(const key_type& key) const
+        {
+            const size_t keylen = key_size(key);
+            const art_node* p = root_;
+            size_t depth = 0;
+            while (p)
+            {
+                if (is_leaf(p))
+                {
+                    leaf_type* l = as_leaf(p);
+                    return key_traits::equal(l->value_field.first, key) ? l : nullptr;
+                }
+                if (p->prefix_len)
+                {
+                    if (depth + p->prefix_len > keylen)
+                        return nullptr;
+                    size_t stored = p->prefix_len < kArtMaxPrefix ? p->prefix_len : kArtMaxPrefix;
+                    for (size_t i = 0; i < stored; ++i)
+                    {
+                        if (p->prefix[i] != key_at(key, depth + i))
+                            return nullptr;
+                    }
+                    depth += p->prefix_len;
+                }
+                if (depth == keylen)
+                {
+                    art_leaf_base* e = p->end_leaf;
+                    return e && key_traits::equal(leaf_key(e), key) ? static_cast<leaf_type*>(e) : nullptr;
+                }
+                art_node** slot = find_child(const_cast<art_node*>(p), key_at(key, depth));
+                if (slot == nullptr)
+                    return nullptr;
+                p = *slot;
+                ++depth;
+            }
+            return nullptr;
+        }
+
+        // 键值不大于 key 的最大叶子, 不存在时返回 header_; exact 表示是否与 key 相等
+        // 下降时记录最深处严格小于 key 的分支, 走不下去时它的最大叶子即为所求
+        art_leaf_base* floor_leaf(const key_type& key, bool& exact) const
+        {
+            exact = false;
+            const size_t keylen = key_size(key);
+            const art_node* p = root_;
+            const art_node* smaller = nullptr;
+            size_t depth = 0;
+            while (p)
+            {
+                if (is_leaf(p))
+                {
+                    leaf_type* l = as_leaf(p);
+                    int c = key_compare(l->value_field.first, key, depth);
+                    if (c <= 0)
+                    {
+                        exact = c == 0;
+                        return l;
+                    }
+                    break;
+                }
+                if (p->prefix_len)
+                {
+                    size_t m = prefix_mismatch(p, key, keylen, depth);
+                    if (m < p->prefix_len)
+                    {
+                        // 整棵子树都大于 key, 或者都小于 key
+                        if (depth + m == keylen || key_at(key, depth + m) < prefix_byte(p, depth, m))
+                            break;
+                        return max_leaf(p);
+                    }
+                    depth += p->prefix_len;
+                }
+                if (depth == keylen)
+                {
+                    if (p->end_leaf)
+                    {
+                        exact = true;
+                        return p->end_leaf;
+                    }
+                    break;
+                }
+                art_node* n = const_cast<art_node*>(p);
+                unsigned char b = key_at(key, depth);
+                int lower = prev_child_byte(n, b);
+                if (lower >= 0)
+                    smaller = *find_child(n, static_cast<unsigned char>(lower));
+                else if (n->end_leaf)
+                    smaller = leaf_ref(n->end_leaf);
+                art_node** slot = find_child(n, b);
+                if (slot == nullptr)
+                    break;
+                p = *slot;
+                ++depth;
+            }
+            return smaller ? static_cast<art_leaf_base*>(max_leaf(smaller)) : header_;
+        }
+
+        // 把已经链入叶子链表的 l 挂到树上, 调用前已确认键值不存在
+        void insert_aux(leaf_type* l)
+        {
+            const key_type& key = l->value_field.first;
+            const size_t keylen = key_size(key);
+            art_node** ref = &root_;
+            size_t depth = 0;
+            while (true)
+            {
+                art_node* p = *ref;
+                if (p == nullptr)
+                {
+                    *ref = leaf_ref(l);
+                    return;
+                }
+                if (is_leaf(p))
+                {
+                    split_leaf(*ref, l, depth);
+                    return;
+                }
+                if (p->prefix_len)
+                {
+                    size_t m = prefix_mismatch(p, key, keylen, depth);
+                    if (m < p->prefix_len)
+                    {
+                        split_prefix(*ref, m, l, depth);
+                        return;
+                    }
+                    depth += p->prefix_len;
+                }
+                if (depth == keylen)
+                {
+                    p->end_leaf = l;
+                    return;
+                }
+                art_node** slot = find_child(p, key_at(key, depth));
+                if (slot == nullptr)
+                {
+                    add_child(*ref, key_at(key, depth), leaf_ref(l));
+                    return;
+                }
+                ref = slot;
+                ++depth;
+            }
+        }
+
+        // ref 指向叶子, 与新叶子 l 的键值从 depth 起的公共部分成为新 Node4 的前缀
+        static void split_leaf(art_node*& ref, leaf_type* l, size_t depth)
+        {
+            leaf_type* old = as_leaf(ref);
+            const key_type& key = l->value_field.first;
+            const key_type& old_key = old->value_field.first;
+            const size_t keylen = key_size(key), old_len = key_size(old_key);
+            size_t i = depth;
+            while (i < keylen && i < old_len && key_at(key, i) == key_at(old_key, i))
+                ++i;
+            art_node* n = create_node<art_node4>();
+            n->prefix_len = static_cast<uint32_t>(i - depth);
+            for (size_t j = 0; j < n->prefix_len && j < kArtMaxPrefix; ++j)
+                n->prefix[j] = key_at(key, depth + j);
+            if (i == old_len)
+                n->end_leaf = old;
+            else
+                add_child(n, key_at(old_key, i), leaf_ref(old));
+            if (i == keylen)
+                n->end_leaf = l;
+            else
+                add_child(n, key_at(key, i), leaf_ref(l));
+            ref = n;
+        }
+
+        // ref 指向的节点的前缀在第 m 个字节处与新键值不同, 在该处分出新的 Node4
+        static void split_prefix(art_node*& ref, size_t m, leaf_type* l, size_t depth)
+        {
+            art_node* old = ref;
+            const key_type& key = l->value_field.first;
+            art_node* n = create_node<art_node4>();
+            n->prefix_len = static_cast<uint32_t>(m);
+            std::memcpy(n->prefix, old->prefix, m < kArtMaxPrefix ? m : kArtMaxPrefix);
+            unsigned char b = prefix_byte(old, depth, m);
+            // old 保留分支字节之后的部分
+            if (old->prefix_len <= kArtMaxPrefix)
+            {
+                old->prefix_len -= static_cast<uint32_t>(m + 1);
+                std::memmove(old->prefix, old->prefix + m + 1, old->prefix_len);
+            }
+            else
+            {
+                old->prefix_len -= static_cast<uint32_t>(m + 1);
+                const key_type& full = leaf_key(min_leaf(old));
+                for (size_t i = 0; i < old->prefix_len && i < kArtMaxPrefix; ++i)
+                    old->prefix[i] = key_at(full, depth + m + 1 + i);
+            }
+            add_child(n, b, old);
+            if (depth + m == key_size(key))
+                n->end_leaf = l;
+            else
+                add_child(n, key_at(key, depth + m), leaf_ref(l));
+            ref = n;
+        }
+
+        // 把键值为 key 的叶子从树上摘下并返回, 不存在时返回 nullptr; 只有叶子所在的节点可能改变布局
+        leaf_type* erase_leaf(const key_type& key)
+        {
+            const size_t keylen = key_size(key);
+            art_node** ref = &root_;
+            size_t depth = 0;
+            while (*ref)
+            {
+                art_node* p = *ref;
+                if (is_leaf(p))
+                {
+                    // 只有根节点会走到这里, 其他叶子在父节点中处理
+                    leaf_type* l = as_leaf(p);
+                    if (!key_traits::equal(l->value_field.first, key))
+                        return nullptr;
+                    *ref = nullptr;
+                    return l;
+                }
+                depth += p->prefix_len;
+                if (depth > keylen)
+                    return nullptr;
+                if (depth == keylen)
+                {
+                    art_leaf_base* e = p->end_leaf;
+                    if (e == nullptr || !key_traits::equal(leaf_key(e), key))
+                        return nullptr;
+                    p->end_leaf = nullptr;
+                    shrink(*ref);
+                    return static_cast<leaf_type*>(e);
+                }
+                unsigned char b = key_at(key, depth);
+                art_node** slot = find_child(p, b);
+                if (slot == nullptr)
+                    return nullptr;
+                if (is_leaf(*slot))
+                {
+                    leaf_type* l = as_leaf(*slot);
+                    if (!key_traits::equal(l->value_field.first, key))
+                        return nullptr;
+                    remove_child(*ref, b, slot);
+                    return l;
+                }
+                ref = slot;
+                ++depth;
+            }
+            return nullptr;
+        }
+
+        // 所有键值以 prefix 为前缀的元素构成的子树, 不存在时返回 nullptr
+        art_node* prefix_subtree(const key_type& prefix) const
+        {
+            const size_t plen = key_size(prefix);
+            art_node* p = root_;
+            size_t depth = 0;
+            while (p)
+            {
+                if (depth == plen)
+                    return p;
+                if (is_leaf(p))
+                {
+                    const key_type& k = as_leaf(p)->value_field.first;
+                    if (key_size(k) < plen)
+                        return nullptr;
+                    for (size_t i = depth; i < plen; ++i)
+                    {
+                        if (key_at(k, i) != key_at(prefix, i))
+                            return nullptr;
+                    }
+                    return p;
+                }
+                size_t m = prefix_mismatch(p, prefix, plen, depth);
+                if (m < p->prefix_len)
+                    return depth + m == plen ? p : nullptr;
+                depth += p->prefix_len;
+                if (depth == plen)
+                    return p;
+                art_node** slot = find_child(p, key_at(prefix, depth));
+                if (slot == nullptr)
+                    return nullptr;
+                p = *slot;
+                ++depth;
+            }
+            return nullptr;
+        }
+
+    public:
+        bool operator==(const art_map& rhs) const
+        {
+            if (size_ != rhs.size_)
+                return false;
+            for (auto i = begin(), j = rhs.begin(); i != end(); ++i, ++j)
+            {
+                if (!key_traits::equal(i->first, j->first) || !(i->second == j->second))
+                    return false;
+            }
+            return true;
+        }
+
+        bool operator!=(const art_map& rhs) const { return !(*this == rhs); }
+    };
+
+    template <class Key, class T, class KeyTraits>
+    void swap(art_map<Key, T, KeyTraits>& lhs, art_map<Key, T, KeyTraits>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+} // namespace mystl
+
+#endif //TINYSTL_ART_MAP_H
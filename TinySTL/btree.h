@@ -0,0 +1,1131 @@
+#ifndef TINYSTL_BTREE_H
+#define TINYSTL_BTREE_H
+
+// 该模板类为 btree (B+ 树), 作为 btree_set / btree_map 的底层容器
+// 与 rb_tree 每个元素一个节点不同, btree 的所有元素连续存放在叶子节点中, 叶子节点之间以双向链表相连,
+// 内部节点只保存分隔键与子节点指针, 查找时只需访问 log_B(n) 个节点, 顺序遍历时几乎不会发生 cache miss
+// 节点的大小由模板参数 NodeBytes 决定, 一般取 cache line 的整数倍(如 256)或页大小(如 4096)
+//
+// 注意: 与 rb_tree 不同, 插入和删除会在节点间移动元素, 因此会使所有迭代器失效
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "iterator.h"
+#include "memory.h"
+#include "functional.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+    struct btree_node_base
+    {
+        typedef btree_node_base* base_ptr;
+
+        base_ptr parent;  // 父节点, 一定是内部节点
+        size_t   count;   // 叶子节点为元素个数, 内部节点为子节点个数
+        bool     leaf;
+    };
+
+    // 叶子节点的头部, 比 btree_node_base 多出前后叶子的指针
+    template <class Leaf>
+    struct btree_leaf_header : public btree_node_base
+    {
+        Leaf* prev;
+        Leaf* next;
+    };
+
+    // 叶子节点, 元素以未初始化的内存连续存放, 只有 [0, count) 范围内的元素被构造
+    template <class Value, size_t Slots>
+    struct btree_leaf_node : public btree_leaf_header<btree_leaf_node<Value, Slots>>
+    {
+        typedef btree_leaf_node<Value, Slots>* leaf_ptr;
+
+        typename std::aligned_storage<sizeof(Value), alignof(Value)>::type slots[Slots];
+
+        Value*       values()       { return reinterpret_cast<Value*>(slots); }
+        const Value* values() const { return reinterpret_cast<const Value*>(slots); }
+        Value&       value(size_t i)       { return values()[i]; }
+        const Value& value(size_t i) const { return values()[i]; }
+    };
+
+    // 内部节点, 有 count 个子节点以及 count - 1 个分隔键
+    // 第 i 棵子树中的元素都不小于 key(i - 1) 且不大于 key(i)
+    template <class Key, size_t Slots>
+    struct btree_inner_node : public btree_node_base
+    {
+        typename std::aligned_storage<sizeof(Key), alignof(Key)>::type keys[Slots - 1];
+        btree_node_base* children[Slots];
+
+        Key&       key(size_t i)       { return reinterpret_cast<Key*>(keys)[i]; }
+        const Key& key(size_t i) const { return reinterpret_cast<const Key*>(keys)[i]; }
+    };
+
+    // 根据节点字节数计算叶子节点 / 内部节点的容量, 每种节点至少容纳 4 个槽位
+    // 头部大小取自节点实际的头部结构, 槽位从按元素对齐后的位置开始
+    template <class Key, class Value, size_t NodeBytes>
+    struct btree_node_size
+    {
+        static constexpr size_t align_up(size_t n, size_t a) { return (n + a - 1) / a * a; }
+
+        // 叶子头部中的 prev / next 都是指针, 大小与 Leaf 的具体类型无关
+        static constexpr size_t leaf_header  = align_up(sizeof(btree_leaf_header<void>), alignof(Value));
+        static constexpr size_t inner_header = align_up(sizeof(btree_node_base), alignof(Key));
+
+        static constexpr size_t leaf_raw  = NodeBytes > leaf_header
+                                            ? (NodeBytes - leaf_header) / sizeof(Value) : 0;
+        static constexpr size_t inner_raw = NodeBytes > inner_header
+                                            ? (NodeBytes - inner_header) / (sizeof(Key) + sizeof(void*)) : 0;
+
+        static constexpr size_t leaf_slots  = leaf_raw  < 4 ? 4 : leaf_raw;
+        static constexpr size_t inner_slots = inner_raw < 4 ? 4 : inner_raw;
+    };
+
+    // btree 的迭代器, 由叶子节点与节点内下标组成
+    template <class Value, class Ref, class Ptr, class Leaf>
+    struct btree_iterator : public mystl::iterator<bidirectional_iterator_tag, Value>
+    {
+        typedef Value                                                       value_type;
+        typedef Ref                                                         reference;
+        typedef Ptr                                                         pointer;
+        typedef btree_iterator<Value, Value&, Value*, Leaf>                 iterator;
+        typedef btree_iterator<Value, const Value&, const Value*, Leaf>     const_iterator;
+        typedef btree_iterator<Value, Ref, Ptr, Leaf>                       self;
+
+        Leaf*  node;
+        size_t pos;
+
+        btree_iterator() : node(nullptr), pos(0) {}
+        btree_iterator(Leaf* x, size_t n) : node(x), pos(n) {}
+        // iterator 到 const_iterator 的转换, 写成模板使复制构造仍是平凡的
+        template <class It, typename std::enable_if<
+            std::is_same<It, iterator>::value && !std::is_same<It, self>::value, int>::type = 0>
+        btree_iterator(const It& it) : node(it.node), pos(it.pos) {}
+
+        reference operator*()  const { return node->value(pos); }
+        pointer   operator->() const { return &(operator*()); }
+
+        // 走到叶子末尾时跳到下一个叶子的开头, 最右叶子的末尾即为 end()
+        self& operator++()
+        {
+            if (++pos == node->count && nullptr != node->next)
+            {
+                node = node->next;
+                pos = 0;
+            }
+            return *this;
+        }
+        self operator++(int)
+        {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        self& operator--()
+        {
+            if (0 == pos)
+            {
+                node = node->prev;
+                pos = node->count;
+            }
+            --pos;
+            return *this;
+        }
+        self operator--(int)
+        {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        bool operator==(const self& rhs) const { return node == rhs.node && pos == rhs.pos; }
+        bool operator!=(const self& rhs) const { return !(*this == rhs); }
+    };
+
+    // 模板类 btree
+    // 参数一为键值类型, 参数二为元素类型, 参数三为从元素中取出键值的方式, 参数四为键值比较方式
+    // 参数五为单个节点期望占用的字节数
+    template <class Key, class Value, class KeyOfValue, class Compare, size_t NodeBytes = 256>
+    class btree
+    {
+    public:
+        typedef btree_node_size<Key, Value, NodeBytes>  node_size;
+
+        static constexpr size_t leaf_slots  = node_size::leaf_slots;
+        static constexpr size_t inner_slots = node_size::inner_slots;
+        static constexpr size_t leaf_min    = leaf_slots / 2;
+        static constexpr size_t inner_min   = inner_slots / 2;
+
+        typedef btree_node_base*                        base_ptr;
+        typedef btree_leaf_node<Value, leaf_slots>      leaf_node;
+        typedef btree_inner_node<Key, inner_slots>      inner_node;
+
+        // 只有元素过大、被迫取最少 4 个槽位时节点才会超过 NodeBytes
+        static_assert(sizeof(leaf_node) <= NodeBytes || node_size::leaf_raw < 4,
+                      "btree leaf node exceeds NodeBytes");
+        static_assert(sizeof(inner_node) <= NodeBytes || node_size::inner_raw < 4,
+                      "btree inner node exceeds NodeBytes");
+
+        typedef mystl::allocator<Value>                 allocator_type;
+        typedef mystl::allocator<Value>                 data_allocator;
+        typedef mystl::allocator<Key>                   key_allocator;
+        typedef mystl::allocator<leaf_node>             leaf_allocator;
+        typedef mystl::allocator<inner_node>            inner_allocator;
+
+        typedef Key                                      key_type;
+        typedef Value                                    value_type;
+
+        typedef typename allocator_type::pointer         pointer;
+        typedef typename allocator_type::const_pointer   const_pointer;
+        typedef typename allocator_type::reference       reference;
+        typedef typename allocator_type::const_reference const_reference;
+        typedef typename allocator_type::size_type       size_type;
+        typedef typename allocator_type::difference_type difference_type;
+
+        typedef btree_iterator<value_type, reference, pointer, leaf_node>             iterator;
+        typedef btree_iterator<value_type, const_reference, const_pointer, leaf_node> const_iterator;
+        typedef mystl::reverse_iterator<iterator>                                     reverse_iterator;
+        typedef mystl::reverse_iterator<const_iterator>                               const_reverse_iterator;
+
+    protected:
+        base_ptr    root;
+        leaf_node*  head;        // 最左叶子, 即 begin() 所在节点
+        leaf_node*  tail;        // 最右叶子, 即 end() 所在节点
+        size_type   node_count;  // 元素个数
+        Compare     key_compare;
+
+    protected:
+        // 节点的创建与销毁
+        leaf_node* create_leaf()
+        {
+            leaf_node* x = leaf_allocator::allocate(1);
+            x->parent = nullptr;
+            x->count = 0;
+            x->leaf = true;
+            x->prev = nullptr;
+            x->next = nullptr;
+            return x;
+        }
+
+        inner_node* create_inner()
+        {
+            inner_node* x = inner_allocator::allocate(1);
+            x->parent = nullptr;
+            x->count = 0;
+            x->leaf = false;
+            return x;
+        }
+
+        void destroy_leaf(leaf_node* x)
+        {
+            data_allocator::destroy(x->values(), x->values() + x->count);
+            leaf_allocator::deallocate(x);
+        }
+
+        void destroy_inner(inner_node* x)
+        {
+            for (size_type i = 0; i + 1 < x->count; ++i)
+                key_allocator::destroy(&x->key(i));
+            inner_allocator::deallocate(x);
+        }
+
+        void destroy_subtree(base_ptr x)
+        {
+            if (x->leaf)
+            {
+                destroy_leaf(static_cast<leaf_node*>(x));
+                return;
+            }
+            inner_node* in = static_cast<inner_node*>(x);
+            for (size_type i = 0; i < in->count; ++i)
+                destroy_subtree(in->children[i]);
+            destroy_inner(in);
+        }
+
+        void btree_init()
+        {
+            head = tail = create_leaf();
+            root = head;
+            node_count = 0;
+        }
+
+        static const key_type& key(const value_type& value) { return KeyOfValue()(value); }
+
+        // 节点内的二分查找
+        // inner_lower: 第一个不小于 k 的分隔键下标, 即 lower_bound 应进入的子树
+        // inner_upper: 第一个大于 k 的分隔键下标, 即 upper_bound 应进入的子树
+        size_type inner_lower(const inner_node* x, const key_type& k) const
+        {
+            size_type lo = 0, hi = x->count - 1;
+            while (lo < hi)
+            {
+                size_type mid = (lo + hi) >> 1;
+                if (key_compare(x->key(mid), k)) lo = mid + 1;
+                else                             hi = mid;
+            }
+            return lo;
+        }
+
+        size_type inner_upper(const inner_node* x, const key_type& k) const
+        {
+            size_type lo = 0, hi = x->count - 1;
+            while (lo < hi)
+            {
+                size_type mid = (lo + hi) >> 1;
+                if (key_compare(k, x->key(mid))) hi = mid;
+                else                             lo = mid + 1;
+            }
+            return lo;
+        }
+
+        size_type leaf_lower(const leaf_node* x, const key_type& k) const
+        {
+            size_type lo = 0, hi = x->count;
+            while (lo < hi)
+            {
+                size_type mid = (lo + hi) >> 1;
+                if (key_compare(key(x->value(mid)), k)) lo = mid + 1;
+                else                                    hi = mid;
+            }
+            return lo;
+        }
+
+        size_type leaf_upper(const leaf_node* x, const key_type& k) const
+        {
+            size_type lo = 0, hi = x->count;
+            while (lo < hi)
+            {
+                size_type mid = (lo + hi) >> 1;
+                if (key_compare(k, key(x->value(mid)))) hi = mid;
+                else                                    lo = mid + 1;
+            }
+            return lo;
+        }
+
+        leaf_node* descend_lower(const key_type& k) const
+        {
+            base_ptr x = root;
+            while (!x->leaf)
+            {
+                inner_node* in = static_cast<inner_node*>(x);
+                x = in->children[inner_lower(in, k)];
+            }
+            return static_cast<leaf_node*>(x);
+        }
+
+        leaf_node* descend_upper(const key_type& k) const
+        {
+            base_ptr x = root;
+            while (!x->leaf)
+            {
+                inner_node* in = static_cast<inner_node*>(x);
+                x = in->children[inner_upper(in, k)];
+            }
+            return static_cast<leaf_node*>(x);
+        }
+
+        // 位于叶子末尾的位置等价于下一个叶子的开头
+        static iterator make_iter(leaf_node* x, size_type pos)
+        {
+            if (pos == x->count && nullptr != x->next)
+                return iterator(x->next, 0);
+            return iterator(x, pos);
+        }
+
+        static size_type child_index(const inner_node* p, const btree_node_base* x)
+        {
+            size_type i = 0;
+            while (p->children[i] != x) ++i;
+            return i;
+        }
+
+        // 将 [first, first + n) 的元素移动到未初始化的 result 处, 并析构原元素
+        static void relocate(value_type* first, size_type n, value_type* result)
+        {
+            for (size_type i = 0; i < n; ++i)
+            {
+                data_allocator::construct(result + i, mystl::move(first[i]));
+                data_allocator::destroy(first + i);
+            }
+        }
+
+        static void relocate_backward(value_type* first, size_type n, value_type* result)
+        {
+            for (size_type i = n; i > 0; --i)
+            {
+                data_allocator::construct(result + i - 1, mystl::move(first[i - 1]));
+                data_allocator::destroy(first + i - 1);
+            }
+        }
+
+        static void relocate_key(key_type* from, key_type* to)
+        {
+            key_allocator::construct(to, mystl::move(*from));
+            key_allocator::destroy(from);
+        }
+
+        iterator insert_at(leaf_node* x, size_type pos, value_type&& value);
+        void     insert_into_parent(base_ptr left, const key_type& sep, base_ptr right);
+        void     inner_insert(inner_node* p, size_type i, const key_type& sep, base_ptr child);
+        void     inner_remove(inner_node* p, size_type i);
+
+        iterator erase_at(leaf_node* x, size_type pos);
+        void     rebalance_leaf(leaf_node* x, leaf_node*& track, size_type& track_pos);
+        void     rebalance_inner(inner_node* x);
+
+        base_ptr copy_subtree(const btree_node_base* x, base_ptr p, leaf_node*& last);
+
+    public:
+        btree() : key_compare()
+        { btree_init(); }
+
+        btree(const btree& other)
+            : key_compare(other.key_compare)
+        {
+            btree_init();
+            copy_from(other);
+        }
+
+        // 移动后 other 仍是一棵可用的空树, 需要为它分配一个空叶子, 因此可能抛出异常
+        btree(btree&& other)
+            : key_compare(other.key_compare)
+        {
+            btree_init();
+            swap(other);
+        }
+
+        btree& operator=(const btree& rhs)
+        {
+            if (this != &rhs)
+            {
+                clear();
+                key_compare = rhs.key_compare;
+                copy_from(rhs);
+            }
+            return *this;
+        }
+
+        btree& operator=(btree&& rhs)
+        {
+            if (this != &rhs)
+            {
+                btree tmp(mystl::move(rhs));
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        ~btree()
+        {
+            if (nullptr != root)
+                destroy_subtree(root);
+        }
+
+    public:
+        // 迭代器
+        iterator                begin()             noexcept { return iterator(head, 0); }
+        const_iterator          begin()       const noexcept { return const_iterator(iterator(head, 0)); }
+        iterator                end()               noexcept { return iterator(tail, tail->count); }
+        const_iterator          end()         const noexcept { return const_iterator(iterator(tail, tail->count)); }
+
+        reverse_iterator        rbegin()            noexcept
+        { return reverse_iterator(end()); }
+        const_reverse_iterator  rbegin()      const noexcept
+        { return const_reverse_iterator(end()); }
+        reverse_iterator        rend()              noexcept
+        { return reverse_iterator(begin()); }
+        const_reverse_iterator  rend()        const noexcept
+        { return const_reverse_iterator(begin()); }
+
+        // 容器相关操作
+        bool        empty()       const noexcept { return node_count == 0; }
+        size_type   size()        const noexcept { return node_count; }
+        size_type   max_size()    const noexcept { return static_cast<size_type>(-1); }
+
+        // 树中所有节点占用的字节数, 用于估计每个元素的内存开销
+        size_type   bytes_used()  const noexcept
+        { return nullptr == root ? 0 : bytes_used(root); }
+
+        void swap(btree& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                mystl::swap(root, rhs.root);
+                mystl::swap(head, rhs.head);
+                mystl::swap(tail, rhs.tail);
+                mystl::swap(node_count, rhs.node_count);
+                mystl::swap(key_compare, rhs.key_compare);
+            }
+        }
+
+    public:
+        // 插入删除相关操作
+
+        template <class ...Args>
+        iterator emplace_multi(Args&& ...args)
+        { return insert_multi(value_type(mystl::forward<Args>(args)...)); }
+
+        template <class ...Args>
+        mystl::pair<iterator, bool> emplace_unique(Args&& ...args)
+        { return insert_unique(value_type(mystl::forward<Args>(args)...)); }
+
+        template <class ...Args>
+        iterator emplace_multi_use_hint(const_iterator hint, Args&& ...args)
+        { return insert_multi(hint, value_type(mystl::forward<Args>(args)...)); }
+
+        template <class ...Args>
+        iterator emplace_unique_use_hint(const_iterator hint, Args&& ...args)
+        { return insert_unique(hint, value_type(mystl::forward<Args>(args)...)); }
+
+        iterator insert_multi(const value_type& value)
+        { return insert_multi(value_type(value)); }
+
+        iterator insert_multi(value_type&& value)
+        {
+            THROW_LENGTH_ERROR_IF(node_count > max_size() - 1,
+                                  "btree<Key, Value, KeyOfValue, Compare>'s size too big");
+            leaf_node* x = descend_upper(key(value));
+            return insert_at(x, leaf_upper(x, key(value)), mystl::move(value));
+        }
+
+        iterator insert_multi(const_iterator hint, const value_type& value)
+        { return insert_multi(hint, value_type(value)); }
+
+        iterator insert_multi(const_iterator hint, value_type&& value);
+
+        template <class InputIter>
+        void insert_multi(InputIter first, InputIter last)
+        {
+            for (; first != last; ++first)
+                insert_multi(end(), *first);
+        }
+
+        mystl::pair<iterator, bool> insert_unique(const value_type& value)
+        { return insert_unique(value_type(value)); }
+
+        mystl::pair<iterator, bool> insert_unique(value_type&& value);
+
+        iterator insert_unique(const_iterator hint, const value_type& value)
+        { return insert_unique(hint, value_type(value)); }
+
+        iterator insert_unique(const_iterator hint, value_type&& value);
+
+        template <class InputIter>
+        void insert_unique(InputIter first, InputIter last)
+        {
+            for (; first != last; ++first)
+                insert_unique(end(), *first);
+        }
+
+        // erase
+
+        iterator  erase(const_iterator position)
+        { return erase_at(position.node, position.pos); }
+
+        size_type erase_multi(const key_type& key);
+
+        size_type erase_unique(const key_type& key);
+
+        iterator  erase(const_iterator first, const_iterator last);
+
+        void      clear();
+
+    public:
+        // btree 相关操作
+
+        iterator       find(const key_type& k)
+        {
+            iterator it = lower_bound(k);
+            return (it == end() || key_compare(k, key(*it))) ? end() : it;
+        }
+
+        const_iterator find(const key_type& k) const
+        {
+            const_iterator it = lower_bound(k);
+            return (it == end() || key_compare(k, key(*it))) ? end() : it;
+        }
+
+        size_type count_multi(const key_type& k) const
+        {
+            auto p = equal_range_multi(k);
+            return static_cast<size_type>(mystl::distance(p.first, p.second));
+        }
+
+        size_type count_unique(const key_type& k) const
+        { return find(k) == end() ? 0 : 1; }
+
+        iterator       lower_bound(const key_type& k)
+        {
+            leaf_node* x = descend_lower(k);
+            return make_iter(x, leaf_lower(x, k));
+        }
+
+        const_iterator lower_bound(const key_type& k) const
+        {
+            leaf_node* x = descend_lower(k);
+            return make_iter(x, leaf_lower(x, k));
+        }
+
+        iterator       upper_bound(const key_type& k)
+        {
+            leaf_node* x = descend_upper(k);
+            return make_iter(x, leaf_upper(x, k));
+        }
+
+        const_iterator upper_bound(const key_type& k) const
+        {
+            leaf_node* x = descend_upper(k);
+            return make_iter(x, leaf_upper(x, k));
+        }
+
+        mystl::pair<iterator, iterator>
+        equal_range_multi(const key_type& k)
+        { return mystl::pair<iterator, iterator>(lower_bound(k), upper_bound(k)); }
+
+        mystl::pair<const_iterator, const_iterator>
+        equal_range_multi(const key_type& k) const
+        { return mystl::pair<const_iterator, const_iterator>(lower_bound(k), upper_bound(k)); }
+
+        mystl::pair<iterator, iterator>
+        equal_range_unique(const key_type& k)
+        {
+            iterator it = find(k);
+            iterator nex = it;
+            return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, ++nex);
+        }
+
+        mystl::pair<const_iterator, const_iterator>
+        equal_range_unique(const key_type& k) const
+        {
+            const_iterator it = find(k);
+            const_iterator nex = it;
+            return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, ++nex);
+        }
+
+    private:
+        void copy_from(const btree& other)
+        {
+            if (0 == other.node_count)
+                return;
+            destroy_leaf(head);
+            leaf_node* last = nullptr;
+            try
+            {
+                root = copy_subtree(other.root, nullptr, last);
+            }
+            catch (...)
+            {
+                btree_init();
+                throw;
+            }
+            head = static_cast<leaf_node*>(root);
+            while (!head->leaf)
+                head = static_cast<leaf_node*>(static_cast<inner_node*>(
+                                               static_cast<base_ptr>(head))->children[0]);
+            tail = last;
+            node_count = other.node_count;
+        }
+
+        size_type bytes_used(const btree_node_base* x) const
+        {
+            if (x->leaf)
+                return sizeof(leaf_node);
+            const inner_node* in = static_cast<const inner_node*>(x);
+            size_type n = sizeof(inner_node);
+            for (size_type i = 0; i < in->count; ++i)
+                n += bytes_used(in->children[i]);
+            return n;
+        }
+    };
+
+    /****************************************************************************/
+
+    // 在叶子 x 的 pos 处插入元素, 叶子已满时先分裂
+    template <class Key, class Value, class KeyOfValue, class Compare, size_t NodeBytes>
+    typename btree<Key, Value, KeyOfValue, Compare, NodeBytes>::iterator
+    btree<Key, Value, KeyOfValue, Compare, NodeBytes>::
+    insert_at(leaf_node* x, size_type pos, value_type&& value)
+    {
+        if (x->count == leaf_slots)
+        {
+            // 在最右叶子末尾追加时只分出一个空叶子, 使顺序插入时叶子保持满载
+            size_type mid = (x == tail && pos == leaf_slots) ? leaf_slots : leaf_slots / 2;
+            leaf_node* right = create_leaf();
+            if (mid == leaf_slots)
+            {
+                right->prev = x;
+                x->next = right;
+                tail = right;
+                // 空叶子没有分隔键可用, 先放入新元素再向父节点登记
+                data_allocator::construct(right->values(), mystl::move(value));
+                right->count = 1;
+                ++node_count;
+                try
+                {
+                    insert_into_parent(x, key(right->value(0)), right);
+                }
+                catch (...)
+                {
+                    x->next = nullptr;
+                    tail = x;
+                    --node_count;
+                    destroy_leaf(right);
+                    throw;
+                }
+                return iterator(right, 0);
+            }
+            relocate(x->values() + mid, leaf_slots - mid, right->values());
+            right->count = leaf_slots - mid;
+            x->count = mid;
+            right->next = x->next;
+            right->prev = x;
+            if (nullptr != x->next)
+                x->next->prev = right;
+            else
+                tail = right;
+            x->next = right;
+            insert_into_parent(x, key(right->value(0)), right);
+            if (pos > mid)
+            {
+                x = right;
+                pos -= mid;
+            }
+        }
+        relocate_backward(x->values() + pos, x->count - pos, x->values() + pos + 1);
+        data_allocator::construct(x->values() + pos, mystl::move(value));
+        ++x->count;
+        ++node_count;
+        return iterator(x, pos);
+    }
+
+    // 在内部节点 p 的第 i 个子节点之后插入分隔键 sep 与子节点 child, p 必须有空位
+    template <class Key, class Value, class KeyOfValue, class Compare, size_t NodeBytes>
+    void btree<Key, Value, KeyOfValue, Compare, NodeBytes>::
+    inner_insert(inner_node* p, size_type i, const key_type& sep, base_ptr child)
+    {
+        for (size_type j = p->count - 1; j > i; --j)
+            relocate_key(&p->key(j - 1), &p->key(j));
+        for (size_type j = p->count; j > i + 1; --j)
+            p->children[j] = p->children[j - 1];
+        key_allocator::construct(&p->key(i), sep);
+        p->children[i + 1] = child;
+        child->parent = p;
+        ++p->count;
+    }
+
+    // 删除内部节点 p 的第 i 个子节点以及它左侧的分隔键
+    template <class Key, class Value, class KeyOfValue, class Compare, size_t NodeBytes>
+    void btree<Key, Value, KeyOfValue, Compare, NodeBytes>::
+    inner_remove(inner_node* p, size_type i)
+    {
+        key_allocator::destroy(&p->key(i - 1));
+        for (size_type j = i - 1; j + 2 < p->count; ++j)
+            relocate_key(&p->key(j + 1), &p->key(j));
+        for (size_type j = i; j + 1 < p->count; ++j)
+            p->children[j] = p->children[j + 1];
+        --p->count;
+    }
+
+    // 节点分裂后, 把新节点 right 登记到 left 的父节点中, 必要时向上分裂直到根
+    template <class Key, class Value, class KeyOfValue, class Compare, size_t NodeBytes>
+    void btree<Key, Value, KeyOfValue, Compare, NodeBytes>::
+    insert_into_parent(base_ptr left, const key_type& sep, base_ptr right)
+    {
+        inner_node* p = static_cast<inner_node*>(left->parent);
+        if (nullptr == p)
+        {
+            // 根节点分裂, 树长高一层
+            p = create_inner();
+            key_allocator::construct(&p->key(0), sep);
+            p->children[0] = left;
+            p->children[1] = right;
+            p->count = 2;
+            left->parent = p;
+            right->parent = p;
+            root = p;
+            return;
+        }
+        size_type i = child_index(p, left);
+        if (p->count < inner_slots)
+        {
+            inner_insert(p, i, sep, right);
+            return;
+        }
+
+        // 内部节点已满: 左边保留 mid 个子节点, 第 mid - 1 个分隔键上移, 其余移入新节点
+        size_type mid = inner_slots / 2;
+        inner_node* q = create_inner();
+        for (size_type j = mid; j < inner_slots; ++j)
+        {
+            q->children[j - mid] = p->children[j];
+            p->children[j]->parent = q;
+        }
+        for (size_type j = mid; j + 1 < inner_slots; ++j)
+            relocate_key(&p->key(j), &q->key(j - mid));
+        q->count = inner_slots - mid;
+        p->count = mid;
+        key_type up = mystl::move(p->key(mid - 1));
+        key_allocator::destroy(&p->key(mid - 1));
+
+        if (i < mid)
+            inner_insert(p, i, sep, right);
+        else
+            inner_insert(q, i - mid, sep, right);
+        insert_into_parent(p, up, q);
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, size_t NodeBytes>
+    typename btree<Key, Value, KeyOfValue, Compare, NodeBytes>::iterator
+    btree<Key, Value, KeyOfValue, Compare, NodeBytes>::
+    insert_multi(const_iterator hint, value_type&& value)
+    {
+        THROW_LENGTH_ERROR_IF(node_count > max_size() - 1,
+                              "btree<Key, Value, KeyOfValue, Compare>'s size too big");
+        const key_type& k = key(value);
+        // 只对首尾两种位置利用 hint, 此时不需要访问任何分隔键
+        if (hint.node == tail && hint.pos == tail->count &&
+            (0 == node_count || !key_compare(k, key(tail->value(tail->count - 1)))))
+            return insert_at(tail, tail->count, mystl::move(value));
+        if (hint.node == head && hint.pos == 0 && 0 != node_count &&
+            !key_compare(key(head->value(0)), k))
+            return insert_at(head, 0, mystl::move(value));
+        return insert_multi(mystl::move(value));
+    }
+
+    // 返回 pair, 如果 pair 参数二为 false 表示插入失败, 反之则插入成功
+    template <class Key, class Value, class KeyOfValue, class Compare, size_t NodeBytes>
+    mystl::pair<typename btree<Key, Value, KeyOfValue, Compare, NodeBytes>::iterator, bool>
+    btree<Key, Value, KeyOfValue, Compare, NodeBytes>::
+    insert_unique(value_type&& value)
+    {
+        THROW_LENGTH_ERROR_IF(node_count > max_size() - 1,
+                              "btree<Key, Value, KeyOfValue, Compare>'s size too big");
+        const key_type& k = key(value);
+        leaf_node* x = descend_lower(k);
+        size_type pos = leaf_lower(x, k);
+        iterator it = make_iter(x, pos);
+        if (it != end() && !key_compare(k, key(*it)))
+            return mystl::make_pair(it, false);
+        return mystl::make_pair(insert_at(x, pos, mystl::move(value)), true);
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, size_t NodeBytes>
+    typename btree<Key, Value, KeyOfValue, Compare, NodeBytes>::iterator
+    btree<Key, Value, KeyOfValue, Compare, NodeBytes>::
+    insert_unique(const_iterator hint, value_type&& value)
+    {
+        THROW_LENGTH_ERROR_IF(node_count > max_size() - 1,
+                              "btree<Key, Value, KeyOfValue, Compare>'s size too big");
+        const key_type& k = key(value);
+        if (hint.node == tail && hint.pos == tail->count &&
+            (0 == node_count || key_compare(key(tail->value(tail->count - 1)), k)))
+            return insert_at(tail, tail->count, mystl::move(value));
+        if (hint.node == head && hint.pos == 0 && 0 != node_count &&
+            key_compare(k, key(head->value(0))))
+            return insert_at(head, 0, mystl::move(value));
+        return insert_unique(mystl::move(value)).first;
+    }
+
+    // 删除叶子 x 中 pos 处的元素, 返回指向下一个元素的迭代器
+    template <class Key, class Value, class KeyOfValue, class Compare, size_t NodeBytes>
+    typename btree<Key, Value, KeyOfValue, Compare, NodeBytes>::iterator
+    btree<Key, Value, KeyOfValue, Compare, NodeBytes>::
+    erase_at(leaf_node* x, size_type pos)
+    {
+        data_allocator::destroy(x->values() + pos);
+        relocate(x->values() + pos + 1, x->count - pos - 1, x->values() + pos);
+        --x->count;
+        --node_count;
+        // 记录下一个元素的位置, 重新平衡时一并修正
+        leaf_node* track = x;
+        size_type  track_pos = pos;
+        if (x != root && x->count < leaf_min)
+            rebalance_leaf(x, track, track_pos);
+        return make_iter(track, track_pos);
+    }
+
+    // 叶子元素过少时, 先尝试向兄弟借一个元素, 否则与兄弟合并
+    template <class Key, class Value, class KeyOfValue, class Compare, size_t NodeBytes>
+    void btree<Key, Value, KeyOfValue, Compare, NodeBytes>::
+    rebalance_leaf(leaf_node* x, leaf_node*& track, size_type& track_pos)
+    {
+        inner_node* p = static_cast<inner_node*>(x->parent);
+        size_type i = child_index(p, x);
+        leaf_node* left  = i > 0 ? static_cast<leaf_node*>(p->children[i - 1]) : nullptr;
+        leaf_node* right = i + 1 < p->count ? static_cast<leaf_node*>(p->children[i + 1]) : nullptr;
+
+        if (nullptr != left && left->count > leaf_min)
+        {
+            // 向左兄弟借最后一个元素
+            relocate_backward(x->values(), x->count, x->values() + 1);
+            relocate(left->values() + left->count - 1, 1, x->values());
+            --left->count;
+            ++x->count;
+            p->key(i - 1) = key(x->value(0));
+            if (track == x)
+                ++track_pos;
+        }
+        else if (nullptr != right && right->count > leaf_min)
+        {
+            // 向右兄弟借第一个元素
+            relocate(right->values(), 1, x->values() + x->count);
+            relocate(right->values() + 1, right->count - 1, right->values());
+            --right->count;
+            ++x->count;
+            p->key(i) = key(right->value(0));
+        }
+        else
+        {
+            // 合并: 总是把右边的叶子并入左边
+            if (nullptr == left)
+            {
+                left = x;
+                x = right;
+                ++i;
+            }
+            else if (track == x)
+            {
+                track = left;
+                track_pos += left->count;
+            }
+            relocate(x->values(), x->count, left->values() + left->count);
+            left->count += x->count;
+            x->count = 0;
+            left->next = x->next;
+            if (nullptr != x->next)
+                x->next->prev = left;
+            else
+                tail = left;
+            destroy_leaf(x);
+            inner_remove(p, i);
+            rebalance_inner(p);
+        }
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, size_t NodeBytes>
+    void btree<Key, Value, KeyOfValue, Compare, NodeBytes>::
+    rebalance_inner(inner_node* x)
+    {
+        if (x == root)
+        {
+            // 根节点只剩一个子节点时, 树降低一层
+            if (1 == x->count)
+            {
+                root = x->children[0];
+                root->parent = nullptr;
+                inner_allocator::deallocate(x);
+            }
+            return;
+        }
+        if (x->count >= inner_min)
+            return;
+
+        inner_node* p = static_cast<inner_node*>(x->parent);
+        size_type i = child_index(p, x);
+        inner_node* left  = i > 0 ? static_cast<inner_node*>(p->children[i - 1]) : nullptr;
+        inner_node* right = i + 1 < p->count ? static_cast<inner_node*>(p->children[i + 1]) : nullptr;
+
+        if (nullptr != left && left->count > inner_min)
+        {
+            // 父节点的分隔键下移, 左兄弟的最后一个分隔键上移
+            for (size_type j = x->count; j > 0; --j)
+                x->children[j] = x->children[j - 1];
+            for (size_type j = x->count - 1; j > 0; --j)
+                relocate_key(&x->key(j - 1), &x->key(j));
+            key_allocator::construct(&x->key(0), mystl::move(p->key(i - 1)));
+            x->children[0] = left->children[left->count - 1];
+            x->children[0]->parent = x;
+            ++x->count;
+            p->key(i - 1) = mystl::move(left->key(left->count - 2));
+            key_allocator::destroy(&left->key(left->count - 2));
+            --left->count;
+        }
+        else if (nullptr != right && right->count > inner_min)
+        {
+            // 父节点的分隔键下移, 右兄弟的第一个分隔键上移
+            key_allocator::construct(&x->key(x->count - 1), mystl::move(p->key(i)));
+            x->children[x->count] = right->children[0];
+            x->children[x->count]->parent = x;
+            ++x->count;
+            p->key(i) = mystl::move(right->key(0));
+            key_allocator::destroy(&right->key(0));
+            for (size_type j = 0; j + 2 < right->count; ++j)
+                relocate_key(&right->key(j + 1), &right->key(j));
+            for (size_type j = 0; j + 1 < right->count; ++j)
+                right->children[j] = right->children[j + 1];
+            --right->count;
+        }
+        else
+        {
+            // 合并: 把右边的节点连同父节点中的分隔键一起并入左边
+            if (nullptr == left)
+            {
+                left = x;
+                x = right;
+                ++i;
+            }
+            key_allocator::construct(&left->key(left->count - 1), mystl::move(p->key(i - 1)));
+            for (size_type j = 0; j + 1 < x->count; ++j)
+                relocate_key(&x->key(j), &left->key(left->count + j));
+            for (size_type j = 0; j < x->count; ++j)
+            {
+                left->children[left->count + j] = x->children[j];
+                x->children[j]->parent = left;
+            }
+            left->count += x->count;
+            inner_allocator::deallocate(x);
+            inner_remove(p, i);
+            rebalance_inner(p);
+        }
+    }
+
+    // 删除与 key 相等的元素, 并返回删除个数
+    template <class Key, class Value, class KeyOfValue, class Compare, size_t NodeBytes>
+    typename btree<Key, Value, KeyOfValue, Compare, NodeBytes>::size_type
+    btree<Key, Value, KeyOfValue, Compare, NodeBytes>::
+    erase_multi(const key_type& k)
+    {
+        auto p = equal_range_multi(k);
+        size_type n = static_cast<size_type>(mystl::distance(p.first, p.second));
+        iterator it = p.first;
+        for (size_type i = 0; i < n; ++i)
+            it = erase(it);
+        return n;
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, size_t NodeBytes>
+    typename btree<Key, Value, KeyOfValue, Compare, NodeBytes>::size_type
+    btree<Key, Value, KeyOfValue, Compare, NodeBytes>::
+    erase_unique(const key_type& k)
+    {
+        iterator it = find(k);
+        if (it == end())
+            return 0;
+        erase(it);
+        return 1;
+    }
+
+    // 删除 [first, last) 区间内元素
+    // 删除会移动元素使 last 失效, 所以先求出区间长度再逐个删除
+    template <class Key, class Value, class KeyOfValue, class Compare, size_t NodeBytes>
+    typename btree<Key, Value, KeyOfValue, Compare, NodeBytes>::iterator
+    btree<Key, Value, KeyOfValue, Compare, NodeBytes>::
+    erase(const_iterator first, const_iterator last)
+    {
+        if (first == begin() && last == end())
+        {
+            clear();
+            return end();
+        }
+        size_type n = static_cast<size_type>(mystl::distance(first, last));
+        iterator it(first.node, first.pos);
+        for (; n > 0; --n)
+            it = erase(it);
+        return it;
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, size_t NodeBytes>
+    void btree<Key, Value, KeyOfValue, Compare, NodeBytes>::clear()
+    {
+        if (nullptr == root)
+        {
+            btree_init();
+            return;
+        }
+        if (node_count > 0)
+        {
+            destroy_subtree(root);
+            btree_init();
+        }
+    }
+
+    // 复制以 x 为根的子树, last 为当前已复制的最右叶子, 用于串起叶子链表
+    template <class Key, class Value, class KeyOfValue, class Compare, size_t NodeBytes>
+    typename btree<Key, Value, KeyOfValue, Compare, NodeBytes>::base_ptr
+    btree<Key, Value, KeyOfValue, Compare, NodeBytes>::
+    copy_subtree(const btree_node_base* x, base_ptr p, leaf_node*& last)
+    {
+        if (x->leaf)
+        {
+            const leaf_node* src = static_cast<const leaf_node*>(x);
+            leaf_node* y = create_leaf();
+            try
+            {
+                for (; y->count < src->count; ++y->count)
+                    data_allocator::construct(y->values() + y->count, src->value(y->count));
+            }
+            catch (...)
+            {
+                destroy_leaf(y);
+                throw;
+            }
+            y->parent = p;
+            y->prev = last;
+            if (nullptr != last)
+                last->next = y;
+            last = y;
+            return y;
+        }
+        const inner_node* src = static_cast<const inner_node*>(x);
+        inner_node* y = create_inner();
+        y->parent = p;
+        size_type nchild = 0, nkey = 0;
+        try
+        {
+            for (; nchild < src->count; ++nchild)
+            {
+                if (nchild > 0)
+                {
+                    key_allocator::construct(&y->key(nkey), src->key(nkey));
+                    ++nkey;
+                }
+                y->children[nchild] = copy_subtree(src->children[nchild], y, last);
+            }
+        }
+        catch (...)
+        {
+            for (size_type i = 0; i < nchild; ++i)
+                destroy_subtree(y->children[i]);
+            for (size_type i = 0; i < nkey; ++i)
+                key_allocator::destroy(&y->key(i));
+            inner_allocator::deallocate(y);
+            throw;
+        }
+        y->count = nchild;
+        return y;
+    }
+
+    // 重载比较运算符
+    template <class Key, class Value, class KeyOfValue, class Compare, size_t NodeBytes>
+    bool operator==(const btree<Key, Value, KeyOfValue, Compare, NodeBytes>& lhs,
+                    const btree<Key, Value, KeyOfValue, Compare, NodeBytes>& rhs)
+    {
+        return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, size_t NodeBytes>
+    bool operator!=(const btree<Key, Value, KeyOfValue, Compare, NodeBytes>& lhs,
+                    const btree<Key, Value, KeyOfValue, Compare, NodeBytes>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, size_t NodeBytes>
+    bool operator<(const btree<Key, Value, KeyOfValue, Compare, NodeBytes>& lhs,
+                   const btree<Key, Value, KeyOfValue, Compare, NodeBytes>& rhs)
+    {
+        return mystl::lexicographical_compare(lhs.begin(), lhs.end(),
+                                              rhs.begin(), rhs.end());
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, size_t NodeBytes>
+    void swap(btree<Key, Value, KeyOfValue, Compare, NodeBytes>& lhs,
+              btree<Key, Value, KeyOfValue, Compare, NodeBytes>& rhs)
+    {
+        lhs.swap(rhs);
+    }
+
+} // namespace mystl
+
+#endif //TINYSTL_BTREE_H
@@ -0,0 +1,366 @@
+#ifndef TINYSTL_BTREE_SET_H
+#define TINYSTL_BTREE_SET_H
+
+// 该头文件包含 btree_set / btree_multiset
+// 接口与 set / multiset 相同, 底层以 btree 代替 rb_tree, 适合元素数量很大的有序集合
+// 参数 NodeBytes 为单个节点的字节数, 默认 256 字节(4 条 cache line)
+// 注意: 插入与删除会使所有迭代器失效
+
+#include "btree.h"
+#include "functional.h"
+#include "algobase.h"
+
+namespace mystl
+{
+
+    // 模板类 btree_set 键值不允许重复
+    template <class Key, class Compare = mystl::less<Key>, size_t NodeBytes = 256>
+    class btree_set
+    {
+    public:
+        typedef Key         key_type;
+        typedef Key         value_type;
+        typedef Compare     key_compare;
+        typedef Compare     value_compare;
+
+    protected:
+        typedef mystl::btree<key_type, value_type,
+                             mystl::identity<value_type>, key_compare, NodeBytes> rep_type;
+        rep_type tree_;
+    public:
+        typedef typename rep_type::pointer                  pointer;
+        typedef typename rep_type::const_pointer            const_pointer;
+        typedef typename rep_type::const_reference          reference;
+        typedef typename rep_type::const_reference          const_reference;
+        typedef typename rep_type::const_iterator           iterator;
+        typedef typename rep_type::const_iterator           const_iterator;
+        typedef typename rep_type::const_reverse_iterator   reverse_iterator;
+        typedef typename rep_type::const_reverse_iterator   const_reverse_iterator;
+        typedef typename rep_type::size_type                size_type;
+        typedef typename rep_type::difference_type          difference_type;
+        typedef typename rep_type::allocator_type           allocator_type;
+
+    public:
+        btree_set() = default;
+
+        template <class InputIter>
+        btree_set(InputIter first, InputIter last)
+            : tree_()
+        { tree_.insert_unique(first, last); }
+
+        btree_set(std::initializer_list<value_type> ilist)
+            : tree_()
+        { tree_.insert_unique(ilist.begin(), ilist.end()); }
+
+        btree_set(const btree_set& other)
+            : tree_(other.tree_)
+        {
+        }
+
+        btree_set(btree_set&& other)
+            : tree_(mystl::move(other.tree_))
+        {
+        }
+
+        btree_set& operator=(const btree_set& rhs)
+        {
+            tree_ = rhs.tree_;
+            return *this;
+        }
+
+        btree_set& operator=(btree_set&& rhs)
+        {
+            tree_ = mystl::move(rhs.tree_);
+            return *this;
+        }
+
+        btree_set& operator=(std::initializer_list<value_type> ilist)
+        {
+            tree_.clear();
+            tree_.insert_unique(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        key_compare     key_comp()   const { return key_compare(); }
+        value_compare   value_comp() const { return key_compare(); }
+
+        // 迭代器
+        iterator                begin()            noexcept
+        { return tree_.begin(); }
+        const_iterator          begin()      const noexcept
+        { return tree_.begin(); }
+        iterator                end()              noexcept
+        { return tree_.end(); }
+        const_iterator          end()        const noexcept
+        { return tree_.end(); }
+
+        reverse_iterator        rbegin()           noexcept
+        { return reverse_iterator(end()); }
+        const_reverse_iterator  rbegin()     const noexcept
+        { return const_reverse_iterator(end()); }
+        reverse_iterator        rend()             noexcept
+        { return reverse_iterator(begin()); }
+        const_reverse_iterator  rend()       const noexcept
+        { return const_reverse_iterator(begin()); }
+
+        const_iterator          cbegin()     const noexcept
+        { return begin(); }
+        const_iterator          cend()       const noexcept
+        { return end(); }
+        const_reverse_iterator  crbegin()    const noexcept
+        { return rbegin(); }
+        const_reverse_iterator  crend()      const noexcept
+        { return rend(); }
+
+        bool                    empty()      const noexcept { return tree_.empty(); }
+        size_type               size()       const noexcept { return tree_.size(); }
+        size_type               max_size()   const noexcept { return tree_.max_size(); }
+        size_type               bytes_used() const noexcept { return tree_.bytes_used(); }
+
+        template <class ...Args>
+        mystl::pair<iterator, bool> emplace(Args&& ...args)
+        { return tree_.emplace_unique(mystl::forward<Args>(args)...); }
+
+        template <class ...Args>
+        iterator emplace_hint(iterator hint, Args&& ...args)
+        { return tree_.emplace_unique_use_hint(hint, mystl::forward<Args>(args)...); }
+
+        pair<iterator, bool> insert(const value_type& value)
+        { return tree_.insert_unique(value); }
+
+        pair<iterator, bool> insert(value_type&& value)
+        { return tree_.insert_unique(mystl::move(value)); }
+
+        iterator insert(iterator hint, const value_type& value)
+        { return tree_.insert_unique(hint, value); }
+
+        iterator insert(iterator hint, value_type&& value)
+        { return tree_.insert_unique(hint, mystl::move(value)); }
+
+        template <class InputIter>
+        void insert(InputIter first, InputIter last)
+        { tree_.insert_unique(first, last); }
+
+        iterator    erase(iterator position)             { return tree_.erase(position); }
+        size_type   erase(const key_type& key)           { return tree_.erase_unique(key); }
+        iterator    erase(iterator first, iterator last) { return tree_.erase(first, last); }
+
+        void        clear() { tree_.clear(); }
+
+    public:
+
+        iterator        find(const key_type& key)              { return tree_.find(key); }
+        const_iterator  find(const key_type& key)        const { return tree_.find(key); }
+
+        size_type       count(const key_type& key)       const { return tree_.count_unique(key); }
+
+        iterator        lower_bound(const key_type& key)       { return tree_.lower_bound(key); }
+        const_iterator  lower_bound(const key_type& key) const { return tree_.lower_bound(key); }
+
+        iterator        upper_bound(const key_type& key)       { return tree_.upper_bound(key); }
+        const_iterator  upper_bound(const key_type& key) const { return tree_.upper_bound(key); }
+
+        pair<iterator, iterator>
+        equal_range(const key_type& key)
+        { return tree_.equal_range_unique(key); }
+
+        pair<const_iterator, const_iterator>
+        equal_range(const key_type& key) const
+        { return tree_.equal_range_unique(key); }
+
+        void swap(btree_set& rhs) noexcept
+        { tree_.swap(rhs.tree_); }
+
+    public:
+        bool operator==(const btree_set& rhs) const { return tree_ == rhs.tree_; }
+        bool operator<(const btree_set& rhs)  const { return tree_ < rhs.tree_; }
+
+        bool operator!=(const btree_set& rhs) const { return !(*this == rhs); }
+        bool operator>(const btree_set& rhs)  const { return rhs < *this; }
+        bool operator<=(const btree_set& rhs) const { return !(rhs < *this); }
+        bool operator>=(const btree_set& rhs) const { return !(*this < rhs); }
+    };
+
+    template <class Key, class Compare, size_t NodeBytes>
+    void swap(btree_set<Key, Compare, NodeBytes>& lhs, btree_set<Key, Compare, NodeBytes>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    // 模板类 btree_multiset 键值允许重复
+    template <class Key, class Compare = mystl::less<Key>, size_t NodeBytes = 256>
+    class btree_multiset
+    {
+    public:
+        typedef Key         key_type;
+        typedef Key         value_type;
+        typedef Compare     key_compare;
+        typedef Compare     value_compare;
+
+    protected:
+        typedef mystl::btree<key_type, value_type,
+                             mystl::identity<value_type>, key_compare, NodeBytes> rep_type;
+        rep_type tree_;
+    public:
+        typedef typename rep_type::pointer                  pointer;
+        typedef typename rep_type::const_pointer            const_pointer;
+        typedef typename rep_type::const_reference          reference;
+        typedef typename rep_type::const_reference          const_reference;
+        typedef typename rep_type::const_iterator           iterator;
+        typedef typename rep_type::const_iterator           const_iterator;
+        typedef typename rep_type::const_reverse_iterator   reverse_iterator;
+        typedef typename rep_type::const_reverse_iterator   const_reverse_iterator;
+        typedef typename rep_type::size_type                size_type;
+        typedef typename rep_type::difference_type          difference_type;
+        typedef typename rep_type::allocator_type           allocator_type;
+
+    public:
+        btree_multiset() = default;
+
+        template <class InputIter>
+        btree_multiset(InputIter first, InputIter last)
+            : tree_()
+        { tree_.insert_multi(first, last); }
+
+        btree_multiset(std::initializer_list<value_type> ilist)
+            : tree_()
+        { tree_.insert_multi(ilist.begin(), ilist.end()); }
+
+        btree_multiset(const btree_multiset& other)
+            : tree_(other.tree_)
+        {
+        }
+
+        btree_multiset(btree_multiset&& other)
+            : tree_(mystl::move(other.tree_))
+        {
+        }
+
+        btree_multiset& operator=(const btree_multiset& rhs)
+        {
+            tree_ = rhs.tree_;
+            return *this;
+        }
+
+        btree_multiset& operator=(btree_multiset&& rhs)
+        {
+            tree_ = mystl::move(rhs.tree_);
+            return *this;
+        }
+
+        btree_multiset& operator=(std::initializer_list<value_type> ilist)
+        {
+            tree_.clear();
+            tree_.insert_multi(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        key_compare     key_comp()   const { return key_compare(); }
+        value_compare   value_comp() const { return key_compare(); }
+
+        // 迭代器
+        iterator                begin()            noexcept
+        { return tree_.begin(); }
+        const_iterator          begin()      const noexcept
+        { return tree_.begin(); }
+        iterator                end()              noexcept
+        { return tree_.end(); }
+        const_iterator          end()        const noexcept
+        { return tree_.end(); }
+
+        reverse_iterator        rbegin()           noexcept
+        { return reverse_iterator(end()); }
+        const_reverse_iterator  rbegin()     const noexcept
+        { return const_reverse_iterator(end()); }
+        reverse_iterator        rend()             noexcept
+        { return reverse_iterator(begin()); }
+        const_reverse_iterator  rend()       const noexcept
+        { return const_reverse_iterator(begin()); }
+
+        const_iterator          cbegin()     const noexcept
+        { return begin(); }
+        const_iterator          cend()       const noexcept
+        { return end(); }
+        const_reverse_iterator  crbegin()    const noexcept
+        { return rbegin(); }
+        const_reverse_iterator  crend()      const noexcept
+        { return rend(); }
+
+        bool                    empty()      const noexcept { return tree_.empty(); }
+        size_type               size()       const noexcept { return tree_.size(); }
+        size_type               max_size()   const noexcept { return tree_.max_size(); }
+        size_type               bytes_used() const noexcept { return tree_.bytes_used(); }
+
+        template <class ...Args>
+        iterator emplace(Args&& ...args)
+        { return tree_.emplace_multi(mystl::forward<Args>(args)...); }
+
+        template <class ...Args>
+        iterator emplace_hint(iterator hint, Args&& ...args)
+        { return tree_.emplace_multi_use_hint(hint, mystl::forward<Args>(args)...); }
+
+        iterator insert(const value_type& value)
+        { return tree_.insert_multi(value); }
+
+        iterator insert(value_type&& value)
+        { return tree_.insert_multi(mystl::move(value)); }
+
+        iterator insert(iterator hint, const value_type& value)
+        { return tree_.insert_multi(hint, value); }
+
+        iterator insert(iterator hint, value_type&& value)
+        { return tree_.insert_multi(hint, mystl::move(value)); }
+
+        template <class InputIter>
+        void insert(InputIter first, InputIter last)
+        { tree_.insert_multi(first, last); }
+
+        iterator    erase(iterator position)             { return tree_.erase(position); }
+        size_type   erase(const key_type& key)           { return tree_.erase_multi(key); }
+        iterator    erase(iterator first, iterator last) { return tree_.erase(first, last); }
+
+        void        clear() { tree_.clear(); }
+
+    public:
+
+        iterator        find(const key_type& key)              { return tree_.find(key); }
+        const_iterator  find(const key_type& key)        const { return tree_.find(key); }
+
+        size_type       count(const key_type& key)       const { return tree_.count_multi(key); }
+
+        iterator        lower_bound(const key_type& key)       { return tree_.lower_bound(key); }
+        const_iterator  lower_bound(const key_type& key) const { return tree_.lower_bound(key); }
+
+        iterator        upper_bound(const key_type& key)       { return tree_.upper_bound(key); }
+        const_iterator  upper_bound(const key_type& key) const { return tree_.upper_bound(key); }
+
+        pair<iterator, iterator>
+        equal_range(const key_type& key)
+        { return tree_.equal_range_multi(key); }
+
+        pair<const_iterator, const_iterator>
+        equal_range(const key_type& key) const
+        { return tree_.equal_range_multi(key); }
+
+        void swap(btree_multiset& rhs) noexcept
+        { tree_.swap(rhs.tree_); }
+
+    public:
+        bool operator==(const btree_multiset& rhs) const { return tree_ == rhs.tree_; }
+        bool operator<(const btree_multiset& rhs)  const { return tree_ < rhs.tree_; }
+
+        bool operator!=(const btree_multiset& rhs) const { return !(*this == rhs); }
+        bool operator>(const btree_multiset& rhs)  const { return rhs < *this; }
+        bool operator<=(const btree_multiset& rhs) const { return !(rhs < *this); }
+        bool operator>=(const btree_multiset& rhs) const { return !(*this < rhs); }
+    };
+
+    template <class Key, class Compare, size_t NodeBytes>
+    void swap(btree_multiset<Key, Compare, NodeBytes>& lhs,
+              btree_multiset<Key, Compare, NodeBytes>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+}
+
+#endif //TINYSTL_BTREE_SET_H
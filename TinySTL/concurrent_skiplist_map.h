@@ -0,0 +1,554 @@
+#ifndef TINYSTL_CONCURRENT_SKIPLIST_MAP_H
+#define TINYSTL_CONCURRENT_SKIPLIST_MAP_H
+
+// 这个头文件包含模板类 concurrent_skiplist_map (并发有序映射)
+// 底层为无锁跳表, 多个线程可以同时插入、查找、删除和遍历, 不需要外部加锁
+// 每个节点的 next 指针最低位为删除标记: 删除时先自顶向下标记各层, 标记第 0 层即视为删除成功,
+// 之后由删除线程 (或途经的其他线程) 用 CAS 把节点从各层摘下, 摘下后交给 epoch_domain 延迟释放
+// 插入和查找是无锁的; 删除需要等待目标节点的插入线程把各层链接完毕, 因此不保证无锁
+// 迭代器在存在期间会固定当前纪元, 它指向的节点即使被删除也不会被释放; 迭代器不能在线程之间传递,
+// 长期持有迭代器会推迟所有无锁容器的内存回收
+// 遍历是弱一致的: 只保证按键升序, 遍历期间其他线程的插入删除可能看得到也可能看不到
+// clear、析构以及 mapped 值的并发修改需要调用者同步
+
+#include <initializer_list>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+
+#include "iterator.h"
+#include "memory.h"
+#include "functional.h"
+#include "epoch.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+    // 每层的晋升概率为 1/4, 16 层足够容纳 4^16 个元素
+    constexpr int kSkiplistMaxHeight = 16;
+
+    template <class Value>
+    struct skiplist_node
+    {
+        typedef skiplist_node<Value>* node_ptr;
+
+        Value                   value_field;
+        int                     height;
+        std::atomic<bool>       fully_linked;   // 各层都已链接, 之后才允许删除
+        std::atomic<uintptr_t>  next[1];        // 实际长度为 height
+
+        static node_ptr  ptr(uintptr_t p)    { return reinterpret_cast<node_ptr>(p & ~uintptr_t(1)); }
+        static bool      marked(uintptr_t p) { return (p & 1) != 0; }
+        static uintptr_t raw(node_ptr p)     { return reinterpret_cast<uintptr_t>(p); }
+
+        bool deleted() const { return marked(next[0].load(std::memory_order_acquire)); }
+
+        // 第 0 层上下一个未删除的节点
+        node_ptr next_live() const
+        {
+            node_ptr x = ptr(next[0].load(std::memory_order_acquire));
+            while (x && x->deleted())
+                x = ptr(x->next[0].load(std::memory_order_acquire));
+            return x;
+        }
+    };
+
+    // 前向迭代器, 指向节点时固定当前纪元
+    template <class T, class Ref, class Ptr>
+    struct skiplist_iterator
+    {
+        typedef forward_iterator_tag                    iterator_category;
+        typedef skiplist_iterator<T, T&, T*>            iterator;
+        typedef skiplist_iterator<T, const T&, const T*> const_iterator;
+        typedef skiplist_iterator                       self;
+
+        typedef T           value_type;
+        typedef Ptr         pointer;
+        typedef Ref         reference;
+        typedef ptrdiff_t   difference_type;
+        typedef skiplist_node<T>* node_ptr;
+
+        node_ptr node;
+
+        skiplist_iterator() noexcept : node(nullptr) {}
+        explicit skiplist_iterator(node_ptr x) : node(x) { pin(); }
+        skiplist_iterator(const self& rhs) : node(rhs.node) { pin(); }
+        // iterator 到 const_iterator 的转换
+        template <class It, typename std::enable_if<
+            std::is_same<It, iterator>::value && !std::is_same<It, self>::value, int>::type = 0>
+        skiplist_iterator(const It& rhs) : node(rhs.node) { pin(); }
+        ~skiplist_iterator() { unpin(); }
+
+        self& operator=(const self& rhs)
+        {
+            if (rhs.node)
+                epoch_domain::enter();
+            unpin();
+            node = rhs.node;
+            return *this;
+        }
+
+        reference operator*()  const { return node->value_field; }
+        pointer   operator->() const { return &(operator*()); }
+
+        self& operator++()
+        {
+            node = node->next_live();
+            if (!node)
+                epoch_domain::exit();
+            return *this;
+        }
+
+        self operator++(int)
+        {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const self& rhs) const { return node == rhs.node; }
+        bool operator!=(const self& rhs) const { return node != rhs.node; }
+
+    private:
+        void pin()   { if (node) epoch_domain::enter(); }
+        void unpin() { if (node) epoch_domain::exit(); }
+    };
+
+    // 模板类 concurrent_skiplist_map
+    // 参数一表示键值类型, 参数二表示实值类型, 参数三表示键值的比较方式, 默认采取 < 比较
+    template <class Key, class T, class Compare = mystl::less<Key>>
+    class concurrent_skiplist_map
+    {
+    public:
+        typedef Key                             key_type;
+        typedef T                               mapped_type;
+        typedef mystl::pair<const Key, T>       value_type;
+        typedef Compare                         key_compare;
+
+        typedef mystl::allocator<value_type>    allocator_type;
+        typedef mystl::allocator<value_type>    data_allocator;
+
+        typedef value_type*                     pointer;
+        typedef const value_type*               const_pointer;
+        typedef value_type&                     reference;
+        typedef const value_type&               const_reference;
+        typedef size_t                          size_type;
+        typedef ptrdiff_t                       difference_type;
+
+        typedef skiplist_iterator<value_type, value_type&, value_type*>             iterator;
+        typedef skiplist_iterator<value_type, const value_type&, const value_type*> const_iterator;
+
+    private:
+        typedef skiplist_node<value_type>       node_type;
+        typedef node_type*                      node_ptr;
+
+        node_ptr                head_;      // 头节点有 kSkiplistMaxHeight 层, 不含值
+        std::atomic<int>        top_;       // 已使用的最高层数, 查找从这一层开始
+        std::atomic<size_type>  size_;
+        Compare                 comp_;
+
+    public:
+        concurrent_skiplist_map()
+            : head_(allocate_node(kSkiplistMaxHeight)), top_(1), size_(0), comp_()
+        {
+        }
+
+        explicit concurrent_skiplist_map(const Compare& comp)
+            : head_(allocate_node(kSkiplistMaxHeight)), top_(1), size_(0), comp_(comp)
+        {
+        }
+
+        template <class InputIterator>
+        concurrent_skiplist_map(InputIterator first, InputIterator last)
+            : concurrent_skiplist_map()
+        {
+            for (; first != last; ++first)
+                insert(*first);
+        }
+
+        concurrent_skiplist_map(std::initializer_list<value_type> ilist)
+            : concurrent_skiplist_map(ilist.begin(), ilist.end())
+        {
+        }
+
+        concurrent_skiplist_map(const concurrent_skiplist_map&) = delete;
+        concurrent_skiplist_map& operator=(const concurrent_skiplist_map&) = delete;
+
+        ~concurrent_skiplist_map()
+        {
+            clear();
+            ::operator delete(head_);
+        }
+
+    public:
+        // 迭代器
+        // 迭代器必须在临界区内构造, 否则节点可能在构造前被释放
+        iterator begin()
+        {
+            epoch_guard guard;
+            return iterator(head_->next_live());
+        }
+        const_iterator begin() const
+        {
+            epoch_guard guard;
+            return const_iterator(head_->next_live());
+        }
+        iterator        end()          noexcept { return iterator(); }
+        const_iterator  end()    const noexcept { return const_iterator(); }
+        const_iterator  cbegin() const          { return begin(); }
+        const_iterator  cend()   const noexcept { return end(); }
+
+        // 容量, 有其他线程修改时只是近似值
+        bool      empty() const noexcept { return size() == 0; }
+        size_type size()  const noexcept { return size_.load(std::memory_order_relaxed); }
+
+        key_compare key_comp() const { return comp_; }
+
+    public:
+        // 插入, 键值已存在时不修改, 返回已有的元素
+
+        mystl::pair<iterator, bool> insert(const value_type& value)
+        {
+            epoch_guard guard;
+            node_ptr preds[kSkiplistMaxHeight], succs[kSkiplistMaxHeight];
+            if (find_aux(value.first, preds, succs))
+                return mystl::make_pair(iterator(succs[0]), false);
+            return insert_node(create_node(value), preds, succs);
+        }
+
+        template <class ...Args>
+        mystl::pair<iterator, bool> emplace(Args&& ...args)
+        {
+            epoch_guard guard;
+            node_ptr preds[kSkiplistMaxHeight], succs[kSkiplistMaxHeight];
+            node_ptr x = create_node(mystl::forward<Args>(args)...);
+            if (find_aux(x->value_field.first, preds, succs))
+            {
+                // 节点尚未发布, 可以直接释放
+                destroy_node(x);
+                return mystl::make_pair(iterator(succs[0]), false);
+            }
+            return insert_node(x, preds, succs);
+        }
+
+        // 不存在时插入值初始化的元素
+        mapped_type& operator[](const key_type& key)
+        {
+            return emplace(key, mapped_type()).first->second;
+        }
+
+        // 删除, 返回删除个数 (0 或 1)
+        size_type erase(const key_type& key)
+        {
+            epoch_guard guard;
+            node_ptr preds[kSkiplistMaxHeight], succs[kSkiplistMaxHeight];
+            if (!find_aux(key, preds, succs))
+                return 0;
+            node_ptr x = succs[0];
+            // 等插入线程链接完各层, 之后 x 的上层指针不会再被插入线程修改
+            while (!x->fully_linked.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            for (int level = x->height - 1; level > 0; --level)
+            {
+                uintptr_t succ = x->next[level].load(std::memory_order_relaxed);
+                while (!node_type::marked(succ) &&
+                       !x->next[level].compare_exchange_weak(succ, succ | 1, std::memory_order_acq_rel,
+                                                             std::memory_order_relaxed))
+                {
+                }
+            }
+            uintptr_t succ = x->next[0].load(std::memory_order_relaxed);
+            while (true)
+            {
+                if (node_type::marked(succ))
+                    return 0;   // 其他线程抢先删除
+                if (x->next[0].compare_exchange_weak(succ, succ | 1, std::memory_order_acq_rel,
+                                                     std::memory_order_relaxed))
+                    break;
+            }
+            size_.fetch_sub(1, std::memory_order_relaxed);
+            // 再查找一次, 越过所有键值不大于 key 的节点, 途中会把 x 从各层摘下
+            // 不能停在第一个相同键值的节点: 新插入的同键值节点可能在某一层上仍指向 x
+            find_position([this, &key](const key_type& k) { return !comp_(key, k); }, preds, succs);
+            epoch_domain::retire(x, &destroy_node);
+            return 1;
+        }
+
+        // 不是线程安全的, 调用时不能有其他线程访问本容器
+        void clear()
+        {
+            node_ptr x = node_type::ptr(head_->next[0].load(std::memory_order_relaxed));
+            while (x)
+            {
+                node_ptr next = node_type::ptr(x->next[0].load(std::memory_order_relaxed));
+                // 已被删除的节点由 epoch_domain 负责释放
+                if (!x->deleted())
+                    destroy_node(x);
+                x = next;
+            }
+            for (int level = 0; level < kSkiplistMaxHeight; ++level)
+                head_->next[level].store(0, std::memory_order_relaxed);
+            top_.store(1, std::memory_order_relaxed);
+            size_.store(0, std::memory_order_relaxed);
+        }
+
+    public:
+        // 查找, 不修改结构, 遇到已删除的节点直接跳过
+
+        iterator find(const key_type& key)
+        {
+            epoch_guard guard;
+            node_ptr x = lower_bound_node(key);
+            return x && !comp_(key, x->value_field.first) ? iterator(x) : end();
+        }
+
+        const_iterator find(const key_type& key) const
+        {
+            epoch_guard guard;
+            node_ptr x = lower_bound_node(key);
+            return x && !comp_(key, x->value_field.first) ? const_iterator(x) : end();
+        }
+
+        bool contains(const key_type& key) const
+        {
+            epoch_guard guard;
+            node_ptr x = lower_bound_node(key);
+            return x && !comp_(key, x->value_field.first);
+        }
+
+        size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+        iterator lower_bound(const key_type& key)
+        {
+            epoch_guard guard;
+            return iterator(lower_bound_node(key));
+        }
+
+        const_iterator lower_bound(const key_type& key) const
+        {
+            epoch_guard guard;
+            return const_iterator(lower_bound_node(key));
+        }
+
+        iterator upper_bound(const key_type& key)
+        {
+            epoch_guard guard;
+            return iterator(upper_bound_node(key));
+        }
+
+        const_iterator upper_bound(const key_type& key) const
+        {
+            epoch_guard guard;
+            return const_iterator(upper_bound_node(key));
+        }
+
+        mystl::pair<iterator, iterator> equal_range(const key_type& key)
+        {
+            epoch_guard guard;
+            return mystl::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+        }
+
+        mystl::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+        {
+            epoch_guard guard;
+            return mystl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+        }
+
+    private:
+        // 节点的分配与释放, next 数组按实际层数分配
+
+        static node_ptr allocate_node(int height)
+        {
+            size_t bytes = sizeof(node_type) + (height - 1) * sizeof(std::atomic<uintptr_t>);
+            node_ptr x = static_cast<node_ptr>(::operator new(bytes));
+            x->height = height;
+            ::new (&x->fully_linked) std::atomic<bool>(false);
+            for (int level = 0; level < height; ++level)
+                ::new (&x->next[level]) std::atomic<uintptr_t>(0);
+            return x;
+        }
+
+        template <class ...Args>
+        static node_ptr create_node(Args&& ...args)
+        {
+            node_ptr x = allocate_node(random_height());
+            try
+            {
+                data_allocator::construct(&x->value_field, mystl::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                ::operator delete(x);
+                throw;
+            }
+            return x;
+        }
+
+        static void destroy_node(void* p)
+        {
+            node_ptr x = static_cast<node_ptr>(p);
+            data_allocator::destroy(&x->value_field);
+            ::operator delete(x);
+        }
+
+        // 每个线程各自的 xorshift 随机数, 层数为 k 的概率为 (3/4) * (1/4)^(k-1)
+        static int random_height()
+        {
+            static std::atomic<uint64_t> seed(0x9E3779B97F4A7C15ull);
+            static thread_local uint64_t state = 0;
+            if (state == 0)
+                state = seed.fetch_add(0x9E3779B97F4A7C15ull, std::memory_order_relaxed) | 1;
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            uint64_t r = state;
+            int height = 1;
+            while (height < kSkiplistMaxHeight && (r & 3) == 0)
+            {
+                ++height;
+                r >>= 2;
+            }
+            return height;
+        }
+
+        // 把 x 插到 preds / succs 之间, preds / succs 由 find_aux 得到且 x 的键值不存在
+        mystl::pair<iterator, bool> insert_node(node_ptr x, node_ptr* preds, node_ptr* succs)
+        {
+            const key_type& key = x->value_field.first;
+            const int height = x->height;
+            int top = top_.load(std::memory_order_relaxed);
+            while (top < height && !top_.compare_exchange_weak(top, height, std::memory_order_relaxed))
+            {
+            }
+            // 第 0 层链接成功即插入成功
+            while (true)
+            {
+                for (int level = 0; level < height; ++level)
+                    x->next[level].store(node_type::raw(succs[level]), std::memory_order_relaxed);
+                uintptr_t expected = node_type::raw(succs[0]);
+                if (preds[0]->next[0].compare_exchange_strong(expected, node_type::raw(x),
+                                                              std::memory_order_release,
+                                                              std::memory_order_relaxed))
+                    break;
+                if (find_aux(key, preds, succs))
+                {
+                    // 其他线程抢先插入了相同的键值, x 尚未发布
+                    destroy_node(x);
+                    return mystl::make_pair(iterator(succs[0]), false);
+                }
+            }
+            // 自底向上链接其余各层, x 在链接完之前不会被删除, 其上层指针只有本线程修改
+            for (int level = 1; level < height; ++level)
+            {
+                while (true)
+                {
+                    // 后继在这一层已被标记时不能链接到它前面, 否则删除线程可能在 x 摘下它之前就将其释放
+                    node_ptr succ = succs[level];
+                    if (succ && node_type::marked(succ->next[level].load(std::memory_order_acquire)))
+                    {
+                        find_aux(key, preds, succs);
+                        x->next[level].store(node_type::raw(succs[level]), std::memory_order_relaxed);
+                        continue;
+                    }
+                    uintptr_t expected = node_type::raw(succ);
+                    if (preds[level]->next[level].compare_exchange_strong(expected, node_type::raw(x),
+                                                                          std::memory_order_release,
+                                                                          std::memory_order_relaxed))
+                        break;
+                    find_aux(key, preds, succs);
+                    x->next[level].store(node_type::raw(succs[level]), std::memory_order_relaxed);
+                }
+            }
+            x->fully_linked.store(true, std::memory_order_release);
+            size_.fetch_add(1, std::memory_order_relaxed);
+            return mystl::make_pair(iterator(x), true);
+        }
+
+        // 找出每一层上最后一个小于 key 的节点 preds 以及它的后继 succs, 途中把已标记删除的节点摘下
+        // 返回 succs[0] 是否等于 key
+        bool find_aux(const key_type& key, node_ptr* preds, node_ptr* succs) const
+        {
+            find_position([this, &key](const key_type& k) { return comp_(k, key); }, preds, succs);
+            return succs[0] && !comp_(key, succs[0]->value_field.first);
+        }
+
+        // 找出每一层上最后一个 before(节点键值) 为 true 的节点 preds 以及它的后继 succs,
+        // 途中把已标记删除的节点摘下
+        template <class Before>
+        void find_position(Before before, node_ptr* preds, node_ptr* succs) const
+        {
+        retry:
+            const int top = top_.load(std::memory_order_relaxed);
+            for (int level = kSkiplistMaxHeight - 1; level >= top; --level)
+            {
+                // 更高的层在读取 top_ 时为空, 若期间被其他线程使用, 之后在这一层的 CAS 会失败并重新查找
+                preds[level] = head_;
+                succs[level] = nullptr;
+            }
+            node_ptr pred = head_;
+            for (int level = top - 1; level >= 0; --level)
+            {
+                node_ptr curr = node_type::ptr(pred->next[level].load(std::memory_order_acquire));
+                while (curr)
+                {
+                    uintptr_t succ = curr->next[level].load(std::memory_order_acquire);
+                    while (node_type::marked(succ))
+                    {
+                        uintptr_t expected = node_type::raw(curr);
+                        if (!pred->next[level].compare_exchange_strong(expected, succ & ~uintptr_t(1),
+                                                                       std::memory_order_acq_rel,
+                                                                       std::memory_order_acquire))
+                            goto retry;     // pred 被删除或后继发生变化
+                        curr = node_type::ptr(succ);
+                        if (!curr)
+                            break;
+                        succ = curr->next[level].load(std::memory_order_acquire);
+                    }
+                    if (!curr || !before(curr->value_field.first))
+                        break;
+                    pred = curr;
+                    curr = node_type::ptr(succ);
+                }
+                preds[level] = pred;
+                succs[level] = curr;
+            }
+        }
+
+        // 返回第一个未删除且 before(节点键值) 为 false 的节点, 只读不写
+        template <class Before>
+        node_ptr search(Before before) const
+        {
+            node_ptr pred = head_;
+            node_ptr curr = nullptr;
+            for (int level = top_.load(std::memory_order_relaxed) - 1; level >= 0; --level)
+            {
+                curr = node_type::ptr(pred->next[level].load(std::memory_order_acquire));
+                while (curr)
+                {
+                    uintptr_t succ = curr->next[level].load(std::memory_order_acquire);
+                    if (!node_type::marked(succ) && !before(curr->value_field.first))
+                        break;
+                    // 已删除的节点冻结的 next 仍然有效, 沿它继续前进
+                    if (!node_type::marked(succ))
+                        pred = curr;
+                    curr = node_type::ptr(succ);
+                }
+            }
+            // 第 0 层的 curr 未删除, 或为 nullptr
+            return curr;
+        }
+
+        node_ptr lower_bound_node(const key_type& key) const
+        {
+            return search([this, &key](const key_type& k) { return comp_(k, key); });
+        }
+
+        node_ptr upper_bound_node(const key_type& key) const
+        {
+            return search([this, &key](const key_type& k) { return !comp_(key, k); });
+        }
+    };
+} // namespace mystl
+
+#endif //TINYSTL_CONCURRENT_SKIPLIST_MAP_H
@@ -40,6 +40,10 @@ void construct(Ty* ptr, Args&&... args)
 
 // destroy 将对象析构
 
+// destroy_cat 中要调用 destroy(Ty*), 先声明
+template <class Ty>
+void destroy(Ty* pointer);
+
 template <class Ty>
 void destroy_one(Ty*, std::true_type) {}
 
@@ -9,7 +9,6 @@
 // deque: 双向队列
 
 #include <initializer_list>
-#include <commctrl.h>
 #include "iterator.h"
 #include "memory.h"
 #include "util.h"
@@ -28,21 +27,26 @@ namespace mystl
 #undef min
 #endif // min
 
-    // 根据 deque 中元素的大小来分配一个分区的元素个数
-    template <class T>
+    // 一个分区 (缓冲区) 的元素个数
+    // BufSize 不为 0 时由使用者指定, 否则根据元素大小决定, 每个分区约 4096 字节, 至少 16 个元素
+    template <class T, size_t BufSize = 0>
     struct deque_buf_size
     {
-        static constexpr size_t value =
+        static constexpr size_t value = BufSize != 0 ? BufSize :
                 sizeof (T) < 256 ? size_t(4096 / sizeof (T)) : 16;
     };
 
-    template <class T, class Ref, class Ptr>
+    // deque 最多缓存的空闲分区个数
+    // 分区用空时先放入缓存, 需要新分区时优先从缓存中取, 避免队列在分区边界附近来回时反复分配和释放
+    constexpr size_t deque_spare_nodes = 2;
+
+    template <class T, class Ref, class Ptr, size_t BufSize = 0>
     struct deque_iterator
     {
         typedef random_access_iterator_tag              iterator_category;
-        typedef deque_iterator<T, T&, T*>               iterator;
-        typedef deque_iterator<T, const T&, const T*>   const_iterator;
-        typedef deque_iterator                          self;
+        typedef deque_iterator<T, T&, T*, BufSize>              iterator;
+        typedef deque_iterator<T, const T&, const T*, BufSize>  const_iterator;
+        typedef deque_iterator                                  self;
 
         typedef T           value_type;
         typedef Ptr         pointer;
@@ -52,7 +56,7 @@ namespace mystl
         typedef T*          value_pointer;
         typedef T**         map_pointer;
 
-        static const size_type buffer_size = deque_buf_size<T>::value;
+        static const size_type buffer_size = deque_buf_size<T, BufSize>::value;
         T* cur;             // 指向所在缓冲区的当前元素
         T* first;           // 指向所在缓冲区的头部
         T* last;            // 指向所在缓冲区的尾部
@@ -187,9 +191,31 @@ namespace mystl
         bool operator>=(const self& rhs) const { return !(*this < rhs); }
     };
 
+    // deque_iterator 是分段迭代器, 每个分区为一段, copy, fill, find 等算法据此逐个分区处理
+    template <class T, class Ref, class Ptr, size_t BufSize>
+    struct segmented_iterator_traits<deque_iterator<T, Ref, Ptr, BufSize>> : public m_true_type
+    {
+        typedef deque_iterator<T, Ref, Ptr, BufSize>    iterator;
+        typedef T**                                     segment_iterator;
+        typedef Ptr                                     local_iterator;
+
+        static segment_iterator segment(const iterator& it) { return it.node; }
+        static local_iterator   local(const iterator& it)   { return it.cur; }
+        static local_iterator   begin(segment_iterator s)   { return *s; }
+        static local_iterator   end(segment_iterator s)     { return *s + iterator::buffer_size; }
+
+        static iterator compose(segment_iterator s, local_iterator l)
+        {
+            iterator it;
+            it.set_node(s);
+            it.cur = const_cast<T*>(l);
+            return it;
+        }
+    };
+
     // 模板类 deque
-    // 模板参数表示数据类型
-    template <class T>
+    // 参数一表示数据类型, 参数二表示每个分区的元素个数, 缺省为 0 即由 deque_buf_size 根据元素大小决定
+    template <class T, size_t BufSize = 0>
     class deque
     {
     public:
@@ -207,14 +233,14 @@ namespace mystl
         typedef pointer*                                    map_pointer;
         typedef const_pointer*                              const_map_pointer;
 
-        typedef deque_iterator<T, T&, T*>                   iterator;
-        typedef deque_iterator<T, const T&, const T*>       const_iterator;
+        typedef deque_iterator<T, T&, T*, BufSize>          iterator;
+        typedef deque_iterator<T, const T&, const T*, BufSize> const_iterator;
         typedef mystl::reverse_iterator<iterator>           reverse_iterator;
         typedef mystl::reverse_iterator<const_iterator>     const_reverse_iterator;
 
         allocator_type get_allocator() { return allocator_type(); }
 
-        static const size_type buffer_size = deque_buf_size<T>::value;
+        static const size_type buffer_size = deque_buf_size<T, BufSize>::value;
         static const size_type init_map_size;
 
     private:
@@ -222,17 +248,19 @@ namespace mystl
         iterator finish;
         map_pointer map_;
         size_type map_size;
+        pointer spare_[deque_spare_nodes];  // 空闲分区的缓存
+        size_type spare_count;
 
     public:
 
         deque()
-            : start(), finish(), map_(nullptr), map_size(0)
+            : start(), finish(), map_(nullptr), map_size(0), spare_count(0)
         {
             create_map_and_nodes(0);
         }
 
         deque(const deque& other)
-            : start(), finish(), map_(nullptr), map_size(0)
+            : start(), finish(), map_(nullptr), map_size(0), spare_count(0)
         {
             create_map_and_nodes(other.size());
             try {
@@ -240,6 +268,7 @@ namespace mystl
             }
             catch(...) {
                 destroy_map_and_nodes();
+                throw ;
             }
         }
 
@@ -247,14 +276,18 @@ namespace mystl
             : start(mystl::move(other.start)),
               finish(mystl::move(other.finish)),
               map_(other.map_),
-              map_size(other.map_size)
+              map_size(other.map_size),
+              spare_count(other.spare_count)
         {
+            for (size_type i = 0; i < spare_count; ++i)
+                spare_[i] = other.spare_[i];
             other.map_ = nullptr,
             other.map_size = 0;
+            other.spare_count = 0;
         }
 
         deque(size_type n, const value_type& value)
-            : start(), finish(), map_(nullptr), map_size(0)
+            : start(), finish(), map_(nullptr), map_size(0), spare_count(0)
         {
             fill_initialize(n, value);
         }
@@ -266,11 +299,13 @@ namespace mystl
         template <class Iter, typename std::enable_if<
                 mystl::is_input_iterator<Iter>::value, int>::type = 0>
         deque(Iter first, Iter last)
+            : start(), finish(), map_(nullptr), map_size(0), spare_count(0)
         {
             range_initialize(first, last, iterator_category(first));
         }
 
         deque(std::initializer_list<value_type> ilist)
+            : start(), finish(), map_(nullptr), map_size(0), spare_count(0)
         {
             range_initialize(ilist.begin(), ilist.end(), mystl::forward_iterator_tag());
         }
@@ -294,13 +329,9 @@ namespace mystl
 
         deque& operator=(deque&& rhs)
         {
-            clear();
-            start = mystl::move(rhs.start);
-            finish = mystl::move(rhs.finish);
-            map_ = rhs.map_;
-            map_size = rhs.map_size;
-            rhs.map_ = nullptr;
-            rhs.map_size = 0;
+            // 原有的 map 和分区交给临时对象释放
+            deque tmp(mystl::move(rhs));
+            swap(tmp);
             return *this;
         }
 
@@ -317,6 +348,9 @@ namespace mystl
             mystl::swap(finish, other.finish);
             mystl::swap(map_, other.map_);
             mystl::swap(map_size, other.map_size);
+            for (size_type i = 0; i < deque_spare_nodes; ++i)
+                mystl::swap(spare_[i], other.spare_[i]);
+            mystl::swap(spare_count, other.spare_count);
         }
 
         ~deque()
@@ -329,6 +363,7 @@ namespace mystl
                 map_allocator::deallocate(map_, map_size);
                 map_ = nullptr;
             }
+            release_spare_nodes();
         }
 
     public:
@@ -373,6 +408,9 @@ namespace mystl
         size_type size() const noexcept { return finish - start; }
         size_type max_size() const noexcept { return static_cast<size_type>(-1); }
 
+        // 释放缓存的空闲分区
+        void shrink_to_fit() noexcept { release_spare_nodes(); }
+
         void resize(size_type new_size, const value_type& value)
         {
             const size_type len = size();
@@ -398,14 +436,14 @@ namespace mystl
         reference at(size_type n)
         {
             THROW_OUT_OF_RANGE_IF(!(n < size()),
-                                  "deque<T>::at() subscript out of range");
+                                  "deque<T, BufSize>::at() subscript out of range");
             return (*this)[n];
         }
 
         const_reference at(size_type n) const
         {
             THROW_OUT_OF_RANGE_IF(!(n < size()),
-                                  "deque<T>::at() subscript out of range");
+                                  "deque<T, BufSize>::at() subscript out of range");
             return (*this)[n];
         }
 
@@ -685,17 +723,36 @@ namespace mystl
 
         void reallocate_map(size_type nodes_to_add, bool add_at_front);
 
-        pointer allocate_node() { return data_allocator::allocate(buffer_size); }
+        // 优先使用缓存的空闲分区
+        pointer allocate_node()
+        {
+            if (spare_count != 0)
+                return spare_[--spare_count];
+            return data_allocator::allocate(buffer_size);
+        }
+
+        // 缓存未满时留下分区以备再用
+        void deallocate_node(pointer x)
+        {
+            if (spare_count < deque_spare_nodes)
+                spare_[spare_count++] = x;
+            else
+                data_allocator::deallocate(x, buffer_size);
+        }
 
-        void deallocate_node(pointer x) { data_allocator::deallocate(x, buffer_size); }
+        void release_spare_nodes() noexcept
+        {
+            while (spare_count != 0)
+                data_allocator::deallocate(spare_[--spare_count], buffer_size);
+        }
     };
 
-    template <class T>
-    const typename deque<T>::size_type deque<T>::init_map_size = 8;
+    template <class T, size_t BufSize>
+    const typename deque<T, BufSize>::size_type deque<T, BufSize>::init_map_size = 8;
 
-    template <class T>
+    template <class T, size_t BufSize>
     template <class ...Args>
-    void deque<T>::emplace_front(Args&& ...args)
+    void deque<T, BufSize>::emplace_front(Args&& ...args)
     {
         if (start.cur != start.first)
         {
@@ -718,9 +775,9 @@ namespace mystl
         }
     }
 
-    template <class T>
+    template <class T, size_t BufSize>
     template <class ...Args>
-    void deque<T>::emplace_back(Args&& ...args)
+    void deque<T, BufSize>::emplace_back(Args&& ...args)
     {
         if (finish.cur != finish.last - 1)
         {
@@ -735,10 +792,10 @@ namespace mystl
         }
     }
 
-    template <class T>
+    template <class T, size_t BufSize>
     template <class ...Args>
-    typename deque<T>::iterator
-    deque<T>::emplace(iterator pos, Args&& ...args)
+    typename deque<T, BufSize>::iterator
+    deque<T, BufSize>::emplace(iterator pos, Args&& ...args)
     {
         if (pos.cur == start.cur)
         {
@@ -753,8 +810,8 @@ namespace mystl
         return insert_aux(pos, mystl::forward<Args>(args)...);
     }
 
-    template <class T>
-    void deque<T>::insert(iterator position, size_type n, const value_type& value)
+    template <class T, size_t BufSize>
+    void deque<T, BufSize>::insert(iterator position, size_type n, const value_type& value)
     {
         if (position.cur == start.cur)
         {
@@ -772,9 +829,9 @@ namespace mystl
             insert_aux(position, n, value);
     }
 
-    template <class T>
+    template <class T, size_t BufSize>
     template <class InputIter>
-    void deque<T>::insert(iterator position, InputIter first, InputIter last, input_iterator_tag)
+    void deque<T, BufSize>::insert(iterator position, InputIter first, InputIter last, input_iterator_tag)
     {
         if (last <= first) return ;
         const size_type n = mystl::distance(first, last);
@@ -789,9 +846,9 @@ namespace mystl
             insert(position, *cur);
     }
 
-    template <class T>
+    template <class T, size_t BufSize>
     template <class ForwardIter>
-    void deque<T>::insert(iterator position, ForwardIter first, ForwardIter last, forward_iterator_tag)
+    void deque<T, BufSize>::insert(iterator position, ForwardIter first, ForwardIter last, forward_iterator_tag)
     {
         if (last <= first) return ;
         const size_type n = mystl::distance(first, last);
@@ -829,9 +886,9 @@ namespace mystl
             insert_aux(position, first, last, n);
     }
 
-    template <class T>
-    typename deque<T>::iterator
-    deque<T>::erase(iterator first, iterator last)
+    template <class T, size_t BufSize>
+    typename deque<T, BufSize>::iterator
+    deque<T, BufSize>::erase(iterator first, iterator last)
     {
         if (first == start && last == finish)
         {
@@ -860,20 +917,20 @@ namespace mystl
         }
     }
 
-    template <class T>
-    void deque<T>::clear()
+    template <class T, size_t BufSize>
+    void deque<T, BufSize>::clear()
     {
         // clear 会保留头部缓冲区
         for (map_pointer cur = start.node + 1; cur < finish.node; ++cur)
         {
             data_allocator::destroy(*cur, *cur + buffer_size);
-            data_allocator::deallocate(*cur, buffer_size);
+            deallocate_node(*cur);
         }
         if (start.node != finish.node)
         {
             mystl::destroy(start.cur, start.last);
             mystl::destroy(finish.first, finish.cur);
-            data_allocator::deallocate(finish.first, buffer_size);
+            deallocate_node(finish.first);
         }
         else
         {
@@ -884,8 +941,8 @@ namespace mystl
 
     /*****************************************************************/
     // helper function
-    template <class T>
-    void deque<T>::create_map_and_nodes(size_type num_elements)
+    template <class T, size_t BufSize>
+    void deque<T, BufSize>::create_map_and_nodes(size_type num_elements)
     {
         size_type num_nodes = num_elements / buffer_size + 1;
         map_size = max(init_map_size, num_nodes + 2);
@@ -900,9 +957,11 @@ namespace mystl
         }
         catch (...)
         {
+            // 构造失败时对象不会再析构, 分区直接释放, 不放入 spare_
             for (auto n = nstart; n < cur; ++n)
-                deallocate_node(*n);
+                data_allocator::deallocate(*n, buffer_size);
             map_allocator::deallocate(map_, map_size);
+            map_ = nullptr;
             throw ;
         }
         start.set_node(nstart);
@@ -912,16 +971,19 @@ namespace mystl
     }
 
     // 只用于 catch 子句中用作清理功能
-    template <class T>
-    void deque<T>::destroy_map_and_nodes()
+    // 构造函数中失败时对象不会再析构, 分区直接释放, 已缓存的空闲分区也一并释放
+    template <class T, size_t BufSize>
+    void deque<T, BufSize>::destroy_map_and_nodes()
     {
         for (auto cur = start.node; cur <= finish.node; ++cur)
-            deallocate_node(*cur);
+            data_allocator::deallocate(*cur, buffer_size);
+        release_spare_nodes();
         map_allocator::deallocate(map_, map_size);
+        map_ = nullptr;
     }
 
-    template <class T>
-    void deque<T>::fill_initialize(size_type n, const value_type& value)
+    template <class T, size_t BufSize>
+    void deque<T, BufSize>::fill_initialize(size_type n, const value_type& value)
     {
         create_map_and_nodes(n);
         map_pointer cur;
@@ -940,18 +1002,18 @@ namespace mystl
         }
     }
 
-    template <class T>
+    template <class T, size_t BufSize>
     template <class InputIter>
-    void deque<T>::range_initialize(InputIter first, InputIter last, input_iterator_tag)
+    void deque<T, BufSize>::range_initialize(InputIter first, InputIter last, input_iterator_tag)
     {
         create_map_and_nodes(0);
         for (; first != last; ++first)
             push_back(*first);
     }
 
-    template <class T>
+    template <class T, size_t BufSize>
     template <class ForwardIter>
-    void deque<T>::range_initialize(ForwardIter first, ForwardIter last, forward_iterator_tag)
+    void deque<T, BufSize>::range_initialize(ForwardIter first, ForwardIter last, forward_iterator_tag)
     {
         size_type n = mystl::distance(first, last);
         create_map_and_nodes(n);
@@ -966,8 +1028,8 @@ namespace mystl
         }
     }
 
-    template <class T>
-    void deque<T>::fill_assign(size_type n, const value_type& value)
+    template <class T, size_t BufSize>
+    void deque<T, BufSize>::fill_assign(size_type n, const value_type& value)
     {
         if (n > size())
         {
@@ -981,9 +1043,9 @@ namespace mystl
         }
     }
 
-    template <class T>
+    template <class T, size_t BufSize>
     template <class InputIter>
-    void deque<T>::copy_assign(InputIter first, InputIter last, input_iterator_tag)
+    void deque<T, BufSize>::copy_assign(InputIter first, InputIter last, input_iterator_tag)
     {
         auto first1 = begin();
         auto last1 = end();
@@ -995,9 +1057,9 @@ namespace mystl
             insert(finish, first, last, input_iterator_tag());
     }
 
-    template <class T>
+    template <class T, size_t BufSize>
     template <class ForwardIter>
-    void deque<T>::copy_assign(ForwardIter first, ForwardIter last, forward_iterator_tag)
+    void deque<T, BufSize>::copy_assign(ForwardIter first, ForwardIter last, forward_iterator_tag)
     {
         const size_type len1 = size();
         const size_type len2 = mystl::distance(first, last);
@@ -1012,10 +1074,10 @@ namespace mystl
             erase(mystl::copy(first, last, start), finish);
     }
 
-    template <class T>
+    template <class T, size_t BufSize>
     template <class... Args>
-    typename deque<T>::iterator
-    deque<T>::insert_aux(iterator position, Args&& ...args)
+    typename deque<T, BufSize>::iterator
+    deque<T, BufSize>::insert_aux(iterator position, Args&& ...args)
     {
         const size_type elems_before = position - start;
         value_type value_copy = value_type(mystl::forward<Args>(args)...);
@@ -1045,9 +1107,9 @@ namespace mystl
         return position;
     }
 
-    template <class T>
-    typename deque<T>::iterator
-    deque<T>::insert_aux(iterator postiton, const value_type& value)
+    template <class T, size_t BufSize>
+    typename deque<T, BufSize>::iterator
+    deque<T, BufSize>::insert_aux(iterator postiton, const value_type& value)
     {
         const size_type elems_before = postiton - start;
         value_type value_copy = value;
@@ -1077,11 +1139,11 @@ namespace mystl
         return postiton;
     }
 
-    template <class T>
-    void deque<T>::insert_aux(iterator position, size_type n, const value_type& value)
+    template <class T, size_t BufSize>
+    void deque<T, BufSize>::insert_aux(iterator position, size_type n, const value_type& value)
     {
         const size_type elems_before = position - start;
-        const size_type value_copy = value;
+        const value_type value_copy = value;
         const size_type length = size();
         if (elems_before < (length / 2))
         {
@@ -1093,7 +1155,7 @@ namespace mystl
                 if (elems_before >= n)
                 {
                     iterator start_n = start + n;
-                    mystl::uninitialized_copy(start, start_n, old_start);
+                    mystl::uninitialized_copy(start, start_n, new_start);
                     start = new_start;
                     mystl::copy(start_n, position, old_start);
                     mystl::fill(position - n, position, value_copy);
@@ -1145,9 +1207,9 @@ namespace mystl
         }
     }
 
-    template <class T>
+    template <class T, size_t BufSize>
     template <class ForwardIter>
-    void deque<T>::insert_aux(iterator position, ForwardIter first, ForwardIter last, size_type n)
+    void deque<T, BufSize>::insert_aux(iterator position, ForwardIter first, ForwardIter last, size_type n)
     {
         const size_type elems_before = position - start;
         const size_type length = size();
@@ -1216,8 +1278,8 @@ namespace mystl
         }
     }
 
-    template <class T>
-    void deque<T>::new_elements_at_front(size_type new_elements)
+    template <class T, size_t BufSize>
+    void deque<T, BufSize>::new_elements_at_front(size_type new_elements)
     {
         size_type new_nodes = (new_elements + buffer_size - 1) / buffer_size;
         reserve_map_at_front(new_nodes);
@@ -1234,8 +1296,8 @@ namespace mystl
         }
     }
 
-    template <class T>
-    void deque<T>::new_elements_at_back(size_type new_elements)
+    template <class T, size_t BufSize>
+    void deque<T, BufSize>::new_elements_at_back(size_type new_elements)
     {
         size_type new_nodes = (new_elements + buffer_size - 1) / buffer_size;
         reserve_map_at_back(new_nodes);
@@ -1252,22 +1314,22 @@ namespace mystl
         }
     }
 
-    template <class T>
-    void deque<T>::desrtoy_nodes_at_front(iterator before_start)
+    template <class T, size_t BufSize>
+    void deque<T, BufSize>::desrtoy_nodes_at_front(iterator before_start)
     {
         for (auto n = before_start.node; n < start.node; ++n)
             deallocate_node(*n);
     }
 
-    template <class T>
-    void deque<T>::desrtoy_nodes_at_back(iterator after_finish)
+    template <class T, size_t BufSize>
+    void deque<T, BufSize>::desrtoy_nodes_at_back(iterator after_finish)
     {
         for (auto n = after_finish.node; n > finish.node; --n)
             deallocate_node(*n);
     }
 
-    template <class T>
-    void deque<T>::reallocate_map(size_type nodes_to_add, bool add_at_front)
+    template <class T, size_t BufSize>
+    void deque<T, BufSize>::reallocate_map(size_type nodes_to_add, bool add_at_front)
     {
         auto old_num_nodes = finish.node - start.node + 1;
         auto new_num_nodes = old_num_nodes + nodes_to_add;
@@ -1294,44 +1356,44 @@ namespace mystl
         finish.set_node(new_nstart + old_num_nodes - 1);
     }
 
-    template <class T>
-    bool operator==(const deque<T>& lhs, const deque<T>& rhs)
+    template <class T, size_t BufSize>
+    bool operator==(const deque<T, BufSize>& lhs, const deque<T, BufSize>& rhs)
     {
         return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
     }
 
-    template <class T>
-    bool operator!=(const deque<T>& lhs, const deque<T>& rhs)
+    template <class T, size_t BufSize>
+    bool operator!=(const deque<T, BufSize>& lhs, const deque<T, BufSize>& rhs)
     {
         return !(lhs == rhs);
     }
 
-    template <class T>
-    bool operator<(const deque<T>& lhs, const deque<T>& rhs)
+    template <class T, size_t BufSize>
+    bool operator<(const deque<T, BufSize>& lhs, const deque<T, BufSize>& rhs)
     {
         return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
     }
 
-    template <class T>
-    bool operator>(const deque<T>& lhs, const deque<T>& rhs)
+    template <class T, size_t BufSize>
+    bool operator>(const deque<T, BufSize>& lhs, const deque<T, BufSize>& rhs)
     {
         return rhs < lhs;
     }
 
-    template <class T>
-    bool operator<=(const deque<T>& lhs, const deque<T>& rhs)
+    template <class T, size_t BufSize>
+    bool operator<=(const deque<T, BufSize>& lhs, const deque<T, BufSize>& rhs)
     {
         return !(rhs > lhs);
     }
 
-    template <class T>
-    bool operator>=(const deque<T>& lhs, const deque<T>& rhs)
+    template <class T, size_t BufSize>
+    bool operator>=(const deque<T, BufSize>& lhs, const deque<T, BufSize>& rhs)
     {
         return !(lhs < rhs);
     }
 
-    template <class T>
-    void swap(deque<T>& lhs, deque<T>& rhs)
+    template <class T, size_t BufSize>
+    void swap(deque<T, BufSize>& lhs, deque<T, BufSize>& rhs)
     {
         lhs.swap(rhs);
     }
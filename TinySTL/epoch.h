@@ -0,0 +1,201 @@
+#ifndef TINYSTL_EPOCH_H
+#define TINYSTL_EPOCH_H
+
+// 这个头文件包含基于纪元 (epoch) 的内存回收 epoch_domain, 以及进入临界区用的 epoch_guard
+// 无锁结构中一个节点被摘下后, 其他线程可能仍在读它, 不能立即释放
+// 线程访问共享结构前进入临界区, 公布自己看到的全局纪元; 摘下的节点连同当时的全局纪元放入本线程的待回收列表
+// 所有处于临界区的线程都已看到当前纪元时, 全局纪元才能加一,
+// 因此全局纪元比节点记录的纪元大 2 时, 摘下节点之前进入临界区的线程都已离开, 节点可以释放
+// 所有无锁容器共用一个 epoch_domain, 线程第一次使用时登记一条记录, 线程退出后记录留给之后的线程复用
+// 临界区可以嵌套, 只有最外层的进入和离开会修改公布的纪元
+
+#include <atomic>
+#include <cstdint>
+
+#include "vector.h"
+
+namespace mystl
+{
+    class epoch_domain
+    {
+    public:
+        typedef void (*deleter_type)(void*);
+
+    private:
+        struct retired_object
+        {
+            void*           ptr;
+            deleter_type    deleter;
+            uint64_t        epoch;      // 摘下时的全局纪元
+        };
+
+        struct thread_record
+        {
+            std::atomic<uint64_t>   epoch;      // 最低位表示是否在临界区中, 其余位为进入时的全局纪元
+            std::atomic<bool>       in_use;
+            thread_record*          next;
+            // 以下只由持有该记录的线程访问
+            size_t                          nesting;
+            mystl::vector<retired_object>   retired;
+
+            thread_record() : epoch(0), in_use(true), next(nullptr), nesting(0) {}
+        };
+
+        // 线程退出时归还记录
+        struct record_holder
+        {
+            thread_record* record = nullptr;
+
+            ~record_holder()
+            {
+                if (record)
+                    instance().release_record(record);
+            }
+        };
+
+        // 每个线程积累这么多待回收对象后尝试推进纪元并回收
+        static constexpr size_t kReclaimThreshold = 64;
+
+        std::atomic<uint64_t>       global_epoch_;
+        std::atomic<thread_record*> records_;
+
+    public:
+        epoch_domain() : global_epoch_(0), records_(nullptr) {}
+
+        // 程序结束时已没有其他线程, 释放所有剩余对象
+        ~epoch_domain()
+        {
+            thread_record* r = records_.load(std::memory_order_acquire);
+            while (r)
+            {
+                thread_record* next = r->next;
+                for (auto& obj : r->retired)
+                    obj.deleter(obj.ptr);
+                delete r;
+                r = next;
+            }
+        }
+
+        epoch_domain(const epoch_domain&) = delete;
+        epoch_domain& operator=(const epoch_domain&) = delete;
+
+        static epoch_domain& instance()
+        {
+            static epoch_domain domain;
+            return domain;
+        }
+
+        // 进入临界区, 之后读到的共享节点在离开之前不会被释放
+        static void enter()
+        {
+            thread_record* r = local_record();
+            if (r->nesting++ == 0)
+            {
+                uint64_t e = instance().global_epoch_.load(std::memory_order_relaxed);
+                r->epoch.store((e << 1) | 1, std::memory_order_relaxed);
+                // 公布纪元必须先于之后对共享结构的读取被其他线程看到
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+
+        static void exit()
+        {
+            thread_record* r = local_record();
+            if (--r->nesting == 0)
+                r->epoch.store(0, std::memory_order_release);
+        }
+
+        // 登记一个已从共享结构中摘下的对象, 等到没有线程可能访问它时调用 deleter(p)
+        // 必须在临界区中调用
+        static void retire(void* p, deleter_type deleter)
+        {
+            epoch_domain& domain = instance();
+            thread_record* r = local_record();
+            uint64_t e = domain.global_epoch_.load(std::memory_order_seq_cst);
+            r->retired.push_back(retired_object{ p, deleter, e });
+            if (r->retired.size() >= kReclaimThreshold)
+            {
+                domain.try_advance();
+                domain.reclaim(r);
+            }
+        }
+
+    private:
+        static thread_record* local_record()
+        {
+            static thread_local record_holder holder;
+            if (!holder.record)
+                holder.record = instance().acquire_record();
+            return holder.record;
+        }
+
+        thread_record* acquire_record()
+        {
+            for (thread_record* r = records_.load(std::memory_order_acquire); r; r = r->next)
+            {
+                bool expected = false;
+                if (!r->in_use.load(std::memory_order_relaxed) &&
+                    r->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                    return r;
+            }
+            // 记录只增加不删除, 头插即可
+            thread_record* r = new thread_record;
+            thread_record* head = records_.load(std::memory_order_relaxed);
+            do
+            {
+                r->next = head;
+            } while (!records_.compare_exchange_weak(head, r, std::memory_order_release,
+                                                     std::memory_order_relaxed));
+            return r;
+        }
+
+        // 未能回收的对象随记录一起留给下一个使用者
+        void release_record(thread_record* r)
+        {
+            try_advance();
+            reclaim(r);
+            r->in_use.store(false, std::memory_order_release);
+        }
+
+        // 所有处于临界区的线程都已看到当前纪元时, 全局纪元加一
+        void try_advance()
+        {
+            uint64_t e = global_epoch_.load(std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            for (thread_record* r = records_.load(std::memory_order_acquire); r; r = r->next)
+            {
+                uint64_t local = r->epoch.load(std::memory_order_seq_cst);
+                if ((local & 1) && (local >> 1) != e)
+                    return;
+            }
+            global_epoch_.compare_exchange_strong(e, e + 1, std::memory_order_seq_cst);
+        }
+
+        void reclaim(thread_record* r)
+        {
+            uint64_t e = global_epoch_.load(std::memory_order_acquire);
+            size_t keep = 0;
+            for (size_t i = 0; i < r->retired.size(); ++i)
+            {
+                if (r->retired[i].epoch + 2 <= e)
+                    r->retired[i].deleter(r->retired[i].ptr);
+                else
+                    r->retired[keep++] = r->retired[i];
+            }
+            r->retired.erase(r->retired.begin() + keep, r->retired.end());
+        }
+    };
+
+    // RAII: 构造时进入临界区, 析构时离开
+    class epoch_guard
+    {
+    public:
+        epoch_guard()  { epoch_domain::enter(); }
+        ~epoch_guard() { epoch_domain::exit(); }
+
+        epoch_guard(const epoch_guard&) = delete;
+        epoch_guard& operator=(const epoch_guard&) = delete;
+    };
+} // namespace mystl
+
+#endif //TINYSTL_EPOCH_H
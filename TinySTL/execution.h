@@ -0,0 +1,834 @@
+#ifndef MYTINYSTL_EXECUTION_H_
+#define MYTINYSTL_EXECUTION_H_
+
+// 这个头文件包含执行策略 mystl::execution::seq / par / par_unseq, 以及 algo.h 中部分算法接受执行策略的重载版本
+// 使用 par / par_unseq 时, 随机访问区间被切成若干块交给 executor (缺省为 default_executor(), 可用 par.on(ex) 指定) 并行处理,
+// 块数约为线程数的 4 倍, 由工作窃取平衡负载; 区间较短、线程只有一个或迭代器不是随机访问迭代器时使用顺序版本
+// par_unseq 目前与 par 相同, 每块内部的循环交给编译器自动向量化
+// 并行版本的函数对象会被多个线程同时调用, 调用者须保证它们可以并发执行
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+#include "algo.h"
+#include "vector.h"
+#include "executor.h"
+
+namespace mystl
+{
+
+namespace execution
+{
+
+class sequenced_policy {};
+
+// 缺省使用 work_stealing_executor::default_executor(), on(ex) 返回改用 ex 的策略
+class parallel_policy
+{
+  work_stealing_executor* ex_;
+public:
+  constexpr parallel_policy() : ex_(nullptr) {}
+  parallel_policy on(work_stealing_executor& ex) const
+  {
+    parallel_policy p;
+    p.ex_ = &ex;
+    return p;
+  }
+  work_stealing_executor& executor() const
+  {
+    return ex_ != nullptr ? *ex_ : work_stealing_executor::default_executor();
+  }
+};
+
+class parallel_unsequenced_policy
+{
+  work_stealing_executor* ex_;
+public:
+  constexpr parallel_unsequenced_policy() : ex_(nullptr) {}
+  parallel_unsequenced_policy on(work_stealing_executor& ex) const
+  {
+    parallel_unsequenced_policy p;
+    p.ex_ = &ex;
+    return p;
+  }
+  work_stealing_executor& executor() const
+  {
+    return ex_ != nullptr ? *ex_ : work_stealing_executor::default_executor();
+  }
+};
+
+constexpr sequenced_policy            seq{};
+constexpr parallel_policy             par{};
+constexpr parallel_unsequenced_policy par_unseq{};
+
+} // namespace execution
+
+template <class T>
+struct is_execution_policy : public m_false_type {};
+
+template <>
+struct is_execution_policy<execution::sequenced_policy> : public m_true_type {};
+
+template <>
+struct is_execution_policy<execution::parallel_policy> : public m_true_type {};
+
+template <>
+struct is_execution_policy<execution::parallel_unsequenced_policy> : public m_true_type {};
+
+// 只有第一个参数是执行策略时才参与重载决议, 避免与顺序版本冲突
+template <class ExecutionPolicy, class R>
+using enable_if_execution_policy_t = typename std::enable_if<
+  is_execution_policy<typename std::decay<ExecutionPolicy>::type>::value, R>::type;
+
+/*****************************************************************************************/
+// 并行辅助函数
+
+// 元素个数少于 kParallelThreshold 时使用顺序版本, 每块至少 kParallelMinChunk 个元素
+constexpr size_t kParallelThreshold = 1 << 15;
+constexpr size_t kParallelMinChunk  = 1 << 13;
+
+// 顺序策略不会走到并行分支, 这里只为让并行分支能够实例化
+inline work_stealing_executor& policy_executor(const execution::sequenced_policy&)
+{
+  return work_stealing_executor::default_executor();
+}
+
+inline work_stealing_executor& policy_executor(const execution::parallel_policy& policy)
+{
+  return policy.executor();
+}
+
+inline work_stealing_executor& policy_executor(const execution::parallel_unsequenced_policy& policy)
+{
+  return policy.executor();
+}
+
+inline bool parallel_enabled(const execution::sequenced_policy&, size_t)
+{
+  return false;
+}
+
+inline bool parallel_enabled(const execution::parallel_policy& policy, size_t n)
+{
+  return n >= kParallelThreshold && policy.executor().concurrency() > 1;
+}
+
+inline bool parallel_enabled(const execution::parallel_unsequenced_policy& policy, size_t n)
+{
+  return n >= kParallelThreshold && policy.executor().concurrency() > 1;
+}
+
+// 把 n 个元素分成的块数
+inline size_t parallel_chunk_count(work_stealing_executor& ex, size_t n)
+{
+  const size_t by_size = (n + kParallelMinChunk - 1) / kParallelMinChunk;
+  return mystl::max<size_t>(1, mystl::min(by_size, ex.concurrency() * 4));
+}
+
+// 第 k 块是 [n * k / chunks, n * (k + 1) / chunks)
+inline size_t parallel_chunk_begin(size_t n, size_t chunks, size_t k)
+{
+  return static_cast<size_t>(static_cast<unsigned long long>(n) * k / chunks);
+}
+
+// 对块号 [first, last) 递归二分, 用 parallel_invoke 并行执行 f(k, begin, end)
+template <class Function>
+void parallel_chunks_aux(work_stealing_executor& ex, size_t n, size_t chunks,
+                         size_t first, size_t last, Function& f)
+{
+  if (last - first == 1)
+  {
+    f(first, parallel_chunk_begin(n, chunks, first), parallel_chunk_begin(n, chunks, first + 1));
+    return;
+  }
+  const size_t mid = first + (last - first) / 2;
+  mystl::parallel_invoke(ex,
+                         [&] { parallel_chunks_aux(ex, n, chunks, mid, last, f); },
+                         [&] { parallel_chunks_aux(ex, n, chunks, first, mid, f); });
+}
+
+template <class Function>
+void parallel_chunks(work_stealing_executor& ex, size_t n, size_t chunks, Function f)
+{
+  parallel_chunks_aux(ex, n, chunks, 0, chunks, f);
+}
+
+/*****************************************************************************************/
+// for_each
+/*****************************************************************************************/
+template <class ExecutionPolicy, class ForwardIter, class Function>
+void for_each_policy_dispatch(ExecutionPolicy&, ForwardIter first, ForwardIter last,
+                              Function& f, m_false_type)
+{
+  mystl::for_each(first, last, f);
+}
+
+template <class ExecutionPolicy, class RandomIter, class Function>
+void for_each_policy_dispatch(ExecutionPolicy& policy, RandomIter first, RandomIter last,
+                              Function& f, m_true_type)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  if (!parallel_enabled(policy, n))
+  {
+    mystl::for_each(first, last, f);
+    return;
+  }
+  auto& ex = policy_executor(policy);
+  parallel_chunks(ex, n, parallel_chunk_count(ex, n), [&](size_t, size_t b, size_t e)
+  {
+    for (auto it = first + b, end = first + e; it != end; ++it)
+      f(*it);
+  });
+}
+
+template <class ExecutionPolicy, class ForwardIter, class Function>
+enable_if_execution_policy_t<ExecutionPolicy, void>
+for_each(ExecutionPolicy&& policy, ForwardIter first, ForwardIter last, Function f)
+{
+  mystl::for_each_policy_dispatch(policy, first, last, f,
+                                  is_random_access_iterator<ForwardIter>());
+}
+
+/*****************************************************************************************/
+// transform
+/*****************************************************************************************/
+template <class ExecutionPolicy, class InputIter, class OutputIter, class UnaryOperation>
+OutputIter transform_policy_dispatch(ExecutionPolicy&, InputIter first, InputIter last,
+                                     OutputIter result, UnaryOperation& unary_op, m_false_type)
+{
+  return mystl::transform(first, last, result, unary_op);
+}
+
+template <class ExecutionPolicy, class RandomIter1, class RandomIter2, class UnaryOperation>
+RandomIter2 transform_policy_dispatch(ExecutionPolicy& policy, RandomIter1 first, RandomIter1 last,
+                                      RandomIter2 result, UnaryOperation& unary_op, m_true_type)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  if (!parallel_enabled(policy, n))
+    return mystl::transform(first, last, result, unary_op);
+  auto& ex = policy_executor(policy);
+  parallel_chunks(ex, n, parallel_chunk_count(ex, n), [&](size_t, size_t b, size_t e)
+  {
+    auto out = result + b;
+    for (auto it = first + b, end = first + e; it != end; ++it, ++out)
+      *out = unary_op(*it);
+  });
+  return result + n;
+}
+
+template <class ExecutionPolicy, class InputIter, class OutputIter, class UnaryOperation>
+enable_if_execution_policy_t<ExecutionPolicy, OutputIter>
+transform(ExecutionPolicy&& policy, InputIter first, InputIter last,
+          OutputIter result, UnaryOperation unary_op)
+{
+  return mystl::transform_policy_dispatch(policy, first, last, result, unary_op,
+    m_bool_constant<is_random_access_iterator<InputIter>::value &&
+                    is_random_access_iterator<OutputIter>::value>());
+}
+
+template <class ExecutionPolicy, class InputIter1, class InputIter2, class OutputIter,
+          class BinaryOperation>
+OutputIter transform_policy_dispatch(ExecutionPolicy&, InputIter1 first1, InputIter1 last1,
+                                     InputIter2 first2, OutputIter result,
+                                     BinaryOperation& binary_op, m_false_type)
+{
+  return mystl::transform(first1, last1, first2, result, binary_op);
+}
+
+template <class ExecutionPolicy, class RandomIter1, class RandomIter2, class RandomIter3,
+          class BinaryOperation>
+RandomIter3 transform_policy_dispatch(ExecutionPolicy& policy, RandomIter1 first1, RandomIter1 last1,
+                                      RandomIter2 first2, RandomIter3 result,
+                                      BinaryOperation& binary_op, m_true_type)
+{
+  const size_t n = static_cast<size_t>(last1 - first1);
+  if (!parallel_enabled(policy, n))
+    return mystl::transform(first1, last1, first2, result, binary_op);
+  auto& ex = policy_executor(policy);
+  parallel_chunks(ex, n, parallel_chunk_count(ex, n), [&](size_t, size_t b, size_t e)
+  {
+    auto it2 = first2 + b;
+    auto out = result + b;
+    for (auto it = first1 + b, end = first1 + e; it != end; ++it, ++it2, ++out)
+      *out = binary_op(*it, *it2);
+  });
+  return result + n;
+}
+
+template <class ExecutionPolicy, class InputIter1, class InputIter2, class OutputIter,
+          class BinaryOperation>
+enable_if_execution_policy_t<ExecutionPolicy, OutputIter>
+transform(ExecutionPolicy&& policy, InputIter1 first1, InputIter1 last1, InputIter2 first2,
+          OutputIter result, BinaryOperation binary_op)
+{
+  return mystl::transform_policy_dispatch(policy, first1, last1, first2, result, binary_op,
+    m_bool_constant<is_random_access_iterator<InputIter1>::value &&
+                    is_random_access_iterator<InputIter2>::value &&
+                    is_random_access_iterator<OutputIter>::value>());
+}
+
+/*****************************************************************************************/
+// count_if
+// 每块分别计数后相加
+/*****************************************************************************************/
+template <class ExecutionPolicy, class InputIter, class UnaryPredicate>
+size_t count_if_policy_dispatch(ExecutionPolicy&, InputIter first, InputIter last,
+                                UnaryPredicate& unary_pred, m_false_type)
+{
+  return mystl::count_if(first, last, unary_pred);
+}
+
+template <class ExecutionPolicy, class RandomIter, class UnaryPredicate>
+size_t count_if_policy_dispatch(ExecutionPolicy& policy, RandomIter first, RandomIter last,
+                                UnaryPredicate& unary_pred, m_true_type)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  if (!parallel_enabled(policy, n))
+    return mystl::count_if(first, last, unary_pred);
+  auto& ex = policy_executor(policy);
+  const size_t chunks = parallel_chunk_count(ex, n);
+  mystl::vector<size_t> counts(chunks, 0);
+  parallel_chunks(ex, n, chunks, [&](size_t k, size_t b, size_t e)
+  {
+    counts[k] = mystl::count_if(first + b, first + e, unary_pred);
+  });
+  size_t total = 0;
+  for (auto c : counts)
+    total += c;
+  return total;
+}
+
+template <class ExecutionPolicy, class InputIter, class UnaryPredicate>
+enable_if_execution_policy_t<ExecutionPolicy, size_t>
+count_if(ExecutionPolicy&& policy, InputIter first, InputIter last, UnaryPredicate unary_pred)
+{
+  return mystl::count_if_policy_dispatch(policy, first, last, unary_pred,
+                                         is_random_access_iterator<InputIter>());
+}
+
+/*****************************************************************************************/
+// find_if
+// 各块按小段扫描, 找到后用原子操作记录最小的下标, 其他块扫描到更靠后的位置时提前结束
+/*****************************************************************************************/
+template <class ExecutionPolicy, class InputIter, class UnaryPredicate>
+InputIter find_if_policy_dispatch(ExecutionPolicy&, InputIter first, InputIter last,
+                                  UnaryPredicate& unary_pred, m_false_type)
+{
+  return mystl::find_if(first, last, unary_pred);
+}
+
+template <class ExecutionPolicy, class RandomIter, class UnaryPredicate>
+RandomIter find_if_policy_dispatch(ExecutionPolicy& policy, RandomIter first, RandomIter last,
+                                   UnaryPredicate& unary_pred, m_true_type)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  if (!parallel_enabled(policy, n))
+    return mystl::find_if(first, last, unary_pred);
+  const size_t kStep = 1024;
+  std::atomic<size_t> found(n);
+  auto& ex = policy_executor(policy);
+  parallel_chunks(ex, n, parallel_chunk_count(ex, n), [&](size_t, size_t b, size_t e)
+  {
+    for (size_t i = b; i < e; i += kStep)
+    {
+      if (found.load(std::memory_order_relaxed) <= i)
+        return;
+      const size_t step_end = mystl::min(e, i + kStep);
+      for (size_t j = i; j < step_end; ++j)
+      {
+        if (unary_pred(*(first + j)))
+        {
+          size_t cur = found.load(std::memory_order_relaxed);
+          while (j < cur && !found.compare_exchange_weak(cur, j, std::memory_order_relaxed))
+          {
+          }
+          return;
+        }
+      }
+    }
+  });
+  return first + found.load(std::memory_order_relaxed);
+}
+
+template <class ExecutionPolicy, class InputIter, class UnaryPredicate>
+enable_if_execution_policy_t<ExecutionPolicy, InputIter>
+find_if(ExecutionPolicy&& policy, InputIter first, InputIter last, UnaryPredicate unary_pred)
+{
+  return mystl::find_if_policy_dispatch(policy, first, last, unary_pred,
+                                        is_random_access_iterator<InputIter>());
+}
+
+/*****************************************************************************************/
+// remove_copy_if
+// 第一遍每块统计保留的个数, 前缀和得到每块的输出位置, 第二遍各块把保留的元素复制到自己的位置
+/*****************************************************************************************/
+template <class ExecutionPolicy, class InputIter, class OutputIter, class UnaryPredicate>
+OutputIter remove_copy_if_policy_dispatch(ExecutionPolicy&, InputIter first, InputIter last,
+                                          OutputIter result, UnaryPredicate& unary_pred,
+                                          m_false_type)
+{
+  return mystl::remove_copy_if(first, last, result, unary_pred);
+}
+
+template <class ExecutionPolicy, class RandomIter1, class RandomIter2, class UnaryPredicate>
+RandomIter2 remove_copy_if_policy_dispatch(ExecutionPolicy& policy, RandomIter1 first,
+                                           RandomIter1 last, RandomIter2 result,
+                                           UnaryPredicate& unary_pred, m_true_type)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  if (!parallel_enabled(policy, n))
+    return mystl::remove_copy_if(first, last, result, unary_pred);
+  auto& ex = policy_executor(policy);
+  const size_t chunks = parallel_chunk_count(ex, n);
+  mystl::vector<size_t> offset(chunks + 1, 0);
+  parallel_chunks(ex, n, chunks, [&](size_t k, size_t b, size_t e)
+  {
+    offset[k + 1] = (e - b) - mystl::count_if(first + b, first + e, unary_pred);
+  });
+  for (size_t k = 0; k < chunks; ++k)
+    offset[k + 1] += offset[k];
+  parallel_chunks(ex, n, chunks, [&](size_t k, size_t b, size_t e)
+  {
+    mystl::remove_copy_if(first + b, first + e, result + offset[k], unary_pred);
+  });
+  return result + offset[chunks];
+}
+
+template <class ExecutionPolicy, class InputIter, class OutputIter, class UnaryPredicate>
+enable_if_execution_policy_t<ExecutionPolicy, OutputIter>
+remove_copy_if(ExecutionPolicy&& policy, InputIter first, InputIter last,
+               OutputIter result, UnaryPredicate unary_pred)
+{
+  return mystl::remove_copy_if_policy_dispatch(policy, first, last, result, unary_pred,
+    m_bool_constant<is_random_access_iterator<InputIter>::value &&
+                    is_random_access_iterator<OutputIter>::value>());
+}
+
+/*****************************************************************************************/
+// replace_if
+/*****************************************************************************************/
+template <class ExecutionPolicy, class ForwardIter, class UnaryPredicate, class T>
+void replace_if_policy_dispatch(ExecutionPolicy&, ForwardIter first, ForwardIter last,
+                                UnaryPredicate& unary_pred, const T& new_value, m_false_type)
+{
+  mystl::replace_if(first, last, unary_pred, new_value);
+}
+
+template <class ExecutionPolicy, class RandomIter, class UnaryPredicate, class T>
+void replace_if_policy_dispatch(ExecutionPolicy& policy, RandomIter first, RandomIter last,
+                                UnaryPredicate& unary_pred, const T& new_value, m_true_type)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  if (!parallel_enabled(policy, n))
+  {
+    mystl::replace_if(first, last, unary_pred, new_value);
+    return;
+  }
+  auto& ex = policy_executor(policy);
+  parallel_chunks(ex, n, parallel_chunk_count(ex, n), [&](size_t, size_t b, size_t e)
+  {
+    mystl::replace_if(first + b, first + e, unary_pred, new_value);
+  });
+}
+
+template <class ExecutionPolicy, class ForwardIter, class UnaryPredicate, class T>
+enable_if_execution_policy_t<ExecutionPolicy, void>
+replace_if(ExecutionPolicy&& policy, ForwardIter first, ForwardIter last,
+           UnaryPredicate unary_pred, const T& new_value)
+{
+  mystl::replace_if_policy_dispatch(policy, first, last, unary_pred, new_value,
+                                    is_random_access_iterator<ForwardIter>());
+}
+
+/*****************************************************************************************/
+// generate
+/*****************************************************************************************/
+template <class ExecutionPolicy, class ForwardIter, class Generator>
+void generate_policy_dispatch(ExecutionPolicy&, ForwardIter first, ForwardIter last,
+                              Generator& gen, m_false_type)
+{
+  mystl::generate(first, last, gen);
+}
+
+template <class ExecutionPolicy, class RandomIter, class Generator>
+void generate_policy_dispatch(ExecutionPolicy& policy, RandomIter first, RandomIter last,
+                              Generator& gen, m_true_type)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  if (!parallel_enabled(policy, n))
+  {
+    mystl::generate(first, last, gen);
+    return;
+  }
+  auto& ex = policy_executor(policy);
+  parallel_chunks(ex, n, parallel_chunk_count(ex, n), [&](size_t, size_t b, size_t e)
+  {
+    for (auto it = first + b, end = first + e; it != end; ++it)
+      *it = gen();
+  });
+}
+
+template <class ExecutionPolicy, class ForwardIter, class Generator>
+enable_if_execution_policy_t<ExecutionPolicy, void>
+generate(ExecutionPolicy&& policy, ForwardIter first, ForwardIter last, Generator gen)
+{
+  mystl::generate_policy_dispatch(policy, first, last, gen,
+                                  is_random_access_iterator<ForwardIter>());
+}
+
+/*****************************************************************************************/
+// max_element / min_element
+// 每块求出自己的结果后再顺序比较各块, 相等时保留较前的块, 与顺序版本一样返回第一个最值
+/*****************************************************************************************/
+template <class ExecutionPolicy, class ForwardIter, class Compared>
+ForwardIter max_element_policy_dispatch(ExecutionPolicy&, ForwardIter first, ForwardIter last,
+                                        Compared& comp, m_false_type)
+{
+  return mystl::max_element(first, last, comp);
+}
+
+template <class ExecutionPolicy, class RandomIter, class Compared>
+RandomIter max_element_policy_dispatch(ExecutionPolicy& policy, RandomIter first, RandomIter last,
+                                       Compared& comp, m_true_type)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  if (!parallel_enabled(policy, n))
+    return mystl::max_element(first, last, comp);
+  auto& ex = policy_executor(policy);
+  const size_t chunks = parallel_chunk_count(ex, n);
+  mystl::vector<RandomIter> best(chunks, first);
+  parallel_chunks(ex, n, chunks, [&](size_t k, size_t b, size_t e)
+  {
+    best[k] = mystl::max_element(first + b, first + e, comp);
+  });
+  auto result = best[0];
+  for (size_t k = 1; k < chunks; ++k)
+  {
+    if (comp(*result, *best[k]))
+      result = best[k];
+  }
+  return result;
+}
+
+template <class ExecutionPolicy, class ForwardIter, class Compared>
+enable_if_execution_policy_t<ExecutionPolicy, ForwardIter>
+max_element(ExecutionPolicy&& policy, ForwardIter first, ForwardIter last, Compared comp)
+{
+  return mystl::max_element_policy_dispatch(policy, first, last, comp,
+                                            is_random_access_iterator<ForwardIter>());
+}
+
+template <class ExecutionPolicy, class ForwardIter>
+enable_if_execution_policy_t<ExecutionPolicy, ForwardIter>
+max_element(ExecutionPolicy&& policy, ForwardIter first, ForwardIter last)
+{
+  return mystl::max_element(policy, first, last,
+                            mystl::less<typename iterator_traits<ForwardIter>::value_type>());
+}
+
+template <class ExecutionPolicy, class ForwardIter, class Compared>
+ForwardIter min_element_policy_dispatch(ExecutionPolicy&, ForwardIter first, ForwardIter last,
+                                        Compared& comp, m_false_type)
+{
+  return mystl::min_element(first, last, comp);
+}
+
+template <class ExecutionPolicy, class RandomIter, class Compared>
+RandomIter min_element_policy_dispatch(ExecutionPolicy& policy, RandomIter first, RandomIter last,
+                                       Compared& comp, m_true_type)
+{
+  const size_t n = static_cast<size_t>(last - first);
+  if (!parallel_enabled(policy, n))
+    return mystl::min_element(first, last, comp);
+  auto& ex = policy_executor(policy);
+  const size_t chunks = parallel_chunk_count(ex, n);
+  mystl::vector<RandomIter> best(chunks, first);
+  parallel_chunks(ex, n, chunks, [&](size_t k, size_t b, size_t e)
+  {
+    best[k] = mystl::min_element(first + b, first + e, comp);
+  });
+  auto result = best[0];
+  for (size_t k = 1; k < chunks; ++k)
+  {
+    if (comp(*best[k], *result))
+      result = best[k];
+  }
+  return result;
+}
+
+template <class ExecutionPolicy, class ForwardIter, class Compared>
+enable_if_execution_policy_t<ExecutionPolicy, ForwardIter>
+min_element(ExecutionPolicy&& policy, ForwardIter first, ForwardIter last, Compared comp)
+{
+  return mystl::min_element_policy_dispatch(policy, first, last, comp,
+                                            is_random_access_iterator<ForwardIter>());
+}
+
+template <class ExecutionPolicy, class ForwardIter>
+enable_if_execution_policy_t<ExecutionPolicy, ForwardIter>
+min_element(ExecutionPolicy&& policy, ForwardIter first, ForwardIter last)
+{
+  return mystl::min_element(policy, first, last,
+                            mystl::less<typename iterator_traits<ForwardIter>::value_type>());
+}
+
+/*****************************************************************************************/
+// merge
+// 把输出区间等分成若干块, 对每个分界点 d 二分求出它在两个序列中各占多少元素 (merge path),
+// 之后各块独立地顺序合并; 相等的元素先取自第一个序列, 与顺序版本一致
+/*****************************************************************************************/
+// 在合并结果的前 d 个元素中, 第一个序列占的个数
+template <class RandomIter1, class RandomIter2, class Compared>
+size_t merge_path_split(RandomIter1 first1, size_t n1, RandomIter2 first2, size_t n2,
+                        size_t d, Compared& comp)
+{
+  size_t lo = d > n2 ? d - n2 : 0;
+  size_t hi = mystl::min(d, n1);
+  while (lo < hi)
+  {
+    const size_t i = lo + (hi - lo) / 2;
+    // first1[i] 不排在 first2[d - i - 1] 之后, 说明第一个序列取得太少
+    if (!comp(*(first2 + (d - i - 1)), *(first1 + i)))
+      lo = i + 1;
+    else
+      hi = i;
+  }
+  return lo;
+}
+
+template <class ExecutionPolicy, class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter merge_policy_dispatch(ExecutionPolicy&, InputIter1 first1, InputIter1 last1,
+                                 InputIter2 first2, InputIter2 last2, OutputIter result,
+                                 Compared& comp, m_false_type)
+{
+  return mystl::merge(first1, last1, first2, last2, result, comp);
+}
+
+template <class ExecutionPolicy, class RandomIter1, class RandomIter2, class RandomIter3,
+          class Compared>
+RandomIter3 merge_policy_dispatch(ExecutionPolicy& policy, RandomIter1 first1, RandomIter1 last1,
+                                  RandomIter2 first2, RandomIter2 last2, RandomIter3 result,
+                                  Compared& comp, m_true_type)
+{
+  const size_t n1 = static_cast<size_t>(last1 - first1);
+  const size_t n2 = static_cast<size_t>(last2 - first2);
+  const size_t n = n1 + n2;
+  if (!parallel_enabled(policy, n))
+    return mystl::merge(first1, last1, first2, last2, result, comp);
+  auto& ex = policy_executor(policy);
+  parallel_chunks(ex, n, parallel_chunk_count(ex, n), [&](size_t, size_t b, size_t e)
+  {
+    const size_t i1 = merge_path_split(first1, n1, first2, n2, b, comp);
+    const size_t i2 = merge_path_split(first1, n1, first2, n2, e, comp);
+    mystl::merge(first1 + i1, first1 + i2, first2 + (b - i1), first2 + (e - i2),
+                 result + b, comp);
+  });
+  return result + n;
+}
+
+template <class ExecutionPolicy, class InputIter1, class InputIter2, class OutputIter, class Compared>
+enable_if_execution_policy_t<ExecutionPolicy, OutputIter>
+merge(ExecutionPolicy&& policy, InputIter1 first1, InputIter1 last1,
+      InputIter2 first2, InputIter2 last2, OutputIter result, Compared comp)
+{
+  return mystl::merge_policy_dispatch(policy, first1, last1, first2, last2, result, comp,
+    m_bool_constant<is_random_access_iterator<InputIter1>::value &&
+                    is_random_access_iterator<InputIter2>::value &&
+                    is_random_access_iterator<OutputIter>::value>());
+}
+
+template <class ExecutionPolicy, class InputIter1, class InputIter2, class OutputIter>
+enable_if_execution_policy_t<ExecutionPolicy, OutputIter>
+merge(ExecutionPolicy&& policy, InputIter1 first1, InputIter1 last1,
+      InputIter2 first2, InputIter2 last2, OutputIter result)
+{
+  return mystl::merge(policy, first1, last1, first2, last2, result,
+                      mystl::less<typename iterator_traits<InputIter1>::value_type>());
+}
+
+/*****************************************************************************************/
+// sort
+// 并行样本排序 (sample sort):
+//   1. 随机抽取 kSampleOversample * (m + 1) 个样本排序, 等距取 m 个分割值并去重
+//   2. 各块并行地把元素分到 2m + 1 个桶: 落在相邻两个分割值之间的为普通桶, 等于某个分割值的为相等桶,
+//      大量重复的元素都进入相等桶而不必再排序; 桶号记在 16 位的数组中, 同时统计每块每个桶的元素个数
+//   3. 按 (桶, 块) 的顺序求前缀和, 各块并行地把元素移动到临时缓冲区中各自的位置
+//   4. 各桶并行地用 mystl::sort 排序后移回原区间
+// 分割值个数取 n / kSampleSortBucket, 普通桶期望约 kSampleSortBucket 个元素;
+// 分割值至多 kSampleSortMaxSplitters 个, n 超过两者之积 (约 2^31) 后每桶的元素个数才随 n 增长
+// 元素较少时使用 mystl::sort; 申请不到临时空间或元素的移动构造可能抛出异常时, 改用并行快速排序
+/*****************************************************************************************/
+constexpr size_t kSampleSortBucket       = 1 << 16;
+constexpr size_t kSampleOversample       = 16;
+constexpr size_t kSampleSortMaxSplitters = 32767; // 桶号不超过 65534, 可以放进 uint16_t
+
+// 并行快速排序: 三点中值分割后两侧交给 parallel_invoke, 短区间或分割过深时改用顺序的 mystl::sort
+template <class RandomIter, class Compared>
+void parallel_quick_sort(work_stealing_executor& ex, RandomIter first, RandomIter last,
+                         size_t depth_limit, Compared& comp)
+{
+  if (static_cast<size_t>(last - first) <= kParallelMinChunk || depth_limit == 0)
+  {
+    mystl::sort(first, last, comp);
+    return;
+  }
+  auto mid = mystl::median(*(first), *(first + (last - first) / 2), *(last - 1), comp);
+  auto cut = mystl::unchecked_partition(first, last, mid, comp);
+  mystl::parallel_invoke(ex,
+                         [&] { parallel_quick_sort(ex, cut, last, depth_limit - 1, comp); },
+                         [&] { parallel_quick_sort(ex, first, cut, depth_limit - 1, comp); });
+}
+
+// 取样并返回去重后的分割值
+template <class RandomIter, class Compared>
+mystl::vector<typename iterator_traits<RandomIter>::value_type>
+sample_sort_splitters(RandomIter first, size_t n, size_t m, Compared& comp)
+{
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  mystl::vector<value_type> sample;
+  const size_t s = (m + 1) * kSampleOversample;
+  sample.reserve(s);
+  uint64_t rng = 0x9E3779B97F4A7C15ull ^ n;
+  for (size_t i = 0; i < s; ++i)
+  {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    sample.push_back(*(first + static_cast<size_t>(rng % n)));
+  }
+  mystl::sort(sample.begin(), sample.end(), comp);
+  mystl::vector<value_type> splitters;
+  splitters.reserve(m);
+  for (size_t i = 1; i <= m; ++i)
+  {
+    const value_type& x = sample[i * kSampleOversample - 1];
+    if (splitters.empty() || comp(splitters.back(), x))
+      splitters.push_back(x);
+  }
+  return splitters;
+}
+
+// 返回 x 所在的桶: 第一个不小于 x 的分割值为第 i 个, 与它相等时为相等桶 2i + 1, 否则为 2i
+template <class T, class Compared>
+unsigned sample_sort_classify(const T* splitters, size_t m, const T& x, Compared& comp)
+{
+  size_t lo = 0, len = m;
+  while (len > 0)
+  {
+    const size_t half = len / 2;
+    if (comp(splitters[lo + half], x))
+    {
+      lo += half + 1;
+      len -= half + 1;
+    }
+    else
+    {
+      len = half;
+    }
+  }
+  return static_cast<unsigned>(lo < m && !comp(x, splitters[lo]) ? 2 * lo + 1 : 2 * lo);
+}
+
+template <class RandomIter, class Compared>
+bool parallel_sample_sort(work_stealing_executor& ex, RandomIter first, size_t n, Compared& comp)
+{
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  const size_t m0 = mystl::min(kSampleSortMaxSplitters,
+                               mystl::max(n / kSampleSortBucket, ex.concurrency() * 4));
+  const auto splitters = sample_sort_splitters(first, n, m0, comp);
+  const size_t m = splitters.size();
+  const size_t buckets = 2 * m + 1;
+  const value_type* spl = &*splitters.begin();
+
+  value_type* buf = static_cast<value_type*>(malloc(n * sizeof(value_type)));
+  uint16_t* ids = static_cast<uint16_t*>(malloc(n * sizeof(uint16_t)));
+  if (buf == nullptr || ids == nullptr)
+  {
+    free(buf);
+    free(ids);
+    return false;
+  }
+
+  // 每块每个桶的元素个数, 之后改为该块在这个桶中的输出位置
+  const size_t chunks = parallel_chunk_count(ex, n);
+  mystl::vector<size_t> offset(chunks * buckets, 0);
+  parallel_chunks(ex, n, chunks, [&](size_t k, size_t b, size_t e)
+  {
+    size_t* cnt = &offset[k * buckets];
+    for (size_t i = b; i < e; ++i)
+    {
+      const unsigned id = sample_sort_classify(spl, m, *(first + i), comp);
+      ids[i] = static_cast<uint16_t>(id);
+      ++cnt[id];
+    }
+  });
+  mystl::vector<size_t> bucket_begin(buckets + 1, 0);
+  size_t pos = 0;
+  for (size_t bk = 0; bk < buckets; ++bk)
+  {
+    bucket_begin[bk] = pos;
+    for (size_t k = 0; k < chunks; ++k)
+    {
+      const size_t c = offset[k * buckets + bk];
+      offset[k * buckets + bk] = pos;
+      pos += c;
+    }
+  }
+  bucket_begin[buckets] = n;
+
+  parallel_chunks(ex, n, chunks, [&](size_t k, size_t b, size_t e)
+  {
+    size_t* out = &offset[k * buckets];
+    for (size_t i = b; i < e; ++i)
+      ::new (buf + out[ids[i]]++) value_type(mystl::move(*(first + i)));
+  });
+  free(ids);
+
+  parallel_chunks(ex, buckets, buckets, [&](size_t bk, size_t, size_t)
+  {
+    value_type* lo = buf + bucket_begin[bk];
+    value_type* hi = buf + bucket_begin[bk + 1];
+    if (bk % 2 == 0)
+      mystl::sort(lo, hi, comp);
+    auto out = first + bucket_begin[bk];
+    for (; lo != hi; ++lo, ++out)
+    {
+      *out = mystl::move(*lo);
+      mystl::destroy(lo);
+    }
+  });
+  free(buf);
+  return true;
+}
+
+template <class ExecutionPolicy, class RandomIter, class Compared>
+enable_if_execution_policy_t<ExecutionPolicy, void>
+sort(ExecutionPolicy&& policy, RandomIter first, RandomIter last, Compared comp)
+{
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  const size_t n = static_cast<size_t>(last - first);
+  if (!parallel_enabled(policy, n))
+  {
+    mystl::sort(first, last, comp);
+    return;
+  }
+  auto& ex = policy_executor(policy);
+  if (std::is_nothrow_move_constructible<value_type>::value &&
+      mystl::parallel_sample_sort(ex, first, n, comp))
+    return;
+  mystl::parallel_quick_sort(ex, first, last, static_cast<size_t>(mystl::slg2(n) * 2), comp);
+}
+
+template <class ExecutionPolicy, class RandomIter>
+enable_if_execution_policy_t<ExecutionPolicy, void>
+sort(ExecutionPolicy&& policy, RandomIter first, RandomIter last)
+{
+  mystl::sort(policy, first, last,
+              mystl::less<typename iterator_traits<RandomIter>::value_type>());
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_EXECUTION_H_
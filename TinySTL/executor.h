@@ -0,0 +1,500 @@
+#ifndef TINYSTL_EXECUTOR_H
+#define TINYSTL_EXECUTOR_H
+
+// 这个头文件包含工作窃取的线程池 work_stealing_executor, 以及建立在它之上的 task_group 和 parallel_invoke
+// 每个工作线程有一个 Chase-Lev 双端队列 (chase_lev_deque):
+//   线程只在底部压入和弹出自己的任务, 后进先出, 刚分出去的子任务仍在缓存中
+//   空闲线程随机挑选一个工作线程, 从它的顶部窃取最早压入的任务, 这通常是递归中最大的一块
+// 非工作线程提交的任务放入共享的 mpmc_queue, 由工作线程取走
+// 等待子任务的线程不会阻塞, 而是继续执行自己或别人的任务, 因此嵌套的 fork-join 不会耗尽线程
+// 没有任务可做的工作线程先自旋让出时间片, 之后在条件变量上睡眠, 有新任务时被唤醒
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include "vector.h"
+#include "queue.h"
+#include "ring_util.h"
+#include "util.h"
+
+namespace mystl
+{
+    /*****************************************************************************************/
+    // 模板类 chase_lev_deque
+    // 单个拥有者在底部 push / pop, 任意线程在顶部 steal, T 须为指针等可平凡复制的类型, T() 表示没有取到
+    // 数组满时换成两倍大小的新数组, 窃取者可能仍在读旧数组, 旧数组留到析构时释放
+
+    template <class T>
+    class chase_lev_deque
+    {
+    private:
+        struct ring
+        {
+            int64_t             cap;
+            std::atomic<T>*     buf;
+
+            explicit ring(int64_t n) : cap(n), buf(new std::atomic<T>[n]) {}
+            ~ring() { delete[] buf; }
+
+            T    get(int64_t i) const noexcept { return buf[i & (cap - 1)].load(std::memory_order_relaxed); }
+            void put(int64_t i, T x) noexcept  { buf[i & (cap - 1)].store(x, std::memory_order_relaxed); }
+        };
+
+        std::atomic<int64_t>    top_;       // 窃取端
+        char                    pad_[cache_line_size];
+        std::atomic<int64_t>    bottom_;    // 拥有者端
+        std::atomic<ring*>      ring_;
+        mystl::vector<ring*>    retired_;   // 只由拥有者访问
+
+    public:
+        explicit chase_lev_deque(int64_t capacity = 256)
+            : top_(0), bottom_(0), ring_(new ring(capacity))
+        {
+        }
+
+        chase_lev_deque(const chase_lev_deque&) = delete;
+        chase_lev_deque& operator=(const chase_lev_deque&) = delete;
+
+        ~chase_lev_deque()
+        {
+            delete ring_.load(std::memory_order_relaxed);
+            for (auto r : retired_)
+                delete r;
+        }
+
+        // 近似值, 只用于判断是否可能有任务
+        bool empty() const noexcept
+        {
+            return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+        }
+
+        // 以下由拥有者调用
+
+        void push(T x)
+        {
+            const int64_t b = bottom_.load(std::memory_order_relaxed);
+            const int64_t t = top_.load(std::memory_order_acquire);
+            ring* r = ring_.load(std::memory_order_relaxed);
+            if (b - t > r->cap - 1)
+                r = grow(r, t, b);
+            r->put(b, x);
+            bottom_.store(b + 1, std::memory_order_release);
+        }
+
+        T pop()
+        {
+            const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+            ring* r = ring_.load(std::memory_order_relaxed);
+            // 先缩小 bottom_ 再读 top_, 与 steal 中先读 top_ 再读 bottom_ 配合, 两者都须是全序操作
+            bottom_.store(b, std::memory_order_seq_cst);
+            int64_t t = top_.load(std::memory_order_seq_cst);
+            if (t > b)
+            {
+                bottom_.store(b + 1, std::memory_order_relaxed);
+                return T();
+            }
+            T x = r->get(b);
+            if (t == b)
+            {
+                // 只剩最后一个, 与窃取者竞争
+                if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                  std::memory_order_relaxed))
+                    x = T();
+                bottom_.store(b + 1, std::memory_order_relaxed);
+            }
+            return x;
+        }
+
+        // 以下可由任意线程调用, 队列为空或与他人竞争失败时返回 T()
+
+        T steal()
+        {
+            int64_t t = top_.load(std::memory_order_seq_cst);
+            const int64_t b = bottom_.load(std::memory_order_seq_cst);
+            if (t >= b)
+                return T();
+            ring* r = ring_.load(std::memory_order_acquire);
+            T x = r->get(t);
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                              std::memory_order_relaxed))
+                return T();
+            return x;
+        }
+
+    private:
+        ring* grow(ring* old, int64_t t, int64_t b)
+        {
+            ring* r = new ring(old->cap * 2);
+            for (int64_t i = t; i < b; ++i)
+                r->put(i, old->get(i));
+            retired_.push_back(old);
+            ring_.store(r, std::memory_order_release);
+            return r;
+        }
+    };
+
+    /*****************************************************************************************/
+    // 任务基类, 由 executor 调用 execute, 任务自己负责捕获异常和释放
+
+    class executor_task
+    {
+    public:
+        virtual void execute() = 0;
+
+    protected:
+        ~executor_task() = default;
+    };
+
+    /*****************************************************************************************/
+    // 类 work_stealing_executor
+
+    // 没有任务可做时, 工作线程在睡眠之前尝试的轮数
+    constexpr int executor_idle_spin = 64;
+
+    class work_stealing_executor
+    {
+    private:
+        struct worker
+        {
+            work_stealing_executor*             owner;
+            size_t                              index;
+            uint64_t                            rng;
+            chase_lev_deque<executor_task*>     tasks;
+            std::thread                         thread;
+        };
+
+        mystl::vector<worker*>              workers_;
+        mystl::mpmc_queue<executor_task*>   injected_;      // 非工作线程提交的任务
+
+        std::atomic<bool>                   stop_;
+        std::mutex                          sleep_mutex_;
+        std::condition_variable             wake_;
+        std::atomic<int>                    sleepers_;
+
+    public:
+        // threads 为 0 时使用硬件线程数
+        explicit work_stealing_executor(size_t threads = 0)
+            : injected_(1024), stop_(false), sleepers_(0)
+        {
+            if (threads == 0)
+                threads = mystl::max<size_t>(1, std::thread::hardware_concurrency());
+            workers_.reserve(threads);
+            for (size_t i = 0; i < threads; ++i)
+            {
+                worker* w = new worker;
+                w->owner = this;
+                w->index = i;
+                w->rng = 0x9E3779B97F4A7C15ull * (i + 1);
+                workers_.push_back(w);
+            }
+            for (auto w : workers_)
+                w->thread = std::thread([this, w] { run_worker(w); });
+        }
+
+        work_stealing_executor(const work_stealing_executor&) = delete;
+        work_stealing_executor& operator=(const work_stealing_executor&) = delete;
+
+        // 调用者须保证已提交的任务都已完成
+        ~work_stealing_executor()
+        {
+            stop_.store(true, std::memory_order_seq_cst);
+            {
+                std::lock_guard<std::mutex> guard(sleep_mutex_);
+            }
+            wake_.notify_all();
+            // 其他工作线程可能还在窃取, 全部结束后才能释放
+            for (auto w : workers_)
+                w->thread.join();
+            for (auto w : workers_)
+                delete w;
+        }
+
+        // 全局共享的 executor, 第一次使用时创建
+        static work_stealing_executor& default_executor()
+        {
+            static work_stealing_executor ex;
+            return ex;
+        }
+
+    public:
+        size_t concurrency() const noexcept { return workers_.size(); }
+
+        // 当前线程是否是本 executor 的工作线程
+        bool in_worker() const noexcept
+        {
+            worker* w = current_worker();
+            return w != nullptr && w->owner == this;
+        }
+
+        // 工作线程提交到自己的队列底部, 其他线程提交到共享队列
+        void submit(executor_task* t)
+        {
+            worker* w = current_worker();
+            if (w != nullptr && w->owner == this)
+                w->tasks.push(t);
+            else
+                injected_.push(t);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (sleepers_.load(std::memory_order_relaxed) > 0)
+            {
+                {
+                    std::lock_guard<std::mutex> guard(sleep_mutex_);
+                }
+                wake_.notify_one();
+            }
+        }
+
+        // 在 done() 为 true 之前执行其他任务, 而不是阻塞
+        template <class Pred>
+        void wait_until(Pred done)
+        {
+            worker* w = current_worker();
+            if (w != nullptr && w->owner != this)
+                w = nullptr;
+            uint64_t rng = reinterpret_cast<uintptr_t>(&rng) | 1;
+            while (!done())
+            {
+                executor_task* t = find_task(w, w != nullptr ? w->rng : rng);
+                if (t != nullptr)
+                    t->execute();
+                else
+                    std::this_thread::yield();
+            }
+        }
+
+    private:
+        static worker*& current_worker() noexcept
+        {
+            static thread_local worker* w = nullptr;
+            return w;
+        }
+
+        static uint64_t next_random(uint64_t& s) noexcept
+        {
+            s ^= s << 13;
+            s ^= s >> 7;
+            s ^= s << 17;
+            return s;
+        }
+
+        // 依次尝试: 自己的队列底部, 共享队列, 随机挑选的其他工作线程
+        executor_task* find_task(worker* self, uint64_t& rng)
+        {
+            executor_task* t = nullptr;
+            if (self != nullptr && (t = self->tasks.pop()) != nullptr)
+                return t;
+            if (injected_.try_pop(t))
+                return t;
+            const size_t n = workers_.size();
+            size_t victim = static_cast<size_t>(next_random(rng) % n);
+            for (size_t k = 0; k < n; ++k, victim = victim + 1 == n ? 0 : victim + 1)
+            {
+                if (workers_[victim] == self)
+                    continue;
+                if ((t = workers_[victim]->tasks.steal()) != nullptr)
+                    return t;
+            }
+            return nullptr;
+        }
+
+        bool has_work() const noexcept
+        {
+            if (!injected_.empty())
+                return true;
+            for (auto w : workers_)
+            {
+                if (!w->tasks.empty())
+                    return true;
+            }
+            return false;
+        }
+
+        void run_worker(worker* self)
+        {
+            current_worker() = self;
+            int idle = 0;
+            while (!stop_.load(std::memory_order_acquire))
+            {
+                executor_task* t = find_task(self, self->rng);
+                if (t != nullptr)
+                {
+                    t->execute();
+                    idle = 0;
+                    continue;
+                }
+                if (++idle < executor_idle_spin)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                // 先登记再检查, 与 submit 中先放入任务再检查登记数配合, 不会错过唤醒
+                std::unique_lock<std::mutex> lock(sleep_mutex_);
+                sleepers_.fetch_add(1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                while (!stop_.load(std::memory_order_acquire) && !has_work())
+                    wake_.wait(lock);
+                sleepers_.fetch_sub(1, std::memory_order_relaxed);
+                idle = 0;
+            }
+            current_worker() = nullptr;
+        }
+    };
+
+    /*****************************************************************************************/
+    // 类 task_group
+    // run 提交一个任务, wait 在所有任务完成之前帮助执行其他任务, 任务抛出的第一个异常在 wait 中重新抛出
+    // 析构时会等待尚未完成的任务
+
+    class task_group
+    {
+    private:
+        template <class F>
+        class group_task final : public executor_task
+        {
+            F            f_;
+            task_group*  group_;
+
+        public:
+            group_task(F&& f, task_group* g) : f_(mystl::move(f)), group_(g) {}
+            group_task(const F& f, task_group* g) : f_(f), group_(g) {}
+
+            void execute() override
+            {
+                try
+                {
+                    f_();
+                }
+                catch (...)
+                {
+                    group_->set_exception(std::current_exception());
+                }
+                task_group* g = group_;
+                // 先释放任务再通知完成, 避免 wait 返回后才析构 f_
+                delete this;
+                g->pending_.fetch_sub(1, std::memory_order_release);
+            }
+        };
+
+        work_stealing_executor&     ex_;
+        std::atomic<size_t>         pending_;
+        std::atomic<bool>           failed_;
+        std::exception_ptr          exception_;
+
+    public:
+        explicit task_group(work_stealing_executor& ex = work_stealing_executor::default_executor())
+            : ex_(ex), pending_(0), failed_(false)
+        {
+        }
+
+        task_group(const task_group&) = delete;
+        task_group& operator=(const task_group&) = delete;
+
+        ~task_group()
+        {
+            ex_.wait_until([this] { return pending_.load(std::memory_order_acquire) == 0; });
+        }
+
+        template <class F>
+        void run(F&& f)
+        {
+            typedef typename std::decay<F>::type fn_type;
+            auto t = new group_task<fn_type>(mystl::forward<F>(f), this);
+            pending_.fetch_add(1, std::memory_order_relaxed);
+            ex_.submit(t);
+        }
+
+        void wait()
+        {
+            ex_.wait_until([this] { return pending_.load(std::memory_order_acquire) == 0; });
+            if (failed_.load(std::memory_order_acquire))
+            {
+                std::exception_ptr e = exception_;
+                exception_ = nullptr;
+                failed_.store(false, std::memory_order_relaxed);
+                std::rethrow_exception(e);
+            }
+        }
+
+    private:
+        void set_exception(std::exception_ptr e)
+        {
+            bool expected = false;
+            // 只保留第一个异常, failed_ 在写入 exception_ 之前就被置位, wait 在 pending_ 为 0 后才读取
+            if (failed_.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+                exception_ = e;
+        }
+    };
+
+    /*****************************************************************************************/
+    // parallel_invoke
+    // 并行执行若干个可调用对象, 全部完成后返回; 第一个交给 executor, 其余的在当前线程递归处理
+    // 子任务放在当前栈上, 如果没有被窃取, 等待时会由当前线程自己从队列底部取回执行
+
+    namespace detail
+    {
+        template <class F>
+        class invoke_task final : public executor_task
+        {
+        public:
+            F&                  f;
+            std::atomic<bool>   done;
+            std::exception_ptr  exception;
+
+            explicit invoke_task(F& fn) : f(fn), done(false) {}
+
+            void execute() override
+            {
+                try
+                {
+                    f();
+                }
+                catch (...)
+                {
+                    exception = std::current_exception();
+                }
+                done.store(true, std::memory_order_release);
+            }
+        };
+    }
+
+    template <class F>
+    void parallel_invoke(work_stealing_executor&, F&& f)
+    {
+        f();
+    }
+
+    template <class F1, class F2, class ...Fs>
+    void parallel_invoke(work_stealing_executor& ex, F1&& f1, F2&& f2, Fs&& ...fs)
+    {
+        detail::invoke_task<typename std::remove_reference<F1>::type> t(f1);
+        ex.submit(&t);
+        std::exception_ptr e;
+        try
+        {
+            parallel_invoke(ex, mystl::forward<F2>(f2), mystl::forward<Fs>(fs)...);
+        }
+        catch (...)
+        {
+            e = std::current_exception();
+        }
+        // t 在当前栈上, 无论如何都要等它完成
+        ex.wait_until([&t] { return t.done.load(std::memory_order_acquire); });
+        if (e)
+            std::rethrow_exception(e);
+        if (t.exception)
+            std::rethrow_exception(t.exception);
+    }
+
+    template <class F1, class F2, class ...Fs>
+    void parallel_invoke(F1&& f1, F2&& f2, Fs&& ...fs)
+    {
+        parallel_invoke(work_stealing_executor::default_executor(), mystl::forward<F1>(f1),
+                        mystl::forward<F2>(f2), mystl::forward<Fs>(fs)...);
+    }
+} // namespace mystl
+
+#endif //TINYSTL_EXECUTOR_H
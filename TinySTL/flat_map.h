@@ -0,0 +1,364 @@
+#ifndef TINYSTL_FLAT_MAP_H
+#define TINYSTL_FLAT_MAP_H
+
+// 这个头文件包含两个模板类 flat_map 和 flat_multimap
+// 接口与 map / multimap 相同, 底层为按键有序的 mystl::vector (flat_tree)
+// 为了能在数组中移动元素, value_type 为 pair<Key, T> 而不是 pair<const Key, T>, 不要通过迭代器修改键
+// 任何插入删除操作都会使迭代器失效
+
+#include "flat_tree.h"
+
+namespace mystl
+{
+    template <class Key, class T, class Compare = mystl::less<Key>>
+    class flat_map
+    {
+    public:
+        typedef Key                         key_type;
+        typedef T                           mapped_type;
+        typedef mystl::pair<Key, T>         value_type;
+        typedef Compare                     key_compare;
+
+    private:
+        typedef mystl::flat_tree<key_type, value_type,
+                                 mystl::selectfirst<value_type>, key_compare> rep_type;
+        rep_type t;
+
+    public:
+        typedef typename rep_type::pointer                  pointer;
+        typedef typename rep_type::const_pointer            const_pointer;
+        typedef typename rep_type::reference                reference;
+        typedef typename rep_type::const_reference          const_reference;
+        typedef typename rep_type::iterator                 iterator;
+        typedef typename rep_type::const_iterator           const_iterator;
+        typedef typename rep_type::reverse_iterator         reverse_iterator;
+        typedef typename rep_type::const_reverse_iterator   const_reverse_iterator;
+        typedef typename rep_type::size_type                size_type;
+        typedef typename rep_type::difference_type          difference_type;
+        typedef typename rep_type::allocator_type           allocator_type;
+
+    public:
+        // 构造 / 复制 / 移动 / 重载赋值运算符
+        flat_map() = default;
+
+        template <class InputIter>
+        flat_map(InputIter first, InputIter last)
+            :t()
+        { t.insert_unique(first, last); }
+
+        // 调用者保证 [first, last) 按键严格递增
+        template <class InputIter>
+        flat_map(mystl::sorted_unique_t, InputIter first, InputIter last)
+            :t()
+        { t.assign_sorted_unique(first, last); }
+
+        flat_map(std::initializer_list<value_type> ilist)
+            :t()
+        { t.insert_unique(ilist.begin(), ilist.end()); }
+
+        flat_map(const flat_map& other)
+            :t(other.t)
+        {
+        }
+
+        flat_map(flat_map&& other) noexcept
+            :t(mystl::move(other.t))
+        {
+        }
+
+        flat_map& operator=(const flat_map& rhs)
+        {
+            t = rhs.t;
+            return *this;
+        }
+
+        flat_map& operator=(flat_map&& rhs)
+        {
+            t = mystl::move(rhs.t);
+            return *this;
+        }
+
+        flat_map& operator=(std::initializer_list<value_type> ilist)
+        {
+            t.clear();
+            t.insert_unique(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        key_compare     key_comp()      const { return t.key_comp(); }
+
+        // 迭代器
+        iterator                begin()             noexcept { return t.begin(); }
+        const_iterator          begin()       const noexcept { return t.begin(); }
+        iterator                end()               noexcept { return t.end(); }
+        const_iterator          end()         const noexcept { return t.end(); }
+        reverse_iterator        rbegin()            noexcept { return t.rbegin(); }
+        const_reverse_iterator  rbegin()      const noexcept { return t.rbegin(); }
+        reverse_iterator        rend()              noexcept { return t.rend(); }
+        const_reverse_iterator  rend()        const noexcept { return t.rend(); }
+        const_iterator          cbegin()      const noexcept { return t.begin(); }
+        const_iterator          cend()        const noexcept { return t.end(); }
+
+        // 容量
+        bool        empty()       const noexcept { return t.empty(); }
+        size_type   size()        const noexcept { return t.size(); }
+        size_type   max_size()    const noexcept { return t.max_size(); }
+        size_type   capacity()    const noexcept { return t.capacity(); }
+        void        reserve(size_type n)         { t.reserve(n); }
+
+        // 访问元素
+        mapped_type& at(const key_type& key)
+        {
+            iterator it = find(key);
+            THROW_OUT_OF_RANGE_IF(it == end(), "flat_map<Key, T> no such element exists");
+            return it->second;
+        }
+
+        const mapped_type& at(const key_type& key) const
+        {
+            const_iterator it = find(key);
+            THROW_OUT_OF_RANGE_IF(it == end(), "flat_map<Key, T> no such element exists");
+            return it->second;
+        }
+
+        mapped_type& operator[](const key_type& key)
+        {
+            iterator it = lower_bound(key);
+            if (it == end() || key_comp()(key, it->first))
+                it = t.insert_unique(it, value_type(key, T()));
+            return it->second;
+        }
+
+        mapped_type& operator[](key_type&& key)
+        {
+            iterator it = lower_bound(key);
+            if (it == end() || key_comp()(key, it->first))
+                it = t.insert_unique(it, value_type(mystl::move(key), T()));
+            return it->second;
+        }
+
+        // 插入删除
+        template <class ...Args>
+        pair<iterator, bool> emplace(Args&& ...args)
+        { return t.emplace_unique(mystl::forward<Args>(args)...); }
+
+        template <class ...Args>
+        iterator emplace_hint(const_iterator hint, Args&& ...args)
+        { return t.insert_unique(hint, value_type(mystl::forward<Args>(args)...)); }
+
+        pair<iterator, bool> insert(const value_type& value)
+        { return t.insert_unique(value); }
+        pair<iterator, bool> insert(value_type&& value)
+        { return t.insert_unique(mystl::move(value)); }
+
+        iterator insert(const_iterator hint, const value_type& value)
+        { return t.insert_unique(hint, value); }
+
+        // 批量插入只排序去重一次
+        template <class InputIter>
+        void insert(InputIter first, InputIter last)
+        { t.insert_unique(first, last); }
+
+        iterator    erase(const_iterator pos)                        { return t.erase(pos); }
+        size_type   erase(const key_type& key)                       { return t.erase_unique(key); }
+        iterator    erase(const_iterator first, const_iterator last) { return t.erase(first, last); }
+
+        void        clear()                                          { t.clear(); }
+
+        // 查找
+        iterator        find(const key_type& key)               { return t.find(key); }
+        const_iterator  find(const key_type& key)        const  { return t.find(key); }
+
+        size_type       count(const key_type& key)       const  { return t.count_unique(key); }
+
+        iterator        lower_bound(const key_type& key)        { return t.lower_bound(key); }
+        const_iterator  lower_bound(const key_type& key) const  { return t.lower_bound(key); }
+
+        iterator        upper_bound(const key_type& key)        { return t.upper_bound(key); }
+        const_iterator  upper_bound(const key_type& key) const  { return t.upper_bound(key); }
+
+        mystl::pair<iterator, iterator>
+        equal_range(const key_type& key)
+        { return t.equal_range_unique(key); }
+
+        mystl::pair<const_iterator, const_iterator>
+        equal_range(const key_type& key) const
+        { return t.equal_range_unique(key); }
+
+        void swap(flat_map& rhs) noexcept
+        { t.swap(rhs.t); }
+
+    public:
+        // 运算符重载
+        bool operator==(const flat_map& rhs) const { return t == rhs.t; }
+        bool operator<(const flat_map& rhs)  const { return t < rhs.t; }
+        bool operator!=(const flat_map& rhs) const { return !(t == rhs.t); }
+        bool operator>(const flat_map& rhs)  const { return rhs.t < t; }
+        bool operator<=(const flat_map& rhs) const { return !(rhs.t < t); }
+        bool operator>=(const flat_map& rhs) const { return !(t < rhs.t); }
+    };
+
+    template <class Key, class T, class Compare>
+    void swap(flat_map<Key, T, Compare>& lhs, flat_map<Key, T, Compare>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    // 模板类 flat_multimap, 键值允许重复
+    template <class Key, class T, class Compare = mystl::less<Key>>
+    class flat_multimap
+    {
+    public:
+        typedef Key                         key_type;
+        typedef T                           mapped_type;
+        typedef mystl::pair<Key, T>         value_type;
+        typedef Compare                     key_compare;
+
+    private:
+        typedef mystl::flat_tree<key_type, value_type,
+                                 mystl::selectfirst<value_type>, key_compare> rep_type;
+        rep_type t;
+
+    public:
+        typedef typename rep_type::pointer                  pointer;
+        typedef typename rep_type::const_pointer            const_pointer;
+        typedef typename rep_type::reference                reference;
+        typedef typename rep_type::const_reference          const_reference;
+        typedef typename rep_type::iterator                 iterator;
+        typedef typename rep_type::const_iterator           const_iterator;
+        typedef typename rep_type::reverse_iterator         reverse_iterator;
+        typedef typename rep_type::const_reverse_iterator   const_reverse_iterator;
+        typedef typename rep_type::size_type                size_type;
+        typedef typename rep_type::difference_type          difference_type;
+        typedef typename rep_type::allocator_type           allocator_type;
+
+    public:
+        flat_multimap() = default;
+
+        template <class InputIter>
+        flat_multimap(InputIter first, InputIter last)
+            :t()
+        { t.insert_multi(first, last); }
+
+        flat_multimap(std::initializer_list<value_type> ilist)
+            :t()
+        { t.insert_multi(ilist.begin(), ilist.end()); }
+
+        flat_multimap(const flat_multimap& other)
+            :t(other.t)
+        {
+        }
+
+        flat_multimap(flat_multimap&& other) noexcept
+            :t(mystl::move(other.t))
+        {
+        }
+
+        flat_multimap& operator=(const flat_multimap& rhs)
+        {
+            t = rhs.t;
+            return *this;
+        }
+
+        flat_multimap& operator=(flat_multimap&& rhs)
+        {
+            t = mystl::move(rhs.t);
+            return *this;
+        }
+
+        flat_multimap& operator=(std::initializer_list<value_type> ilist)
+        {
+            t.clear();
+            t.insert_multi(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        key_compare     key_comp()      const { return t.key_comp(); }
+
+        // 迭代器
+        iterator                begin()             noexcept { return t.begin(); }
+        const_iterator          begin()       const noexcept { return t.begin(); }
+        iterator                end()               noexcept { return t.end(); }
+        const_iterator          end()         const noexcept { return t.end(); }
+        reverse_iterator        rbegin()            noexcept { return t.rbegin(); }
+        const_reverse_iterator  rbegin()      const noexcept { return t.rbegin(); }
+        reverse_iterator        rend()              noexcept { return t.rend(); }
+        const_reverse_iterator  rend()        const noexcept { return t.rend(); }
+        const_iterator          cbegin()      const noexcept { return t.begin(); }
+        const_iterator          cend()        const noexcept { return t.end(); }
+
+        // 容量
+        bool        empty()       const noexcept { return t.empty(); }
+        size_type   size()        const noexcept { return t.size(); }
+        size_type   max_size()    const noexcept { return t.max_size(); }
+        size_type   capacity()    const noexcept { return t.capacity(); }
+        void        reserve(size_type n)         { t.reserve(n); }
+
+        // 插入删除
+        template <class ...Args>
+        iterator emplace(Args&& ...args)
+        { return t.emplace_multi(mystl::forward<Args>(args)...); }
+
+        template <class ...Args>
+        iterator emplace_hint(const_iterator hint, Args&& ...args)
+        { return t.insert_multi(hint, value_type(mystl::forward<Args>(args)...)); }
+
+        iterator insert(const value_type& value)
+        { return t.insert_multi(value); }
+        iterator insert(value_type&& value)
+        { return t.insert_multi(mystl::move(value)); }
+
+        iterator insert(const_iterator hint, const value_type& value)
+        { return t.insert_multi(hint, value); }
+
+        template <class InputIter>
+        void insert(InputIter first, InputIter last)
+        { t.insert_multi(first, last); }
+
+        iterator    erase(const_iterator pos)                        { return t.erase(pos); }
+        size_type   erase(const key_type& key)                       { return t.erase_multi(key); }
+        iterator    erase(const_iterator first, const_iterator last) { return t.erase(first, last); }
+
+        void        clear()                                          { t.clear(); }
+
+        // 查找
+        iterator        find(const key_type& key)               { return t.find(key); }
+        const_iterator  find(const key_type& key)        const  { return t.find(key); }
+
+        size_type       count(const key_type& key)       const  { return t.count_multi(key); }
+
+        iterator        lower_bound(const key_type& key)        { return t.lower_bound(key); }
+        const_iterator  lower_bound(const key_type& key) const  { return t.lower_bound(key); }
+
+        iterator        upper_bound(const key_type& key)        { return t.upper_bound(key); }
+        const_iterator  upper_bound(const key_type& key) const  { return t.upper_bound(key); }
+
+        mystl::pair<iterator, iterator>
+        equal_range(const key_type& key)
+        { return t.equal_range_multi(key); }
+
+        mystl::pair<const_iterator, const_iterator>
+        equal_range(const key_type& key) const
+        { return t.equal_range_multi(key); }
+
+        void swap(flat_multimap& rhs) noexcept
+        { t.swap(rhs.t); }
+
+    public:
+        // 运算符重载
+        bool operator==(const flat_multimap& rhs) const { return t == rhs.t; }
+        bool operator<(const flat_multimap& rhs)  const { return t < rhs.t; }
+        bool operator!=(const flat_multimap& rhs) const { return !(t == rhs.t); }
+        bool operator>(const flat_multimap& rhs)  const { return rhs.t < t; }
+        bool operator<=(const flat_multimap& rhs) const { return !(rhs.t < t); }
+        bool operator>=(const flat_multimap& rhs) const { return !(t < rhs.t); }
+    };
+
+    template <class Key, class T, class Compare>
+    void swap(flat_multimap<Key, T, Compare>& lhs, flat_multimap<Key, T, Compare>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+} // namespace mystl
+
+#endif //TINYSTL_FLAT_MAP_H
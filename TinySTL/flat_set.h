@@ -0,0 +1,163 @@
+#ifndef TINYSTL_FLAT_SET_H
+#define TINYSTL_FLAT_SET_H
+
+// 这个头文件包含模板类 flat_set
+// flat_set 的接口与 set 相同, 底层为有序的 mystl::vector (flat_tree), 键值不允许重复
+// 任何插入删除操作都会使迭代器失效
+
+#include "flat_tree.h"
+
+namespace mystl
+{
+    template <class Key, class Compare = mystl::less<Key>>
+    class flat_set
+    {
+    public:
+        typedef Key         key_type;
+        typedef Key         value_type;
+        typedef Compare     key_compare;
+        typedef Compare     value_compare;
+
+    private:
+        typedef mystl::flat_tree<key_type, value_type,
+                                 mystl::identity<value_type>, key_compare> rep_type;
+        rep_type tree_;
+
+    public:
+        typedef typename rep_type::pointer                  pointer;
+        typedef typename rep_type::const_pointer            const_pointer;
+        typedef typename rep_type::const_reference          reference;
+        typedef typename rep_type::const_reference          const_reference;
+        typedef typename rep_type::const_iterator           iterator;
+        typedef typename rep_type::const_iterator           const_iterator;
+        typedef typename rep_type::const_reverse_iterator   reverse_iterator;
+        typedef typename rep_type::const_reverse_iterator   const_reverse_iterator;
+        typedef typename rep_type::size_type                size_type;
+        typedef typename rep_type::difference_type          difference_type;
+        typedef typename rep_type::allocator_type           allocator_type;
+
+    public:
+        flat_set() = default;
+
+        template <class InputIter>
+        flat_set(InputIter first, InputIter last)
+            : tree_()
+        { tree_.insert_unique(first, last); }
+
+        // 调用者保证 [first, last) 严格递增
+        template <class InputIter>
+        flat_set(mystl::sorted_unique_t, InputIter first, InputIter last)
+            : tree_()
+        { tree_.assign_sorted_unique(first, last); }
+
+        flat_set(std::initializer_list<value_type> ilist)
+            : tree_()
+        { tree_.insert_unique(ilist.begin(), ilist.end()); }
+
+        flat_set(const flat_set& other)
+            : tree_(other.tree_)
+        {
+        }
+
+        flat_set(flat_set&& other) noexcept
+            : tree_(mystl::move(other.tree_))
+        {
+        }
+
+        flat_set& operator=(const flat_set& rhs)
+        {
+            tree_ = rhs.tree_;
+            return *this;
+        }
+
+        flat_set& operator=(flat_set&& rhs)
+        {
+            tree_ = mystl::move(rhs.tree_);
+            return *this;
+        }
+
+        flat_set& operator=(std::initializer_list<value_type> ilist)
+        {
+            tree_.clear();
+            tree_.insert_unique(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        key_compare     key_comp()   const { return tree_.key_comp(); }
+        value_compare   value_comp() const { return tree_.key_comp(); }
+
+        // 迭代器
+        iterator                begin()       const noexcept { return tree_.begin(); }
+        iterator                end()         const noexcept { return tree_.end(); }
+        reverse_iterator        rbegin()      const noexcept { return tree_.rbegin(); }
+        reverse_iterator        rend()        const noexcept { return tree_.rend(); }
+        const_iterator          cbegin()      const noexcept { return tree_.begin(); }
+        const_iterator          cend()        const noexcept { return tree_.end(); }
+        const_reverse_iterator  crbegin()     const noexcept { return tree_.rbegin(); }
+        const_reverse_iterator  crend()       const noexcept { return tree_.rend(); }
+
+        // 容量
+        bool        empty()       const noexcept { return tree_.empty(); }
+        size_type   size()        const noexcept { return tree_.size(); }
+        size_type   max_size()    const noexcept { return tree_.max_size(); }
+        size_type   capacity()    const noexcept { return tree_.capacity(); }
+        void        reserve(size_type n)         { tree_.reserve(n); }
+
+        // 插入删除
+        template <class ...Args>
+        pair<iterator, bool> emplace(Args&& ...args)
+        { return tree_.emplace_unique(mystl::forward<Args>(args)...); }
+
+        template <class ...Args>
+        iterator emplace_hint(const_iterator hint, Args&& ...args)
+        { return tree_.insert_unique(hint, value_type(mystl::forward<Args>(args)...)); }
+
+        pair<iterator, bool> insert(const value_type& value)
+        { return tree_.insert_unique(value); }
+        pair<iterator, bool> insert(value_type&& value)
+        { return tree_.insert_unique(mystl::move(value)); }
+
+        iterator insert(const_iterator hint, const value_type& value)
+        { return tree_.insert_unique(hint, value); }
+
+        template <class InputIter>
+        void insert(InputIter first, InputIter last)
+        { tree_.insert_unique(first, last); }
+
+        iterator    erase(const_iterator pos)                    { return tree_.erase(pos); }
+        size_type   erase(const key_type& key)                   { return tree_.erase_unique(key); }
+        iterator    erase(const_iterator first, const_iterator last) { return tree_.erase(first, last); }
+
+        void        clear() { tree_.clear(); }
+
+        // 查找
+        iterator        find(const key_type& key)        const { return tree_.find(key); }
+        size_type       count(const key_type& key)       const { return tree_.count_unique(key); }
+        iterator        lower_bound(const key_type& key) const { return tree_.lower_bound(key); }
+        iterator        upper_bound(const key_type& key) const { return tree_.upper_bound(key); }
+
+        pair<iterator, iterator>
+        equal_range(const key_type& key) const
+        { return tree_.equal_range_unique(key); }
+
+        void swap(flat_set& rhs) noexcept
+        { tree_.swap(rhs.tree_); }
+
+    public:
+        bool operator==(const flat_set& rhs) const { return tree_ == rhs.tree_; }
+        bool operator<(const flat_set& rhs)  const { return tree_ < rhs.tree_; }
+
+        bool operator!=(const flat_set& rhs) const { return !(*this == rhs); }
+        bool operator>(const flat_set& rhs)  const { return rhs < *this; }
+        bool operator<=(const flat_set& rhs) const { return !(rhs < *this); }
+        bool operator>=(const flat_set& rhs) const { return !(*this < rhs); }
+    };
+
+    template <class Key, class Compare>
+    void swap(flat_set<Key, Compare>& lhs, flat_set<Key, Compare>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+} // namespace mystl
+
+#endif //TINYSTL_FLAT_SET_H
@@ -0,0 +1,337 @@
+#ifndef TINYSTL_FLAT_TREE_H
+#define TINYSTL_FLAT_TREE_H
+
+// 该模板类为 flat_tree, 是 flat_set / flat_map 的底层实现
+// 元素按键有序地存放在一段连续的 mystl::vector 中, 查找使用二分, 遍历就是顺序访问数组
+// 与 rb_tree 相比没有节点的指针开销, 对缓存更友好, 适合读多写少的场景
+// 单个元素的插入删除需要移动其后的元素, 为 O(n); 批量插入先追加再排序去重, 为 O(n log n)
+// 任何插入删除操作都会使迭代器失效
+
+#include <initializer_list>
+
+#include "vector.h"
+#include "algo.h"
+#include "functional.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+    template <class Key, class Value, class KeyOfValue, class Compare>
+    class flat_tree
+    {
+    public:
+        typedef mystl::vector<Value>                        container_type;
+        typedef typename container_type::allocator_type     allocator_type;
+
+        typedef Key                                         key_type;
+        typedef Value                                       value_type;
+        typedef Compare                                     key_compare_type;
+
+        typedef typename container_type::pointer            pointer;
+        typedef typename container_type::const_pointer      const_pointer;
+        typedef typename container_type::reference          reference;
+        typedef typename container_type::const_reference    const_reference;
+        typedef typename container_type::size_type          size_type;
+        typedef typename container_type::difference_type    difference_type;
+
+        typedef typename container_type::iterator               iterator;
+        typedef typename container_type::const_iterator         const_iterator;
+        typedef typename container_type::reverse_iterator       reverse_iterator;
+        typedef typename container_type::const_reverse_iterator const_reverse_iterator;
+
+    protected:
+        container_type data_;
+        Compare        key_compare;
+
+        bool value_less(const value_type& lhs, const value_type& rhs) const
+        { return key_compare(KeyOfValue()(lhs), KeyOfValue()(rhs)); }
+
+    public:
+        flat_tree() : data_(), key_compare() {}
+
+        flat_tree(const flat_tree& other)
+            : data_(other.data_), key_compare(other.key_compare)
+        {
+        }
+
+        flat_tree(flat_tree&& other) noexcept
+            : data_(mystl::move(other.data_)), key_compare(other.key_compare)
+        {
+        }
+
+        flat_tree& operator=(const flat_tree& rhs)
+        {
+            if (this != &rhs)
+            {
+                data_ = rhs.data_;
+                key_compare = rhs.key_compare;
+            }
+            return *this;
+        }
+
+        flat_tree& operator=(flat_tree&& rhs)
+        {
+            data_ = mystl::move(rhs.data_);
+            key_compare = rhs.key_compare;
+            return *this;
+        }
+
+    public:
+        // 迭代器
+        iterator                begin()             noexcept { return data_.begin(); }
+        const_iterator          begin()       const noexcept { return data_.begin(); }
+        iterator                end()               noexcept { return data_.end(); }
+        const_iterator          end()         const noexcept { return data_.end(); }
+
+        reverse_iterator        rbegin()            noexcept { return data_.rbegin(); }
+        const_reverse_iterator  rbegin()      const noexcept { return data_.rbegin(); }
+        reverse_iterator        rend()              noexcept { return data_.rend(); }
+        const_reverse_iterator  rend()        const noexcept { return data_.rend(); }
+
+        // 容器相关操作
+        bool        empty()       const noexcept { return data_.empty(); }
+        size_type   size()        const noexcept { return data_.size(); }
+        size_type   max_size()    const noexcept { return data_.max_size(); }
+        size_type   capacity()    const noexcept { return data_.capacity(); }
+        void        reserve(size_type n)         { data_.reserve(n); }
+
+        Compare     key_comp()    const          { return key_compare; }
+
+        void swap(flat_tree& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                data_.swap(rhs.data_);
+                mystl::swap(key_compare, rhs.key_compare);
+            }
+        }
+
+    public:
+        // 插入删除相关操作
+
+        template <class ...Args>
+        mystl::pair<iterator, bool> emplace_unique(Args&& ...args)
+        { return insert_unique(value_type(mystl::forward<Args>(args)...)); }
+
+        template <class ...Args>
+        iterator emplace_multi(Args&& ...args)
+        { return insert_multi(value_type(mystl::forward<Args>(args)...)); }
+
+        mystl::pair<iterator, bool> insert_unique(const value_type& value)
+        {
+            auto pos = lower_bound(KeyOfValue()(value));
+            if (pos != end() && !key_compare(KeyOfValue()(value), KeyOfValue()(*pos)))
+                return mystl::make_pair(pos, false);
+            return mystl::make_pair(data_.insert(pos, value), true);
+        }
+
+        mystl::pair<iterator, bool> insert_unique(value_type&& value)
+        {
+            auto pos = lower_bound(KeyOfValue()(value));
+            if (pos != end() && !key_compare(KeyOfValue()(value), KeyOfValue()(*pos)))
+                return mystl::make_pair(pos, false);
+            return mystl::make_pair(data_.insert(pos, mystl::move(value)), true);
+        }
+
+        iterator insert_multi(const value_type& value)
+        { return data_.insert(upper_bound(KeyOfValue()(value)), value); }
+
+        iterator insert_multi(value_type&& value)
+        {
+            auto pos = upper_bound(KeyOfValue()(value));
+            return data_.insert(pos, mystl::move(value));
+        }
+
+        // 提示位置正确时不需要查找, 只做两次比较
+        iterator insert_unique(const_iterator hint, const value_type& value)
+        {
+            const auto& k = KeyOfValue()(value);
+            if ((hint == begin() || key_compare(KeyOfValue()(*(hint - 1)), k)) &&
+                (hint == end() || key_compare(k, KeyOfValue()(*hint))))
+                return data_.insert(hint, value);
+            return insert_unique(value).first;
+        }
+
+        iterator insert_multi(const_iterator hint, const value_type& value)
+        {
+            const auto& k = KeyOfValue()(value);
+            if ((hint == begin() || !key_compare(k, KeyOfValue()(*(hint - 1)))) &&
+                (hint == end() || !key_compare(KeyOfValue()(*hint), k)))
+                return data_.insert(hint, value);
+            return insert_multi(value);
+        }
+
+        // 批量插入: 先追加到尾部, 对新加入的部分排序后与原有部分归并, 最后去重
+        // 与已有元素键重复时保留已有的元素, 新加入的元素之间重复时保留最先出现的一个
+        template <class InputIter>
+        void insert_unique(InputIter first, InputIter last)
+        {
+            append_sorted(first, last);
+            auto equal = [this](const value_type& lhs, const value_type& rhs)
+            { return !value_less(lhs, rhs); };
+            data_.erase(mystl::unique(data_.begin(), data_.end(), equal), data_.end());
+        }
+
+        template <class InputIter>
+        void insert_multi(InputIter first, InputIter last)
+        { append_sorted(first, last); }
+
+        // 调用者保证 [first, last) 严格递增, 直接替换原有内容
+        template <class InputIter>
+        void assign_sorted_unique(InputIter first, InputIter last)
+        {
+            data_.assign(first, last);
+            MYSTL_DEBUG(mystl::is_sorted(data_.begin(), data_.end(),
+                        [this](const value_type& lhs, const value_type& rhs)
+                        { return value_less(lhs, rhs); }));
+        }
+
+        iterator  erase(const_iterator pos) { return data_.erase(pos); }
+        iterator  erase(const_iterator first, const_iterator last) { return data_.erase(first, last); }
+
+        size_type erase_unique(const key_type& key)
+        {
+            auto it = find(key);
+            if (it == end())
+                return 0;
+            data_.erase(it);
+            return 1;
+        }
+
+        size_type erase_multi(const key_type& key)
+        {
+            auto p = equal_range_multi(key);
+            size_type n = static_cast<size_type>(p.second - p.first);
+            data_.erase(p.first, p.second);
+            return n;
+        }
+
+        void clear() { data_.clear(); }
+
+    public:
+        // 查找相关操作
+
+        iterator       lower_bound(const key_type& key)
+        { return begin() + lower_index(key); }
+        const_iterator lower_bound(const key_type& key) const
+        { return begin() + lower_index(key); }
+
+        iterator       upper_bound(const key_type& key)
+        { return begin() + upper_index(key); }
+        const_iterator upper_bound(const key_type& key) const
+        { return begin() + upper_index(key); }
+
+        iterator find(const key_type& key)
+        {
+            auto it = lower_bound(key);
+            return (it == end() || key_compare(key, KeyOfValue()(*it))) ? end() : it;
+        }
+
+        const_iterator find(const key_type& key) const
+        {
+            auto it = lower_bound(key);
+            return (it == end() || key_compare(key, KeyOfValue()(*it))) ? end() : it;
+        }
+
+        size_type count_unique(const key_type& key) const
+        { return find(key) == end() ? 0 : 1; }
+
+        size_type count_multi(const key_type& key) const
+        { return upper_index(key) - lower_index(key); }
+
+        mystl::pair<iterator, iterator> equal_range_unique(const key_type& key)
+        {
+            auto it = find(key);
+            return mystl::make_pair(it, it == end() ? it : it + 1);
+        }
+
+        mystl::pair<const_iterator, const_iterator> equal_range_unique(const key_type& key) const
+        {
+            auto it = find(key);
+            return mystl::make_pair(it, it == end() ? it : it + 1);
+        }
+
+        mystl::pair<iterator, iterator> equal_range_multi(const key_type& key)
+        { return mystl::make_pair(lower_bound(key), upper_bound(key)); }
+
+        mystl::pair<const_iterator, const_iterator> equal_range_multi(const key_type& key) const
+        { return mystl::make_pair(lower_bound(key), upper_bound(key)); }
+
+    protected:
+        size_type lower_index(const key_type& key) const;
+        size_type upper_index(const key_type& key) const;
+
+        template <class InputIter>
+        void append_sorted(InputIter first, InputIter last);
+
+    public:
+        bool operator==(const flat_tree& rhs) const
+        { return size() == rhs.size() && mystl::equal(begin(), end(), rhs.begin()); }
+
+        bool operator<(const flat_tree& rhs) const
+        { return mystl::lexicographical_compare(begin(), end(), rhs.begin(), rhs.end()); }
+    };
+
+    /****************************************************************************/
+
+    // 无分支的二分查找: 每一步只根据比较结果选择两个基址之一, 编译器可以生成 cmov,
+    // 循环次数只与元素个数有关, 不会因为分支预测失败而停顿
+    // 返回第一个不小于 key 的位置
+    template <class Key, class Value, class KeyOfValue, class Compare>
+    typename flat_tree<Key, Value, KeyOfValue, Compare>::size_type
+    flat_tree<Key, Value, KeyOfValue, Compare>::lower_index(const key_type& key) const
+    {
+        size_type n = data_.size();
+        if (0 == n)
+            return 0;
+        const value_type* first = data_.begin();
+        const value_type* base = first;
+        while (n > 1)
+        {
+            const size_type half = n / 2;
+            base = key_compare(KeyOfValue()(base[half]), key) ? base + half : base;
+            n -= half;
+        }
+        return static_cast<size_type>(base - first) + key_compare(KeyOfValue()(*base), key);
+    }
+
+    // 返回第一个大于 key 的位置
+    template <class Key, class Value, class KeyOfValue, class Compare>
+    typename flat_tree<Key, Value, KeyOfValue, Compare>::size_type
+    flat_tree<Key, Value, KeyOfValue, Compare>::upper_index(const key_type& key) const
+    {
+        size_type n = data_.size();
+        if (0 == n)
+            return 0;
+        const value_type* first = data_.begin();
+        const value_type* base = first;
+        while (n > 1)
+        {
+            const size_type half = n / 2;
+            base = key_compare(key, KeyOfValue()(base[half])) ? base : base + half;
+            n -= half;
+        }
+        return static_cast<size_type>(base - first) + !key_compare(key, KeyOfValue()(*base));
+    }
+
+    // 将 [first, last) 追加到尾部并恢复有序
+    // 新加入的部分本身有序时跳过排序, 全部不小于原有元素时跳过归并
+    // 排序和归并都是稳定的: 键相等的元素中原有元素在前, 新加入的元素保持传入的顺序
+    template <class Key, class Value, class KeyOfValue, class Compare>
+    template <class InputIter>
+    void flat_tree<Key, Value, KeyOfValue, Compare>::append_sorted(InputIter first, InputIter last)
+    {
+        const size_type old = data_.size();
+        data_.insert(data_.end(), first, last);
+        auto comp = [this](const value_type& lhs, const value_type& rhs)
+        { return value_less(lhs, rhs); };
+        auto mid = data_.begin() + old;
+        if (!mystl::is_sorted(mid, data_.end(), comp))
+            mystl::stable_sort(mid, data_.end(), comp);
+        if (old != 0 && mid != data_.end() && comp(*mid, *(mid - 1)))
+            mystl::inplace_merge(data_.begin(), mid, data_.end(), comp);
+    }
+
+} // namespace mystl
+
+#endif //TINYSTL_FLAT_TREE_H
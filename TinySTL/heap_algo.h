@@ -2,8 +2,12 @@
 #define MYTINYSTL_HEAP_ALGO_H_
 
 // 这个头文件包含 heap 的四个算法 : push_heap, pop_heap, sort_heap, make_heap
+// 以及 d 叉堆的算法 : push_dary_heap, pop_dary_heap, sort_dary_heap, make_dary_heap
+// 调整堆时元素都是移动而不是复制的
 
+#include "functional.h"
 #include "iterator.h"
+#include "util.h"
 
 namespace mystl
 {
@@ -19,17 +23,18 @@ void push_heap_aux(RandomIter first, Distance holeIndex, Distance topIndex, T va
   while (holeIndex > topIndex && *(first + parent) < value)
   {
     // 使用 operator<，所以 heap 为 max-heap
-    *(first + holeIndex) = *(first + parent);
+    *(first + holeIndex) = mystl::move(*(first + parent));
     holeIndex = parent;
     parent = (holeIndex - 1) / 2;
   }
-  *(first + holeIndex) = value;
+  *(first + holeIndex) = mystl::move(value);
 }
 
 template <class RandomIter, class Distance>
 void push_heap_d(RandomIter first, RandomIter last, Distance*)
 {
-  mystl::push_heap_aux(first, (last - first) - 1, static_cast<Distance>(0), *(last - 1));
+  mystl::push_heap_aux(first, (last - first) - 1, static_cast<Distance>(0),
+                       mystl::move(*(last - 1)));
 }
 
 template <class RandomIter>
@@ -46,18 +51,18 @@ void push_heap_aux(RandomIter first, Distance holeIndex, Distance topIndex, T va
   auto parent = (holeIndex - 1) / 2;
   while (holeIndex > topIndex && comp(*(first + parent), value))
   {
-    *(first + holeIndex) = *(first + parent);
+    *(first + holeIndex) = mystl::move(*(first + parent));
     holeIndex = parent;
     parent = (holeIndex - 1) / 2;
   }
-  *(first + holeIndex) = value;
+  *(first + holeIndex) = mystl::move(value);
 }
 
 template <class RandomIter, class Compared, class Distance>
 void push_heap_d(RandomIter first, RandomIter last, Distance*, Compared comp)
 {
   mystl::push_heap_aux(first, (last - first) - 1, static_cast<Distance>(0),
-                       *(last - 1), comp);
+                       mystl::move(*(last - 1)), comp);
 }
 
 template <class RandomIter, class Compared>
@@ -80,17 +85,17 @@ void adjust_heap(RandomIter first, Distance holeIndex, Distance len, T value)
   {
     if (*(first + rchild) < *(first + rchild - 1))
       --rchild;
-    *(first + holeIndex) = *(first + rchild);
+    *(first + holeIndex) = mystl::move(*(first + rchild));
     holeIndex = rchild;
     rchild = 2 * (rchild + 1);
   }
   if (rchild == len)
   {  // 如果没有右子节点
-    *(first + holeIndex) = *(first + (rchild - 1));
+    *(first + holeIndex) = mystl::move(*(first + (rchild - 1)));
     holeIndex = rchild - 1;
   }
   // 再执行一次上溯(percolate up)过程
-  mystl::push_heap_aux(first, holeIndex, topIndex, value);
+  mystl::push_heap_aux(first, holeIndex, topIndex, mystl::move(value));
 }
 
 template <class RandomIter, class T, class Distance>
@@ -98,14 +103,14 @@ void pop_heap_aux(RandomIter first, RandomIter last, RandomIter result, T value,
                   Distance*)
 {
   // 先将首值调至尾节点，然后调整[first, last - 1)使之重新成为一个 max-heap
-  *result = *first;
-  mystl::adjust_heap(first, static_cast<Distance>(0), last - first, value);
+  *result = mystl::move(*first);
+  mystl::adjust_heap(first, static_cast<Distance>(0), last - first, mystl::move(value));
 }
 
 template <class RandomIter>
 void pop_heap(RandomIter first, RandomIter last)
 {
-  mystl::pop_heap_aux(first, last - 1, last - 1, *(last - 1), distance_type(first));
+  mystl::pop_heap_aux(first, last - 1, last - 1, mystl::move(*(last - 1)), distance_type(first));
 }
 
 // 重载版本使用函数对象 comp 代替比较操作
@@ -119,31 +124,31 @@ void adjust_heap(RandomIter first, Distance holeIndex, Distance len, T value,
   while (rchild < len)
   {
     if (comp(*(first + rchild), *(first + rchild - 1)))  --rchild;
-    *(first + holeIndex) = *(first + rchild);
+    *(first + holeIndex) = mystl::move(*(first + rchild));
     holeIndex = rchild;
     rchild = 2 * (rchild + 1);
   }
   if (rchild == len)
   {
-    *(first + holeIndex) = *(first + (rchild - 1));
+    *(first + holeIndex) = mystl::move(*(first + (rchild - 1)));
     holeIndex = rchild - 1;
   }
   // 再执行一次上溯(percolate up)过程
-  mystl::push_heap_aux(first, holeIndex, topIndex, value, comp);
+  mystl::push_heap_aux(first, holeIndex, topIndex, mystl::move(value), comp);
 }
 
 template <class RandomIter, class T, class Distance, class Compared>
 void pop_heap_aux(RandomIter first, RandomIter last, RandomIter result, 
                   T value, Distance*, Compared comp)
 {
-  *result = *first;  // 先将尾指设置成首值，即尾指为欲求结果
-  mystl::adjust_heap(first, static_cast<Distance>(0), last - first, value, comp);
+  *result = mystl::move(*first);  // 先将尾指设置成首值，即尾指为欲求结果
+  mystl::adjust_heap(first, static_cast<Distance>(0), last - first, mystl::move(value), comp);
 }
 
 template <class RandomIter, class Compared>
 void pop_heap(RandomIter first, RandomIter last, Compared comp)
 {
-  mystl::pop_heap_aux(first, last - 1, last - 1, *(last - 1),
+  mystl::pop_heap_aux(first, last - 1, last - 1, mystl::move(*(last - 1)),
                       distance_type(first), comp);
 }
 
@@ -185,7 +190,7 @@ void make_heap_aux(RandomIter first, RandomIter last, Distance*)
   while (true)
   {
     // 重排以 holeIndex 为首的子树
-    mystl::adjust_heap(first, holeIndex, len, *(first + holeIndex));
+    mystl::adjust_heap(first, holeIndex, len, mystl::move(*(first + holeIndex)));
     if (holeIndex == 0)
       return;
     holeIndex--;
@@ -209,7 +214,7 @@ void make_heap_aux(RandomIter first, RandomIter last, Distance*, Compared comp)
   while (true)
   {
     // 重排以 holeIndex 为首的子树
-    mystl::adjust_heap(first, holeIndex, len, *(first + holeIndex), comp);
+    mystl::adjust_heap(first, holeIndex, len, mystl::move(*(first + holeIndex)), comp);
     if (holeIndex == 0)
       return;
     holeIndex--;
@@ -222,6 +227,173 @@ void make_heap(RandomIter first, RandomIter last, Compared comp)
   mystl::make_heap_aux(first, last, distance_type(first), comp);
 }
 
+/*****************************************************************************************/
+// d 叉堆 : push_dary_heap, pop_dary_heap, sort_dary_heap, make_dary_heap
+// 节点 i 的子节点为 D*i+1 ~ D*i+D, 父节点为 (i-1)/D, 与对应的二叉堆算法一样为 max-heap
+// 树高是二叉堆的 1/log2(D), push 上溯的层数更少, 但 pop 下溯时每层要在 D 个子节点中比较 D - 1 次
+// 同一节点的 D 个子节点相邻, 但没有按缓存行对齐, 一组子节点可能跨两条缓存行
+// queue_test 中随机的 push + pop 上 4 叉、8 叉堆并不比二叉堆快, push 远多于 pop 时才可能有收益
+// 用法 : mystl::push_dary_heap<4>(first, last, comp)
+/*****************************************************************************************/
+template <size_t D, class RandomIter, class Distance, class T, class Compared>
+void dary_push_heap_aux(RandomIter first, Distance holeIndex, Distance topIndex, T value,
+                        Compared& comp)
+{
+  while (holeIndex > topIndex)
+  {
+    auto parent = (holeIndex - 1) / static_cast<Distance>(D);
+    if (!comp(*(first + parent), value))
+      break;
+    *(first + holeIndex) = mystl::move(*(first + parent));
+    holeIndex = parent;
+  }
+  *(first + holeIndex) = mystl::move(value);
+}
+
+// 与 adjust_heap 相同, 先把洞下溯到叶子 (每层上移最大的子节点), 再把 value 上溯
+template <size_t D, class RandomIter, class Distance, class T, class Compared>
+void dary_adjust_heap(RandomIter first, Distance holeIndex, Distance len, T value,
+                      Compared& comp)
+{
+  const Distance d = static_cast<Distance>(D);
+  auto topIndex = holeIndex;
+  auto child = d * holeIndex + 1;
+  while (len - child >= d)
+  { // D 个子节点都存在, 循环次数固定, 选择时不用分支
+    auto best = child;
+    for (Distance i = 1; i < d; ++i)
+      best = comp(*(first + best), *(first + (child + i))) ? child + i : best;
+    *(first + holeIndex) = mystl::move(*(first + best));
+    holeIndex = best;
+    child = d * holeIndex + 1;
+  }
+  if (child < len)
+  { // 最后一个不满的节点
+    auto best = child;
+    for (auto i = child + 1; i < len; ++i)
+    {
+      if (comp(*(first + best), *(first + i)))
+        best = i;
+    }
+    *(first + holeIndex) = mystl::move(*(first + best));
+    holeIndex = best;
+  }
+  mystl::dary_push_heap_aux<D>(first, holeIndex, topIndex, mystl::move(value), comp);
+}
+
+template <size_t D, class RandomIter, class Compared>
+void push_dary_heap(RandomIter first, RandomIter last, Compared comp)
+{ // 新元素应该已置于底部容器的最尾端
+  static_assert(D >= 2, "the arity of a d-ary heap should be at least 2");
+  typedef typename iterator_traits<RandomIter>::difference_type Distance;
+  if (last - first > 1)
+    mystl::dary_push_heap_aux<D>(first, static_cast<Distance>((last - first) - 1),
+                                 static_cast<Distance>(0), mystl::move(*(last - 1)), comp);
+}
+
+template <size_t D, class RandomIter>
+void push_dary_heap(RandomIter first, RandomIter last)
+{
+  mystl::push_dary_heap<D>(first, last, mystl::less<typename iterator_traits<RandomIter>::value_type>());
+}
+
+template <size_t D, class RandomIter, class Compared>
+void pop_dary_heap(RandomIter first, RandomIter last, Compared comp)
+{
+  static_assert(D >= 2, "the arity of a d-ary heap should be at least 2");
+  typedef typename iterator_traits<RandomIter>::difference_type Distance;
+  if (last - first < 2)
+    return;
+  auto value = mystl::move(*(last - 1));
+  *(last - 1) = mystl::move(*first);
+  mystl::dary_adjust_heap<D>(first, static_cast<Distance>(0),
+                             static_cast<Distance>((last - first) - 1), mystl::move(value), comp);
+}
+
+template <size_t D, class RandomIter>
+void pop_dary_heap(RandomIter first, RandomIter last)
+{
+  mystl::pop_dary_heap<D>(first, last, mystl::less<typename iterator_traits<RandomIter>::value_type>());
+}
+
+template <size_t D, class RandomIter, class Compared>
+void sort_dary_heap(RandomIter first, RandomIter last, Compared comp)
+{
+  while (last - first > 1)
+  {
+    mystl::pop_dary_heap<D>(first, last--, comp);
+  }
+}
+
+template <size_t D, class RandomIter>
+void sort_dary_heap(RandomIter first, RandomIter last)
+{
+  mystl::sort_dary_heap<D>(first, last, mystl::less<typename iterator_traits<RandomIter>::value_type>());
+}
+
+template <size_t D, class RandomIter, class Compared>
+void make_dary_heap(RandomIter first, RandomIter last, Compared comp)
+{
+  static_assert(D >= 2, "the arity of a d-ary heap should be at least 2");
+  typedef typename iterator_traits<RandomIter>::difference_type Distance;
+  if (last - first < 2)
+    return;
+  const Distance len = last - first;
+  auto holeIndex = (len - 2) / static_cast<Distance>(D);
+  while (true)
+  {
+    // 重排以 holeIndex 为首的子树
+    mystl::dary_adjust_heap<D>(first, holeIndex, len, mystl::move(*(first + holeIndex)), comp);
+    if (holeIndex == 0)
+      return;
+    holeIndex--;
+  }
+}
+
+template <size_t D, class RandomIter>
+void make_dary_heap(RandomIter first, RandomIter last)
+{
+  mystl::make_dary_heap<D>(first, last, mystl::less<typename iterator_traits<RandomIter>::value_type>());
+}
+
+/*****************************************************************************************/
+// 堆的策略, 作为 priority_queue 的模板参数选择底层使用的堆算法
+// binary_heap_policy     : make_heap / push_heap / pop_heap
+// dary_heap_policy<D>    : make_dary_heap<D> / push_dary_heap<D> / pop_dary_heap<D>
+/*****************************************************************************************/
+struct binary_heap_policy
+{
+  template <class RandomIter, class Compared>
+  static void make_heap(RandomIter first, RandomIter last, const Compared& comp)
+  { mystl::make_heap(first, last, comp); }
+
+  template <class RandomIter, class Compared>
+  static void push_heap(RandomIter first, RandomIter last, const Compared& comp)
+  { mystl::push_heap(first, last, comp); }
+
+  template <class RandomIter, class Compared>
+  static void pop_heap(RandomIter first, RandomIter last, const Compared& comp)
+  { mystl::pop_heap(first, last, comp); }
+};
+
+template <size_t D>
+struct dary_heap_policy
+{
+  static_assert(D >= 2, "the arity of a d-ary heap should be at least 2");
+
+  template <class RandomIter, class Compared>
+  static void make_heap(RandomIter first, RandomIter last, const Compared& comp)
+  { mystl::make_dary_heap<D>(first, last, comp); }
+
+  template <class RandomIter, class Compared>
+  static void push_heap(RandomIter first, RandomIter last, const Compared& comp)
+  { mystl::push_dary_heap<D>(first, last, comp); }
+
+  template <class RandomIter, class Compared>
+  static void pop_heap(RandomIter first, RandomIter last, const Compared& comp)
+  { mystl::pop_dary_heap<D>(first, last, comp); }
+};
+
 } // namespace mystl
 #endif // !MYTINYSTL_HEAP_ALGO_H_
 
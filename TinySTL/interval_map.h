@@ -0,0 +1,311 @@
+#ifndef TINYSTL_INTERVAL_MAP_H
+#define TINYSTL_INTERVAL_MAP_H
+
+// 这个头文件包含模板类 interval_map (区间映射 / 区间树)
+// 元素为半开区间 [low, high) 及其对应的值, 区间可以重复
+// 底层为 rb_tree, 按 (low, high) 排序, 每个节点额外记录其子树中所有区间 high 的最大值,
+// 旋转和插入删除后的调整通过 rb_tree 的 augment 回调维护该值
+// 查询所有与给定区间 (或点) 相交的区间时, 可以跳过 high 最大值不足的子树以及 low 过大的右子树,
+// 输出 k 个结果的代价为 O(log n + k log(n / k)), 结果较少时接近 O(log n + k)
+
+#include <initializer_list>
+
+#include "rb_tree.h"
+#include "vector.h"
+#include "functional.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+    // interval_map 的元素类型
+    // first 为区间, 不能修改; second 为对应的值; max_high 由树维护, 使用者不要修改
+    template <class K, class V>
+    struct interval_map_value
+    {
+        typedef mystl::pair<K, K> interval_type;
+
+        const interval_type first;
+        V                   second;
+        mutable K           max_high;
+
+        interval_map_value(const interval_type& i, const V& v)
+            : first(i), second(v), max_high(i.second)
+        {
+        }
+    };
+
+    // 区间按 (low, high) 的字典序比较
+    template <class K, class Compare>
+    struct interval_less
+    {
+        Compare comp;
+
+        bool operator()(const mystl::pair<K, K>& lhs, const mystl::pair<K, K>& rhs) const
+        {
+            return comp(lhs.first, rhs.first) ||
+                   (!comp(rhs.first, lhs.first) && comp(lhs.second, rhs.second));
+        }
+    };
+
+    template <class K, class V>
+    struct interval_of_value
+    {
+        const mystl::pair<K, K>& operator()(const interval_map_value<K, V>& value) const
+        {
+            return value.first;
+        }
+    };
+
+    // rb_tree 的附加信息回调: 根据左右儿子重新计算节点的 max_high
+    template <class K, class V, class Compare>
+    struct interval_max_augment
+    {
+        typedef rb_tree_node<interval_map_value<K, V>>* link_type;
+
+        void operator()(rb_tree_node_base* x) const
+        {
+            Compare comp;
+            const auto& v = static_cast<link_type>(x)->value_field;
+            v.max_high = v.first.second;
+            if (x->left && comp(v.max_high, static_cast<link_type>(x->left)->value_field.max_high))
+                v.max_high = static_cast<link_type>(x->left)->value_field.max_high;
+            if (x->right && comp(v.max_high, static_cast<link_type>(x->right)->value_field.max_high))
+                v.max_high = static_cast<link_type>(x->right)->value_field.max_high;
+        }
+    };
+
+    // 模板类 interval_map
+    // 参数一表示区间端点类型, 参数二表示对应的值类型, 参数三表示端点的比较方式, 默认采取 < 比较
+    template <class K, class V, class Compare = mystl::less<K>>
+    class interval_map
+    {
+    public:
+        typedef K                                   endpoint_type;
+        typedef mystl::pair<K, K>                   interval_type;
+        typedef interval_type                       key_type;
+        typedef V                                   mapped_type;
+        typedef interval_map_value<K, V>            value_type;
+        typedef Compare                             endpoint_compare;
+
+    private:
+        typedef interval_max_augment<K, V, Compare> augment_type;
+        typedef mystl::rb_tree<interval_type, value_type, interval_of_value<K, V>,
+                               interval_less<K, Compare>> base_type;
+
+        // 只通过维护 max_high 的插入删除修改树, rb_tree 的其他修改操作 (join / split 等) 不对外开放
+        class rep_type : public base_type
+        {
+        public:
+            typedef typename base_type::iterator    iterator;
+            typedef typename base_type::link_type   link_type;
+            typedef typename base_type::base_ptr    base_ptr;
+
+            iterator insert_augmented(const value_type& value)
+            {
+                auto pos = this->get_insert_multi_pos(value.first);
+                link_type node = this->create_node(value);
+                return this->insert_node_at(pos.first, node, pos.second, augment_type());
+            }
+
+            iterator erase_augmented(iterator pos)
+            { return this->erase_node(pos, augment_type()); }
+
+            base_ptr root_node() const { return this->root(); }
+        };
+
+        typedef typename rep_type::base_ptr         base_ptr;
+        typedef typename rep_type::link_type        link_type;
+
+        rep_type t;
+        Compare  comp;
+
+    public:
+        typedef typename base_type::pointer                 pointer;
+        typedef typename base_type::const_pointer           const_pointer;
+        typedef typename base_type::reference               reference;
+        typedef typename base_type::const_reference         const_reference;
+        typedef typename base_type::iterator                iterator;
+        typedef typename base_type::const_iterator          const_iterator;
+        typedef typename base_type::reverse_iterator        reverse_iterator;
+        typedef typename base_type::const_reverse_iterator  const_reverse_iterator;
+        typedef typename base_type::size_type               size_type;
+        typedef typename base_type::difference_type         difference_type;
+
+    public:
+        // 构造 / 复制 / 移动, 复制时 max_high 随元素一起复制, 树的形状不变, 不需要重新计算
+        interval_map() = default;
+
+        interval_map(std::initializer_list<mystl::pair<interval_type, V>> ilist)
+            : t(), comp()
+        {
+            for (auto& p : ilist)
+                insert(p.first.first, p.first.second, p.second);
+        }
+
+        interval_map(const interval_map& other) = default;
+        interval_map(interval_map&& other) = default;
+        interval_map& operator=(const interval_map& rhs) = default;
+        interval_map& operator=(interval_map&& rhs) = default;
+
+        // 迭代器, 按 (low, high) 升序
+        iterator                begin()             noexcept { return t.begin(); }
+        const_iterator          begin()       const noexcept { return t.begin(); }
+        iterator                end()               noexcept { return t.end(); }
+        const_iterator          end()         const noexcept { return t.end(); }
+        reverse_iterator        rbegin()            noexcept { return t.rbegin(); }
+        const_reverse_iterator  rbegin()      const noexcept { return t.rbegin(); }
+        reverse_iterator        rend()              noexcept { return t.rend(); }
+        const_reverse_iterator  rend()        const noexcept { return t.rend(); }
+
+        // 容量
+        bool        empty()     const noexcept { return t.empty(); }
+        size_type   size()      const noexcept { return t.size(); }
+        size_type   max_size()  const noexcept { return t.max_size(); }
+
+    public:
+        // 插入删除
+
+        // 插入区间 [low, high), 要求 low <= high, 相同的区间可以重复插入
+        iterator insert(const endpoint_type& low, const endpoint_type& high, const mapped_type& value)
+        {
+            MYSTL_DEBUG(!comp(high, low));
+            return t.insert_augmented(value_type(interval_type(low, high), value));
+        }
+
+        iterator insert(const mystl::pair<interval_type, V>& value)
+        { return insert(value.first.first, value.first.second, value.second); }
+
+        iterator erase(iterator pos) { return t.erase_augmented(pos); }
+
+        // 删除所有与 [low, high) 完全相同的区间, 返回删除个数
+        size_type erase(const endpoint_type& low, const endpoint_type& high)
+        {
+            auto range = t.equal_range_multi(interval_type(low, high));
+            size_type n = 0;
+            for (auto it = range.first; it != range.second; ++n)
+                it = t.erase_augmented(it);
+            return n;
+        }
+
+        void clear() { t.clear(); }
+
+        void swap(interval_map& rhs) noexcept
+        {
+            t.swap(rhs.t);
+            mystl::swap(comp, rhs.comp);
+        }
+
+    public:
+        // 查找
+
+        // 与 [low, high) 完全相同的区间
+        iterator       find(const endpoint_type& low, const endpoint_type& high)
+        { return t.find(interval_type(low, high)); }
+        const_iterator find(const endpoint_type& low, const endpoint_type& high) const
+        { return t.find(interval_type(low, high)); }
+
+        size_type count(const endpoint_type& low, const endpoint_type& high) const
+        { return t.count_multi(interval_type(low, high)); }
+
+        // 返回任意一个与 [low, high) 相交的区间, 不存在时返回 end(), O(log n)
+        iterator any_overlap(const endpoint_type& low, const endpoint_type& high)
+        {
+            base_ptr x = t.root_node();
+            while (x && !overlaps(x, low, high, false))
+            {
+                // 左子树中有区间结束于 low 之后时, 若左子树中没有相交的区间, 右子树中也不会有
+                if (x->left && comp(low, max_high(x->left)))
+                    x = x->left;
+                else
+                    x = x->right;
+            }
+            return x ? iterator(static_cast<link_type>(x)) : end();
+        }
+
+        // 对每一个与 [low, high) 相交的区间调用 f(iterator), 按 (low, high) 升序
+        // f 中不能修改本容器
+        template <class Func>
+        void for_each_overlap(const endpoint_type& low, const endpoint_type& high, Func f)
+        { overlap_aux(t.root_node(), low, high, false, f); }
+
+        // 对每一个包含点 p (即 low <= p < high) 的区间调用 f(iterator)
+        template <class Func>
+        void for_each_stab(const endpoint_type& p, Func f)
+        { overlap_aux(t.root_node(), p, p, true, f); }
+
+        // 以 vector 返回所有与 [low, high) 相交的区间
+        mystl::vector<iterator> overlap(const endpoint_type& low, const endpoint_type& high)
+        {
+            mystl::vector<iterator> result;
+            for_each_overlap(low, high, [&result](iterator it) { result.push_back(it); });
+            return result;
+        }
+
+        // 以 vector 返回所有包含点 p 的区间
+        mystl::vector<iterator> stab(const endpoint_type& p)
+        {
+            mystl::vector<iterator> result;
+            for_each_stab(p, [&result](iterator it) { result.push_back(it); });
+            return result;
+        }
+
+    private:
+        static const value_type& value(base_ptr x)
+        { return static_cast<link_type>(x)->value_field; }
+
+        static const endpoint_type& max_high(base_ptr x)
+        { return value(x).max_high; }
+
+        // closed 为 true 时查询点 low (此时 high == low), 要求区间的 low 不大于该点
+        bool low_in_range(base_ptr x, const endpoint_type& high, bool closed) const
+        {
+            return closed ? !comp(high, value(x).first.first)
+                          : comp(value(x).first.first, high);
+        }
+
+        bool overlaps(base_ptr x, const endpoint_type& low, const endpoint_type& high, bool closed) const
+        { return comp(low, value(x).first.second) && low_in_range(x, high, closed); }
+
+        template <class Func>
+        void overlap_aux(base_ptr x, const endpoint_type& low, const endpoint_type& high,
+                         bool closed, Func& f)
+        {
+            while (x)
+            {
+                // 子树中所有区间都在 low 之前结束
+                if (!comp(low, max_high(x)))
+                    return;
+                overlap_aux(x->left, low, high, closed, f);
+                // x 以及右子树中区间的 low 都不小于 x 的 low
+                if (!low_in_range(x, high, closed))
+                    return;
+                if (comp(low, value(x).first.second))
+                    f(iterator(static_cast<link_type>(x)));
+                x = x->right;
+            }
+        }
+
+    public:
+        bool operator==(const interval_map& rhs) const
+        {
+            if (size() != rhs.size())
+                return false;
+            for (auto i = begin(), j = rhs.begin(); i != end(); ++i, ++j)
+            {
+                if (!(i->first == j->first) || !(i->second == j->second))
+                    return false;
+            }
+            return true;
+        }
+
+        bool operator!=(const interval_map& rhs) const { return !(*this == rhs); }
+    };
+
+    template <class K, class V, class Compare>
+    void swap(interval_map<K, V, Compare>& lhs, interval_map<K, V, Compare>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+} // namespace mystl
+
+#endif //TINYSTL_INTERVAL_MAP_H
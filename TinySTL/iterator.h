@@ -125,6 +125,17 @@ struct is_iterator :
 {
 };
 
+// 萃取分段迭代器
+// 由若干段连续内存组成的迭代器 (如 deque_iterator) 可以特化此模板, 使 copy, fill, find 等算法逐段处理,
+// 每段内退化为指针区间. 特化版本需继承 m_true_type, 并提供类型 segment_iterator, local_iterator
+// 以及静态函数 segment(it), local(it), begin(seg), end(seg), compose(seg, local)
+template <class Iterator>
+struct segmented_iterator_traits : public m_false_type {};
+
+template <class Iterator>
+struct is_segmented_iterator
+  : public m_bool_constant<segmented_iterator_traits<Iterator>::value> {};
+
 // 萃取某个迭代器的 category
 template <class Iterator>
 typename iterator_traits<Iterator>::iterator_category
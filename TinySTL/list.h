@@ -531,10 +531,10 @@ public:
   void merge(list& x, Compare comp);
 
   void sort()
-  { list_sort(begin(), end(), size(), mystl::less<T>()); }
+  { list_sort(mystl::less<T>()); }
   template <class Compared>
   void sort(Compared comp)
-  { list_sort(begin(), end(), size(), comp); }
+  { list_sort(comp); }
 
   void reverse();
 
@@ -570,7 +570,12 @@ private:
 
   // sort
   template <class Compared>
-  iterator  list_sort(iterator first, iterator last, size_type n, Compared comp);
+  void      list_sort(Compared comp);
+  template <class Compared>
+  static void merge_runs(base_ptr a, base_ptr b, Compared& comp, base_ptr& result);
+  template <class Compared>
+  void      merge_final(base_ptr a, base_ptr b, Compared& comp);
+  void      relink_chain(base_ptr first);
 
 };
 
@@ -1078,81 +1083,182 @@ list<T>::copy_insert(const_iterator pos, size_type n, Iter first)
   return r;
 }
 
-// 对 list 进行归并排序，返回一个迭代器指向区间最小元素的位置
+// 合并两个以 nullptr 结尾、只用 next 相连的有序链, 结果写入 result, 相等时 a 中的节点在前
+// 只在切换来源时修改 next 指针, 连续取自同一条链的节点保持原来的链接
+// comp 抛出异常时把另一条链接在后面, 保证节点不会丢失
 template <class T>
 template <class Compared>
-typename list<T>::iterator 
-list<T>::list_sort(iterator f1, iterator l2, size_type n, Compared comp)
+void list<T>::merge_runs(base_ptr a, base_ptr b, Compared& comp, base_ptr& result)
 {
-  if (n < 2)
-    return f1;
-
-  if (n == 2)
+  result = a;
+  bool from_a = true;  // 当前正在从 a 中取节点, 此时 result 一直连到 a 的末尾
+  try
   {
-    if (comp(*--l2, *f1))
+    if (comp(b->as_node()->value, a->as_node()->value))
+    {
+      result = b;
+      from_a = false;
+    }
+    while (true)
     {
-      auto ln = l2.node_;
-      unlink_nodes(ln, ln);
-      link_nodes(f1.node_, ln, ln);
-      return l2;
+      base_ptr tail;
+      if (from_a)
+      {
+        do
+        {
+          tail = a;
+          a = a->next;
+        } while (a != nullptr && !comp(b->as_node()->value, a->as_node()->value));
+        tail->next = b;
+        if (a == nullptr)
+          return;
+      }
+      else
+      {
+        do
+        {
+          tail = b;
+          b = b->next;
+        } while (b != nullptr && comp(b->as_node()->value, a->as_node()->value));
+        tail->next = a;
+        if (b == nullptr)
+          return;
+      }
+      from_a = !from_a;
     }
-    return f1;
-  }
-
-  auto n2 = n / 2;
-  auto l1 = f1;
-  mystl::advance(l1, n2);
-  auto result = f1 = list_sort(f1, l1, n2, comp);  // 前半段的最小位置
-  auto f2 = l1 = list_sort(l1, l2, n - n2, comp);  // 后半段的最小位置
-
-  // 把较小的一段区间移到前面
-  if (comp(*f2, *f1))
-  {
-    auto m = f2;
-    ++m;
-    for (; m != l2 && comp(*m, *f1); ++m)
-      ;
-    auto f = f2.node_;
-    auto l = m.node_->prev;
-    result = f2;
-    l1 = f2 = m;
-    unlink_nodes(f, l);
-    m = f1;
-    ++m;
-    link_nodes(f1.node_, f, l);
-    f1 = m;
   }
-  else
+  catch (...)
   {
-    ++f1;
+    base_ptr t = result;
+    while (t->next != nullptr)
+      t = t->next;
+    t->next = from_a ? b : a;
+    throw;
   }
+}
 
-  // 合并两段有序区间
-  while (f1 != l1 && f2 != l2)
+// 对 list 进行自底向上的归并排序, 是稳定的
+// 排序时只维护 next 指针: 每次取下一个节点作为长度为 1 的 run, 与 runs[0], runs[1], ... 依次合并,
+// 直到遇到空位, runs[i] 的长度为 2^i, 最后把所有 run 合并起来, 在最后一次合并时顺便重建 prev 指针
+// 不需要递归, 也不需要为了找中点而遍历链表
+template <class T>
+template <class Compared>
+void list<T>::list_sort(Compared comp)
+{
+  if (size_ < 2)
+    return;
+  base_ptr runs[64] = {};
+  size_t fill = 0;
+  base_ptr rest = node_->next;
+  node_->prev->next = nullptr;
+  base_ptr carry = nullptr;
+  base_ptr result = nullptr;
+  try
   {
-    if (comp(*f2, *f1))
+    while (rest != nullptr)
     {
-      auto m = f2;
-      ++m;
-      for (; m != l2 && comp(*m, *f1); ++m)
-        ;
-      auto f = f2.node_;
-      auto l = m.node_->prev;
-      if (l1 == f2)
-        l1 = m;
-      f2 = m;
-      unlink_nodes(f, l);
-      m = f1;
-      ++m;
-      link_nodes(f1.node_, f, l);
-      f1 = m;
+      carry = rest;
+      rest = rest->next;
+      carry->next = nullptr;
+      size_t i = 0;
+      for (; i < fill && runs[i] != nullptr; ++i)
+      { // runs[i] 中的节点在 carry 之前
+        base_ptr run = runs[i];
+        runs[i] = nullptr;
+        merge_runs(run, carry, comp, carry);
+      }
+      runs[i] = carry;
+      carry = nullptr;
+      if (i == fill)
+        ++fill;
     }
-    else
+    // runs[fill - 1] 一定非空, 先合并较短的 run, 最后一次合并单独处理
+    for (size_t i = 0; i + 1 < fill; ++i)
+    {
+      if (runs[i] != nullptr)
+      {
+        base_ptr run = runs[i];
+        runs[i] = nullptr;
+        if (result == nullptr)
+          result = run;
+        else
+          merge_runs(run, result, comp, result);
+      }
+    }
+  }
+  catch (...)
+  { // 把所有节点重新接成一条链, 顺序不确定
+    base_ptr chains[3] = { carry, result, rest };
+    base_ptr all = nullptr;
+    for (size_t i = 0; i < fill + 3; ++i)
     {
-      ++f1;
+      base_ptr c = i < fill ? runs[i] : chains[i - fill];
+      if (c == nullptr)
+        continue;
+      base_ptr t = c;
+      while (t->next != nullptr)
+        t = t->next;
+      t->next = all;
+      all = c;
     }
+    relink_chain(all);
+    throw;
+  }
+  if (result == nullptr)
+    relink_chain(runs[fill - 1]);
+  else
+    merge_final(runs[fill - 1], result, comp);
+}
+
+// 最后一次合并: 直接把节点接到 node_ 之后, 同时设置 prev 指针, 省去单独重建 prev 的一趟遍历
+template <class T>
+template <class Compared>
+void list<T>::merge_final(base_ptr a, base_ptr b, Compared& comp)
+{
+  base_ptr tail = node_;
+  try
+  {
+    while (a != nullptr && b != nullptr)
+    {
+      base_ptr& from = comp(b->as_node()->value, a->as_node()->value) ? b : a;
+      tail->next = from;
+      from->prev = tail;
+      tail = from;
+      from = from->next;
+    }
+    for (base_ptr p = a != nullptr ? a : b; p != nullptr; p = p->next)
+    {
+      tail->next = p;
+      p->prev = tail;
+      tail = p;
+    }
+    tail->next = node_;
+    node_->prev = tail;
+  }
+  catch (...)
+  {
+    tail->next = a;
+    while (tail->next != nullptr)
+      tail = tail->next;
+    tail->next = b;
+    relink_chain(node_->next);
+    throw;
+  }
+}
+
+// 把以 nullptr 结尾、只用 next 相连的链重新接回 list, 并重建 prev 指针
+template <class T>
+void list<T>::relink_chain(base_ptr first)
+{
+  base_ptr prev = node_;
+  for (base_ptr p = first; p != nullptr; p = p->next)
+  {
+    p->prev = prev;
+    prev->next = p;
+    prev = p;
   }
-  return result;
+  prev->next = node_;
+  node_->prev = prev;
 }
 
 // 重载比较操作符
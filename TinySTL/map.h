@@ -17,7 +17,8 @@ namespace mystl
 {
     // 模板类 map 键值唯一
     // 参数一表示键值类型, 参数二表示对应的实际值类型, 参数三表示确定键值优先级的比较方式, 默认采取 < 比较
-    template <class Key, class T, class Compare = mystl::less<T>>
+    // 参数四表示节点附加信息的维护方式, 取 rb_tree_size_augment 时支持顺序统计
+    template <class Key, class T, class Compare = mystl::less<T>, class Augment = mystl::rb_tree_no_augment>
     class map
     {
     public:
@@ -31,7 +32,7 @@ namespace mystl
         class value_compare
                 : public mystl::binary_function<value_type, value_type, bool>
         {
-            friend class map<Key, T, Compare>;
+            friend class map<Key, T, Compare, Augment>;
         private:
             Compare comp;
             value_compare(Compare c) : comp(c) {}
@@ -43,12 +44,12 @@ namespace mystl
         };
 
         class select1st
-                : public mystl::unarg_function<value_type, T>
+                : public mystl::unarg_function<value_type, Key>
         {
-            friend class map<Key, T, Compare>;
+            friend class map<Key, T, Compare, Augment>;
 
         public:
-            T operator()(const value_type& value) const
+            const Key& operator()(const value_type& value) const
             {
                 return value.first;
             }
@@ -57,7 +58,7 @@ namespace mystl
 
     private:
         typedef mystl::rb_tree<key_type, value_type,
-                               select1st, key_compare> rep_type;
+                               select1st, key_compare, Augment> rep_type;
         rep_type t;
 
     public:
@@ -83,33 +84,39 @@ namespace mystl
             :t()
         { t.insert_unique(first, last); }
 
+        // 调用者保证 [first, last) 按键严格递增, O(n) 建树
+        template<class InputIter>
+        map(mystl::sorted_unique_t, InputIter first, InputIter last)
+            :t()
+        { t.assign_sorted_unique(first, last); }
+
         map(std::initializer_list<value_type> ilist)
             :t()
         { t.insert_unique(ilist.begin(), ilist.end()); }
 
-        explicit map(const map<Key, T, Compare>& other)
+        explicit map(const map<Key, T, Compare, Augment>& other)
             :t(other.t)
         {
         }
 
-        explicit map(map<Key, T, Compare>&& other)
+        explicit map(map<Key, T, Compare, Augment>&& other)
             :t(mystl::move(other.t))
         {
         }
 
-        map<Key, T, Compare>& operator=(const map<Key, T, Compare>& rhs)
+        map<Key, T, Compare, Augment>& operator=(const map<Key, T, Compare, Augment>& rhs)
         {
             t = rhs.t;
             return *this;
         }
 
-        map<Key, T, Compare>& operator=(map<Key, T, Compare>&& rhs)
+        map<Key, T, Compare, Augment>& operator=(map<Key, T, Compare, Augment>&& rhs)
         {
             t = rhs.t;
             return *this;
         }
 
-        map<Key, T, Compare>& operator=(std::initializer_list<value_type> ilist)
+        map<Key, T, Compare, Augment>& operator=(std::initializer_list<value_type> ilist)
         {
             t.clear();
             t.insert_unique(ilist.begin(), ilist.end());
@@ -247,6 +254,11 @@ namespace mystl
         iterator        upper_bound(const key_type& key)        { return t.upper_bound(key); }
         const_iterator  upper_bound(const key_type& key) const  { return t.upper_bound(key); }
 
+        // 顺序统计, O(log n), 需要 Augment 为 rb_tree_size_augment
+        iterator        find_by_order(size_type k)              { return t.find_by_order(k); }
+        const_iterator  find_by_order(size_type k)       const  { return t.find_by_order(k); }
+        size_type       order_of_key(const key_type& key) const { return t.order_of_key(key); }
+
         mystl::pair<iterator, iterator>
             equal_range(const key_type& key)
         { return t.equal_range_unique(key); }
@@ -255,21 +267,29 @@ namespace mystl
             equal_range(const key_type& key) const
         { return t.equal_range_unique(key); }
 
-        void swap(map<Key, T, Compare>& rhs) noexcept
+        // join / split 与集合运算, 节点在两个 map 之间转移, 不分配新节点
+        // 键相同时保留本 map 中的值, 除 split 外参数 map 在调用后为空
+        void split(const key_type& key, map& right) { t.split(key, right.t); }
+        void join(map& right)                       { t.join(right.t); }
+        void union_with(map& other)                 { t.union_with(other.t); }
+        void intersect_with(map& other)             { t.intersect_with(other.t); }
+        void difference_with(map& other)            { t.difference_with(other.t); }
+
+        void swap(map<Key, T, Compare, Augment>& rhs) noexcept
         { t.swap(rhs.t); }
 
     public:
         // 运算符重载
-        bool operator==(const map<Key, T, Compare>& rhs) { return this->t == rhs.t; }
-        bool operator<(const map<Key, T, Compare>& rhs)  { return this->t < rhs.t; }
-        bool operator!=(const map<Key, T, Compare>& rhs) { return !(this->t == rhs.t); }
-        bool operator>(const map<Key, T, Compare>& rhs)  { return rhs.t < this->t; }
-        bool operator<=(const map<Key, T, Compare>& rhs) { return !(rhs.t < this->t); }
-        bool operator>=(const map<Key, T, Compare>& rhs) { return !(this->t < rhs.t); }
+        bool operator==(const map<Key, T, Compare, Augment>& rhs) { return this->t == rhs.t; }
+        bool operator<(const map<Key, T, Compare, Augment>& rhs)  { return this->t < rhs.t; }
+        bool operator!=(const map<Key, T, Compare, Augment>& rhs) { return !(this->t == rhs.t); }
+        bool operator>(const map<Key, T, Compare, Augment>& rhs)  { return rhs.t < this->t; }
+        bool operator<=(const map<Key, T, Compare, Augment>& rhs) { return !(rhs.t < this->t); }
+        bool operator>=(const map<Key, T, Compare, Augment>& rhs) { return !(this->t < rhs.t); }
     };
 
-    template <class Key, class T, class Compare>
-    void swap(map<Key, T, Compare>& lhs, map<Key, T, Compare>& rhs)
+    template <class Key, class T, class Compare, class Augment>
+    void swap(map<Key, T, Compare, Augment>& lhs, map<Key, T, Compare, Augment>& rhs)
     {
         lhs.swap(rhs);
     }
@@ -279,7 +299,8 @@ namespace mystl
 
     // 模板类 multimap, 键值允许重复
     // 参数一表示键值类型, 参数二表示对应的实际值类型, 参数三表示确定键值优先级的比较方式, 默认采取 < 比较
-    template <class Key, class T, class Compare = mystl::less<T>>
+    // 参数四表示节点附加信息的维护方式, 取 rb_tree_size_augment 时支持顺序统计
+    template <class Key, class T, class Compare = mystl::less<T>, class Augment = mystl::rb_tree_no_augment>
     class multimap
     {
     public:
@@ -293,7 +314,7 @@ namespace mystl
         class value_compare
                 : public mystl::binary_function<value_type, value_type, bool>
         {
-            friend class map<Key, T, Compare>;
+            friend class map<Key, T, Compare, Augment>;
         private:
             Compare comp;
             value_compare(Compare c) : comp(c) {}
@@ -305,12 +326,12 @@ namespace mystl
         };
 
         class select1st
-                : public mystl::unarg_function<value_type, T>
+                : public mystl::unarg_function<value_type, Key>
         {
-            friend class map<Key, T, Compare>;
+            friend class map<Key, T, Compare, Augment>;
 
         public:
-            T operator()(const value_type& value) const
+            const Key& operator()(const value_type& value) const
             {
                 return value.first;
             }
@@ -319,7 +340,7 @@ namespace mystl
 
     private:
         typedef mystl::rb_tree<key_type, value_type,
-                               select1st, key_compare> rep_type;
+                               select1st, key_compare, Augment> rep_type;
         rep_type t;
 
     public:
@@ -349,29 +370,29 @@ namespace mystl
             :t()
         { t.insert_multi(ilist.begin(), ilist.end()); }
 
-        explicit multimap(const multimap<Key, T, Compare>& other)
+        explicit multimap(const multimap<Key, T, Compare, Augment>& other)
             :t(other.t)
         {
         }
 
-        explicit multimap(multimap<Key, T, Compare>&& other)
+        explicit multimap(multimap<Key, T, Compare, Augment>&& other)
             :t(mystl::move(other.t))
         {
         }
 
-        multimap<Key, T, Compare>& operator=(const multimap<Key, T, Compare>& rhs)
+        multimap<Key, T, Compare, Augment>& operator=(const multimap<Key, T, Compare, Augment>& rhs)
         {
             t = rhs.t;
             return *this;
         }
 
-        multimap<Key, T, Compare>& operator=(multimap<Key, T, Compare>&& rhs)
+        multimap<Key, T, Compare, Augment>& operator=(multimap<Key, T, Compare, Augment>&& rhs)
         {
             t = rhs.t;
             return *this;
         }
 
-        multimap<Key, T, Compare>& operator=(std::initializer_list<value_type> ilist)
+        multimap<Key, T, Compare, Augment>& operator=(std::initializer_list<value_type> ilist)
         {
             t.clear();
             t.insert_multi(ilist.begin(), ilist.end());
@@ -473,6 +494,11 @@ namespace mystl
         iterator        upper_bound(const key_type& key)        { return t.upper_bound(key); }
         const_iterator  upper_bound(const key_type& key) const  { return t.upper_bound(key); }
 
+        // 顺序统计, O(log n), 需要 Augment 为 rb_tree_size_augment
+        iterator        find_by_order(size_type k)              { return t.find_by_order(k); }
+        const_iterator  find_by_order(size_type k)       const  { return t.find_by_order(k); }
+        size_type       order_of_key(const key_type& key) const { return t.order_of_key(key); }
+
         mystl::pair<iterator, iterator>
             equal_range(const key_type& key)
         { return t.equal_range_multi(key); }
@@ -481,21 +507,25 @@ namespace mystl
             equal_range(const key_type& key) const
         { return t.equal_range_multi(key); }
 
-        void swap(multimap<Key, T, Compare>& rhs) noexcept
+        // split 后本 multimap 保留键小于 key 的元素; join 要求本 multimap 的键都不大于 right 的键
+        void split(const key_type& key, multimap& right) { t.split(key, right.t); }
+        void join(multimap& right)                       { t.join(right.t); }
+
+        void swap(multimap<Key, T, Compare, Augment>& rhs) noexcept
         { t.swap(rhs.t); }
 
     public:
         // 运算符重载
-        bool operator==(const multimap<Key, T, Compare>& rhs) { return this->t == rhs.t; }
-        bool operator<(const multimap<Key, T, Compare>& rhs)  { return this->t < rhs.t; }
-        bool operator!=(const multimap<Key, T, Compare>& rhs) { return !(this->t == rhs.t); }
-        bool operator>(const multimap<Key, T, Compare>& rhs)  { return rhs.t < this->t; }
-        bool operator<=(const multimap<Key, T, Compare>& rhs) { return !(rhs.t < this->t); }
-        bool operator>=(const multimap<Key, T, Compare>& rhs) { return !(this->t < rhs.t); }
+        bool operator==(const multimap<Key, T, Compare, Augment>& rhs) { return this->t == rhs.t; }
+        bool operator<(const multimap<Key, T, Compare, Augment>& rhs)  { return this->t < rhs.t; }
+        bool operator!=(const multimap<Key, T, Compare, Augment>& rhs) { return !(this->t == rhs.t); }
+        bool operator>(const multimap<Key, T, Compare, Augment>& rhs)  { return rhs.t < this->t; }
+        bool operator<=(const multimap<Key, T, Compare, Augment>& rhs) { return !(rhs.t < this->t); }
+        bool operator>=(const multimap<Key, T, Compare, Augment>& rhs) { return !(this->t < rhs.t); }
     };
 
-    template <class Key, class T, class Compare>
-    void swap(multimap<Key, T, Compare>& lhs, multimap<Key, T, Compare>& rhs)
+    template <class Key, class T, class Compare, class Augment>
+    void swap(multimap<Key, T, Compare, Augment>& lhs, multimap<Key, T, Compare, Augment>& rhs)
     {
         lhs.swap(rhs);
     }
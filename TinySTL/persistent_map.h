@@ -0,0 +1,574 @@
+#ifndef TINYSTL_PERSISTENT_MAP_H
+#define TINYSTL_PERSISTENT_MAP_H
+
+// 这个头文件包含模板类 persistent_map (可持久化映射)
+// 底层为路径复制的 AVL 树, 节点一经发布便不再修改, 通过引用计数在多个版本之间共享
+// snapshot() 以及复制构造只增加根节点的引用计数, 为 O(1)
+// 每次插入删除只复制从根到修改位置的路径, 新分配 O(log n) 个节点, 其余节点与旧版本共享
+// 引用计数为原子变量, 不同线程各自持有不同版本时读取不需要加锁;
+// 同一个 persistent_map 对象的并发修改仍需要调用者同步
+// 修改操作会使本对象的迭代器失效, 快照的迭代器不受影响
+
+#include <initializer_list>
+#include <atomic>
+
+#include "iterator.h"
+#include "memory.h"
+#include "functional.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+    template <class Value>
+    struct persistent_map_node
+    {
+        typedef persistent_map_node<Value>* node_ptr;
+        typedef size_t                      size_type;
+
+        Value                       value_field;
+        node_ptr                    left;
+        node_ptr                    right;
+        std::atomic<size_type>      ref_count;
+        size_type                   size;       // 以该节点为根的子树的节点个数
+        int                         height;     // 以该节点为根的子树的高度, 叶子为 1
+    };
+
+    // 迭代器中保存从根到当前节点的路径, AVL 树的高度不超过 1.44 log2(n), 这里的上限足够容纳任何能放进内存的树
+    constexpr int kPersistentMapMaxHeight = 96;
+
+    template <class Value>
+    struct persistent_map_iterator
+    {
+        typedef Value                                   value_type;
+        typedef const Value&                            reference;
+        typedef const Value*                            pointer;
+        typedef ptrdiff_t                               difference_type;
+        typedef bidirectional_iterator_tag              iterator_category;
+        typedef const persistent_map_node<Value>*       node_ptr;
+        typedef persistent_map_iterator<Value>          self;
+
+        node_ptr root;
+        node_ptr path[kPersistentMapMaxHeight];
+        int      depth;     // depth 为 0 表示 end()
+
+        persistent_map_iterator() : root(nullptr), depth(0) {}
+        explicit persistent_map_iterator(node_ptr r) : root(r), depth(0) {}
+
+        reference operator*()  const { return path[depth - 1]->value_field; }
+        pointer   operator->() const { return &(operator*()); }
+
+        // 从 x 出发一直向左走到底
+        void push_leftmost(node_ptr x)
+        {
+            for (; x; x = x->left)
+                path[depth++] = x;
+        }
+
+        void push_rightmost(node_ptr x)
+        {
+            for (; x; x = x->right)
+                path[depth++] = x;
+        }
+
+        void increment()
+        {
+            node_ptr x = path[depth - 1];
+            if (x->right)
+            {
+                push_leftmost(x->right);
+                return;
+            }
+            // 回溯到第一个从左子树上来的祖先
+            --depth;
+            while (depth > 0 && path[depth - 1]->right == x)
+                x = path[--depth];
+        }
+
+        void decrement()
+        {
+            if (0 == depth)
+            {
+                push_rightmost(root);
+                return;
+            }
+            node_ptr x = path[depth - 1];
+            if (x->left)
+            {
+                push_rightmost(x->left);
+                return;
+            }
+            --depth;
+            while (depth > 0 && path[depth - 1]->left == x)
+                x = path[--depth];
+        }
+
+        self& operator++()
+        {
+            increment();
+            return *this;
+        }
+
+        self operator++(int)
+        {
+            self tmp = *this;
+            increment();
+            return tmp;
+        }
+
+        self& operator--()
+        {
+            decrement();
+            return *this;
+        }
+
+        self operator--(int)
+        {
+            self tmp = *this;
+            decrement();
+            return tmp;
+        }
+
+        bool operator==(const self& rhs) const
+        { return depth == rhs.depth && (0 == depth || path[depth - 1] == rhs.path[depth - 1]); }
+        bool operator!=(const self& rhs) const
+        { return !(*this == rhs); }
+    };
+
+    // 模板类 persistent_map, 键值唯一
+    // 参数一表示键值类型, 参数二表示实值类型, 参数三表示键值的比较方式, 默认采取 < 比较
+    template <class Key, class T, class Compare = mystl::less<Key>>
+    class persistent_map
+    {
+    public:
+        typedef Key                                     key_type;
+        typedef T                                       mapped_type;
+        typedef mystl::pair<const Key, T>               value_type;
+        typedef Compare                                 key_compare;
+
+        typedef mystl::allocator<value_type>            allocator_type;
+        typedef mystl::allocator<value_type>            data_allocator;
+        typedef persistent_map_node<value_type>         node_type;
+        typedef mystl::allocator<node_type>             node_allocator;
+        typedef node_type*                              node_ptr;
+
+        typedef const value_type*                       pointer;
+        typedef const value_type*                       const_pointer;
+        typedef const value_type&                       reference;
+        typedef const value_type&                       const_reference;
+        typedef size_t                                  size_type;
+        typedef ptrdiff_t                               difference_type;
+
+        // 节点不可修改, 只提供常量迭代器
+        typedef persistent_map_iterator<value_type>     iterator;
+        typedef persistent_map_iterator<value_type>     const_iterator;
+        typedef mystl::reverse_iterator<const_iterator> reverse_iterator;
+        typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    private:
+        node_ptr root_;
+        Compare  key_compare_;
+
+    public:
+        // 构造 / 复制 / 移动 / 析构
+        persistent_map() : root_(nullptr), key_compare_() {}
+
+        template <class InputIter>
+        persistent_map(InputIter first, InputIter last)
+            : root_(nullptr), key_compare_()
+        {
+            for (; first != last; ++first)
+                insert(*first);
+        }
+
+        persistent_map(std::initializer_list<value_type> ilist)
+            : persistent_map(ilist.begin(), ilist.end())
+        {
+        }
+
+        // 复制与 snapshot() 相同, 只共享根节点
+        persistent_map(const persistent_map& other)
+            : root_(retain(other.root_)), key_compare_(other.key_compare_)
+        {
+        }
+
+        persistent_map(persistent_map&& other) noexcept
+            : root_(other.root_), key_compare_(other.key_compare_)
+        {
+            other.root_ = nullptr;
+        }
+
+        persistent_map& operator=(const persistent_map& rhs)
+        {
+            if (this != &rhs)
+            {
+                node_ptr old = root_;
+                root_ = retain(rhs.root_);
+                key_compare_ = rhs.key_compare_;
+                release(old);
+            }
+            return *this;
+        }
+
+        persistent_map& operator=(persistent_map&& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                release(root_);
+                root_ = rhs.root_;
+                key_compare_ = rhs.key_compare_;
+                rhs.root_ = nullptr;
+            }
+            return *this;
+        }
+
+        ~persistent_map() { release(root_); }
+
+        // 取得当前版本的快照, O(1), 之后对本对象的修改不会影响快照
+        persistent_map snapshot() const { return *this; }
+
+        key_compare key_comp() const { return key_compare_; }
+
+    public:
+        // 迭代器
+        const_iterator begin() const
+        {
+            const_iterator it(root_);
+            it.push_leftmost(root_);
+            return it;
+        }
+        const_iterator end()   const { return const_iterator(root_); }
+
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend()   const { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend()   const { return end(); }
+
+        // 容量
+        bool      empty()    const noexcept { return nullptr == root_; }
+        size_type size()     const noexcept { return subtree_size(root_); }
+        size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(node_type); }
+
+        // 两个版本是否共享同一个根节点, 共享时内容必然相同
+        bool      same_version(const persistent_map& rhs) const noexcept { return root_ == rhs.root_; }
+
+    public:
+        // 查找
+        const_iterator find(const key_type& key) const
+        {
+            const_iterator it = lower_bound(key);
+            return (it == end() || key_compare_(key, it->first)) ? end() : it;
+        }
+
+        size_type count(const key_type& key) const
+        { return nullptr != find_node(key) ? 1 : 0; }
+
+        const mapped_type& at(const key_type& key) const
+        {
+            node_ptr x = find_node(key);
+            THROW_OUT_OF_RANGE_IF(nullptr == x, "persistent_map<Key, T> no such element exists");
+            return x->value_field.second;
+        }
+
+        const_iterator lower_bound(const key_type& key) const
+        {
+            const_iterator it(root_);
+            int keep = 0;
+            for (node_ptr x = root_; x; )
+            {
+                it.path[it.depth++] = x;
+                if (key_compare_(x->value_field.first, key))
+                {
+                    x = x->right;
+                }
+                else
+                {
+                    keep = it.depth;
+                    x = x->left;
+                }
+            }
+            it.depth = keep;
+            return it;
+        }
+
+        const_iterator upper_bound(const key_type& key) const
+        {
+            const_iterator it(root_);
+            int keep = 0;
+            for (node_ptr x = root_; x; )
+            {
+                it.path[it.depth++] = x;
+                if (key_compare_(key, x->value_field.first))
+                {
+                    keep = it.depth;
+                    x = x->left;
+                }
+                else
+                {
+                    x = x->right;
+                }
+            }
+            it.depth = keep;
+            return it;
+        }
+
+        mystl::pair<const_iterator, const_iterator>
+        equal_range(const key_type& key) const
+        { return mystl::make_pair(lower_bound(key), upper_bound(key)); }
+
+    public:
+        // 修改, 只影响本对象, 已经取得的快照不变
+
+        // 键值已存在时不做任何修改, 也不分配节点
+        mystl::pair<const_iterator, bool> insert(const value_type& value)
+        {
+            if (nullptr != find_node(value.first))
+                return mystl::make_pair(find(value.first), false);
+            replace_root(insert_aux(root_, value));
+            return mystl::make_pair(find(value.first), true);
+        }
+
+        template <class ...Args>
+        mystl::pair<const_iterator, bool> emplace(Args&& ...args)
+        { return insert(value_type(mystl::forward<Args>(args)...)); }
+
+        // 键值已存在时以新值替换, 返回是否新插入了元素
+        bool insert_or_assign(const key_type& key, const mapped_type& obj)
+        {
+            const bool inserted = nullptr == find_node(key);
+            replace_root(insert_aux(root_, value_type(key, obj)));
+            return inserted;
+        }
+
+        size_type erase(const key_type& key)
+        {
+            if (nullptr == find_node(key))
+                return 0;
+            replace_root(erase_aux(root_, key));
+            return 1;
+        }
+
+        void clear()
+        {
+            release(root_);
+            root_ = nullptr;
+        }
+
+        void swap(persistent_map& rhs) noexcept
+        {
+            mystl::swap(root_, rhs.root_);
+            mystl::swap(key_compare_, rhs.key_compare_);
+        }
+
+    private:
+        // 引用计数相关
+        static node_ptr retain(node_ptr x)
+        {
+            if (x)
+                x->ref_count.fetch_add(1, std::memory_order_relaxed);
+            return x;
+        }
+
+        static void release(node_ptr x)
+        {
+            while (x && x->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                node_ptr r = x->right;
+                release(x->left);
+                data_allocator::destroy(&x->value_field);
+                node_allocator::deallocate(x);
+                x = r;
+            }
+        }
+
+        void replace_root(node_ptr x)
+        {
+            node_ptr old = root_;
+            root_ = x;
+            release(old);
+        }
+
+        static size_type subtree_size(node_ptr x)   { return x ? x->size : 0; }
+        static int       subtree_height(node_ptr x) { return x ? x->height : 0; }
+
+        static void update(node_ptr x)
+        {
+            x->size = subtree_size(x->left) + subtree_size(x->right) + 1;
+            const int lh = subtree_height(x->left);
+            const int rh = subtree_height(x->right);
+            x->height = (lh > rh ? lh : rh) + 1;
+        }
+
+        // 新建节点, 接管 l, r 两个引用
+        static node_ptr create_node(const value_type& value, node_ptr l, node_ptr r)
+        {
+            node_ptr x = node_allocator::allocate(1);
+            try
+            {
+                data_allocator::construct(&x->value_field, value);
+            }
+            catch (...)
+            {
+                node_allocator::deallocate(x);
+                release(l);
+                release(r);
+                throw;
+            }
+            ::new (&x->ref_count) std::atomic<size_type>(1);
+            x->left = l;
+            x->right = r;
+            update(x);
+            return x;
+        }
+
+        // 接管 x 的一个引用, 返回由调用者独占、可以就地修改的等价节点
+        // 本次修改中新建的节点只被新路径引用, 计数为 1; 与旧版本共享的节点计数至少为 2, 需要复制
+        static node_ptr detach(node_ptr x)
+        {
+            if (x->ref_count.load(std::memory_order_acquire) == 1)
+                return x;
+            node_ptr y = create_node(x->value_field, retain(x->left), retain(x->right));
+            release(x);
+            return y;
+        }
+
+        // 旋转与平衡只作用于调用者独占的节点
+        static node_ptr rotate_right(node_ptr x)
+        {
+            node_ptr l = detach(x->left);
+            x->left = l->right;
+            l->right = x;
+            update(x);
+            update(l);
+            return l;
+        }
+
+        static node_ptr rotate_left(node_ptr x)
+        {
+            node_ptr r = detach(x->right);
+            x->right = r->left;
+            r->left = x;
+            update(x);
+            update(r);
+            return r;
+        }
+
+        static node_ptr balance(node_ptr x)
+        {
+            update(x);
+            const int diff = subtree_height(x->left) - subtree_height(x->right);
+            if (diff > 1)
+            {
+                if (subtree_height(x->left->left) < subtree_height(x->left->right))
+                    x->left = rotate_left(detach(x->left));
+                return rotate_right(x);
+            }
+            if (diff < -1)
+            {
+                if (subtree_height(x->right->right) < subtree_height(x->right->left))
+                    x->right = rotate_right(detach(x->right));
+                return rotate_left(x);
+            }
+            return x;
+        }
+
+        node_ptr find_node(const key_type& key) const
+        {
+            node_ptr x = root_;
+            while (x)
+            {
+                if (key_compare_(key, x->value_field.first))
+                    x = x->left;
+                else if (key_compare_(x->value_field.first, key))
+                    x = x->right;
+                else
+                    return x;
+            }
+            return nullptr;
+        }
+
+        node_ptr insert_aux(node_ptr x, const value_type& value);
+        node_ptr erase_aux(node_ptr x, const key_type& key);
+        node_ptr erase_min(node_ptr x, node_ptr& min);
+
+    public:
+        bool operator==(const persistent_map& rhs) const
+        {
+            if (root_ == rhs.root_)
+                return true;
+            return size() == rhs.size() && mystl::equal(begin(), end(), rhs.begin());
+        }
+
+        bool operator!=(const persistent_map& rhs) const { return !(*this == rhs); }
+    };
+
+    /*****************************************************************************************/
+
+    // 在旧版本的子树 x 中插入 value, 键值已存在时替换, 返回新子树的根 (持有一个引用)
+    // x 只被读取, 路径以外的子树通过增加引用计数共享
+    template <class Key, class T, class Compare>
+    typename persistent_map<Key, T, Compare>::node_ptr
+    persistent_map<Key, T, Compare>::insert_aux(node_ptr x, const value_type& value)
+    {
+        if (nullptr == x)
+            return create_node(value, nullptr, nullptr);
+        if (key_compare_(value.first, x->value_field.first))
+        {
+            node_ptr l = insert_aux(x->left, value);
+            return balance(create_node(x->value_field, l, retain(x->right)));
+        }
+        if (key_compare_(x->value_field.first, value.first))
+        {
+            node_ptr r = insert_aux(x->right, value);
+            return balance(create_node(x->value_field, retain(x->left), r));
+        }
+        return create_node(value, retain(x->left), retain(x->right));
+    }
+
+    // 在旧版本的子树 x 中删除 key (调用者保证存在), 返回新子树的根
+    template <class Key, class T, class Compare>
+    typename persistent_map<Key, T, Compare>::node_ptr
+    persistent_map<Key, T, Compare>::erase_aux(node_ptr x, const key_type& key)
+    {
+        if (key_compare_(key, x->value_field.first))
+        {
+            node_ptr l = erase_aux(x->left, key);
+            return balance(create_node(x->value_field, l, retain(x->right)));
+        }
+        if (key_compare_(x->value_field.first, key))
+        {
+            node_ptr r = erase_aux(x->right, key);
+            return balance(create_node(x->value_field, retain(x->left), r));
+        }
+        if (nullptr == x->left)
+            return retain(x->right);
+        if (nullptr == x->right)
+            return retain(x->left);
+        // 用右子树的最小节点代替被删除的节点
+        node_ptr min = nullptr;
+        node_ptr r = erase_min(x->right, min);
+        return balance(create_node(min->value_field, retain(x->left), r));
+    }
+
+    // 删除子树 x 的最小节点, min 指向旧版本中的该节点
+    template <class Key, class T, class Compare>
+    typename persistent_map<Key, T, Compare>::node_ptr
+    persistent_map<Key, T, Compare>::erase_min(node_ptr x, node_ptr& min)
+    {
+        if (nullptr == x->left)
+        {
+            min = x;
+            return retain(x->right);
+        }
+        node_ptr l = erase_min(x->left, min);
+        return balance(create_node(x->value_field, l, retain(x->right)));
+    }
+
+    template <class Key, class T, class Compare>
+    void swap(persistent_map<Key, T, Compare>& lhs, persistent_map<Key, T, Compare>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+} // namespace mystl
+
+#endif //TINYSTL_PERSISTENT_MAP_H
@@ -5,13 +5,20 @@
 #ifndef TINYSTL_QUEUE_H
 #define TINYSTL_QUEUE_H
 
-// 包含了 queue 以及 priority_queue
+// 包含了 queue, mpmc_queue 以及 priority_queue
 // queue 队列
+// mpmc_queue 多生产者多消费者的有界并发队列
 // priority_queue 优先队列
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
 #include "list.h"
 #include "vector.h"
 #include "functional.h"
 #include "heap_algo.h"
+#include "ring_util.h"
 
 namespace mystl
 {
@@ -141,19 +148,304 @@ namespace mystl
         lhs.swap(rhs);
     }
 
+    /*****************************************************************************************/
+    // 模板类 mpmc_queue
+    // 模板参数表示数据类型, 任意多个线程可以同时 push 和 pop
+    // 元素存放在容量为 2 的幂的环形数组中, 每个槽位带一个序号 seq, 第 pos 次写入 / 读出使用槽位 pos & mask_:
+    //   seq == pos           槽位空闲, 生产者用 CAS 推进 enqueue_pos_ 抢到它, 构造元素后把 seq 置为 pos + 1
+    //   seq == pos + 1       槽位有数据, 消费者用 CAS 推进 dequeue_pos_ 抢到它, 取走元素后把 seq 置为 pos + capacity
+    // 生产者之间只在 enqueue_pos_ 上竞争, 消费者之间只在 dequeue_pos_ 上竞争, 两者分处不同的缓存行
+    // try_push / try_pop 不阻塞; push / pop 先自旋再让出时间片, 仍不成功时在条件变量上等待
+
+    // 阻塞操作在挂起之前尝试的次数, 后一半每次失败后让出时间片
+    constexpr int mpmc_queue_spin = 64;
+
+    template <class T>
+    class mpmc_queue
+    {
+    public:
+        typedef T                                           value_type;
+        typedef T*                                          pointer;
+        typedef T&                                          reference;
+        typedef const T&                                    const_reference;
+        typedef size_t                                      size_type;
+
+    private:
+        struct cell
+        {
+            std::atomic<size_type>  seq;
+            bool                    valid;      // 构造元素时抛出异常的槽位照常发布, 但标记为无效, 消费者会跳过它
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+            pointer value() { return reinterpret_cast<pointer>(&storage); }
+        };
+
+        char                    pad0_[cache_line_size];
+        cell*                   buf_;
+        size_type               mask_;
+        char                    pad1_[cache_line_size];
+        std::atomic<size_type>  enqueue_pos_;
+        char                    pad2_[cache_line_size];
+        std::atomic<size_type>  dequeue_pos_;
+        char                    pad3_[cache_line_size];
+
+        // 阻塞操作使用, 生产者与消费者各用一把锁, 通知对方时一般不持有自己的锁
+        // 只有 dequeue 释放无效槽位时可能持有 pop_mutex_ 通知生产者, 加锁顺序总是先 pop_mutex_ 后 push_mutex_
+        std::mutex              push_mutex_;
+        std::condition_variable not_full_;
+        std::atomic<int>        push_waiters_;
+        std::mutex              pop_mutex_;
+        std::condition_variable not_empty_;
+        std::atomic<int>        pop_waiters_;
+
+    public:
+        // 容量向上取整为 2 的幂, 至少为 2
+        explicit mpmc_queue(size_type capacity)
+            : buf_(nullptr), mask_(0), enqueue_pos_(0), dequeue_pos_(0),
+              push_waiters_(0), pop_waiters_(0)
+        {
+            size_type cap = 2;
+            while (cap < capacity)
+                cap <<= 1;
+            buf_ = static_cast<cell*>(::operator new(cap * sizeof(cell)));
+            for (size_type i = 0; i < cap; ++i)
+            {
+                ::new (&buf_[i].seq) std::atomic<size_type>(i);
+                buf_[i].valid = false;
+            }
+            mask_ = cap - 1;
+        }
+
+        mpmc_queue(const mpmc_queue&) = delete;
+        mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+        ~mpmc_queue()
+        {
+            const size_type tail = enqueue_pos_.load(std::memory_order_relaxed);
+            for (size_type h = dequeue_pos_.load(std::memory_order_relaxed); h != tail; ++h)
+            {
+                cell& c = buf_[h & mask_];
+                if (c.valid)
+                    mystl::destroy(c.value());
+            }
+            ::operator delete(buf_);
+        }
+
+    public:
+        size_type capacity() const noexcept { return mask_ + 1; }
+
+        // 有其他线程并发操作时结果只是一个近似值
+        size_type size() const noexcept
+        {
+            const size_type head = dequeue_pos_.load(std::memory_order_acquire);
+            const size_type tail = enqueue_pos_.load(std::memory_order_acquire);
+            return tail > head ? mystl::min(tail - head, capacity()) : 0;
+        }
+
+        bool empty() const noexcept { return size() == 0; }
+
+    public:
+        // 非阻塞操作, 队列已满 (已空) 时返回 false
+
+        template <class ...Args>
+        bool try_emplace(Args&& ...args)
+        {
+            if (!enqueue(mystl::forward<Args>(args)...))
+                return false;
+            notify(pop_mutex_, not_empty_, pop_waiters_);
+            return true;
+        }
+
+        bool try_push(const value_type& value) { return try_emplace(value); }
+        bool try_push(value_type&& value)      { return try_emplace(mystl::move(value)); }
+
+        bool try_pop(value_type& value)
+        {
+            if (!dequeue(value))
+                return false;
+            notify(push_mutex_, not_full_, push_waiters_);
+            return true;
+        }
+
+    public:
+        // 阻塞操作, 队列已满 (已空) 时等待
+
+        template <class ...Args>
+        void emplace(Args&& ...args)
+        {
+            // 失败的 enqueue 不会使用参数, 因此可以反复转发
+            for (int i = 0; i < mpmc_queue_spin; ++i)
+            {
+                if (try_emplace(mystl::forward<Args>(args)...))
+                    return;
+                if (i >= mpmc_queue_spin / 2)
+                    std::this_thread::yield();
+            }
+            {
+                std::unique_lock<std::mutex> lock(push_mutex_);
+                push_waiters_.fetch_add(1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                while (!enqueue(mystl::forward<Args>(args)...))
+                    not_full_.wait(lock);
+                push_waiters_.fetch_sub(1, std::memory_order_relaxed);
+            }
+            notify(pop_mutex_, not_empty_, pop_waiters_);
+        }
+
+        void push(const value_type& value) { emplace(value); }
+        void push(value_type&& value)      { emplace(mystl::move(value)); }
+
+        void pop(value_type& value)
+        {
+            for (int i = 0; i < mpmc_queue_spin; ++i)
+            {
+                if (try_pop(value))
+                    return;
+                if (i >= mpmc_queue_spin / 2)
+                    std::this_thread::yield();
+            }
+            {
+                std::unique_lock<std::mutex> lock(pop_mutex_);
+                pop_waiters_.fetch_add(1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                while (!dequeue(value))
+                    not_empty_.wait(lock);
+                pop_waiters_.fetch_sub(1, std::memory_order_relaxed);
+            }
+            notify(push_mutex_, not_full_, push_waiters_);
+        }
+
+        value_type pop()
+        {
+            value_type value;
+            pop(value);
+            return value;
+        }
+
+    private:
+        template <class ...Args>
+        bool enqueue(Args&& ...args)
+        {
+            cell* c;
+            size_type pos = enqueue_pos_.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                c = buf_ + (pos & mask_);
+                const size_type seq = c->seq.load(std::memory_order_acquire);
+                const ptrdiff_t dif = static_cast<ptrdiff_t>(seq - pos);
+                if (dif == 0)
+                {
+                    if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (dif < 0)
+                {
+                    return false;   // 这个槽位上一轮的数据还没被取走, 队列已满
+                }
+                else
+                {
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+            // 槽位已被本线程独占, 构造失败也必须发布, 否则后面的消费者会一直等在这里
+            try
+            {
+                mystl::construct(c->value(), mystl::forward<Args>(args)...);
+                c->valid = true;
+            }
+            catch (...)
+            {
+                c->valid = false;
+                c->seq.store(pos + 1, std::memory_order_release);
+                throw;
+            }
+            c->seq.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool dequeue(value_type& value)
+        {
+            for (;;)
+            {
+                cell* c;
+                size_type pos = dequeue_pos_.load(std::memory_order_relaxed);
+                for (;;)
+                {
+                    c = buf_ + (pos & mask_);
+                    const size_type seq = c->seq.load(std::memory_order_acquire);
+                    const ptrdiff_t dif = static_cast<ptrdiff_t>(seq - (pos + 1));
+                    if (dif == 0)
+                    {
+                        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                            break;
+                    }
+                    else if (dif < 0)
+                    {
+                        return false;   // 生产者还没有写到这个槽位, 队列为空
+                    }
+                    else
+                    {
+                        pos = dequeue_pos_.load(std::memory_order_relaxed);
+                    }
+                }
+                // 成功取出时由调用者通知生产者, 其余释放槽位的路径在这里通知,
+                // 否则等在已满队列上的生产者可能错过这次唤醒
+                if (!c->valid)
+                {
+                    c->seq.store(pos + mask_ + 1, std::memory_order_release);
+                    notify(push_mutex_, not_full_, push_waiters_);
+                    continue;
+                }
+                try
+                {
+                    value = mystl::move(*c->value());
+                }
+                catch (...)
+                {
+                    mystl::destroy(c->value());
+                    c->seq.store(pos + mask_ + 1, std::memory_order_release);
+                    notify(push_mutex_, not_full_, push_waiters_);
+                    throw;
+                }
+                mystl::destroy(c->value());
+                c->seq.store(pos + mask_ + 1, std::memory_order_release);
+                return true;
+            }
+        }
+
+        // 等待方先登记再重试, 通知方先完成操作再检查登记数, 两边各有一个 seq_cst 屏障,
+        // 因此要么等待方的重试能看到这次操作, 要么通知方能看到等待方;
+        // 通知前短暂获取等待方的锁, 保证等待方已经进入 wait
+        static void notify(std::mutex& m, std::condition_variable& cv, std::atomic<int>& waiters)
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters.load(std::memory_order_relaxed) > 0)
+            {
+                {
+                    std::lock_guard<std::mutex> guard(m);
+                }
+                cv.notify_one();
+            }
+        }
+    };
+
     /*****************************************************************************************/
     // 模板类 priority_queue
     // 第一个模板参数表示代表数据类型
     // 第二个模板参数表示底层容器类型(必须是连续型容器), 缺省使用 mystl::vector
     // 第三个模板参数表示元素优先级的判定方式, 缺省使用仿函数 mystl::less 作为默认判定方式
+    // 第四个模板参数表示使用的堆算法, 缺省使用二叉堆, mystl::dary_heap_policy<4> 等为 d 叉堆
+    // d 叉堆的 push 更快而 pop 每层的比较更多, 随机的 push + pop 并不比二叉堆快, 见 heap_algo.h
 
     template <class T, class Sequence = mystl::vector<T>,
-              class Compare = mystl::less<T>>
+              class Compare = mystl::less<T>,
+              class HeapPolicy = mystl::binary_heap_policy>
     class priority_queue
     {
     public:
         typedef Sequence    sequence_type;
         typedef Compare     value_compare;
+        typedef HeapPolicy  heap_policy;
 
         typedef typename Sequence::value_type       value_type;
         typedef typename Sequence::size_type        size_type;
@@ -178,73 +470,73 @@ namespace mystl
         explicit priority_queue(size_type n)
             : c(n)
         {
-            mystl::make_heap(c.begin(), c.end(), comp);
+            heap_policy::make_heap(c.begin(), c.end(), comp);
         }
 
         priority_queue(size_type n, const value_type& value)
             : c(n, value)
         {
-            mystl::make_heap(c.begin(), c.end(), comp);
+            heap_policy::make_heap(c.begin(), c.end(), comp);
         }
 
         template <class Iter>
         priority_queue(Iter first, Iter last)
             : c(first, last)
         {
-            mystl::make_heap(c.begin(), c.end(), comp);
+            heap_policy::make_heap(c.begin(), c.end(), comp);
         }
 
         priority_queue(std::initializer_list<T> ilist)
             : c(ilist.begin(), ilist.end())
         {
-            mystl::make_heap(c.begin(), c.end());
+            heap_policy::make_heap(c.begin(), c.end(), comp);
         }
 
         priority_queue(const Sequence& s)
             : c(s)
         {
-            mystl::make_heap(c.begin(), c.end(), comp);
+            heap_policy::make_heap(c.begin(), c.end(), comp);
         }
         priority_queue(Sequence&& s)
             : c(mystl::move(s))
         {
-            mystl::make_heap(c.begin(), c.end(), comp);
+            heap_policy::make_heap(c.begin(), c.end(), comp);
         }
 
-        priority_queue(const priority_queue<T>& other)
+        priority_queue(const priority_queue& other)
             : c(other.c), comp(other.comp)
         {
-            mystl::make_heap(c.begin(), c.end(), comp);
+            heap_policy::make_heap(c.begin(), c.end(), comp);
         }
 
-        priority_queue(priority_queue<T>&& other)
+        priority_queue(priority_queue&& other)
             : c(mystl::move(other.c)), comp(other.comp)
         {
-            mystl::make_heap(c.begin(), c.end(), comp);
+            heap_policy::make_heap(c.begin(), c.end(), comp);
         }
 
-        priority_queue<T>&
-                operator=(const priority_queue<T>& rhs)
+        priority_queue&
+                operator=(const priority_queue& rhs)
         {
             c = rhs.c;
             comp = rhs.comp;
-            mystl::make_heap(c.begin(), c.end(), comp);
+            heap_policy::make_heap(c.begin(), c.end(), comp);
             return *this;
         }
 
-        priority_queue<T>& operator=(priority_queue<T>&& rhs)
+        priority_queue& operator=(priority_queue&& rhs)
         {
             c = mystl::move(rhs.c);
             comp = rhs.comp;
-            mystl::make_heap(c.begin(), c.end(), comp);
+            heap_policy::make_heap(c.begin(), c.end(), comp);
             return *this;
         }
 
-        priority_queue<T>& operator=(std::initializer_list<T> ilist)
+        priority_queue& operator=(std::initializer_list<T> ilist)
         {
             c = ilist;
             comp = value_compare();
-            mystl::make_heap(c.begin(), c.end(), comp);
+            heap_policy::make_heap(c.begin(), c.end(), comp);
             return *this;
         }
 
@@ -260,18 +552,24 @@ namespace mystl
         void emplace(Args&& ...args)
         {
             c.emplace_back(mystl::forward<Args>(args)...);
-            mystl::push_heap(c.begin(), c.end(), comp);
+            heap_policy::push_heap(c.begin(), c.end(), comp);
         }
 
         void push(const value_type& value)
         {
             c.push_back(value);
-            mystl::push_heap(c.begin(), c.end(), comp);
+            heap_policy::push_heap(c.begin(), c.end(), comp);
+        }
+
+        void push(value_type&& value)
+        {
+            c.push_back(mystl::move(value));
+            heap_policy::push_heap(c.begin(), c.end(), comp);
         }
 
         void pop()
         {
-            mystl::pop_heap(c.begin(), c.end());
+            heap_policy::pop_heap(c.begin(), c.end(), comp);
             c.pop_back();
         }
 
@@ -280,7 +578,7 @@ namespace mystl
             while (!empty()) pop();
         }
 
-        void swap(priority_queue<T>& rhs)  noexcept(noexcept(mystl::swap(c, rhs.c)) &&
+        void swap(priority_queue& rhs)  noexcept(noexcept(mystl::swap(c, rhs.c)) &&
                                                     noexcept(mystl::swap(comp, rhs.comp)))
         {
             mystl::swap(c, rhs.c);
@@ -289,15 +587,17 @@ namespace mystl
 
     public:
 
-        bool operator==(const priority_queue<T>& rhs) const
-        { return this->c == rhs.c; }
+        // 底层容器不一定提供 operator==, 逐个比较元素
+        bool operator==(const priority_queue& rhs) const
+        { return c.size() == rhs.c.size() && mystl::equal(c.begin(), c.end(), rhs.c.begin()); }
 
-        bool operator!=(const priority_queue<T>& rhs)
-        { return this->c < rhs.c; }
+        bool operator!=(const priority_queue& rhs) const
+        { return !(*this == rhs); }
     };
 
-    template <class T, class Sequence, class Compare>
-    void swap(priority_queue<T>& lhs, priority_queue<T>& rhs)
+    template <class T, class Sequence, class Compare, class HeapPolicy>
+    void swap(priority_queue<T, Sequence, Compare, HeapPolicy>& lhs,
+              priority_queue<T, Sequence, Compare, HeapPolicy>& rhs)
               noexcept(noexcept(lhs.swap(rhs)))
     {
         lhs.swap(rhs);
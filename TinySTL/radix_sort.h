@@ -0,0 +1,355 @@
+#ifndef MYTINYSTL_RADIX_SORT_H_
+#define MYTINYSTL_RADIX_SORT_H_
+
+// 这个头文件包含基数排序 : radix_sort, radix_sort_by_key
+// 整数与浮点数的键使用 LSD 基数排序, 字符串的键使用原地的 MSD 基数排序 (American flag sort)
+
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#include "algo.h"
+#include "construct.h"
+
+namespace mystl
+{
+
+constexpr size_t kRadixSortThreshold = 64;   // 不超过这个长度时使用插入排序
+constexpr size_t kRadixBuckets       = 256;  // 每趟处理一个字节
+
+/*****************************************************************************************/
+// radix_key_traits
+// 把算术类型的键映射为同样宽度的无符号整数, 且保持大小关系不变:
+//   无符号整数不变, 有符号整数翻转符号位,
+//   浮点数为负时按位取反, 否则翻转符号位 (-0.0 排在 +0.0 之前, 负的 NaN 排在最前, 正的 NaN 排在最后)
+/*****************************************************************************************/
+template <class Key, bool = std::is_floating_point<Key>::value>
+struct radix_key_traits
+{
+  typedef typename std::make_unsigned<
+    typename std::conditional<std::is_same<Key, bool>::value, unsigned char, Key>::type>::type
+    unsigned_type;
+
+  static unsigned_type encode(Key k)
+  {
+    return encode_aux(k, std::is_signed<Key>());
+  }
+
+private:
+  static unsigned_type encode_aux(Key k, std::false_type)
+  {
+    return static_cast<unsigned_type>(k);
+  }
+  static unsigned_type encode_aux(Key k, std::true_type)
+  {
+    return static_cast<unsigned_type>(k) ^
+      (static_cast<unsigned_type>(1) << (sizeof(unsigned_type) * CHAR_BIT - 1));
+  }
+};
+
+template <class Key>
+struct radix_key_traits<Key, true>
+{
+  static_assert(sizeof(Key) == 4 || sizeof(Key) == 8,
+                "radix_sort supports float and double keys only");
+  typedef typename std::conditional<sizeof(Key) == 4, uint32_t, uint64_t>::type unsigned_type;
+
+  static unsigned_type encode(Key k)
+  {
+    unsigned_type bits;
+    std::memcpy(&bits, &k, sizeof(bits));
+    const unsigned_type sign = static_cast<unsigned_type>(1) << (sizeof(unsigned_type) * CHAR_BIT - 1);
+    return (bits & sign) ? ~bits : (bits | sign);
+  }
+};
+
+// 比较两个键编码后的值, 用于短区间的插入排序
+template <class KeyOf>
+struct radix_key_less
+{
+  KeyOf& key;
+  explicit radix_key_less(KeyOf& k) : key(k) {}
+  template <class T>
+  bool operator()(const T& a, const T& b) const
+  {
+    typedef typename std::decay<decltype(key(a))>::type key_type;
+    return radix_key_traits<key_type>::encode(key(a)) < radix_key_traits<key_type>::encode(key(b));
+  }
+};
+
+// 默认的键提取: 元素本身
+struct radix_identity
+{
+  template <class T>
+  const T& operator()(const T& x) const { return x; }
+};
+
+// 稳定的插入排序, 只在短区间上使用
+template <class RandomIter, class Compared>
+void radix_insertion_sort(RandomIter first, RandomIter last, Compared comp)
+{
+  if (first == last)
+    return;
+  for (auto i = first + 1; i != last; ++i)
+  {
+    auto value = mystl::move(*i);
+    auto hole = i;
+    for (auto prev = i; hole != first && comp(value, *--prev); --hole)
+      *hole = mystl::move(*prev);
+    *hole = mystl::move(value);
+  }
+}
+
+/*****************************************************************************************/
+// LSD 基数排序
+// 一次遍历统计所有字节的直方图, 某个字节在所有键上都相同时跳过这一趟,
+// 其余各趟在原区间与临时缓冲区之间来回分配, 是稳定的
+// 要求元素的移动构造与移动赋值不抛出异常; 申请不到缓冲区时改用 mystl::sort (此时不稳定)
+/*****************************************************************************************/
+template <class RandomIter, class KeyOf>
+void lsd_radix_sort(RandomIter first, RandomIter last, KeyOf& key)
+{
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  typedef typename std::decay<decltype(key(*first))>::type key_type;
+  typedef radix_key_traits<key_type>                        traits;
+  typedef typename traits::unsigned_type                    unsigned_type;
+  constexpr size_t passes = sizeof(unsigned_type);
+
+  const size_t n = static_cast<size_t>(last - first);
+  if (n <= kRadixSortThreshold)
+  {
+    mystl::radix_insertion_sort(first, last, radix_key_less<KeyOf>(key));
+    return;
+  }
+
+  size_t hist[passes][kRadixBuckets];
+  std::memset(hist, 0, sizeof(hist));
+  for (size_t i = 0; i < n; ++i)
+  {
+    unsigned_type u = traits::encode(key(*(first + i)));
+    for (size_t p = 0; p < passes; ++p, u >>= CHAR_BIT)
+      ++hist[p][u & 0xff];
+  }
+
+  // 找出需要执行的趟数, 跳过各键在该字节上都相同的趟
+  bool need[passes];
+  size_t need_count = 0;
+  const unsigned_type u0 = traits::encode(key(*first));
+  for (size_t p = 0; p < passes; ++p)
+  {
+    need[p] = hist[p][(u0 >> (p * CHAR_BIT)) & 0xff] != n;
+    need_count += need[p];
+  }
+  if (need_count == 0)
+    return;
+
+  value_type* buf = static_cast<value_type*>(malloc(n * sizeof(value_type)));
+  if (buf == nullptr)
+  {
+    mystl::sort(first, last, radix_key_less<KeyOf>(key));
+    return;
+  }
+
+  bool in_buf = false;       // 当前数据在缓冲区中
+  bool constructed = false;  // 缓冲区中的元素已经构造
+  for (size_t p = 0; p < passes; ++p)
+  {
+    if (!need[p])
+      continue;
+    size_t offset[kRadixBuckets];
+    size_t pos = 0;
+    for (size_t b = 0; b < kRadixBuckets; ++b)
+    {
+      offset[b] = pos;
+      pos += hist[p][b];
+    }
+    const size_t shift = p * CHAR_BIT;
+    if (!in_buf)
+    {
+      for (size_t i = 0; i < n; ++i)
+      {
+        auto& x = *(first + i);
+        value_type* dst = buf + offset[(traits::encode(key(x)) >> shift) & 0xff]++;
+        if (constructed)
+          *dst = mystl::move(x);
+        else
+          ::new (static_cast<void*>(dst)) value_type(mystl::move(x));
+      }
+      constructed = true;
+    }
+    else
+    {
+      for (size_t i = 0; i < n; ++i)
+        *(first + offset[(traits::encode(key(buf[i])) >> shift) & 0xff]++) = mystl::move(buf[i]);
+    }
+    in_buf = !in_buf;
+  }
+  if (in_buf)
+    mystl::move(buf, buf + n, first);
+  mystl::destroy(buf, buf + n);
+  free(buf);
+}
+
+/*****************************************************************************************/
+// MSD 基数排序 (American flag sort)
+// 按第 depth 个字符把区间原地分为 257 个桶 (0 号桶为已经结束的字符串), 再递归处理各桶,
+// 所有字符串在当前位置的字符相同时直接进入下一位, 短区间使用插入排序
+// 字符串键需要提供 size() 与 operator[], 或者是以 '\0' 结尾的 const char*
+/*****************************************************************************************/
+template <class Str>
+inline size_t radix_char_at(const Str& s, size_t depth)
+{
+  static_assert(sizeof(s[0]) == 1, "radix_sort supports byte strings only");
+  return depth < s.size() ? static_cast<unsigned char>(s[depth]) + 1 : 0;
+}
+
+// 只会在前 depth 个字符都不是 '\0' 时调用
+inline size_t radix_char_at(const char* s, size_t depth)
+{
+  return static_cast<unsigned char>(s[depth]) == 0 ? 0 : static_cast<unsigned char>(s[depth]) + 1;
+}
+
+inline size_t radix_char_at(char* s, size_t depth)
+{
+  return radix_char_at(static_cast<const char*>(s), depth);
+}
+
+// 从第 depth 个字符开始比较
+template <class KeyOf>
+struct radix_suffix_less
+{
+  KeyOf& key;
+  size_t depth;
+  radix_suffix_less(KeyOf& k, size_t d) : key(k), depth(d) {}
+  template <class T>
+  bool operator()(const T& a, const T& b) const
+  {
+    auto&& ka = key(a);
+    auto&& kb = key(b);
+    for (size_t d = depth; ; ++d)
+    {
+      const size_t ca = radix_char_at(ka, d);
+      const size_t cb = radix_char_at(kb, d);
+      if (ca != cb)
+        return ca < cb;
+      if (ca == 0)
+        return false;
+    }
+  }
+};
+
+template <class RandomIter, class KeyOf>
+void msd_radix_sort(RandomIter first, RandomIter last, KeyOf& key, size_t depth)
+{
+  constexpr size_t buckets = kRadixBuckets + 1;
+  while (true)
+  {
+    const size_t n = static_cast<size_t>(last - first);
+    if (n <= kRadixSortThreshold)
+    {
+      mystl::radix_insertion_sort(first, last, radix_suffix_less<KeyOf>(key, depth));
+      return;
+    }
+    size_t count[buckets] = { 0 };
+    for (auto i = first; i != last; ++i)
+      ++count[radix_char_at(key(*i), depth)];
+
+    // 当前字符都相同时直接比较下一个字符
+    const size_t c0 = radix_char_at(key(*first), depth);
+    if (count[c0] == n)
+    {
+      if (c0 == 0)
+        return;
+      ++depth;
+      continue;
+    }
+
+    // 原地置换: next[b] 为桶 b 中下一个待放置的位置, 把不属于桶 b 的元素交换到它所属的桶中
+    size_t next[buckets], end[buckets];
+    size_t pos = 0;
+    for (size_t b = 0; b < buckets; ++b)
+    {
+      next[b] = pos;
+      pos += count[b];
+      end[b] = pos;
+    }
+    for (size_t b = 0; b < buckets; ++b)
+    {
+      while (next[b] < end[b])
+      {
+        size_t c = radix_char_at(key(*(first + next[b])), depth);
+        while (c != b)
+        {
+          mystl::iter_swap(first + next[b], first + next[c]++);
+          c = radix_char_at(key(*(first + next[b])), depth);
+        }
+        ++next[b];
+      }
+    }
+
+    // 0 号桶中的字符串已经结束, 互相相等
+    // 其余桶中最大的一个留在本层循环处理, 只对较小的桶递归, 递归深度不超过 log2(n)
+    size_t big = 1;
+    for (size_t b = 2; b < buckets; ++b)
+    {
+      if (count[b] > count[big])
+        big = b;
+    }
+    size_t begin = count[0];
+    RandomIter big_first = first;
+    for (size_t b = 1; b < buckets; ++b)
+    {
+      if (b == big)
+        big_first = first + begin;
+      else if (count[b] > 1)
+        mystl::msd_radix_sort(first + begin, first + begin + count[b], key, depth + 1);
+      begin += count[b];
+    }
+    first = big_first;
+    last = big_first + count[big];
+    ++depth;
+  }
+}
+
+template <class RandomIter, class KeyOf>
+void radix_sort_dispatch(RandomIter first, RandomIter last, KeyOf& key, m_true_type)
+{
+  mystl::lsd_radix_sort(first, last, key);
+}
+
+template <class RandomIter, class KeyOf>
+void radix_sort_dispatch(RandomIter first, RandomIter last, KeyOf& key, m_false_type)
+{
+  mystl::msd_radix_sort(first, last, key, 0);
+}
+
+/*****************************************************************************************/
+// radix_sort_by_key
+// 按 key(元素) 的值排序, key 返回算术类型时为稳定的 LSD 基数排序, 返回字符串时为 MSD 基数排序
+/*****************************************************************************************/
+template <class RandomIter, class KeyOf>
+void radix_sort_by_key(RandomIter first, RandomIter last, KeyOf key)
+{
+  static_assert(is_random_access_iterator<RandomIter>::value,
+                "radix_sort requires random access iterators");
+  if (first == last)
+    return;
+  typedef typename std::decay<decltype(key(*first))>::type key_type;
+  mystl::radix_sort_dispatch(first, last, key, m_bool_constant<std::is_arithmetic<key_type>::value>());
+}
+
+/*****************************************************************************************/
+// radix_sort
+// 元素本身作为键, 以升序排序整数、浮点数或字符串
+/*****************************************************************************************/
+template <class RandomIter>
+void radix_sort(RandomIter first, RandomIter last)
+{
+  mystl::radix_sort_by_key(first, last, radix_identity());
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_RADIX_SORT_H_
@@ -10,11 +10,14 @@
 
 #include <initializer_list>
 #include <cassert>
+#include <cstdint>
+#include <thread>
 
 #include "iterator.h"
 #include "memory.h"
 #include "type_traits.h"
 #include "exceptdef.h"
+#include "executor.h"
 
 namespace mystl
 {
@@ -26,12 +29,36 @@ namespace mystl
     {
         typedef rb_tree_color_type color_type;
         typedef rb_tree_node_base* base_ptr;
+        typedef size_t             size_type;
 
-        color_type  color;
-        base_ptr    parent;
+        // 节点至少按指针对齐, 父节点指针的最低位恒为 0, 用来存放颜色, 省去单独的 color 字段及其填充
+        // 红色为 0, 因此红色节点 (包括 header) 的 parent_color 就是父节点指针本身
+        base_ptr    parent_color;
         base_ptr    left;
         base_ptr    right;
 
+        base_ptr parent() const
+        { return reinterpret_cast<base_ptr>(reinterpret_cast<uintptr_t>(parent_color) & ~uintptr_t(1)); }
+
+        color_type color() const
+        { return static_cast<color_type>(reinterpret_cast<uintptr_t>(parent_color) & 1); }
+
+        void set_parent(base_ptr p)
+        {
+            parent_color = reinterpret_cast<base_ptr>(reinterpret_cast<uintptr_t>(p) |
+                (reinterpret_cast<uintptr_t>(parent_color) & 1));
+        }
+
+        void set_color(color_type c)
+        {
+            parent_color = reinterpret_cast<base_ptr>(
+                (reinterpret_cast<uintptr_t>(parent_color) & ~uintptr_t(1)) | static_cast<uintptr_t>(c));
+        }
+
+        // 新节点的 parent_color 尚未初始化时使用
+        void set_parent_color(base_ptr p, color_type c)
+        { parent_color = reinterpret_cast<base_ptr>(reinterpret_cast<uintptr_t>(p) | static_cast<uintptr_t>(c)); }
+
         static base_ptr minimum(base_ptr x)
         {
             while (nullptr != x->left) x = x->left;
@@ -45,10 +72,13 @@ namespace mystl
         }
     };
 
-    template <class Value>
-    struct rb_tree_node : public rb_tree_node_base
+    static_assert(alignof(rb_tree_node_base) >= 2, "the lowest bit of parent_color holds the color");
+
+    // NodeBase 为节点头部, 需要维护附加信息 (如顺序统计的子树大小) 时可以换成 rb_tree_node_base 的派生类
+    template <class Value, class NodeBase = rb_tree_node_base>
+    struct rb_tree_node : public NodeBase
     {
-        typedef rb_tree_node<Value>*  link_type;
+        typedef rb_tree_node<Value, NodeBase>*  link_type;
         Value value_field;
     };
 
@@ -76,11 +106,11 @@ namespace mystl
             }
             else
             {
-                base_ptr y = node->parent;
+                base_ptr y = node->parent();
                 while (node == y->right)
                 {
                     node = y;
-                    y = y->parent;
+                    y = y->parent();
                 }
                 if (node->right != y)
                     node = y;
@@ -90,7 +120,7 @@ namespace mystl
         void decrement()
         {
             // 如果到达 end();
-            if (node->color == rb_tree_red && node->parent->parent == node)
+            if (node->color() == rb_tree_red && node->parent()->parent() == node)
                 node = node->right;
             else if (nullptr != node->left)
             {
@@ -101,11 +131,11 @@ namespace mystl
             }
             else
             {
-                base_ptr y = node->parent;
+                base_ptr y = node->parent();
                 while (node == y->left)
                 {
                     node = y;
-                    y = y->parent;
+                    y = y->parent();
                 }
                 node = y;
             }
@@ -116,23 +146,27 @@ namespace mystl
 
     };
 
-    template <class Value, class Ref, class Ptr>
+    template <class Value, class Ref, class Ptr, class Node = rb_tree_node<Value>>
     struct rb_tree_iterator : public rb_tree_base_iterator
     {
-        typedef Value                                               value_type;
-        typedef Ref                                                 reference;
-        typedef Ptr                                                 pointer;
-        typedef rb_tree_iterator<Value, Value&, Value*>             iterator;
-        typedef rb_tree_iterator<Value, const Value&, const Value*> const_iterator;
-        typedef rb_tree_iterator<Value, Ref, Ptr>                   self;
-        typedef rb_tree_node<Value>*                                link_type;
+        typedef Value                                                       value_type;
+        typedef Ref                                                         reference;
+        typedef Ptr                                                         pointer;
+        typedef rb_tree_iterator<Value, Value&, Value*, Node>               iterator;
+        typedef rb_tree_iterator<Value, const Value&, const Value*, Node>   const_iterator;
+        typedef rb_tree_iterator<Value, Ref, Ptr, Node>                     self;
+        typedef Node*                                                       link_type;
 
         rb_tree_iterator() = default;
         rb_tree_iterator(link_type x)
             : rb_tree_base_iterator(x)
         {
         }
-        rb_tree_iterator(const iterator& it)
+        // iterator 到 const_iterator 的转换, 写成模板使复制构造仍是平凡的,
+        // 迭代器可以按位复制 (如放入 vector 时)
+        template <class It, typename std::enable_if<
+            std::is_same<It, iterator>::value && !std::is_same<It, self>::value, int>::type = 0>
+        rb_tree_iterator(const It& it)
             : rb_tree_base_iterator(it.node)
         {
         }
@@ -166,12 +200,52 @@ namespace mystl
     distance_type(const rb_tree_base_iterator&)
     { return (rb_tree_base_iterator::difference_type*) 0; }
 
-    template <class Value, class Ref, class Ptr>
-    inline Value* value_type(const rb_tree_iterator<Value, Ref, Ptr>&)
+    template <class Value, class Ref, class Ptr, class Node>
+    inline Value* value_type(const rb_tree_iterator<Value, Ref, Ptr, Node>&)
     { return (Value*)0; }
 
 
 
+    // 节点附加信息的维护回调, 以节点 x 调用时根据其左右儿子重新计算 x 的附加信息 (如区间树的子树最大端点)
+    // 旋转、插入后的调整、删除后的调整以及 join 都会在结构改变的节点上调用它, 默认不维护任何信息
+    // 作为 rb_tree 的模板参数时, node_base 为节点头部的类型, 附加信息可以作为它的成员存放在节点中
+    struct rb_tree_no_augment
+    {
+        typedef rb_tree_node_base node_base;
+
+        void operator()(rb_tree_node_base*) const {}
+    };
+
+    // 顺序统计 (rank / select) 用的节点头部, 多记录以该节点为根的子树的节点个数
+    struct rb_tree_size_node_base : public rb_tree_node_base
+    {
+        size_type size;
+    };
+
+    // 空子树的 size 视为 0
+    inline size_t rb_tree_subtree_size(rb_tree_node_base* x)
+    {
+        return nullptr == x ? 0 : static_cast<rb_tree_size_node_base*>(x)->size;
+    }
+
+    // 维护子树大小, 以它作为 rb_tree 的 Augment 参数时才能使用 find_by_order / order_of_key
+    struct rb_tree_size_augment
+    {
+        typedef rb_tree_size_node_base node_base;
+
+        void operator()(rb_tree_node_base* x) const
+        {
+            static_cast<rb_tree_size_node_base*>(x)->size =
+                rb_tree_subtree_size(x->left) + rb_tree_subtree_size(x->right) + 1;
+        }
+    };
+
+    template <class Augment>
+    struct rb_tree_has_size
+        : public std::is_base_of<rb_tree_size_node_base, typename Augment::node_base>
+    {
+    };
+
     /*---------------------------------------*\
     |       p                         p       |
     |      / \                       / \      |
@@ -183,23 +257,27 @@ namespace mystl
     \*---------------------------------------*/
     // 左旋，参数一为左旋点，参数二为根节点
     // 注释摘自项目 MyTinySTL
+    template <class Augment = rb_tree_no_augment>
     inline void
-    rb_tree_rotate_left(rb_tree_node_base* x, rb_tree_node_base*& root)
+    rb_tree_rotate_left(rb_tree_node_base* x, rb_tree_node_base*& root, Augment aug = Augment())
     {
         rb_tree_node_base* y = x->right;
         x->right = y->left;
         if (nullptr != y->left)
-            y->left->parent = x;
-        y->parent = x->parent;
+            y->left->set_parent(x);
+        y->set_parent(x->parent());
 
         if (x == root)
             root = y;
-        else if (x == x->parent->left)
-            x->parent->left = y;
+        else if (x == x->parent()->left)
+            x->parent()->left = y;
         else
-            x->parent->right = y;
+            x->parent()->right = y;
         y->left = x;
-        x->parent = y;
+        x->set_parent(y);
+        // 旋转只改变 x, y 两个节点的子树, 先更新下方的 x
+        aug(x);
+        aug(y);
     }
 
     /*----------------------------------------*\
@@ -213,22 +291,25 @@ namespace mystl
     \*----------------------------------------*/
     // 右旋，参数一为右旋点，参数二为根节点
     // 注释摘自 github MyTinySTL
+    template <class Augment = rb_tree_no_augment>
     inline void
-    rb_tree_rotate_right(rb_tree_node_base* x, rb_tree_node_base*& root)
+    rb_tree_rotate_right(rb_tree_node_base* x, rb_tree_node_base*& root, Augment aug = Augment())
     {
         rb_tree_node_base* y = x->left;
         x->left = y->right;
         if (nullptr != y->right)
-            y->right->parent = x;
-        y->parent = x->parent;
+            y->right->set_parent(x);
+        y->set_parent(x->parent());
         if (x == root)
             root = y;
-        else if (x == x->parent->right)
-            x->parent->right = y;
+        else if (x == x->parent()->right)
+            x->parent()->right = y;
         else
-            x->parent->left = y;
+            x->parent()->left = y;
         y->right = x;
-        x->parent = y;
+        x->set_parent(y);
+        aug(x);
+        aug(y);
     }
 
 
@@ -251,73 +332,95 @@ namespace mystl
      *      (2) 将当前节点的祖父节点设置为红色
      *      (3) 将祖父节点进行右旋
      */
-    inline void
-    rb_tree_reblance(rb_tree_node_base* x, rb_tree_node_base*& root)
+    // x 必须为红色, 除了 x 与其父节点可能同为红色外其余性质均满足
+    // 不要求 x 是叶子节点, join 时也用它来修复拼接点
+    // 返回值表示树的黑高是否增加了 1 (case 1 一直调整到根节点时发生)
+    template <class Augment = rb_tree_no_augment>
+    inline bool
+    rb_tree_insert_fixup(rb_tree_node_base* x, rb_tree_node_base*& root, Augment aug = Augment())
     {
-        x->color = rb_tree_red;
-        while (x != root && x->parent->color == rb_tree_red)
+        while (x != root && x->parent()->color() == rb_tree_red)
         {
-            if (x->parent == x->parent->parent->left)
+            if (x->parent() == x->parent()->parent()->left)
             {
-                auto y = x->parent->parent->right;
+                auto y = x->parent()->parent()->right;
                 // case 1
-                if (y && y->color == rb_tree_red)
+                if (y && y->color() == rb_tree_red)
                 {
-                    x->parent->color = rb_tree_black;
-                    y->color = rb_tree_black;
-                    x->parent->parent->color = rb_tree_red;
-                    x = x->parent->parent;
+                    x->parent()->set_color(rb_tree_black);
+                    y->set_color(rb_tree_black);
+                    x->parent()->parent()->set_color(rb_tree_red);
+                    x = x->parent()->parent();
                 }
                 else
                 {
                     // case 2
-                    if (x == x->parent->right)
+                    if (x == x->parent()->right)
                     {
-                        x = x->parent;
-                        rb_tree_rotate_left(x, root);
+                        x = x->parent();
+                        rb_tree_rotate_left(x, root, aug);
                     }
                     // case 3, 只要不是 case 1, 无论有没有经过 case 2, 都会变成 case 3
-                    x->parent->color = rb_tree_black;
-                    x->parent->parent->color = rb_tree_red;
-                    rb_tree_rotate_right(x->parent->parent, root);
+                    x->parent()->set_color(rb_tree_black);
+                    x->parent()->parent()->set_color(rb_tree_red);
+                    rb_tree_rotate_right(x->parent()->parent(), root, aug);
                 }
             }
             // 如果父节点是祖父节点的右儿子, 操作步骤是一样的, 不过有关旋转的方向反一下就可以
             else
             {
-                auto y = x->parent->parent->left;
-                if (y && y->color == rb_tree_red)
+                auto y = x->parent()->parent()->left;
+                if (y && y->color() == rb_tree_red)
                 {
-                    x->parent->color = rb_tree_black;
-                    y->color = rb_tree_black;
-                    x->parent->parent->color = rb_tree_red;
-                    x = x->parent->parent;
+                    x->parent()->set_color(rb_tree_black);
+                    y->set_color(rb_tree_black);
+                    x->parent()->parent()->set_color(rb_tree_red);
+                    x = x->parent()->parent();
                 }
                 else
                 {
-                    if (x == x->parent->left)
+                    if (x == x->parent()->left)
                     {
-                        x = x->parent;
-                        rb_tree_rotate_right(x, root);
+                        x = x->parent();
+                        rb_tree_rotate_right(x, root, aug);
                     }
-                    x->parent->color = rb_tree_black;
-                    x->parent->parent->color = rb_tree_red;
-                    rb_tree_rotate_left(x->parent->parent, root);
+                    x->parent()->set_color(rb_tree_black);
+                    x->parent()->parent()->set_color(rb_tree_red);
+                    rb_tree_rotate_left(x->parent()->parent(), root, aug);
                 }
             }
         }
         // 由于旋转后根节点可能会变为红色, 这里将根节点染为黑色
-        root->color = rb_tree_black;
+        const bool grow = root->color() == rb_tree_red;
+        root->set_color(rb_tree_black);
+        return grow;
+    }
+
+    template <class Augment = rb_tree_no_augment>
+    inline void
+    rb_tree_reblance(rb_tree_node_base* x, rb_tree_node_base*& root, Augment aug = Augment())
+    {
+        // 新节点已经挂到树上, 先更新从它到根路径上的附加信息, 之后的旋转会自行维护
+        aug(x);
+        for (auto p = x; p != root; )
+        {
+            p = p->parent();
+            aug(p);
+        }
+        x->set_color(rb_tree_red);
+        rb_tree_insert_fixup(x, root, aug);
     }
 
     // 删除节点后使得 rb_tree 重新满足红黑树条件
 
 
+    template <class Augment = rb_tree_no_augment>
     inline rb_tree_node_base*
     rb_tree_rebalance_for_erase(rb_tree_node_base* z,
                                 rb_tree_node_base*& root,
                                 rb_tree_node_base*& leftmost,
-                                rb_tree_node_base*& rightmost)
+                                rb_tree_node_base*& rightmost,
+                                Augment aug = Augment())
     {
         rb_tree_node_base* y = z;
         rb_tree_node_base* x = 0;
@@ -332,7 +435,7 @@ namespace mystl
             // 否则就找右子树的最左节点与要删除节点交换
             // 由于该节点一定是只有右儿子的节点, 所以交换完后直接删除即可
             y = y->right;
-            while (nullptr == y->left)
+            while (nullptr != y->left)
                 y = y->left;
             x = y->right;
         }
@@ -340,138 +443,334 @@ namespace mystl
         if (y != z)
         {
             // 先将要删除节点的左儿子的父节点指向 y
-            z->left->parent = y;
+            z->left->set_parent(y);
             y->left = z->left;
             // 如果 y 不是要删除节点 z 的右儿子
             if (y != z->right)
             {
-                x_parent = y->parent;
-                if (x) x->parent = y->parent;
-                y->parent->left = x;
+                x_parent = y->parent();
+                if (x) x->set_parent(y->parent());
+                y->parent()->left = x;
                 y->right = z->right;
-                z->right->parent = y;
+                z->right->set_parent(y);
             } // 如果 y 是要删除节点 z 的右儿子
             else
                 x_parent = y;
             if (root == z)
                 root = y;
-            else if (z->parent->left == z)
-                z->parent->left = y;
+            else if (z->parent()->left == z)
+                z->parent()->left = y;
             else
-                z->parent->right = y;
-            y->parent = z->parent;
-            mystl::swap(y->color, z->color);
+                z->parent()->right = y;
+            y->set_parent(z->parent());
+            rb_tree_color_type c = y->color();
+            y->set_color(z->color());
+            z->set_color(c);
             y = z;
         }
         else
         {
-            x_parent = y->parent;
-            if (x) x->parent = y->parent;
+            x_parent = y->parent();
+            if (x) x->set_parent(y->parent());
             if (root == z)
                 root = x;
-            else if (z->parent->left = z)
-                z->parent->left = x;
+            else if (z->parent()->left == z)
+                z->parent()->left = x;
             else
-                z->parent->right = x;
+                z->parent()->right = x;
             if (leftmost == z)
                 if (nullptr == z->right)
-                    leftmost = z->parent;
+                    leftmost = z->parent();
                 else
                     leftmost = rb_tree_node_base::minimum(x);
 
 
             if (rightmost == z)
                 if (nullptr == z->left)
-                    rightmost = z->parent;
+                    rightmost = z->parent();
                 else
                     rightmost = rb_tree_node_base::maximum(x);
         }
 
+        // 摘除节点后, 从 x_parent 到根路径上的附加信息需要重新计算, 之后的旋转会自行维护
+        if (nullptr != root)
+        {
+            for (auto p = x_parent, top = root->parent(); p != top; p = p->parent())
+                aug(p);
+        }
+
         // 开始修复因删除而破坏的红黑树性质
-        if (y->color != rb_tree_red)
+        if (y->color() != rb_tree_red)
         {
-            while (x != root && (nullptr == x || x->color == rb_tree_black))
+            while (x != root && (nullptr == x || x->color() == rb_tree_black))
                 if (x == x_parent->left)
                 {
                     auto w = x_parent->right;
-                    if (w->color == rb_tree_red)
+                    if (w->color() == rb_tree_red)
                     {
-                        w->color = rb_tree_black;
-                        x_parent->color = rb_tree_red;
-                        rb_tree_rotate_left(x_parent, root);
+                        w->set_color(rb_tree_black);
+                        x_parent->set_color(rb_tree_red);
+                        rb_tree_rotate_left(x_parent, root, aug);
                         w = x_parent->right;
                     }
                     // 如果第一步执行了, 那么就满足 w 节点是黑色
                     // 反之, 则说明 w 本来就是黑色, 所以只需要判断子节点符不符合条件即可
-                    if ((nullptr == w->left || w->left->color == rb_tree_black) &&
-                         (nullptr == w->right || w->right->color == rb_tree_black))
+                    if ((nullptr == w->left || w->left->color() == rb_tree_black) &&
+                         (nullptr == w->right || w->right->color() == rb_tree_black))
                     {
-                        w->color = rb_tree_red;
+                        w->set_color(rb_tree_red);
                         x = x_parent;
-                        x_parent = x_parent->parent;
+                        x_parent = x_parent->parent();
                     }
                     else
                     {
-                        if (nullptr == w->right || w->right->color == rb_tree_black)
+                        if (nullptr == w->right || w->right->color() == rb_tree_black)
                         {
-                            w->color = rb_tree_red;
-                            rb_tree_rotate_right(w, root);
+                            w->set_color(rb_tree_red);
+                            rb_tree_rotate_right(w, root, aug);
                             w = x_parent->right;
                         }
-                        w->color = x_parent->color;
-                        x_parent->color = rb_tree_black;
-                        if (w->right) w->right->color = rb_tree_black;
-                        rb_tree_rotate_left(x_parent, root);
+                        w->set_color(x_parent->color());
+                        x_parent->set_color(rb_tree_black);
+                        if (w->right) w->right->set_color(rb_tree_black);
+                        rb_tree_rotate_left(x_parent, root, aug);
                         break;
                     }
                 }
                 else
                 {
                     auto w = x_parent->left;
-                    if (w->color == rb_tree_red)
+                    if (w->color() == rb_tree_red)
                     {
-                        w->color = rb_tree_black;
-                        x_parent->color = rb_tree_red;
-                        rb_tree_rotate_right(x_parent, root);
+                        w->set_color(rb_tree_black);
+                        x_parent->set_color(rb_tree_red);
+                        rb_tree_rotate_right(x_parent, root, aug);
                         w = x_parent->left;
                     }
-                    if ((nullptr == w->right || w->right->color == rb_tree_black) &&
-                        (nullptr == w->left  || w->left->color == rb_tree_black))
+                    if ((nullptr == w->right || w->right->color() == rb_tree_black) &&
+                        (nullptr == w->left  || w->left->color() == rb_tree_black))
                     {
-                        w->color = rb_tree_red;
+                        w->set_color(rb_tree_red);
                         x = x_parent;
-                        x_parent = x_parent->parent;
+                        x_parent = x_parent->parent();
                     }
                     else
                     {
-                        if (nullptr == w->left || w->left->color == rb_tree_black)
+                        if (nullptr == w->left || w->left->color() == rb_tree_black)
                         {
                             if (w->right)
-                                w->right->color = rb_tree_black;
-                            w->color = rb_tree_red;
+                                w->right->set_color(rb_tree_black);
+                            w->set_color(rb_tree_red);
+                            rb_tree_rotate_left(w, root, aug);
                             w = x_parent->left;
                         }
-                        w->color = x_parent->color;
-                        x_parent->color = rb_tree_black;
+                        w->set_color(x_parent->color());
+                        x_parent->set_color(rb_tree_black);
                         if (w->left)
-                            w->left->color = rb_tree_black;
-                        rb_tree_rotate_right(x_parent, root);
+                            w->left->set_color(rb_tree_black);
+                        rb_tree_rotate_right(x_parent, root, aug);
                         break;
                     }
                 }
             if (x)
-                x->color = rb_tree_black;
+                x->set_color(rb_tree_black);
         }
         return y;
     }
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
+    /*****************************************************************************************/
+    // join / split 相关
+    // 下面的函数操作的是独立的子树: 根节点的 parent 为 nullptr, 且根节点为黑色
+    // 黑高 (black height) 指从根到空指针路径上的黑节点个数, 空树的黑高为 0
+    /*****************************************************************************************/
+
+    inline size_t rb_tree_black_height(rb_tree_node_base* x)
+    {
+        size_t h = 0;
+        for (; nullptr != x; x = x->left)
+        {
+            if (x->color() == rb_tree_black)
+                ++h;
+        }
+        return h;
+    }
+
+    // 将子树 x 从父节点上摘下作为独立的树, 子树原本的黑高为 h, 返回摘下后的黑高
+    inline size_t rb_tree_detach(rb_tree_node_base* x, size_t h)
+    {
+        if (nullptr == x)
+            return 0;
+        x->set_parent(nullptr);
+        if (x->color() == rb_tree_red)
+        {
+            x->set_color(rb_tree_black);
+            return h + 1;
+        }
+        return h;
+    }
+
+    // 以节点 k 为分隔, 将 l (所有元素都不大于 k) 与 r (所有元素都不小于 k) 合并为一棵树
+    // lbh, rbh 为两棵树的黑高, 合并后的黑高写入 bh, 时间复杂度 O(|lbh - rbh| + 1)
+    // 黑高较大的一侧沿着靠近另一侧的边缘向下, 找到黑高相等的黑节点 c, 用红色的 k 替换 c,
+    // 以 c 和较矮的树作为 k 的两个儿子, 之后和插入一样向上修复连续的红节点
+    // k 的附加信息以及向下经过的节点的附加信息都由 aug 重新计算
+    template <class Augment = rb_tree_no_augment>
+    inline rb_tree_node_base*
+    rb_tree_join(rb_tree_node_base* l, size_t lbh, rb_tree_node_base* k,
+                 rb_tree_node_base* r, size_t rbh, size_t& bh, Augment aug = Augment())
+    {
+        k->set_parent(nullptr);
+        if (lbh == rbh)
+        {
+            k->left = l;
+            k->right = r;
+            if (l) l->set_parent(k);
+            if (r) r->set_parent(k);
+            k->set_color(rb_tree_black);
+            aug(k);
+            bh = lbh + 1;
+            return k;
+        }
+        rb_tree_node_base* root = lbh > rbh ? l : r;
+        rb_tree_node_base* p = nullptr;
+        rb_tree_node_base* c = root;
+        if (lbh > rbh)
+        {
+            size_t h = lbh;
+            while (nullptr != c && (c->color() == rb_tree_red || h > rbh))
+            {
+                if (c->color() == rb_tree_black)
+                    --h;
+                p = c;
+                c = c->right;
+            }
+            k->left = c;
+            k->right = r;
+            p->right = k;
+            bh = lbh;
+        }
+        else
+        {
+            size_t h = rbh;
+            while (nullptr != c && (c->color() == rb_tree_red || h > lbh))
+            {
+                if (c->color() == rb_tree_black)
+                    --h;
+                p = c;
+                c = c->left;
+            }
+            k->left = l;
+            k->right = c;
+            p->left = k;
+            bh = rbh;
+        }
+        k->set_parent(p);
+        if (k->left) k->left->set_parent(k);
+        if (k->right) k->right->set_parent(k);
+        k->set_color(rb_tree_red);
+        for (auto q = k; nullptr != q; q = q->parent())
+            aug(q);
+        if (rb_tree_insert_fixup(k, root, aug))
+            ++bh;
+        return root;
+    }
+
+    // 集合运算时子问题两棵树的黑高之和不小于该值才会交给线程池并行执行
+    // 节点中不一定有子树大小, 用黑高估计规模: 黑高为 h 的树至少有 2^h - 1 个节点
+    const size_t kRbTreeParallelBlackHeight = 20;
+
+    // 并行递归的最大深度, 约为 log2(硬件线程数)
+    inline int rb_tree_fork_depth()
+    {
+        unsigned n = std::thread::hardware_concurrency();
+        int depth = 0;
+        while ((1u << depth) < n)
+            ++depth;
+        return depth;
+    }
+
+    // fork 为 true 时 f1 交给默认线程池 work_stealing_executor 执行, f2 在当前线程执行, 两者都结束后返回
+    // 任何一边抛出的异常都会在两边结束后重新抛出
+    template <class F1, class F2>
+    void rb_tree_fork_join(bool fork, F1& f1, F2& f2)
+    {
+        if (fork)
+        {
+            mystl::parallel_invoke(f1, f2);
+            return;
+        }
+        f1();
+        f2();
+    }
+
+    // 没有分隔节点时的合并: 取出 l 的最大节点作为分隔节点
+    template <class Augment = rb_tree_no_augment>
+    inline rb_tree_node_base*
+    rb_tree_join2(rb_tree_node_base* l, size_t lbh,
+                  rb_tree_node_base* r, size_t rbh, size_t& bh, Augment aug = Augment())
+    {
+        if (nullptr == l)
+        {
+            bh = rbh;
+            return r;
+        }
+        if (nullptr == r)
+        {
+            bh = lbh;
+            return l;
+        }
+        rb_tree_node_base* k = rb_tree_node_base::maximum(l);
+        rb_tree_node_base* leftmost = nullptr;
+        rb_tree_node_base* rightmost = k;
+        rb_tree_rebalance_for_erase(k, l, leftmost, rightmost, aug);
+        if (l)
+        {
+            l->set_parent(nullptr);
+            l->set_color(rb_tree_black);
+        }
+        return rb_tree_join(l, rb_tree_black_height(l), k, r, rbh, bh, aug);
+    }
+
+    // 独立子树中 x 的中序后继, x 为最大节点时返回 nullptr
+    inline rb_tree_node_base* rb_tree_subtree_next(rb_tree_node_base* x)
+    {
+        if (nullptr != x->right)
+            return rb_tree_node_base::minimum(x->right);
+        rb_tree_node_base* y = x->parent();
+        while (nullptr != y && x == y->right)
+        {
+            x = y;
+            y = y->parent();
+        }
+        return y;
+    }
+
+    // l, r 为两棵独立的子树, 共有 total 个节点, 返回 l 的节点个数
+    // 节点中没有子树大小时同时遍历两棵树, 数完较小的一棵即停止, 时间复杂度 O(min(|l|, |r|))
+    inline size_t rb_tree_count_left(rb_tree_node_base* l, rb_tree_node_base* r, size_t total)
+    {
+        rb_tree_node_base* a = l ? rb_tree_node_base::minimum(l) : nullptr;
+        rb_tree_node_base* b = r ? rb_tree_node_base::minimum(r) : nullptr;
+        size_t na = 0, nb = 0;
+        while (nullptr != a && nullptr != b)
+        {
+            a = rb_tree_subtree_next(a), ++na;
+            b = rb_tree_subtree_next(b), ++nb;
+        }
+        return nullptr == a ? na : total - nb;
+    }
+
+    // 模板类 rb_tree
+    // 参数一为键值类型, 参数二为元素类型, 参数三为从元素中取出键值的方式, 参数四为键值比较方式
+    // 参数五为节点附加信息的维护方式, 如 rb_tree_size_augment, 缺省不维护任何附加信息
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment = rb_tree_no_augment>
     class rb_tree
     {
     public:
         typedef rb_tree_color_type                      color_type;
         typedef rb_tree_node_base*                      base_ptr;
-        typedef rb_tree_node<Value>                     rb_tree_node;
+        typedef typename Augment::node_base             node_base;
+        typedef rb_tree_node<Value, node_base>          rb_tree_node;
 
 
         typedef mystl::allocator<Value>                 allocator_type;
@@ -490,8 +789,8 @@ namespace mystl
         typedef typename allocator_type::size_type       size_type;
         typedef typename allocator_type::difference_type difference_type;
 
-        typedef rb_tree_iterator<value_type, reference, pointer>                iterator;
-        typedef rb_tree_iterator<value_type, const_reference, const_pointer>    const_iterator;
+        typedef rb_tree_iterator<value_type, reference, pointer, rb_tree_node>              iterator;
+        typedef rb_tree_iterator<value_type, const_reference, const_pointer, rb_tree_node>  const_iterator;
         typedef mystl::reverse_iterator<iterator>                               reverse_iterator;
         typedef mystl::reverse_iterator<const_iterator>                         const_reverse_iterator;
 
@@ -507,7 +806,7 @@ namespace mystl
                 data_allocator::construct(mystl::address_of(tmp->value_field), value);
                 tmp->left = nullptr;
                 tmp->right = nullptr;
-                tmp->parent = nullptr;
+                tmp->set_parent_color(nullptr, rb_tree_red);
             }
             catch (...)
             {
@@ -527,7 +826,7 @@ namespace mystl
                                           mystl::forward<Args>(args)...);
                 tmp->left = nullptr;
                 tmp->right = nullptr;
-                tmp->parent = nullptr;
+                tmp->set_parent_color(nullptr, rb_tree_red);
             }
             catch (...)
             {
@@ -540,7 +839,8 @@ namespace mystl
         link_type clone_type(link_type x)
         {
             link_type tmp = create_node(x->value_field);
-            tmp->color = x->color;
+            // 连同颜色与附加信息一起复制节点头部, 树的形状不变, 附加信息不需要重新计算
+            static_cast<node_base&>(*tmp) = static_cast<const node_base&>(*x);
             tmp->left = nullptr;
             tmp->right = nullptr;
             return tmp;
@@ -557,16 +857,17 @@ namespace mystl
         link_type header;
         Compare   key_compare;
 
-        link_type& root()       const { return (link_type&)(header->parent); }
+        // header 始终为红色, 其 parent_color 不带颜色位, 可以直接作为根节点指针的引用
+        link_type& root()       const { return (link_type&)(header->parent_color); }
         link_type& leftmost()   const { return (link_type&)(header->left); }
         link_type& rightmost()  const { return (link_type&)(header->right); }
 
         static link_type& left(link_type x)   { return (link_type&)(x->left); }
         static link_type& right(link_type x)  { return (link_type&)(x->right);; }
-        static link_type& parent(link_type x) { return (link_type&)(x->parent); }
+        static link_type  parent(link_type x) { return (link_type)(x->parent()); }
         static reference  value(base_ptr x)   { return ((link_type&)x)->value_field; }
         static const Key& key(base_ptr x)     { return KeyOfValue()(value(link_type(x))); }
-        static color_type& color(base_ptr x)  { return (color_type&)(link_type(x)->color); }
+        static color_type color(base_ptr x)   { return x->color(); }
         static link_type  change_link_type(base_ptr x)
         { return (link_type)(x); }
 
@@ -583,8 +884,7 @@ namespace mystl
         void rb_tree_init()
         {
             header = get_node();
-            color(header) = rb_tree_red;
-            root() = nullptr;
+            header->set_parent_color(nullptr, rb_tree_red);
             leftmost() = header;
             rightmost() = header;
         }
@@ -600,7 +900,7 @@ namespace mystl
         rb_tree() :node_count(0), key_compare()
         { rb_tree_init(); }
 
-        rb_tree(const rb_tree<Key, Value, KeyOfValue, Compare>& other)
+        rb_tree(const rb_tree<Key, Value, KeyOfValue, Compare, Augment>& other)
             : node_count(other.node_count), key_compare(other.key_compare)
         {
             rb_tree_init();
@@ -611,7 +911,7 @@ namespace mystl
                 rightmost() = rb_tree::maximum(root());
             }
         }
-        rb_tree(rb_tree<Key, Value, KeyOfValue, Compare>&& other) noexcept
+        rb_tree(rb_tree<Key, Value, KeyOfValue, Compare, Augment>&& other) noexcept
             : header(mystl::move(other.header)),
               node_count(other.node_count),
               key_compare(other.key_compare)
@@ -619,8 +919,8 @@ namespace mystl
             other.reset();
         }
 
-        rb_tree<Key, Value, KeyOfValue, Compare>&
-                operator=(const rb_tree<Key, Value, KeyOfValue, Compare>& rhs)
+        rb_tree<Key, Value, KeyOfValue, Compare, Augment>&
+                operator=(const rb_tree<Key, Value, KeyOfValue, Compare, Augment>& rhs)
         {
             if (this != &rhs)
             {
@@ -637,8 +937,8 @@ namespace mystl
             return *this;
         }
 
-        rb_tree<Key, Value, KeyOfValue, Compare>&
-                operator=(rb_tree<Key, Value, KeyOfValue, Compare>&& rhs)
+        rb_tree<Key, Value, KeyOfValue, Compare, Augment>&
+                operator=(rb_tree<Key, Value, KeyOfValue, Compare, Augment>&& rhs)
         {
             clear();
             header = mystl::move(rhs.header);
@@ -679,7 +979,7 @@ namespace mystl
         bool        empty()       const noexcept { return node_count == 0;}
         size_type   size()        const noexcept { return node_count; }
         size_type   max_size()    const noexcept { return static_cast<size_type>(-1); }
-        void swap(rb_tree<Key, Value, KeyOfValue, Compare>& rhs) noexcept
+        void swap(rb_tree<Key, Value, KeyOfValue, Compare, Augment>& rhs) noexcept
         {
             if (this != &rhs)
             {
@@ -731,6 +1031,12 @@ namespace mystl
             size_type  n = mystl::distance(first, last);
             THROW_LENGTH_ERROR_IF(node_count > max_size() - n,
                                   "rb_tree<Key, Value, KeyOfValue, Compare>'s size too big");
+            // 空树且输入有序时直接 O(n) 建树
+            if (0 == node_count && is_sorted_range(first, last, false))
+            {
+                build_sorted(first, n);
+                return;
+            }
             for (; n > 0; --n, ++first)
                 insert_multi(end(), *first);
         }
@@ -760,10 +1066,27 @@ namespace mystl
             size_type  n = mystl::distance(first, last);
             THROW_LENGTH_ERROR_IF(node_count > max_size() - n,
                                   "rb_tree<Key, Value, KeyOfValue, Compare>'s size too big");
+            // 空树且输入严格递增时直接 O(n) 建树
+            if (0 == node_count && is_sorted_range(first, last, true))
+            {
+                build_sorted(first, n);
+                return;
+            }
             for (; n > 0; --n, ++first)
                 insert_unique(end(), *first);
         }
 
+        // 调用者保证 [first, last) 严格递增, 清空原有元素后 O(n) 建树, 不做任何比较
+        template <class InputIter>
+        void    assign_sorted_unique(InputIter first, InputIter last)
+        {
+            size_type  n = mystl::distance(first, last);
+            THROW_LENGTH_ERROR_IF(n > max_size(),
+                                  "rb_tree<Key, Value, KeyOfValue, Compare>'s size too big");
+            clear();
+            build_sorted(first, n);
+        }
+
         // erase
 
         iterator  erase(iterator hint);
@@ -829,6 +1152,31 @@ namespace mystl
             return it == end() ? mystl::make_pair(it, it) : make_pair(it, ++nex);
         }
 
+        // 顺序统计, Augment 为 rb_tree_size_augment 时才能使用
+        // find_by_order(k) 返回第 k 小 (从 0 开始) 的元素, k >= size() 时返回 end()
+        // order_of_key(key) 返回严格小于 key 的元素个数
+        iterator       find_by_order(size_type k)
+        { return iterator(select_node(k)); }
+        const_iterator find_by_order(size_type k) const
+        { return const_iterator(select_node(k)); }
+
+        size_type order_of_key(const key_type& key) const;
+
+        // join / split, 节点直接在树之间转移, 不会分配新的节点
+        // split: 本树保留小于 key 的元素, 不小于 key 的元素移入 right, right 原有的元素被清空
+        // join : 要求本树的元素都不大于 right 的元素, 合并后 right 为空
+        // join 的时间复杂度为 O(log n); split 在维护子树大小 (rb_tree_size_augment) 时为 O(log n),
+        // 否则还要数出较小一侧的节点个数, 为 O(log n + min(|左|, |右|))
+        void split(const key_type& key, rb_tree& right);
+        void join(rb_tree& right);
+
+        // 基于 join / split 的集合运算, 按键唯一的语义处理 (用于 set / map)
+        // other 的节点被转移到本树或被释放, 调用后 other 为空
+        // 设两棵树的大小为 n >= m, 工作量为 O(m log(n / m + 1)), 较大的子问题会交给其他线程并行执行
+        void union_with(rb_tree& other);
+        void intersect_with(rb_tree& other);
+        void difference_with(rb_tree& other);
+
         // get insert pos
 
         mystl::pair<link_type, bool>
@@ -840,24 +1188,60 @@ namespace mystl
         // insert value / insert node
 
         iterator insert_value_at(link_type x, const value_type& value, bool add_to_left);
-        iterator insert_node_at(link_type x, link_type node, bool add_to_left);
+        // aug 用于维护节点的附加信息, 缺省为本树的 Augment, 见 rb_tree_no_augment
+        template <class Aug = Augment>
+        iterator insert_node_at(link_type x, link_type node, bool add_to_left, Aug aug = Aug());
+        template <class Aug>
+        iterator erase_node(iterator hint, Aug aug);
 
         iterator insert_multi_use_hint(iterator hint, key_type key, link_type node);
         iterator insert_unique_use_hint(iterator hint, key_type key, link_type node);
 
         link_type __copy(link_type x, link_type p);
 
-        void erase_since(link_type x);
+        link_type select_node(size_type k) const;
+
+        // bulk build
+
+        template <class InputIter>
+        bool is_sorted_range(InputIter first, InputIter last, bool strict) const;
+
+        template <class InputIter>
+        void build_sorted(InputIter first, size_type n);
+
+        template <class InputIter>
+        link_type build_sorted_aux(InputIter& first, size_type n, size_type depth,
+                                   size_type red_depth, link_type p);
+
+        // join / split
+
+        base_ptr  take_root(size_type& bh);
+        void      reset_root(base_ptr x, size_type n);
+        size_type count_left(base_ptr l, base_ptr r, size_type total, std::true_type) const;
+        size_type count_left(base_ptr l, base_ptr r, size_type total, std::false_type) const;
+
+        void split_aux(base_ptr x, size_type h, const key_type& k, bool extract,
+                       base_ptr& l, size_type& lbh, base_ptr& mid,
+                       base_ptr& r, size_type& rbh) const;
+
+        base_ptr union_aux(base_ptr a, size_type abh, base_ptr b, size_type bbh,
+                           size_type& bh, size_type& erased, int depth);
+        base_ptr intersect_aux(base_ptr a, size_type abh, base_ptr b, size_type bbh,
+                               size_type& bh, size_type& erased, int depth);
+        base_ptr difference_aux(base_ptr a, size_type abh, base_ptr b, size_type bbh,
+                                size_type& bh, size_type& erased, int depth);
+
+        size_type erase_since(link_type x);
 
     };
 
     /****************************************************************************/
 
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
     template <class ...Args>
-    typename rb_tree<Key, Value, KeyOfValue, Compare>::iterator
-    rb_tree<Key, Value, KeyOfValue, Compare>::
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
     emplace_multi(Args&& ...args)
     {
         THROW_LENGTH_ERROR_IF(node_count > max_size() - 1,
@@ -867,10 +1251,10 @@ namespace mystl
         return insert_node_at(res.first, pos, res.second);
     }
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
     template <class ...Args>
-    mystl::pair<typename rb_tree<Key, Value, KeyOfValue, Compare>::iterator, bool>
-    rb_tree<Key, Value, KeyOfValue, Compare>::
+    mystl::pair<typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::iterator, bool>
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
     emplace_unique(Args&& ...args)
     {
         THROW_LENGTH_ERROR_IF(node_count > max_size() - 1,
@@ -885,10 +1269,10 @@ namespace mystl
         return mystl::make_pair(iterator(res.first.first), false);
     }
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
     template <class ...Args>
-    typename rb_tree<Key, Value, KeyOfValue, Compare>::iterator
-    rb_tree<Key, Value, KeyOfValue, Compare>::
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
     emplace_multi_use_hint(iterator hint, Args&& ...args)
     {
         THROW_LENGTH_ERROR_IF(node_count > max_size() - 1,
@@ -929,10 +1313,10 @@ namespace mystl
         return insert_multi_use_hint(hint, key, pos);
     }
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
     template <class ...Args>
-    typename rb_tree<Key, Value, KeyOfValue, Compare>::iterator
-    rb_tree<Key, Value, KeyOfValue, Compare>::
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
     emplace_unique_use_hint(iterator hint, Args&& ...args)
     {
         THROW_LENGTH_ERROR_IF(node_count > max_size() - 1,
@@ -983,9 +1367,9 @@ namespace mystl
         return insert_unique_use_hint(hint, key, pos);
     }
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    typename rb_tree<Key, Value, KeyOfValue, Compare>::iterator
-    rb_tree<Key, Value, KeyOfValue, Compare>::
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
     insert_multi(const value_type& value)
     {
         THROW_LENGTH_ERROR_IF(node_count > max_size() - 1,
@@ -996,9 +1380,9 @@ namespace mystl
 
 
     // 返回 pair, 如果 pair 第参数二 为 false 表示插入失败, 反之则插入成功
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    mystl::pair<typename rb_tree<Key, Value, KeyOfValue, Compare>::iterator, bool>
-    rb_tree<Key, Value, KeyOfValue, Compare>::
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    mystl::pair<typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::iterator, bool>
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
     insert_unique(const value_type& value)
     {
         THROW_LENGTH_ERROR_IF(node_count > max_size() - 1,
@@ -1011,25 +1395,35 @@ namespace mystl
         return mystl::make_pair(res.first.first, false);
     }
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    typename rb_tree<Key, Value, KeyOfValue, Compare>::iterator
-    rb_tree<Key, Value, KeyOfValue, Compare>::
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
     erase(iterator hint)
+    {
+        return erase_node(hint, Augment());
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    template <class Aug>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
+    erase_node(iterator hint, Aug aug)
     {
         auto node = (link_type)(hint.node);
         iterator nex(node);
         ++nex;
 
-        rb_tree_rebalance_for_erase(hint.node, header->parent, (base_ptr&)leftmost(), (base_ptr&)rightmost());
+        rb_tree_rebalance_for_erase(hint.node, (base_ptr&)root(), (base_ptr&)leftmost(),
+                                    (base_ptr&)rightmost(), aug);
         destroy_node(node);
         --node_count;
         return nex;
     }
 
     // 删除等于 key 的元素, 并返回删除个数
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    typename rb_tree<Key, Value, KeyOfValue, Compare>::size_type
-    rb_tree<Key, Value, KeyOfValue, Compare>::
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::size_type
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
     erase_multi(const key_type& key)
     {
         auto p = equal_range_multi(key);
@@ -1039,9 +1433,9 @@ namespace mystl
     }
 
     // 删除等于 key 的元素, 并返回删除个数
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    typename rb_tree<Key, Value, KeyOfValue, Compare>::size_type
-    rb_tree<Key, Value, KeyOfValue, Compare>::
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::size_type
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
     erase_unique(const key_type& key)
     {
         auto p = find(key);
@@ -1050,12 +1444,12 @@ namespace mystl
             erase(p);
             return 1;
         }
-        return 1;
+        return 0;
     }
 
     // 删除 [first, last) 区间内元素
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    void rb_tree<Key, Value, KeyOfValue, Compare>::
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    void rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
     erase(iterator first, iterator last)
     {
         if (first == begin() && last == end())
@@ -1067,8 +1461,8 @@ namespace mystl
         }
     }
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    void rb_tree<Key, Value, KeyOfValue, Compare>::clear()
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    void rb_tree<Key, Value, KeyOfValue, Compare, Augment>::clear()
     {
         if (node_count > 0)
         {
@@ -1080,9 +1474,9 @@ namespace mystl
         }
     }
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    typename rb_tree<Key, Value, KeyOfValue, Compare>::iterator
-    rb_tree<Key, Value, KeyOfValue, Compare>::
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
     find(const key_type& key)
     {
         // 最后一个不小于 key 的节点
@@ -1102,9 +1496,9 @@ namespace mystl
     }
 
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    typename rb_tree<Key, Value, KeyOfValue, Compare>::const_iterator
-    rb_tree<Key, Value, KeyOfValue, Compare>::
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::const_iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
     find(const key_type& key) const
     {
         // 最后一个不小于 key 的节点
@@ -1124,9 +1518,9 @@ namespace mystl
     }
 
     // 不小于 Key 的第一个位置
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    typename rb_tree<Key, Value, KeyOfValue, Compare>::iterator
-    rb_tree<Key, Value, KeyOfValue, Compare>::
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
     lower_bound(const key_type& key)
     {
         link_type y = header;
@@ -1141,9 +1535,9 @@ namespace mystl
         return iterator(y);
     }
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    typename rb_tree<Key, Value, KeyOfValue, Compare>::const_iterator
-    rb_tree<Key, Value, KeyOfValue, Compare>::
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::const_iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
     lower_bound(const key_type& key) const
     {
         link_type y = header;
@@ -1159,9 +1553,9 @@ namespace mystl
     }
 
     // 不小于 Key 的最后一个位置
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    typename rb_tree<Key, Value, KeyOfValue, Compare>::iterator
-    rb_tree<Key, Value, KeyOfValue, Compare>::
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
     upper_bound(const key_type &key)
     {
         link_type y = header;
@@ -1176,9 +1570,9 @@ namespace mystl
         return iterator(y);
     }
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    typename rb_tree<Key, Value, KeyOfValue, Compare>::const_iterator
-    rb_tree<Key, Value, KeyOfValue, Compare>::
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::const_iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
     upper_bound(const key_type &key) const
     {
         link_type y = header;
@@ -1194,11 +1588,14 @@ namespace mystl
     }
 
     // get_insert_multi_pos
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    mystl::pair<typename rb_tree<Key, Value, KeyOfValue, Compare>::link_type, bool>
-    rb_tree<Key, Value, KeyOfValue, Compare>::
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    mystl::pair<typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::link_type, bool>
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
     get_insert_multi_pos(const key_type& key)
     {
+        // 追加到最右端是很常见的情况 (如按序插入), 此时不需要从根开始查找
+        if (0 != node_count && !key_compare(key, KeyOfValue()(rightmost()->value_field)))
+            return mystl::make_pair(rightmost(), false);
         link_type x = root();
         link_type y = header;
         bool add_to_left = true;
@@ -1212,11 +1609,13 @@ namespace mystl
     }
 
     // get_insert_unique_pos
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    mystl::pair<mystl::pair<typename rb_tree<Key, Value, KeyOfValue, Compare>::link_type, bool>, bool>
-    rb_tree<Key, Value, KeyOfValue, Compare>::
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    mystl::pair<mystl::pair<typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::link_type, bool>, bool>
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
     get_insert_unique_pos(const key_type& key)
     {
+        if (0 != node_count && key_compare(KeyOfValue()(rightmost()->value_field), key))
+            return mystl::make_pair(mystl::make_pair(rightmost(), false), true);
         link_type x = root();
         link_type y = header;
         bool add_to_left = true;
@@ -1241,13 +1640,13 @@ namespace mystl
     }
 
     // insert_value_at
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    typename rb_tree<Key, Value, KeyOfValue, Compare>::iterator
-    rb_tree<Key, Value, KeyOfValue, Compare>::
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
     insert_value_at(link_type x, const value_type& value, bool add_to_left)
     {
         link_type node = create_node(value);
-        node->parent = x;
+        node->set_parent(x);
         if (x == header)
         {
             root() = node;
@@ -1266,17 +1665,18 @@ namespace mystl
             if (rightmost() == x)
                 rightmost() = node;
         }
-        rb_tree_reblance(node, header->parent);
+        rb_tree_reblance(node, (base_ptr&)root(), Augment());
         ++node_count;
         return iterator(node);
     }
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    typename rb_tree<Key, Value, KeyOfValue, Compare>::iterator
-    rb_tree<Key, Value, KeyOfValue, Compare>::
-    insert_node_at(link_type x, link_type node, bool add_to_left)
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    template <class Aug>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
+    insert_node_at(link_type x, link_type node, bool add_to_left, Aug aug)
     {
-        node->parent = x;
+        node->set_parent(x);
         if (x == header)
         {
             root() = node;
@@ -1295,14 +1695,14 @@ namespace mystl
             if (rightmost() == x)
                 rightmost() = node;
         }
-        rb_tree_reblance(node, header->parent);
+        rb_tree_reblance(node, (base_ptr&)root(), aug);
         ++node_count;
         return iterator(node);
     }
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    typename rb_tree<Key, Value, KeyOfValue, Compare>::iterator
-    rb_tree<Key, Value, KeyOfValue, Compare>::
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
     insert_multi_use_hint(iterator hint, key_type key, link_type node)
     {
         link_type np = (link_type)hint.node;
@@ -1323,9 +1723,9 @@ namespace mystl
     }
 
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    typename rb_tree<Key, Value, KeyOfValue, Compare>::iterator
-    rb_tree<Key, Value, KeyOfValue, Compare>::
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
     insert_unique_use_hint(iterator hint, key_type key, link_type node)
     {
         link_type np = (link_type)hint.node;
@@ -1351,12 +1751,12 @@ namespace mystl
         return insert_node_at(pos.first.first, node, pos.first.second);
     }
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    typename rb_tree<Key, Value, KeyOfValue, Compare>::link_type
-    rb_tree<Key, Value, KeyOfValue, Compare>::__copy(link_type x, link_type p)
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::link_type
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::__copy(link_type x, link_type p)
     {
         link_type top = clone_type(x);
-        top->parent = p;
+        top->set_parent(p);
         try
         {
             if(x->right)
@@ -1367,7 +1767,7 @@ namespace mystl
             {
                 link_type y = clone_type(x);
                 p->left = y;
-                y->parent = p;
+                y->set_parent(p);
                 if (x->right)
                     y->right = __copy(right(x), y);
                 p = y;
@@ -1382,68 +1782,493 @@ namespace mystl
         return top;
     }
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    void rb_tree<Key, Value, KeyOfValue, Compare>::
+    // 根据子树大小向下查找第 k 小的节点, 时间复杂度 O(log n)
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::link_type
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::select_node(size_type k) const
+    {
+        static_assert(rb_tree_has_size<Augment>::value,
+                      "find_by_order needs rb_tree_size_augment");
+        link_type x = root();
+        while (nullptr != x)
+        {
+            size_type ls = rb_tree_subtree_size(x->left);
+            if (k < ls)
+                x = left(x);
+            else if (k == ls)
+                return x;
+            else
+            {
+                k -= ls + 1;
+                x = right(x);
+            }
+        }
+        return header;
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::size_type
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
+    order_of_key(const key_type& key) const
+    {
+        static_assert(rb_tree_has_size<Augment>::value,
+                      "order_of_key needs rb_tree_size_augment");
+        size_type rank = 0;
+        link_type x = root();
+        while (nullptr != x)
+        {
+            if (key_compare(KeyOfValue()(x->value_field), key))
+            {
+                rank += rb_tree_subtree_size(x->left) + 1;
+                x = right(x);
+            }
+            else
+                x = left(x);
+        }
+        return rank;
+    }
+
+    // 检查区间是否有序, strict 为 true 时要求严格递增
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    template <class InputIter>
+    bool rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
+    is_sorted_range(InputIter first, InputIter last, bool strict) const
+    {
+        if (first == last)
+            return true;
+        InputIter next = first;
+        for (++next; next != last; ++first, ++next)
+        {
+            if (strict ? !key_compare(KeyOfValue()(*first), KeyOfValue()(*next))
+                       : key_compare(KeyOfValue()(*next), KeyOfValue()(*first)))
+                return false;
+        }
+        return true;
+    }
+
+    // 由有序区间在空树上建立一棵完全平衡的红黑树, 时间复杂度 O(n)
+    // 按中序顺序依次创建节点, 输入只遍历一次
+    // 平衡后所有空指针位于深度 D 或 D + 1 (D = floor(log2(n))), 将深度为 D 的节点染红,
+    // 其余染黑, 即可使每条路径上的黑节点数相同且没有相邻的红节点
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    template <class InputIter>
+    void rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
+    build_sorted(InputIter first, size_type n)
+    {
+        if (0 == n)
+            return;
+        size_type max_depth = 0;
+        for (size_type m = n; m > 1; m >>= 1)
+            ++max_depth;
+        root() = build_sorted_aux(first, n, 0, max_depth == 0 ? 1 : max_depth, header);
+        root()->set_color(rb_tree_black);
+        leftmost() = rb_tree::minimum(root());
+        rightmost() = rb_tree::maximum(root());
+        node_count = n;
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    template <class InputIter>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::link_type
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
+    build_sorted_aux(InputIter& first, size_type n, size_type depth,
+                     size_type red_depth, link_type p)
+    {
+        if (0 == n)
+            return nullptr;
+        size_type left_n = (n - 1) / 2;
+        link_type l = build_sorted_aux(first, left_n, depth + 1, red_depth, nullptr);
+        link_type x = nullptr;
+        try
+        {
+            x = create_node(*first);
+        }
+        catch (...)
+        {
+            erase_since(l);
+            throw ;
+        }
+        ++first;
+        x->set_color(depth == red_depth ? rb_tree_red : rb_tree_black);
+        x->set_parent(p);
+        x->left = l;
+        if (l) l->set_parent(x);
+        try
+        {
+            x->right = build_sorted_aux(first, n - 1 - left_n, depth + 1, red_depth, x);
+        }
+        catch (...)
+        {
+            erase_since(x);
+            throw ;
+        }
+        Augment()(x);
+        return x;
+    }
+
+    /*****************************************************************************************/
+    // join / split
+
+    // 取出整棵树作为独立的子树, 本树变为空, bh 为取出的树的黑高
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::base_ptr
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::take_root(size_type& bh)
+    {
+        base_ptr x = root();
+        if (x)
+            x->set_parent(nullptr);
+        bh = rb_tree_black_height(x);
+        root() = nullptr;
+        leftmost() = header;
+        rightmost() = header;
+        node_count = 0;
+        return x;
+    }
+
+    // 以有 n 个节点的独立子树 x 作为本树的全部内容
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    void rb_tree<Key, Value, KeyOfValue, Compare, Augment>::reset_root(base_ptr x, size_type n)
+    {
+        root() = (link_type)x;
+        if (x)
+        {
+            x->set_parent(header);
+            leftmost() = rb_tree::minimum(root());
+            rightmost() = rb_tree::maximum(root());
+        }
+        else
+        {
+            leftmost() = header;
+            rightmost() = header;
+        }
+        node_count = n;
+    }
+
+    // 两棵独立子树 l, r 共有 total 个节点, 返回 l 的节点个数
+    // 维护了子树大小时直接读取, 否则数较小的一棵
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::size_type
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::count_left(base_ptr l, base_ptr r, size_type total, std::true_type) const
+    {
+        (void)r, (void)total;
+        return rb_tree_subtree_size(l);
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::size_type
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::count_left(base_ptr l, base_ptr r, size_type total, std::false_type) const
+    {
+        return rb_tree_count_left(l, r, total);
+    }
+
+    // 将黑高为 h 的子树 x 拆成 l 和 r 两部分, l 中的元素都小于 k
+    // extract 为 false 时等于 k 的元素都放入 r
+    // extract 为 true 时等于 k 的节点 (至多一个) 被单独取出放入 mid, r 中的元素都大于 k
+    // 路径上的每个节点都作为 join 的分隔节点被重新利用
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    void rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
+    split_aux(base_ptr x, size_type h, const key_type& k, bool extract,
+              base_ptr& l, size_type& lbh, base_ptr& mid,
+              base_ptr& r, size_type& rbh) const
+    {
+        if (nullptr == x)
+        {
+            l = r = nullptr;
+            lbh = rbh = 0;
+            return;
+        }
+        const bool go_left = key_compare(k, key(x));
+        const bool go_right = !go_left && key_compare(key(x), k);
+        size_type ch = x->color() == rb_tree_black ? h - 1 : h;
+        base_ptr xl = x->left;
+        base_ptr xr = x->right;
+        size_type xlbh = rb_tree_detach(xl, ch);
+        size_type xrbh = rb_tree_detach(xr, ch);
+        if (go_left || (!go_right && !extract))
+        {
+            // x 与右子树都属于 r
+            base_ptr rr = nullptr;
+            size_type rrbh = 0;
+            split_aux(xl, xlbh, k, extract, l, lbh, mid, rr, rrbh);
+            r = rb_tree_join(rr, rrbh, x, xr, xrbh, rbh, Augment());
+        }
+        else if (go_right)
+        {
+            base_ptr ll = nullptr;
+            size_type llbh = 0;
+            split_aux(xr, xrbh, k, extract, ll, llbh, mid, r, rbh);
+            l = rb_tree_join(xl, xlbh, x, ll, llbh, lbh, Augment());
+        }
+        else
+        {
+            x->left = x->right = nullptr;
+            x->set_parent(nullptr);
+            mid = x;
+            l = xl, lbh = xlbh;
+            r = xr, rbh = xrbh;
+        }
+    }
+
+    // 以 a 的根为分隔拆分 b, 再分别合并左右两部分, 两个子问题互不相关, 可以并行执行
+    // 被释放的节点个数累加到 erased 上, 用来计算结果的节点个数
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::base_ptr
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
+    union_aux(base_ptr a, size_type abh, base_ptr b, size_type bbh, size_type& bh,
+              size_type& erased, int depth)
+    {
+        if (nullptr == a)
+        {
+            bh = bbh;
+            return b;
+        }
+        if (nullptr == b)
+        {
+            bh = abh;
+            return a;
+        }
+        const bool fork = depth > 0 && abh + bbh >= kRbTreeParallelBlackHeight;
+        base_ptr l2, mid = nullptr, r2;
+        size_type l2bh, r2bh;
+        split_aux(b, bbh, key(a), true, l2, l2bh, mid, r2, r2bh);
+        if (mid)
+        {
+            destroy_node((link_type)mid);
+            ++erased;
+        }
+        base_ptr al = a->left;
+        base_ptr ar = a->right;
+        size_type albh = rb_tree_detach(al, abh - 1);
+        size_type arbh = rb_tree_detach(ar, abh - 1);
+        base_ptr l, r;
+        size_type lbh, rbh, lerased = 0, rerased = 0;
+        const int next = fork ? depth - 1 : depth;
+        auto do_left = [&] { l = union_aux(al, albh, l2, l2bh, lbh, lerased, next); };
+        auto do_right = [&] { r = union_aux(ar, arbh, r2, r2bh, rbh, rerased, next); };
+        rb_tree_fork_join(fork, do_left, do_right);
+        erased += lerased + rerased;
+        return rb_tree_join(l, lbh, a, r, rbh, bh, Augment());
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::base_ptr
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
+    intersect_aux(base_ptr a, size_type abh, base_ptr b, size_type bbh, size_type& bh,
+                  size_type& erased, int depth)
+    {
+        if (nullptr == a || nullptr == b)
+        {
+            erased += erase_since((link_type)a);
+            erased += erase_since((link_type)b);
+            bh = 0;
+            return nullptr;
+        }
+        const bool fork = depth > 0 && abh + bbh >= kRbTreeParallelBlackHeight;
+        base_ptr l2, mid = nullptr, r2;
+        size_type l2bh, r2bh;
+        split_aux(b, bbh, key(a), true, l2, l2bh, mid, r2, r2bh);
+        base_ptr al = a->left;
+        base_ptr ar = a->right;
+        size_type albh = rb_tree_detach(al, abh - 1);
+        size_type arbh = rb_tree_detach(ar, abh - 1);
+        base_ptr l, r;
+        size_type lbh, rbh, lerased = 0, rerased = 0;
+        const int next = fork ? depth - 1 : depth;
+        auto do_left = [&] { l = intersect_aux(al, albh, l2, l2bh, lbh, lerased, next); };
+        auto do_right = [&] { r = intersect_aux(ar, arbh, r2, r2bh, rbh, rerased, next); };
+        rb_tree_fork_join(fork, do_left, do_right);
+        erased += lerased + rerased + 1;
+        if (mid)
+        {
+            destroy_node((link_type)mid);
+            return rb_tree_join(l, lbh, a, r, rbh, bh, Augment());
+        }
+        destroy_node((link_type)a);
+        return rb_tree_join2(l, lbh, r, rbh, bh, Augment());
+    }
+
+    // 以 b 的根为分隔拆分 a, b 的根以及 a 中与之相等的节点都被释放
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::base_ptr
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
+    difference_aux(base_ptr a, size_type abh, base_ptr b, size_type bbh, size_type& bh,
+                   size_type& erased, int depth)
+    {
+        if (nullptr == a)
+        {
+            erased += erase_since((link_type)b);
+            bh = 0;
+            return nullptr;
+        }
+        if (nullptr == b)
+        {
+            bh = abh;
+            return a;
+        }
+        const bool fork = depth > 0 && abh + bbh >= kRbTreeParallelBlackHeight;
+        base_ptr l1, mid = nullptr, r1;
+        size_type l1bh, r1bh;
+        split_aux(a, abh, key(b), true, l1, l1bh, mid, r1, r1bh);
+        base_ptr bl = b->left;
+        base_ptr br = b->right;
+        size_type blbh = rb_tree_detach(bl, bbh - 1);
+        size_type brbh = rb_tree_detach(br, bbh - 1);
+        destroy_node((link_type)b);
+        ++erased;
+        if (mid)
+        {
+            destroy_node((link_type)mid);
+            ++erased;
+        }
+        base_ptr l, r;
+        size_type lbh, rbh, lerased = 0, rerased = 0;
+        const int next = fork ? depth - 1 : depth;
+        auto do_left = [&] { l = difference_aux(l1, l1bh, bl, blbh, lbh, lerased, next); };
+        auto do_right = [&] { r = difference_aux(r1, r1bh, br, brbh, rbh, rerased, next); };
+        rb_tree_fork_join(fork, do_left, do_right);
+        erased += lerased + rerased;
+        return rb_tree_join2(l, lbh, r, rbh, bh, Augment());
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    void rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
+    split(const key_type& key, rb_tree& right)
+    {
+        right.clear();
+        const size_type n = node_count;
+        size_type bh;
+        base_ptr x = take_root(bh);
+        base_ptr l, mid = nullptr, r;
+        size_type lbh, rbh;
+        split_aux(x, bh, key, false, l, lbh, mid, r, rbh);
+        const size_type ln = count_left(l, r, n, rb_tree_has_size<Augment>());
+        reset_root(l, ln);
+        right.reset_root(r, n - ln);
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    void rb_tree<Key, Value, KeyOfValue, Compare, Augment>::join(rb_tree& right)
+    {
+        if (this == &right || right.empty())
+            return;
+        MYSTL_DEBUG(empty() || !key_compare(KeyOfValue()(right.leftmost()->value_field),
+                                            KeyOfValue()(rightmost()->value_field)));
+        const size_type n = node_count + right.node_count;
+        size_type lbh, rbh, bh;
+        base_ptr l = take_root(lbh);
+        base_ptr r = right.take_root(rbh);
+        reset_root(rb_tree_join2(l, lbh, r, rbh, bh, Augment()), n);
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    void rb_tree<Key, Value, KeyOfValue, Compare, Augment>::union_with(rb_tree& other)
+    {
+        if (this == &other)
+            return;
+        const size_type n = node_count + other.node_count;
+        size_type abh, bbh, bh, erased = 0;
+        base_ptr a = take_root(abh);
+        base_ptr b = other.take_root(bbh);
+        base_ptr x = union_aux(a, abh, b, bbh, bh, erased, rb_tree_fork_depth());
+        reset_root(x, n - erased);
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    void rb_tree<Key, Value, KeyOfValue, Compare, Augment>::intersect_with(rb_tree& other)
+    {
+        if (this == &other)
+            return;
+        const size_type n = node_count + other.node_count;
+        size_type abh, bbh, bh, erased = 0;
+        base_ptr a = take_root(abh);
+        base_ptr b = other.take_root(bbh);
+        base_ptr x = intersect_aux(a, abh, b, bbh, bh, erased, rb_tree_fork_depth());
+        reset_root(x, n - erased);
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    void rb_tree<Key, Value, KeyOfValue, Compare, Augment>::difference_with(rb_tree& other)
+    {
+        if (this == &other)
+        {
+            clear();
+            return;
+        }
+        const size_type n = node_count + other.node_count;
+        size_type abh, bbh, bh, erased = 0;
+        base_ptr a = take_root(abh);
+        base_ptr b = other.take_root(bbh);
+        base_ptr x = difference_aux(a, abh, b, bbh, bh, erased, rb_tree_fork_depth());
+        reset_root(x, n - erased);
+    }
+
+    // 释放以 x 为根的子树, 返回释放的节点个数
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Augment>::size_type
+    rb_tree<Key, Value, KeyOfValue, Compare, Augment>::
     erase_since(link_type x)
     {
+        size_type n = 0;
         while (nullptr != x)
         {
-            erase_since(right(x));
+            n += erase_since(right(x));
             link_type y = left(x);
             destroy_node(x);
+            ++n;
             x = y;
         }
+        return n;
     }
 
     // 重载比较运算符
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    bool operator==(const rb_tree<Key, Value, KeyOfValue, Compare>& lhs,
-                    const rb_tree<Key, Value, KeyOfValue, Compare>& rhs)
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    bool operator==(const rb_tree<Key, Value, KeyOfValue, Compare, Augment>& lhs,
+                    const rb_tree<Key, Value, KeyOfValue, Compare, Augment>& rhs)
     {
         return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
     }
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    bool operator!=(const rb_tree<Key, Value, KeyOfValue, Compare>& lhs,
-                    const rb_tree<Key, Value, KeyOfValue, Compare>& rhs)
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    bool operator!=(const rb_tree<Key, Value, KeyOfValue, Compare, Augment>& lhs,
+                    const rb_tree<Key, Value, KeyOfValue, Compare, Augment>& rhs)
     {
         return !(lhs == rhs);
     }
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    bool operator<(const rb_tree<Key, Value, KeyOfValue, Compare>& lhs,
-                    const rb_tree<Key, Value, KeyOfValue, Compare>& rhs)
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    bool operator<(const rb_tree<Key, Value, KeyOfValue, Compare, Augment>& lhs,
+                    const rb_tree<Key, Value, KeyOfValue, Compare, Augment>& rhs)
     {
         return mystl::lexicographical_compare(lhs.begin(), lhs.end(),
                                               rhs.begin(), rhs.end());
     }
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    bool operator>(const rb_tree<Key, Value, KeyOfValue, Compare>& lhs,
-                   const rb_tree<Key, Value, KeyOfValue, Compare>& rhs)
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    bool operator>(const rb_tree<Key, Value, KeyOfValue, Compare, Augment>& lhs,
+                   const rb_tree<Key, Value, KeyOfValue, Compare, Augment>& rhs)
     {
         return rhs < lhs;
     }
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    bool operator<=(const rb_tree<Key, Value, KeyOfValue, Compare>& lhs,
-                    const rb_tree<Key, Value, KeyOfValue, Compare>& rhs)
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    bool operator<=(const rb_tree<Key, Value, KeyOfValue, Compare, Augment>& lhs,
+                    const rb_tree<Key, Value, KeyOfValue, Compare, Augment>& rhs)
     {
         return !(rhs < lhs);
     }
 
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    bool operator>=(const rb_tree<Key, Value, KeyOfValue, Compare>& lhs,
-                    const rb_tree<Key, Value, KeyOfValue, Compare>& rhs)
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    bool operator>=(const rb_tree<Key, Value, KeyOfValue, Compare, Augment>& lhs,
+                    const rb_tree<Key, Value, KeyOfValue, Compare, Augment>& rhs)
     {
         return !(lhs < rhs);
     }
 
 
-    template <class Key, class Value, class KeyOfValue, class Compare>
-    void swap(rb_tree<Key, Value, KeyOfValue, Compare>& lhs,
-              rb_tree<Key, Value, KeyOfValue, Compare>& rhs)
+    template <class Key, class Value, class KeyOfValue, class Compare, class Augment>
+    void swap(rb_tree<Key, Value, KeyOfValue, Compare, Augment>& lhs,
+              rb_tree<Key, Value, KeyOfValue, Compare, Augment>& rhs)
     {
         lhs.swap(rhs);
     }
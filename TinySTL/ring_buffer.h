@@ -0,0 +1,542 @@
+#ifndef TINYSTL_RING_BUFFER_H
+#define TINYSTL_RING_BUFFER_H
+
+// 这个头文件包含模板类 ring_buffer (别名 circular_buffer)
+// ring_buffer: 固定容量的环形缓冲区, 容量为 2 的幂, 下标通过与 capacity - 1 按位与回绕
+// 元素存放在一整块连续内存中, 不会为每个元素单独分配结点, 可以作为 mystl::queue 的底层容器
+// 缺省情况下向已满的缓冲区插入元素会抛出 length_error, 打开覆盖模式 (set_overwrite(true)) 后改为覆盖最旧的元素
+// push_n / pop_n 批量读写, 数据在环上至多分为两段, 可平凡复制的类型每段使用一次 memcpy
+
+#include <initializer_list>
+
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "algobase.h"
+#include "ring_util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+    // 不指定容量时的缺省容量
+    constexpr size_t ring_buffer_default_capacity = 64;
+
+    // 标记类型, 表示构造函数的参数是容量而不是元素个数, ring_buffer(n) 与其他序列容器一样构造 n 个元素
+    struct ring_buffer_capacity_t
+    {
+        explicit ring_buffer_capacity_t() = default;
+    };
+
+    constexpr ring_buffer_capacity_t ring_buffer_capacity{};
+
+    // 不小于 n 的最小的 2 的幂, 至少为 1
+    inline size_t ring_buffer_round_up(size_t n)
+    {
+        size_t cap = 1;
+        while (cap < n)
+            cap <<= 1;
+        return cap;
+    }
+
+    // ring_buffer 的迭代器, pos 为不回绕的逻辑位置, 解引用时与 mask 按位与
+    template <class T, class Ref, class Ptr>
+    struct ring_buffer_iterator : public mystl::iterator<mystl::random_access_iterator_tag, T>
+    {
+        typedef ring_buffer_iterator<T, T&, T*>             iterator;
+        typedef ring_buffer_iterator<T, const T&, const T*> const_iterator;
+        typedef ring_buffer_iterator                        self;
+
+        typedef T           value_type;
+        typedef Ptr         pointer;
+        typedef Ref         reference;
+        typedef size_t      size_type;
+        typedef ptrdiff_t   difference_type;
+
+        T*        buf;
+        size_type mask;
+        size_type pos;
+
+        ring_buffer_iterator() noexcept : buf(nullptr), mask(0), pos(0) {}
+        ring_buffer_iterator(T* b, size_type m, size_type p) noexcept : buf(b), mask(m), pos(p) {}
+        // iterator 到 const_iterator 的转换, 写成模板使复制构造仍是平凡的
+        template <class It, typename std::enable_if<
+            std::is_same<It, iterator>::value && !std::is_same<It, self>::value, int>::type = 0>
+        ring_buffer_iterator(const It& rhs) noexcept : buf(rhs.buf), mask(rhs.mask), pos(rhs.pos) {}
+
+        reference operator*()  const { return buf[pos & mask]; }
+        pointer   operator->() const { return &(operator*()); }
+        reference operator[](difference_type n) const { return buf[(pos + n) & mask]; }
+
+        self& operator++()    { ++pos; return *this; }
+        self  operator++(int) { self tmp = *this; ++pos; return tmp; }
+        self& operator--()    { --pos; return *this; }
+        self  operator--(int) { self tmp = *this; --pos; return tmp; }
+
+        self& operator+=(difference_type n) { pos += n; return *this; }
+        self& operator-=(difference_type n) { pos -= n; return *this; }
+        self  operator+(difference_type n) const { return self(buf, mask, pos + n); }
+        self  operator-(difference_type n) const { return self(buf, mask, pos - n); }
+
+        difference_type operator-(const self& rhs) const
+        { return static_cast<difference_type>(pos - rhs.pos); }
+
+        bool operator==(const self& rhs) const { return pos == rhs.pos; }
+        bool operator!=(const self& rhs) const { return pos != rhs.pos; }
+        bool operator<(const self& rhs)  const { return static_cast<difference_type>(pos - rhs.pos) < 0; }
+        bool operator>(const self& rhs)  const { return rhs < *this; }
+        bool operator<=(const self& rhs) const { return !(rhs < *this); }
+        bool operator>=(const self& rhs) const { return !(*this < rhs); }
+    };
+
+    template <class T, class Ref, class Ptr>
+    ring_buffer_iterator<T, Ref, Ptr>
+    operator+(ptrdiff_t n, const ring_buffer_iterator<T, Ref, Ptr>& it)
+    {
+        return it + n;
+    }
+
+    // 模板类 ring_buffer
+    // 模板参数表示数据类型
+    template <class T>
+    class ring_buffer
+    {
+    public:
+        typedef mystl::allocator<T>                         allocator_type;
+        typedef mystl::allocator<T>                         data_allocator;
+
+        typedef typename allocator_type::value_type         value_type;
+        typedef typename allocator_type::pointer            pointer;
+        typedef typename allocator_type::const_pointer      const_pointer;
+        typedef typename allocator_type::reference          reference;
+        typedef typename allocator_type::const_reference    const_reference;
+        typedef typename allocator_type::size_type          size_type;
+        typedef typename allocator_type::difference_type    difference_type;
+
+        typedef ring_buffer_iterator<T, T&, T*>             iterator;
+        typedef ring_buffer_iterator<T, const T&, const T*> const_iterator;
+        typedef mystl::reverse_iterator<iterator>           reverse_iterator;
+        typedef mystl::reverse_iterator<const_iterator>     const_reverse_iterator;
+
+        allocator_type get_allocator() { return allocator_type(); }
+
+    private:
+        pointer   buf_;
+        size_type mask_;        // 容量减一
+        size_type head_;        // 第一个元素的逻辑位置, 只增不减, 使用时与 mask_ 按位与
+        size_type tail_;        // 最后一个元素之后的逻辑位置
+        bool      overwrite_;   // 已满时是否覆盖最旧的元素
+
+    public:
+        // 构造、复制、移动、析构函数
+
+        ring_buffer()
+            : buf_(nullptr), mask_(0), head_(0), tail_(0), overwrite_(false)
+        {
+            init(ring_buffer_default_capacity);
+        }
+
+        // 容量向上取整为 2 的幂, 缓冲区为空
+        ring_buffer(ring_buffer_capacity_t, size_type capacity)
+            : buf_(nullptr), mask_(0), head_(0), tail_(0), overwrite_(false)
+        {
+            init(capacity);
+        }
+
+        // n 个值初始化的元素, 容量为不小于 n 的 2 的幂
+        explicit ring_buffer(size_type n)
+            : ring_buffer(n, value_type())
+        {
+        }
+
+        ring_buffer(size_type n, const value_type& value)
+            : buf_(nullptr), mask_(0), head_(0), tail_(0), overwrite_(false)
+        {
+            init(n);
+            mystl::uninitialized_fill_n(buf_, n, value);
+            tail_ = n;
+        }
+
+        template <class Iter, typename std::enable_if<
+                mystl::is_input_iterator<Iter>::value, int>::type = 0>
+        ring_buffer(Iter first, Iter last)
+            : buf_(nullptr), mask_(0), head_(0), tail_(0), overwrite_(false)
+        {
+            range_init(first, last);
+        }
+
+        ring_buffer(std::initializer_list<value_type> ilist)
+            : buf_(nullptr), mask_(0), head_(0), tail_(0), overwrite_(false)
+        {
+            range_init(ilist.begin(), ilist.end());
+        }
+
+        ring_buffer(const ring_buffer& rhs)
+            : buf_(nullptr), mask_(0), head_(0), tail_(0), overwrite_(rhs.overwrite_)
+        {
+            init(rhs.capacity());
+            copy_from(rhs);
+        }
+
+        ring_buffer(ring_buffer&& rhs) noexcept
+            : buf_(rhs.buf_), mask_(rhs.mask_), head_(rhs.head_), tail_(rhs.tail_),
+              overwrite_(rhs.overwrite_)
+        {
+            rhs.buf_ = nullptr;
+            rhs.mask_ = 0;
+            rhs.head_ = rhs.tail_ = 0;
+        }
+
+        ring_buffer& operator=(const ring_buffer& rhs)
+        {
+            if (this != &rhs)
+            {
+                ring_buffer tmp(rhs);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        ring_buffer& operator=(ring_buffer&& rhs) noexcept
+        {
+            ring_buffer tmp(mystl::move(rhs));
+            swap(tmp);
+            return *this;
+        }
+
+        ring_buffer& operator=(std::initializer_list<value_type> ilist)
+        {
+            ring_buffer tmp(ilist);
+            tmp.overwrite_ = overwrite_;
+            swap(tmp);
+            return *this;
+        }
+
+        ~ring_buffer()
+        {
+            clear();
+            data_allocator::deallocate(buf_, capacity());
+            buf_ = nullptr;
+        }
+
+    public:
+        // 迭代器相关操作
+        iterator       begin()       noexcept { return iterator(buf_, mask_, head_); }
+        const_iterator begin() const noexcept { return const_iterator(buf_, mask_, head_); }
+        iterator       end()         noexcept { return iterator(buf_, mask_, tail_); }
+        const_iterator end()   const noexcept { return const_iterator(buf_, mask_, tail_); }
+
+        reverse_iterator       rbegin()       noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        reverse_iterator       rend()         noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend()   const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator         cbegin()  const noexcept { return begin(); }
+        const_iterator         cend()    const noexcept { return end(); }
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+        const_reverse_iterator crend()   const noexcept { return rend(); }
+
+        // 容量相关操作
+        bool      empty()    const noexcept { return head_ == tail_; }
+        bool      full()     const noexcept { return size() == capacity(); }
+        size_type size()     const noexcept { return tail_ - head_; }
+        size_type capacity() const noexcept { return buf_ == nullptr ? 0 : mask_ + 1; }
+        size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(T); }
+
+        bool overwrite() const noexcept { return overwrite_; }
+        void set_overwrite(bool on) noexcept { overwrite_ = on; }
+
+        // 访问元素相关操作
+        reference operator[](size_type n)
+        {
+            MYSTL_DEBUG(n < size());
+            return buf_[(head_ + n) & mask_];
+        }
+        const_reference operator[](size_type n) const
+        {
+            MYSTL_DEBUG(n < size());
+            return buf_[(head_ + n) & mask_];
+        }
+
+        reference at(size_type n)
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "ring_buffer<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+        const_reference at(size_type n) const
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "ring_buffer<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+
+        reference front()
+        {
+            MYSTL_DEBUG(!empty());
+            return buf_[head_ & mask_];
+        }
+        const_reference front() const
+        {
+            MYSTL_DEBUG(!empty());
+            return buf_[head_ & mask_];
+        }
+        reference back()
+        {
+            MYSTL_DEBUG(!empty());
+            return buf_[(tail_ - 1) & mask_];
+        }
+        const_reference back() const
+        {
+            MYSTL_DEBUG(!empty());
+            return buf_[(tail_ - 1) & mask_];
+        }
+
+        // 修改容器相关操作
+
+        template <class ...Args>
+        void emplace_back(Args&& ...args)
+        {
+            if (full())
+            {
+                THROW_LENGTH_ERROR_IF(!overwrite_, "ring_buffer<T>'s size too big");
+                if (capacity() == 0)
+                    return;
+                // 参数可能引用将被覆盖的元素 (如 push_back(front())), 先构造出新元素再删除旧元素
+                value_type tmp(mystl::forward<Args>(args)...);
+                pop_front();
+                data_allocator::construct(buf_ + (tail_ & mask_), mystl::move(tmp));
+                ++tail_;
+                return;
+            }
+            data_allocator::construct(buf_ + (tail_ & mask_), mystl::forward<Args>(args)...);
+            ++tail_;
+        }
+
+        // 覆盖模式下从头部插入时, 被覆盖的是尾部的元素
+        template <class ...Args>
+        void emplace_front(Args&& ...args)
+        {
+            if (full())
+            {
+                THROW_LENGTH_ERROR_IF(!overwrite_, "ring_buffer<T>'s size too big");
+                if (capacity() == 0)
+                    return;
+                value_type tmp(mystl::forward<Args>(args)...);
+                pop_back();
+                data_allocator::construct(buf_ + ((head_ - 1) & mask_), mystl::move(tmp));
+                --head_;
+                return;
+            }
+            data_allocator::construct(buf_ + ((head_ - 1) & mask_), mystl::forward<Args>(args)...);
+            --head_;
+        }
+
+        void push_back(const value_type& value)  { emplace_back(value); }
+        void push_back(value_type&& value)       { emplace_back(mystl::move(value)); }
+        void push_front(const value_type& value) { emplace_front(value); }
+        void push_front(value_type&& value)      { emplace_front(mystl::move(value)); }
+
+        void pop_front()
+        {
+            MYSTL_DEBUG(!empty());
+            data_allocator::destroy(buf_ + (head_ & mask_));
+            ++head_;
+        }
+
+        void pop_back()
+        {
+            MYSTL_DEBUG(!empty());
+            --tail_;
+            data_allocator::destroy(buf_ + (tail_ & mask_));
+        }
+
+        // 批量写入 [first, first + n), 返回写入的元素个数
+        // 非覆盖模式下至多写满剩余空间; 覆盖模式下全部写入, 必要时丢弃最旧的元素
+        size_type push_n(const value_type* first, size_type n);
+
+        // 从头部批量取出至多 n 个元素, 依次移动赋值给 result 开始的区间, 返回取出的元素个数
+        size_type pop_n(value_type* result, size_type n);
+
+        void clear()
+        {
+            destroy_range(head_, tail_);
+            head_ = tail_ = 0;
+        }
+
+        void swap(ring_buffer& rhs) noexcept
+        {
+            mystl::swap(buf_, rhs.buf_);
+            mystl::swap(mask_, rhs.mask_);
+            mystl::swap(head_, rhs.head_);
+            mystl::swap(tail_, rhs.tail_);
+            mystl::swap(overwrite_, rhs.overwrite_);
+        }
+
+    private:
+        void init(size_type capacity)
+        {
+            const size_type cap = ring_buffer_round_up(capacity);
+            buf_ = data_allocator::allocate(cap);
+            mask_ = cap - 1;
+        }
+
+        template <class Iter>
+        void range_init(Iter first, Iter last)
+        {
+            init(mystl::distance(first, last));
+            try
+            {
+                for (; first != last; ++first)
+                {
+                    data_allocator::construct(buf_ + (tail_ & mask_), *first);
+                    ++tail_;
+                }
+            }
+            catch (...)
+            {
+                clear();
+                data_allocator::deallocate(buf_, capacity());
+                buf_ = nullptr;
+                throw;
+            }
+        }
+
+        void copy_from(const ring_buffer& rhs)
+        {
+            for (auto it = rhs.begin(); it != rhs.end(); ++it)
+            {
+                data_allocator::construct(buf_ + (tail_ & mask_), *it);
+                ++tail_;
+            }
+        }
+
+        // 逻辑位置 [from, to) 在环上对应的至多两段
+        void segments(size_type from, size_type to, pointer& p1, size_type& n1,
+                      pointer& p2, size_type& n2) const
+        {
+            const size_type n = to - from;
+            const size_type off = from & mask_;
+            n1 = mystl::min(n, capacity() - off);
+            n2 = n - n1;
+            p1 = buf_ + off;
+            p2 = buf_;
+        }
+
+        void destroy_range(size_type from, size_type to)
+        {
+            if (from == to)
+                return;
+            pointer p1, p2;
+            size_type n1, n2;
+            segments(from, to, p1, n1, p2, n2);
+            mystl::destroy(p1, p1 + n1);
+            mystl::destroy(p2, p2 + n2);
+        }
+    };
+
+    /*****************************************************************************************/
+
+    template <class T>
+    typename ring_buffer<T>::size_type
+    ring_buffer<T>::push_n(const value_type* first, size_type n)
+    {
+        const size_type cap = capacity();
+        size_type written = n;
+        if (n > cap - size())
+        {
+            if (!overwrite_)
+            {
+                n = cap - size();
+                written = n;
+            }
+            else
+            {
+                // 只有最后 cap 个元素会留下, 其余旧元素全部丢弃
+                if (n > cap)
+                {
+                    first += n - cap;
+                    n = cap;
+                }
+                const size_type drop = n - (cap - size());
+                destroy_range(head_, head_ + drop);
+                head_ += drop;
+            }
+        }
+        pointer p1, p2;
+        size_type n1, n2;
+        segments(tail_, tail_ + n, p1, n1, p2, n2);
+        mystl::ring_copy_in(p1, first, n1);
+        try
+        {
+            mystl::ring_copy_in(p2, first + n1, n2);
+        }
+        catch (...)
+        {
+            mystl::destroy(p1, p1 + n1);
+            throw;
+        }
+        tail_ += n;
+        return written;
+    }
+
+    template <class T>
+    typename ring_buffer<T>::size_type
+    ring_buffer<T>::pop_n(value_type* result, size_type n)
+    {
+        n = mystl::min(n, size());
+        pointer p1, p2;
+        size_type n1, n2;
+        segments(head_, head_ + n, p1, n1, p2, n2);
+        mystl::ring_move_out(result, p1, n1);
+        mystl::ring_move_out(result + n1, p2, n2);
+        head_ += n;
+        return n;
+    }
+
+    // 重载比较操作符
+    template <class T>
+    bool operator==(const ring_buffer<T>& lhs, const ring_buffer<T>& rhs)
+    {
+        return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class T>
+    bool operator!=(const ring_buffer<T>& lhs, const ring_buffer<T>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T>
+    bool operator<(const ring_buffer<T>& lhs, const ring_buffer<T>& rhs)
+    {
+        return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template <class T>
+    bool operator>(const ring_buffer<T>& lhs, const ring_buffer<T>& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template <class T>
+    bool operator<=(const ring_buffer<T>& lhs, const ring_buffer<T>& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template <class T>
+    bool operator>=(const ring_buffer<T>& lhs, const ring_buffer<T>& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+    template <class T>
+    void swap(ring_buffer<T>& lhs, ring_buffer<T>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    // boost 风格的别名
+    template <class T>
+    using circular_buffer = ring_buffer<T>;
+} // namespace mystl
+
+#endif //TINYSTL_RING_BUFFER_H
@@ -0,0 +1,64 @@
+#ifndef TINYSTL_RING_UTIL_H
+#define TINYSTL_RING_UTIL_H
+
+// 这个头文件包含环形缓冲区类容器 (ring_buffer, spsc_queue) 共用的辅助函数和常量
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "type_traits.h"
+#include "util.h"
+#include "construct.h"
+#include "algobase.h"
+#include "uninitialized.h"
+
+namespace mystl
+{
+    // 缓存行大小, 并发结构用它把不同线程写的数据隔开
+    constexpr size_t cache_line_size = 64;
+
+    // 把 [src, src + n) 复制到未初始化的 dst
+    // 可平凡复制的类型用 memcpy, 否则逐个构造
+    template <class T>
+    void ring_copy_in(T* dst, const T* src, size_t n, m_true_type)
+    {
+        if (n != 0)
+            std::memcpy(dst, src, n * sizeof(T));
+    }
+
+    template <class T>
+    void ring_copy_in(T* dst, const T* src, size_t n, m_false_type)
+    {
+        mystl::uninitialized_copy(src, src + n, dst);
+    }
+
+    template <class T>
+    void ring_copy_in(T* dst, const T* src, size_t n)
+    {
+        ring_copy_in(dst, src, n, m_bool_constant<std::is_trivially_copyable<T>::value>());
+    }
+
+    // 把 [src, src + n) 移动赋值给 dst 后析构源元素
+    template <class T>
+    void ring_move_out(T* dst, T* src, size_t n, m_true_type)
+    {
+        if (n != 0)
+            std::memcpy(dst, src, n * sizeof(T));
+    }
+
+    template <class T>
+    void ring_move_out(T* dst, T* src, size_t n, m_false_type)
+    {
+        mystl::move(src, src + n, dst);
+        mystl::destroy(src, src + n);
+    }
+
+    template <class T>
+    void ring_move_out(T* dst, T* src, size_t n)
+    {
+        ring_move_out(dst, src, n, m_bool_constant<std::is_trivially_copyable<T>::value>());
+    }
+} // namespace mystl
+
+#endif //TINYSTL_RING_UTIL_H
@@ -14,8 +14,9 @@
 namespace mystl
 {
 
-    // 模板类 set<Key, Compare> 以 rb_tree_ 作为底层容器, 键值不允许重复
-    template <class Key, class Compare = mystl::less<Key>>
+    // 模板类 set<Key, Compare, Augment> 以 rb_tree_ 作为底层容器, 键值不允许重复
+    // Augment 为节点附加信息的维护方式, 取 rb_tree_size_augment 时支持顺序统计
+    template <class Key, class Compare = mystl::less<Key>, class Augment = mystl::rb_tree_no_augment>
     class set
     {
     public:
@@ -26,7 +27,7 @@ namespace mystl
 
     protected:
         typedef mystl::rb_tree<key_type, value_type,
-                                mystl::identity<value_type>, key_compare> rep_type;
+                                mystl::identity<value_type>, key_compare, Augment> rep_type;
         typedef typename rep_type::iterator                 rep_iterator;
         rep_type tree_;
     public:
@@ -51,33 +52,39 @@ namespace mystl
             : tree_()
         { tree_.insert_unique(first, last); }
 
+        // 调用者保证 [first, last) 严格递增, O(n) 建树
+        template <class InputIter>
+        set(mystl::sorted_unique_t, InputIter first, InputIter last)
+            : tree_()
+        { tree_.assign_sorted_unique(first, last); }
+
         set(std::initializer_list<value_type>ilist)
             : tree_()
         { tree_.insert_unique(ilist.begin(), ilist.end()); }
 
-        set(const set<Key>& other)
+        set(const set& other)
             : tree_(other.tree_)
         {
         }
 
-        set(set<Key>&& other) noexcept
+        set(set&& other) noexcept
             : tree_(mystl::move(other.tree_))
         {
         }
 
-        set<Key>& operator=(const set<Key>& rhs)
+        set& operator=(const set& rhs)
         {
             tree_ = rhs.tree_;
             return *this;
         }
 
-        set<Key>& operator=(set<Key>&& rhs)
+        set& operator=(set&& rhs)
         {
             tree_ = mystl::move(rhs.tree_);
             return *this;
         }
 
-        set<Key>& operator=(std::initializer_list<value_type> ilist)
+        set& operator=(std::initializer_list<value_type> ilist)
         {
             tree_.clear();
             tree_.insert_unique(ilist.begin(), ilist.end());
@@ -166,6 +173,10 @@ namespace mystl
         iterator        upper_bound(const key_type& key)       { return tree_.upper_bound(key); }
         const_reference upper_bound(const key_type& key) const { return tree_.upper_bound(key); }
 
+        // 顺序统计, O(log n), 需要 Augment 为 rb_tree_size_augment
+        iterator        find_by_order(size_type k)       const { return tree_.find_by_order(k); }
+        size_type       order_of_key(const key_type& key) const { return tree_.order_of_key(key); }
+
         pair<iterator, iterator>
         equal_range(const key_type& key)
         { return tree_.equal_range_unique(key); }
@@ -174,21 +185,29 @@ namespace mystl
         equal_range(const key_type& key) const
         { return tree_.equal_range_unique(key); }
 
-        void swap(set<Key>& rhs) noexcept
+        // join / split 与集合运算, 节点在两个 set 之间转移, 不分配新节点
+        // 运算结果保存在本 set 中, 除 split 外参数 set 在调用后为空
+        void split(const key_type& key, set& right) { tree_.split(key, right.tree_); }
+        void join(set& right)                       { tree_.join(right.tree_); }
+        void union_with(set& other)                 { tree_.union_with(other.tree_); }
+        void intersect_with(set& other)             { tree_.intersect_with(other.tree_); }
+        void difference_with(set& other)            { tree_.difference_with(other.tree_); }
+
+        void swap(set& rhs) noexcept
         { tree_.swap(rhs.tree_); }
 
     public:
-        bool operator==(const set<Key>& rhs) { return tree_ == rhs.tree_; }
-        bool operator<(const set<Key>& rhs)  { return tree_ < rhs.tree_; }
+        bool operator==(const set& rhs) { return tree_ == rhs.tree_; }
+        bool operator<(const set& rhs)  { return tree_ < rhs.tree_; }
 
-        bool operator!=(const set<Key>& rhs) { return !(*this == rhs); }
-        bool operator>(const set<Key>& rhs)  { return rhs < *this; }
-        bool operator<=(const set<Key>& rhs) { return !(rhs < *this); }
-        bool operator>=(const set<Key>& rhs) { return !(*this < rhs); }
+        bool operator!=(const set& rhs) { return !(*this == rhs); }
+        bool operator>(const set& rhs)  { return rhs < *this; }
+        bool operator<=(const set& rhs) { return !(rhs < *this); }
+        bool operator>=(const set& rhs) { return !(*this < rhs); }
     };
 
     // 模板类 multiset 键值允许重复
-    template <class Key, class Compare = mystl::less<Key>>
+    template <class Key, class Compare = mystl::less<Key>, class Augment = mystl::rb_tree_no_augment>
     class multiset
     {
     public:
@@ -199,7 +218,7 @@ namespace mystl
 
     protected:
         typedef mystl::rb_tree<key_type, value_type,
-                                mystl::identity<value_type>, key_compare> rep_type;
+                                mystl::identity<value_type>, key_compare, Augment> rep_type;
         typedef typename rep_type::iterator                 rept_iterator;
         rep_type tree_;
     public:
@@ -227,29 +246,29 @@ namespace mystl
             : tree_()
         { tree_.insert_multi(ilist.begin(), ilist.end()); }
 
-        multiset(const multiset<Key>& other)
+        multiset(const multiset& other)
             : tree_(other.tree_)
         {
         }
 
-        multiset(multiset<Key>&& other) noexcept
+        multiset(multiset&& other) noexcept
             : tree_(mystl::move(other.tree_))
         {
         }
 
-        multiset<Key>& operator=(const multiset<Key>& rhs)
+        multiset& operator=(const multiset& rhs)
         {
             tree_ = rhs.tree_;
             return *this;
         }
 
-        multiset<Key>& operator=(multiset<Key>&& rhs)
+        multiset& operator=(multiset&& rhs)
         {
             tree_ = mystl::move(rhs.tree_);
             return *this;
         }
 
-        multiset<Key>& operator=(std::initializer_list<value_type> ilist)
+        multiset& operator=(std::initializer_list<value_type> ilist)
         {
             tree_.clear();
             tree_.insert_multi(ilist.begin(), ilist.end());
@@ -337,6 +356,10 @@ namespace mystl
         iterator        upper_bound(const key_type& key)       { return tree_.upper_bound(key); }
         const_reference upper_bound(const key_type& key) const { return tree_.upper_bound(key); }
 
+        // 顺序统计, O(log n), 需要 Augment 为 rb_tree_size_augment
+        iterator        find_by_order(size_type k)       const { return tree_.find_by_order(k); }
+        size_type       order_of_key(const key_type& key) const { return tree_.order_of_key(key); }
+
         pair<iterator, iterator>
         equal_range(const key_type& key)
         { return tree_.equal_range_multi(key); }
@@ -345,17 +368,21 @@ namespace mystl
         equal_range(const key_type& key) const
         { return tree_.equal_range_multi(key); }
 
-        void swap(multiset<Key>& rhs) noexcept
+        // split 后本 multiset 保留小于 key 的元素; join 要求本 multiset 的元素都不大于 right 的元素
+        void split(const key_type& key, multiset& right) { tree_.split(key, right.tree_); }
+        void join(multiset& right)                       { tree_.join(right.tree_); }
+
+        void swap(multiset& rhs) noexcept
         { tree_.swap(rhs.tree_); }
 
     public:
-        bool operator==(const multiset<Key>& rhs) { return tree_ == rhs.tree_; }
-        bool operator<(const multiset<Key>& rhs)  { return tree_ < rhs.tree_; }
+        bool operator==(const multiset& rhs) { return tree_ == rhs.tree_; }
+        bool operator<(const multiset& rhs)  { return tree_ < rhs.tree_; }
 
-        bool operator!=(const multiset<Key>& rhs) { return !(*this == rhs); }
-        bool operator>(const multiset<Key>& rhs)  { return rhs < *this; }
-        bool operator<=(const multiset<Key>& rhs) { return !(rhs < *this); }
-        bool operator>=(const multiset<Key>& rhs) { return !(*this < rhs); }
+        bool operator!=(const multiset& rhs) { return !(*this == rhs); }
+        bool operator>(const multiset& rhs)  { return rhs < *this; }
+        bool operator<=(const multiset& rhs) { return !(rhs < *this); }
+        bool operator>=(const multiset& rhs) { return !(*this < rhs); }
     };
 }
 
@@ -566,8 +566,21 @@ namespace mystl
 
         void remove(const value_type& val);
         void unique();
-        void merge(slist& other);
-        void sort();
+        void merge(slist& other)
+        { merge(other, mystl::less<T>()); }
+        template <class Compared>
+        void merge(slist& other, Compared comp);
+
+        void sort()
+        { sort(mystl::less<T>()); }
+        template <class Compared>
+        void sort(Compared comp);
+
+    private:
+
+        template <class Compared>
+        static void merge_runs(list_node_base* a, list_node_base* b,
+                               Compared& comp, list_node_base*& result);
     };
 
     template <class T>
@@ -650,50 +663,139 @@ namespace mystl
         lhs.swap(rhs);
     }
 
+    // 合并两条以 nullptr 结尾的有序链, 结果写入 result, 相等时 a 中的节点在前
+    // 只在切换来源时修改 next 指针; comp 抛出异常时把另一条链接在后面, 节点不会丢失
     template <class T>
-    void slist<T>::merge(slist<T>& other)
+    template <class Compared>
+    void slist<T>::merge_runs(list_node_base* a, list_node_base* b,
+                              Compared& comp, list_node_base*& result)
     {
-        list_node_base* n1 = head_;
-        while (n1->next && other.head_->next)
+        result = a != nullptr ? a : b;
+        if (a == nullptr || b == nullptr)
+            return;
+        bool from_a = true;
+        try
         {
-            if (((list_node*)(other.head_->next))->data <
-                ((list_node*)(n1->next))->data)
-                slist_splice_after(n1, other.head_, other.head_->next);
-            n1 = n1->next;
+            if (comp(((list_node*)b)->data, ((list_node*)a)->data))
+            {
+                result = b;
+                from_a = false;
+            }
+            while (true)
+            {
+                list_node_base* tail;
+                if (from_a)
+                {
+                    do
+                    {
+                        tail = a;
+                        a = a->next;
+                    } while (a && !comp(((list_node*)b)->data, ((list_node*)a)->data));
+                    tail->next = b;
+                    if (a == nullptr)
+                        return;
+                }
+                else
+                {
+                    do
+                    {
+                        tail = b;
+                        b = b->next;
+                    } while (b && comp(((list_node*)b)->data, ((list_node*)a)->data));
+                    tail->next = a;
+                    if (b == nullptr)
+                        return;
+                }
+                from_a = !from_a;
+            }
         }
-        if (other.head_->next)
+        catch (...)
         {
-            n1->next = other.head_->next;
-            other.head_->next = nullptr;
+            list_node_base* t = result;
+            while (t->next)
+                t = t->next;
+            t->next = from_a ? b : a;
+            throw;
         }
     }
 
+    // 将有序的 other 合并进来, other 变为空
     template <class T>
-    void slist<T>::sort()
+    template <class Compared>
+    void slist<T>::merge(slist<T>& other, Compared comp)
     {
-        if (head_->next && head_->next->next)
-        {
-            slist<T> carry;
-            slist<T> counter[64];
-            int fill = 0;
-            while (!empty())
+        if (this == &other)
+            return;
+        list_node_base* a = head_->next;
+        list_node_base* b = other.head_->next;
+        head_->next = nullptr;
+        other.head_->next = nullptr;
+        size_ += other.size_;
+        other.size_ = 0;
+        merge_runs(a, b, comp, head_->next);
+    }
+
+    // 自底向上的归并排序, 是稳定的
+    // 每次取下一个节点与 runs[0], runs[1], ... 依次合并, 直到遇到空位, runs[i] 的长度为 2^i,
+    // 最后把所有 run 合并起来; 只操作节点指针, 不需要额外的 slist 对象
+    template <class T>
+    template <class Compared>
+    void slist<T>::sort(Compared comp)
+    {
+        if (head_->next == nullptr || head_->next->next == nullptr)
+            return;
+        list_node_base* runs[64] = {};
+        size_t fill = 0;
+        list_node_base* rest = head_->next;
+        list_node_base* carry = nullptr;
+        list_node_base* result = nullptr;
+        head_->next = nullptr;
+        try
+        {
+            while (rest)
             {
-                slist_splice_after(carry.head_, head_, head_->next);
-                int i = 0;
-                while (i < fill && !counter[i].empty())
-                {
-                    counter[i].merge(carry);
-                    carry.swap(counter[i]);
-                    ++i;
+                carry = rest;
+                rest = rest->next;
+                carry->next = nullptr;
+                size_t i = 0;
+                for (; i < fill && runs[i]; ++i)
+                { // runs[i] 中的节点在 carry 之前
+                    list_node_base* run = runs[i];
+                    runs[i] = nullptr;
+                    merge_runs(run, carry, comp, carry);
                 }
-                carry.swap(counter[i]);
+                runs[i] = carry;
+                carry = nullptr;
                 if (i == fill)
                     ++fill;
             }
-            for (int i = 1; i < fill; ++i)
-                counter[i].merge(counter[i - 1]);
-            this->swap(counter[fill - 1]);
+            for (size_t i = 0; i < fill; ++i)
+            {
+                if (runs[i])
+                {
+                    list_node_base* run = runs[i];
+                    runs[i] = nullptr;
+                    merge_runs(run, result, comp, result);
+                }
+            }
+        }
+        catch (...)
+        { // 把所有节点重新接回 slist, 顺序不确定
+            list_node_base* chains[3] = { carry, result, rest };
+            for (size_t i = 0; i < fill + 3; ++i)
+            {
+                list_node_base* c = i < fill ? runs[i] : chains[i - fill];
+                if (c == nullptr)
+                    continue;
+                list_node_base* t = c;
+                while (t->next)
+                    t = t->next;
+                t->next = head_->next;
+                head_->next = c;
+            }
+            throw;
         }
+        head_->next = result;
     }
 };
 
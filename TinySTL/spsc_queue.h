@@ -0,0 +1,188 @@
+#ifndef TINYSTL_SPSC_QUEUE_H
+#define TINYSTL_SPSC_QUEUE_H
+
+// 这个头文件包含模板类 spsc_queue (单生产者单消费者的有界无锁队列)
+// 元素存放在容量为 2 的幂的环形数组中, tail_ 只由生产者写, head_ 只由消费者写, 两者都只增不减
+// 生产者以 release 发布 tail_, 消费者以 acquire 读到后即可看到元素; head_ 同理, 保证槽位被读完后才会被覆盖
+// 生产者与消费者各自的数据放在不同的缓存行上, 避免伪共享
+// 每一方都缓存对方的下标, 只有根据缓存判断队列已满 (已空) 时才去读对方的缓存行
+// push_n / pop_n 一次发布一批元素, 每批只需一次原子写
+
+#include <atomic>
+
+#include "memory.h"
+#include "util.h"
+#include "ring_util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+    // 模板类 spsc_queue
+    // 模板参数表示数据类型, 同一时刻只能有一个线程 push, 一个线程 pop
+    template <class T>
+    class spsc_queue
+    {
+    public:
+        typedef mystl::allocator<T>                         data_allocator;
+
+        typedef T                                           value_type;
+        typedef T*                                          pointer;
+        typedef T&                                          reference;
+        typedef const T&                                    const_reference;
+        typedef size_t                                      size_type;
+
+    private:
+        char                    pad0_[cache_line_size];
+        // 两个线程都只读的数据
+        pointer                 buf_;
+        size_type               mask_;
+        char                    pad1_[cache_line_size];
+        // 生产者的缓存行
+        std::atomic<size_type>  tail_;          // 下一个写入的位置
+        size_type               head_cache_;    // 生产者上次读到的 head_
+        char                    pad2_[cache_line_size];
+        // 消费者的缓存行
+        std::atomic<size_type>  head_;          // 下一个读出的位置
+        size_type               tail_cache_;    // 消费者上次读到的 tail_
+        char                    pad3_[cache_line_size];
+
+    public:
+        // 容量向上取整为 2 的幂
+        explicit spsc_queue(size_type capacity)
+            : buf_(nullptr), mask_(0), tail_(0), head_cache_(0), head_(0), tail_cache_(0)
+        {
+            size_type cap = 1;
+            while (cap < capacity)
+                cap <<= 1;
+            buf_ = data_allocator::allocate(cap);
+            mask_ = cap - 1;
+        }
+
+        spsc_queue(const spsc_queue&) = delete;
+        spsc_queue& operator=(const spsc_queue&) = delete;
+
+        ~spsc_queue()
+        {
+            const size_type tail = tail_.load(std::memory_order_relaxed);
+            for (size_type h = head_.load(std::memory_order_relaxed); h != tail; ++h)
+                data_allocator::destroy(buf_ + (h & mask_));
+            data_allocator::deallocate(buf_, capacity());
+        }
+
+    public:
+        size_type capacity() const noexcept { return mask_ + 1; }
+
+        // 其他线程调用时结果只是一个近似值
+        size_type size() const noexcept
+        {
+            const size_type head = head_.load(std::memory_order_acquire);
+            return tail_.load(std::memory_order_acquire) - head;
+        }
+
+        bool empty() const noexcept { return size() == 0; }
+
+    public:
+        // 以下由生产者调用
+
+        // 队列已满时返回 false
+        template <class ...Args>
+        bool try_emplace(Args&& ...args)
+        {
+            const size_type tail = tail_.load(std::memory_order_relaxed);
+            if (tail - head_cache_ == capacity())
+            {
+                head_cache_ = head_.load(std::memory_order_acquire);
+                if (tail - head_cache_ == capacity())
+                    return false;
+            }
+            data_allocator::construct(buf_ + (tail & mask_), mystl::forward<Args>(args)...);
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool try_push(const value_type& value) { return try_emplace(value); }
+        bool try_push(value_type&& value)      { return try_emplace(mystl::move(value)); }
+
+        // 写入 [first, first + n) 中能放下的部分, 返回写入的个数
+        size_type push_n(const value_type* first, size_type n)
+        {
+            const size_type tail = tail_.load(std::memory_order_relaxed);
+            if (capacity() - (tail - head_cache_) < n)
+                head_cache_ = head_.load(std::memory_order_acquire);
+            n = mystl::min(n, capacity() - (tail - head_cache_));
+            const size_type off = tail & mask_;
+            const size_type n1 = mystl::min(n, capacity() - off);
+            mystl::ring_copy_in(buf_ + off, first, n1);
+            try
+            {
+                mystl::ring_copy_in(buf_, first + n1, n - n1);
+            }
+            catch (...)
+            {
+                mystl::destroy(buf_ + off, buf_ + off + n1);
+                throw;
+            }
+            tail_.store(tail + n, std::memory_order_release);
+            return n;
+        }
+
+    public:
+        // 以下由消费者调用
+
+        // 队列为空时返回 false
+        bool try_pop(value_type& value)
+        {
+            const size_type head = head_.load(std::memory_order_relaxed);
+            if (head == tail_cache_)
+            {
+                tail_cache_ = tail_.load(std::memory_order_acquire);
+                if (head == tail_cache_)
+                    return false;
+            }
+            pointer slot = buf_ + (head & mask_);
+            value = mystl::move(*slot);
+            data_allocator::destroy(slot);
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 队首元素的地址, 队列为空时返回 nullptr, 元素在 pop 之前一直有效
+        pointer front()
+        {
+            const size_type head = head_.load(std::memory_order_relaxed);
+            if (head == tail_cache_)
+            {
+                tail_cache_ = tail_.load(std::memory_order_acquire);
+                if (head == tail_cache_)
+                    return nullptr;
+            }
+            return buf_ + (head & mask_);
+        }
+
+        // 丢弃队首元素, 须在 front() 返回非空之后调用
+        void pop()
+        {
+            const size_type head = head_.load(std::memory_order_relaxed);
+            MYSTL_DEBUG(head != tail_cache_);
+            data_allocator::destroy(buf_ + (head & mask_));
+            head_.store(head + 1, std::memory_order_release);
+        }
+
+        // 取出至多 n 个元素, 依次移动赋值给 result 开始的区间, 返回取出的个数
+        size_type pop_n(value_type* result, size_type n)
+        {
+            const size_type head = head_.load(std::memory_order_relaxed);
+            if (tail_cache_ - head < n)
+                tail_cache_ = tail_.load(std::memory_order_acquire);
+            n = mystl::min(n, tail_cache_ - head);
+            const size_type off = head & mask_;
+            const size_type n1 = mystl::min(n, capacity() - off);
+            mystl::ring_move_out(result, buf_ + off, n1);
+            mystl::ring_move_out(result + n1, buf_, n - n1);
+            head_.store(head + n, std::memory_order_release);
+            return n;
+        }
+    };
+} // namespace mystl
+
+#endif //TINYSTL_SPSC_QUEUE_H
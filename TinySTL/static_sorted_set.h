@@ -0,0 +1,409 @@
+#ifndef TINYSTL_STATIC_SORTED_SET_H
+#define TINYSTL_STATIC_SORTED_SET_H
+
+// 这个头文件包含模板类 static_sorted_set (只读有序集合)
+// 构造后不再修改, 元素按 Eytzinger 顺序 (完全二叉树的层序) 存放在 vector 中: 下标从 1 开始, k 的左右儿子为 2k 和 2k+1
+// 二分查找前几层的元素集中在数组开头, 常驻缓存; 每一步的下标只由比较结果决定 (k = 2k + (tree[k] < x)),
+// 没有难以预测的分支, 并且提前预取四层之后的子孙所在的缓存行, 把访存延迟与比较重叠起来
+// 查找结束时 k 的二进制末尾连续的 1 表示最后几步向右走, 去掉它们和再上一层即得到第一个不小于 x 的元素
+// 批量查询把多个查找交错推进, 让多个缓存未命中同时进行
+// 迭代器按元素大小顺序遍历, 在隐式的二叉树上做中序移动
+
+#include <initializer_list>
+
+#include "vector.h"
+#include "set.h"
+#include "iterator.h"
+#include "functional.h"
+#include "exceptdef.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <xmmintrin.h>
+#define MYSTL_PREFETCH(p) _mm_prefetch(reinterpret_cast<const char*>(p), _MM_HINT_T0)
+#else
+#define MYSTL_PREFETCH(p) __builtin_prefetch(p)
+#endif
+
+namespace mystl
+{
+    // 末尾 0 的个数, x 不为 0
+    inline unsigned eytzinger_ctz(size_t x)
+    {
+#if defined(_MSC_VER) && defined(_WIN64)
+        unsigned long i;
+        _BitScanForward64(&i, x);
+        return static_cast<unsigned>(i);
+#elif defined(_MSC_VER)
+        unsigned long i;
+        _BitScanForward(&i, x);
+        return static_cast<unsigned>(i);
+#else
+        return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
+    }
+
+    // 中序遍历的前驱后继, 下标 0 表示 end()
+    inline size_t eytzinger_next(size_t k, size_t n)
+    {
+        if (2 * k + 1 <= n)
+        {
+            k = 2 * k + 1;
+            while (2 * k <= n)
+                k = 2 * k;
+            return k;
+        }
+        // 向上越过所有作为右儿子的祖先, 再上一层
+        return k >> (eytzinger_ctz(~k) + 1);
+    }
+
+    inline size_t eytzinger_prev(size_t k, size_t n)
+    {
+        if (k == 0)
+        {
+            k = n ? 1 : 0;
+            while (k && 2 * k + 1 <= n)
+                k = 2 * k + 1;
+            return k;
+        }
+        if (2 * k <= n)
+        {
+            k = 2 * k;
+            while (2 * k + 1 <= n)
+                k = 2 * k + 1;
+            return k;
+        }
+        return k >> (eytzinger_ctz(k) + 1);
+    }
+
+    template <class T>
+    struct static_sorted_set_iterator : public mystl::iterator<mystl::bidirectional_iterator_tag, T>
+    {
+        typedef T                                   value_type;
+        typedef const T*                            pointer;
+        typedef const T&                            reference;
+        typedef ptrdiff_t                           difference_type;
+        typedef static_sorted_set_iterator<T>       self;
+
+        const T* tree;  // Eytzinger 数组, 下标从 1 开始
+        size_t   n;
+        size_t   k;     // 0 表示 end()
+
+        static_sorted_set_iterator() noexcept : tree(nullptr), n(0), k(0) {}
+        static_sorted_set_iterator(const T* t, size_t size, size_t pos) noexcept
+            : tree(t), n(size), k(pos)
+        {
+        }
+
+        reference operator*()  const { return tree[k]; }
+        pointer   operator->() const { return &(operator*()); }
+
+        self& operator++()
+        {
+            k = eytzinger_next(k, n);
+            return *this;
+        }
+        self operator++(int)
+        {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        self& operator--()
+        {
+            k = eytzinger_prev(k, n);
+            return *this;
+        }
+        self operator--(int)
+        {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        bool operator==(const self& rhs) const { return k == rhs.k && tree == rhs.tree; }
+        bool operator!=(const self& rhs) const { return !(*this == rhs); }
+    };
+
+    // 模板类 static_sorted_set
+    // 参数一表示元素类型, 参数二表示比较方式, 默认采取 < 比较
+    template <class T, class Compare = mystl::less<T>>
+    class static_sorted_set
+    {
+    public:
+        typedef T                                       key_type;
+        typedef T                                       value_type;
+        typedef Compare                                 key_compare;
+        typedef Compare                                 value_compare;
+        typedef const T*                                pointer;
+        typedef const T*                                const_pointer;
+        typedef const T&                                reference;
+        typedef const T&                                const_reference;
+        typedef size_t                                  size_type;
+        typedef ptrdiff_t                               difference_type;
+
+        typedef static_sorted_set_iterator<T>           iterator;
+        typedef iterator                                const_iterator;
+        typedef mystl::reverse_iterator<iterator>       reverse_iterator;
+        typedef reverse_iterator                        const_reverse_iterator;
+
+        // 批量查询每组同时推进的查找个数
+        static constexpr size_t kBatch = 16;
+
+    private:
+        // 一个缓存行能放下的元素个数, 每步预取 k * kPrefetchStride, 即四层 (int) 之后的子孙
+        static constexpr size_t kPrefetchStride = 64 / sizeof(T) > 1 ? 64 / sizeof(T) : 1;
+
+        mystl::vector<T>    tree_;      // tree_[0] 不使用, 元素在 tree_[1..n]
+        size_type           n_;
+        size_type           full_;      // 每个查找都会走满的层数, 即 floor(log2(n + 1))
+        Compare             comp_;
+
+    public:
+        // 构造函数
+
+        static_sorted_set() : tree_(), n_(0), full_(0), comp_() {}
+
+        // [first, last) 须按 comp 升序排列, 相等的元素只保留第一个
+        template <class InputIterator>
+        static_sorted_set(InputIterator first, InputIterator last, const Compare& comp = Compare())
+            : tree_(), n_(0), full_(0), comp_(comp)
+        {
+            mystl::vector<T> sorted;
+            for (; first != last; ++first)
+            {
+                MYSTL_DEBUG(sorted.empty() || !comp_(*first, sorted.back()));
+                if (sorted.empty() || comp_(sorted.back(), *first))
+                    sorted.push_back(*first);
+            }
+            build(sorted);
+        }
+
+        explicit static_sorted_set(const mystl::set<T, Compare>& s)
+            : static_sorted_set(s.begin(), s.end())
+        {
+        }
+
+        static_sorted_set(std::initializer_list<T> ilist)
+            : static_sorted_set(ilist.begin(), ilist.end())
+        {
+        }
+
+        static_sorted_set(const static_sorted_set&) = default;
+        static_sorted_set& operator=(const static_sorted_set&) = default;
+
+        static_sorted_set(static_sorted_set&& rhs) noexcept
+            : tree_(mystl::move(rhs.tree_)), n_(rhs.n_), full_(rhs.full_), comp_(rhs.comp_)
+        {
+            rhs.n_ = rhs.full_ = 0;
+        }
+
+        static_sorted_set& operator=(static_sorted_set&& rhs) noexcept
+        {
+            swap(rhs);
+            return *this;
+        }
+
+    public:
+        // 迭代器与容量
+        iterator         begin()  const noexcept { return iterator(base(), n_, n_ ? leftmost() : 0); }
+        iterator         end()    const noexcept { return iterator(base(), n_, 0); }
+        reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
+        reverse_iterator rend()   const noexcept { return reverse_iterator(begin()); }
+        iterator         cbegin() const noexcept { return begin(); }
+        iterator         cend()   const noexcept { return end(); }
+
+        bool      empty() const noexcept { return n_ == 0; }
+        size_type size()  const noexcept { return n_; }
+
+        key_compare key_comp() const { return comp_; }
+
+        void swap(static_sorted_set& rhs) noexcept
+        {
+            tree_.swap(rhs.tree_);
+            mystl::swap(n_, rhs.n_);
+            mystl::swap(full_, rhs.full_);
+            mystl::swap(comp_, rhs.comp_);
+        }
+
+    public:
+        // 查找
+
+        iterator lower_bound(const T& value) const
+        { return iterator(base(), n_, lower_bound_index(value)); }
+
+        iterator upper_bound(const T& value) const
+        { return iterator(base(), n_, upper_bound_index(value)); }
+
+        mystl::pair<iterator, iterator> equal_range(const T& value) const
+        { return mystl::pair<iterator, iterator>(lower_bound(value), upper_bound(value)); }
+
+        iterator find(const T& value) const
+        {
+            size_type k = lower_bound_index(value);
+            return iterator(base(), n_, k != 0 && !comp_(value, tree_[k]) ? k : 0);
+        }
+
+        bool contains(const T& value) const
+        {
+            size_type k = lower_bound_index(value);
+            return k != 0 && !comp_(value, tree_[k]);
+        }
+
+        size_type count(const T& value) const { return contains(value) ? 1 : 0; }
+
+        // 批量查询: 对 [first, last) 中的每个值依次把 lower_bound 写入 result, 返回 result 的尾后位置
+        template <class ForwardIterator, class OutputIterator>
+        OutputIterator lower_bound_batch(ForwardIterator first, ForwardIterator last, OutputIterator result) const
+        {
+            size_type ks[kBatch];
+            while (first != last)
+            {
+                ForwardIterator group = first;
+                size_type m = batch_search(first, last, ks);
+                for (size_type i = 0; i < m; ++i, ++group, ++result)
+                    *result = iterator(base(), n_, ks[i]);
+            }
+            return result;
+        }
+
+        // 批量查询: 对 [first, last) 中的每个值依次把是否存在写入 result, 返回 result 的尾后位置
+        template <class ForwardIterator, class OutputIterator>
+        OutputIterator contains_batch(ForwardIterator first, ForwardIterator last, OutputIterator result) const
+        {
+            size_type ks[kBatch];
+            while (first != last)
+            {
+                ForwardIterator group = first;
+                size_type m = batch_search(first, last, ks);
+                for (size_type i = 0; i < m; ++i, ++group, ++result)
+                    *result = ks[i] != 0 && !comp_(*group, tree_[ks[i]]);
+            }
+            return result;
+        }
+
+    private:
+        const T* base() const noexcept { return n_ ? &tree_[0] : nullptr; }
+
+        size_type leftmost() const noexcept
+        {
+            size_type k = 1;
+            while (2 * k <= n_)
+                k = 2 * k;
+            return k;
+        }
+
+        // 按中序把 sorted 依次填入 Eytzinger 数组
+        void build(const mystl::vector<T>& sorted)
+        {
+            n_ = sorted.size();
+            full_ = 0;
+            while ((size_type(2) << full_) - 1 <= n_)
+                ++full_;
+            if (n_ == 0)
+                return;
+            mystl::vector<T> tree(n_ + 1, sorted[0]);
+            size_type i = 0;
+            build_aux(tree, sorted, i, 1);
+            tree_.swap(tree);
+        }
+
+        void build_aux(mystl::vector<T>& tree, const mystl::vector<T>& sorted, size_type& i, size_type k)
+        {
+            if (k > n_)
+                return;
+            build_aux(tree, sorted, i, 2 * k);
+            tree[k] = sorted[i++];
+            build_aux(tree, sorted, i, 2 * k + 1);
+        }
+
+        // 走到叶子之下后, 去掉末尾连续的 1 (最后向右的几步) 以及再上一层, 剩下的就是答案, 为 0 表示不存在
+        static size_type finish(size_type k)
+        {
+            return k >> (eytzinger_ctz(~k) + 1);
+        }
+
+        size_type lower_bound_index(const T& value) const
+        {
+            const T* t = base();
+            size_type k = 1;
+            while (k <= n_)
+            {
+                MYSTL_PREFETCH(t + k * kPrefetchStride);
+                k = 2 * k + static_cast<size_type>(comp_(t[k], value));
+            }
+            return finish(k);
+        }
+
+        size_type upper_bound_index(const T& value) const
+        {
+            const T* t = base();
+            size_type k = 1;
+            while (k <= n_)
+            {
+                MYSTL_PREFETCH(t + k * kPrefetchStride);
+                k = 2 * k + static_cast<size_type>(!comp_(value, t[k]));
+            }
+            return finish(k);
+        }
+
+        // 从 first 起最多取 kBatch 个值, 把它们的 lower_bound 下标写入 ks, first 前进到下一组, 返回本组个数
+        // 前 full_ 层对所有查找都存在, 可以不加判断地交错推进, 最后至多再走一层
+        template <class ForwardIterator>
+        size_type batch_search(ForwardIterator& first, ForwardIterator last, size_type* ks) const
+        {
+            ForwardIterator vals[kBatch];
+            size_type m = 0;
+            for (; m < kBatch && first != last; ++m, ++first)
+            {
+                vals[m] = first;
+                ks[m] = 1;
+            }
+            if (n_ == 0)
+            {
+                for (size_type i = 0; i < m; ++i)
+                    ks[i] = 0;
+                return m;
+            }
+            const T* t = base();
+            for (size_type level = 0; level < full_; ++level)
+            {
+                for (size_type i = 0; i < m; ++i)
+                {
+                    MYSTL_PREFETCH(t + ks[i] * kPrefetchStride);
+                    ks[i] = 2 * ks[i] + static_cast<size_type>(comp_(t[ks[i]], *vals[i]));
+                }
+            }
+            for (size_type i = 0; i < m; ++i)
+            {
+                if (ks[i] <= n_)
+                    ks[i] = 2 * ks[i] + static_cast<size_type>(comp_(t[ks[i]], *vals[i]));
+                ks[i] = finish(ks[i]);
+            }
+            return m;
+        }
+
+    public:
+        bool operator==(const static_sorted_set& rhs) const
+        {
+            if (n_ != rhs.n_)
+                return false;
+            for (auto i = begin(), j = rhs.begin(); i != end(); ++i, ++j)
+            {
+                if (comp_(*i, *j) || comp_(*j, *i))
+                    return false;
+            }
+            return true;
+        }
+
+        bool operator!=(const static_sorted_set& rhs) const { return !(*this == rhs); }
+    };
+
+    template <class T, class Compare>
+    void swap(static_sorted_set<T, Compare>& lhs, static_sorted_set<T, Compare>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+} // namespace mystl
+
+#endif //TINYSTL_STATIC_SORTED_SET_H
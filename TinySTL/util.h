@@ -57,6 +57,16 @@ void swap(Tp(&a)[N], Tp(&b)[N])
   mystl::swap_range(a, a + N, b);
 }
 
+// sorted_unique
+// 标记类型, 表示传入的区间已经按比较函数严格递增, 有序容器可以据此跳过查找直接建树
+
+struct sorted_unique_t
+{
+  explicit sorted_unique_t() = default;
+};
+
+constexpr sorted_unique_t sorted_unique{};
+
 // --------------------------------------------------------------------------------------
 // pair
 
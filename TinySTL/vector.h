@@ -118,7 +118,7 @@ namespace mystl
         reverse_iterator        rbegin()          noexcept
         { return reverse_iterator(end()); }
         const_reverse_iterator  rbegin()    const noexcept
-        { return reverse_iterator(end()); }
+        { return const_reverse_iterator(end()); }
         reverse_iterator        rend()            noexcept
         { return reverse_iterator(begin());}
         const_reverse_iterator  rend()      const noexcept
@@ -236,7 +236,7 @@ namespace mystl
         }
 
         void push_back(T&& value)
-        { emplace_back(forward<T>(value)); }
+        { emplace_back(mystl::move(value)); }
 
         void pop_back()
         {
@@ -251,13 +251,15 @@ namespace mystl
 
         iterator insert(const_iterator pos, const T& value)
         {
-            auto n = pos - begin();
-            if (finish != end_of_storage && pos == end())
+            iterator xpos = const_cast<iterator>(pos);
+            auto n = xpos - begin();
+            if (finish != end_of_storage && xpos == end())
             {
                 data_allocator::construct(finish, value);
+                ++finish;
             }
             else
-                insert_aux(pos, value);
+                insert_aux(xpos, value);
             return begin() + n;
         }
 
@@ -497,11 +499,11 @@ namespace mystl
     {
         if (finish < end_of_storage)
         {
-            data_allocator::construct(end(), forward<Args>(args)...);
+            data_allocator::construct(end(), mystl::forward<Args>(args)...);
             ++finish;
         }
         else
-            insert_aux(end(), forward<Args>(args)...);
+            insert_aux(end(), mystl::forward<Args>(args)...);
     }
 
     // insert
@@ -514,7 +516,7 @@ namespace mystl
         {
             data_allocator::construct(finish, *(finish - 1));
             ++finish;
-            copy_backward(position, finish - 2, finish - 1);
+            mystl::copy_backward(position, finish - 2, finish - 1);
             *position = value_type(mystl::forward<Args>(args)...);
         }
         else
@@ -551,7 +553,7 @@ namespace mystl
             data_allocator::construct(finish, *(finish - 1));
             ++finish;
             auto value_copy = value;
-            copy_backward(position, finish - 2, finish - 1);
+            mystl::copy_backward(position, finish - 2, finish - 1);
             *position = value_copy;
         }
         else
@@ -672,7 +674,7 @@ namespace mystl
                 try
                 {
                     new_finish = mystl::uninitialized_copy((iterator)start, (iterator)position, (iterator)new_start);
-                    new_finish = mystl::uninitialized_copy((iterator)first, (iterator)last, (iterator)new_finish);
+                    new_finish = mystl::uninitialized_copy(first, last, (iterator)new_finish);
                     new_finish = mystl::uninitialized_copy((iterator)position, (iterator)finish, (iterator)new_finish);
                 }
                 catch (...)
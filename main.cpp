@@ -19,6 +19,20 @@
 #include "Test/unordered_set_test.h"
 #include "Test/unordered_map_test.h"
 #include "Test/deque_test.h"
+#include "Test/btree_test.h"
+#include "Test/flat_test.h"
+#include "Test/persistent_map_test.h"
+#include "Test/interval_map_test.h"
+#include "Test/concurrent_skiplist_map_test.h"
+#include "Test/art_map_test.h"
+#include "Test/static_sorted_set_test.h"
+#include "Test/ring_buffer_test.h"
+#include "Test/spsc_queue_test.h"
+#include "Test/executor_test.h"
+#include "Test/execution_test.h"
+#include "Test/radix_sort_test.h"
+#include "Test/sort_test.h"
+#include "Test/addressable_heap_test.h"
 
 int main()
 {